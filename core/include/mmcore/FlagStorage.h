@@ -10,10 +10,11 @@
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
-#include "mmcore/FlagStorageBitsChecker.h"
+#include "mmcore/FlagStorageBitmap.h"
 #include "mmcore/FlagStorageTypes.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include <array>
 
 namespace megamol {
 namespace core {
@@ -109,12 +110,17 @@ protected:
      */
     virtual bool writeCPUDataCallback(core::Call& caller);
 
-    static nlohmann::json make_bit_array(
-        const FlagStorageTypes::index_vector& bit_starts, const FlagStorageTypes::index_vector& bit_ends);
     void array_to_bits(const nlohmann::json& json, FlagStorageTypes::flag_bits flag_bit);
     static FlagStorageTypes::index_type array_max(const nlohmann::json& json);
+    /**
+     * Updates the bitmaps from the flags, re-collecting only the ranges marked as changed if the writer recorded any,
+     * and stores them in the binary format in serializedFlags.
+     */
     void serializeCPUData();
+    /** Reads serializedFlags, either in the binary or in the legacy JSON format */
     void deserializeCPUData();
+    void deserializeJSON(const std::string& str);
+    bool deserializeBitmaps(const std::string& str);
     virtual bool onJSONChanged(param::ParamSlot& slot);
 
     /** The slot for reading the data */
@@ -128,6 +134,16 @@ protected:
     std::shared_ptr<FlagCollection_CPU> theCPUData;
     bool cpu_stale = true;
     uint32_t version = 0;
+
+    /** Compressed copy of the enabled, filtered and selected bits */
+    std::array<FlagStorageBitmap, 3> bitmaps;
+    /** Whether the bitmaps hold the flags of 'bitmapVersion', a write of the next version can update them */
+    bool bitmapsValid = false;
+    uint32_t bitmapVersion = 0;
+    size_t bitmapFlagCount = 0;
+
+    /** Ranges changed by the last write, empty if everything might have changed */
+    FlagStorageBitmap::range_vector lastChanges;
 };
 
 class FlagCollection_CPU {
@@ -136,11 +152,29 @@ public:
 
     void validateFlagCount(FlagStorageTypes::index_type num) {
         if (flags->size() < num) {
-            flags->resize(num);
-            std::fill(
-                flags->begin(), flags->end(), FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::ENABLED));
+            flags->resize(num, FlagStorageTypes::to_integral(FlagStorageTypes::flag_bits::ENABLED));
         }
     }
+
+    /**
+     * Records that the flags in [first, last] have been modified. Writers that mark their modifications before
+     * publishing get only these ranges re-compressed and uploaded, otherwise all flags are.
+     */
+    void markChanged(FlagStorageTypes::index_type first, FlagStorageTypes::index_type last) {
+        changed.emplace_back(first, last);
+    }
+
+    /** Ranges marked since the last publication, empty if unknown */
+    const FlagStorageBitmap::range_vector& changedRanges() const {
+        return changed;
+    }
+
+    void clearChanged() {
+        changed.clear();
+    }
+
+private:
+    FlagStorageBitmap::range_vector changed;
 };
 
 } // namespace core
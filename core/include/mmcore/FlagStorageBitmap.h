@@ -0,0 +1,135 @@
+/*
+ * FlagStorageBitmap.h
+ *
+ * Copyright (C) 2021 by Universitaet Stuttgart (VISUS).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include "mmcore/FlagStorageTypes.h"
+#include "mmcore/api/MegaMolCore.std.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace megamol {
+namespace core {
+
+/**
+ * Compressed set of flag indices, i.e. the items for which one flag bit is set, in the manner of roaring bitmaps.
+ *
+ * The index space is split into chunks of 2^16 items. Only chunks with at least one item are stored, each one in the
+ * smallest of three containers: a sorted array of the items, a run-length (range) encoding, or a plain bit set. Set
+ * operations work chunk by chunk, so sparse selections and large contiguous ranges stay small and fast.
+ */
+class MEGAMOLCORE_API FlagStorageBitmap {
+public:
+    using index_type = FlagStorageTypes::index_type;
+    using range_vector = std::vector<std::pair<index_type, index_type>>;
+
+    /** Number of items per chunk is 2^chunk_bits */
+    static constexpr int chunk_bits = 16;
+    static constexpr index_type chunk_size = 1 << chunk_bits;
+
+    /**
+     * Collects the items of 'flags' with 'bit' set, compressing the chunks in parallel.
+     */
+    static FlagStorageBitmap fromFlags(
+        const FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit);
+
+    /**
+     * Re-collects only the chunks that overlap the inclusive 'ranges' from 'flags'. Chunks beyond the end of 'flags'
+     * are dropped.
+     */
+    void update(const FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit,
+        const range_vector& ranges);
+
+    /**
+     * Sets 'bit' for all items in the set and clears it for all others in 'flags'.
+     */
+    void toFlags(FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit) const;
+
+    void add(index_type idx);
+
+    /** Adds all items in [first, last] */
+    void addRange(index_type first, index_type last);
+
+    bool contains(index_type idx) const;
+
+    /** Number of items in the set */
+    size_t cardinality(void) const;
+
+    bool empty(void) const {
+        return chunks.empty();
+    }
+
+    /** Appends the maximal inclusive ranges of consecutive items to 'ranges' */
+    void ranges(range_vector& ranges) const;
+
+    FlagStorageBitmap operator|(const FlagStorageBitmap& rhs) const;
+    FlagStorageBitmap operator&(const FlagStorageBitmap& rhs) const;
+    /** Set difference */
+    FlagStorageBitmap operator-(const FlagStorageBitmap& rhs) const;
+
+    bool operator==(const FlagStorageBitmap& rhs) const;
+    bool operator!=(const FlagStorageBitmap& rhs) const {
+        return !(*this == rhs);
+    }
+
+    /**
+     * Appends the inclusive item ranges of all chunks that differ between 'a' and 'b' to 'changed'.
+     */
+    static void changedChunks(const FlagStorageBitmap& a, const FlagStorageBitmap& b, range_vector& changed);
+
+    /** Appends the binary representation to 'out' */
+    void serialize(std::vector<uint8_t>& out) const;
+
+    /**
+     * Reads the binary representation written by serialize, starting at 'pos'.
+     *
+     * @return The position after the bitmap, or nullptr if the data is malformed.
+     */
+    const uint8_t* deserialize(const uint8_t* pos, const uint8_t* end);
+
+private:
+    enum class container_type : uint8_t { ARRAY = 0, RUNS = 1, BITSET = 2 };
+
+    /** Maximum cardinality of an array container, beyond it a bit set is never larger */
+    static constexpr uint32_t max_array_size = 4096;
+    static constexpr uint32_t bitset_words = chunk_size / 64;
+
+    struct chunk {
+        uint16_t key;
+        container_type type;
+        uint32_t cardinality;
+        /** Sorted items (ARRAY) or pairs of run start and run length - 1 (RUNS) */
+        std::vector<uint16_t> values;
+        /** BITSET only */
+        std::vector<uint64_t> bits;
+
+        bool operator==(const chunk& rhs) const {
+            return key == rhs.key && type == rhs.type && cardinality == rhs.cardinality && values == rhs.values &&
+                   bits == rhs.bits;
+        }
+    };
+
+    /** Compresses the bit set of a chunk into its smallest container, returns false if the chunk is empty */
+    static bool compress(uint16_t key, const uint64_t* bits, chunk& c);
+
+    static void decompress(const chunk& c, uint64_t* bits);
+
+    /** Collects chunk 'key' of 'flags' */
+    static bool collect(
+        const FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_item_type mask, uint16_t key, chunk& c);
+
+    template<typename OP>
+    static FlagStorageBitmap combine(const FlagStorageBitmap& a, const FlagStorageBitmap& b, bool keepA, bool keepB,
+        OP op);
+
+    /** Chunks sorted by key */
+    std::vector<chunk> chunks;
+};
+
+} // namespace core
+} /* end namespace megamol */
@@ -0,0 +1,285 @@
+/**
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include "mmcore/Call.h"
+#include "mmcore/api/MegaMolCore.std.h"
+#include "mmcore/param/ParamSlot.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace megamol {
+namespace core {
+
+/**
+ * Size-bounded least recently used cache for the outputs of modules, which is shared by all modules of the graph.
+ *
+ * An output is identified by the module that computed it, the values of the parameters the output depends on, the
+ * module providing its input, the data hash of the input and the frame. Modules opt in via a ResultCacheClient, so switching back to a previous
+ * parameter setting or revisiting a frame can be served from memory instead of being recomputed.
+ *
+ * Outputs are shared and immutable, an output evicted from the cache remains valid as long as a module holds it.
+ */
+class MEGAMOLCORE_API ResultCache {
+public:
+    /** Identifies an output. */
+    struct Key {
+        /** The module that computed the output. */
+        const void* Owner;
+        /** The values of the parameters that feed the output. */
+        std::string Parameters;
+        /** The class and slot of the module providing the input. */
+        std::string Source;
+        /** The data hash of the input, which is only unique for the same source. */
+        uint64_t Inputs;
+        unsigned int FrameID;
+
+        inline bool operator==(const Key& rhs) const {
+            return (this->Owner == rhs.Owner) && (this->Inputs == rhs.Inputs) && (this->FrameID == rhs.FrameID) &&
+                   (this->Parameters == rhs.Parameters) && (this->Source == rhs.Source);
+        }
+    };
+
+    /**
+     * The capacity of the cache unless changed by SetCapacity, 512 MiB. The
+     * configuration value 'ResultCacheSize' sets the capacity in MiB.
+     */
+    static const size_t DEFAULT_CAPACITY;
+
+    /**
+     * Answer the cache shared by all modules.
+     *
+     * @return The graph-wide cache.
+     */
+    static ResultCache& Instance(void);
+
+    /**
+     * Answer the maximum number of bytes of all cached outputs.
+     *
+     * @return The capacity in bytes.
+     */
+    size_t Capacity(void) const;
+
+    /** Removes all outputs. */
+    void Clear(void);
+
+    /**
+     * Removes all outputs of a module, which must be done before the module
+     * is destroyed.
+     *
+     * @param owner The module.
+     */
+    void Evict(const void* owner);
+
+    /**
+     * Looks up an output and marks it as most recently used.
+     *
+     * @param key The output to look up.
+     *
+     * @return The output or nullptr if it is not cached or of another type.
+     */
+    template<class T>
+    inline std::shared_ptr<const T> Find(const Key& key) {
+        return std::static_pointer_cast<const T>(this->find(key, typeid(T)));
+    }
+
+    /**
+     * Answer how many lookups were answered from the cache.
+     *
+     * @return The number of hits since the start.
+     */
+    size_t Hits(void) const;
+
+    /**
+     * Stores an output, replacing an output with the same key. The least
+     * recently used outputs are evicted until the cache fits into its
+     * capacity. Outputs larger than the capacity are not stored.
+     *
+     * @param key   The output to store.
+     * @param value The output.
+     * @param size  The number of bytes of the output.
+     */
+    template<class T>
+    inline void Insert(const Key& key, std::shared_ptr<const T> value, const size_t size) {
+        this->insert(key, std::static_pointer_cast<const void>(value), typeid(T), size);
+    }
+
+    /**
+     * Answer how many lookups were not answered from the cache.
+     *
+     * @return The number of misses since the start.
+     */
+    size_t Misses(void) const;
+
+    /**
+     * Changes the capacity and evicts outputs if necessary.
+     *
+     * @param capacity The maximum number of bytes, zero disables the cache.
+     */
+    void SetCapacity(const size_t capacity);
+
+    /**
+     * Answer the number of bytes of all cached outputs.
+     *
+     * @return The size in bytes.
+     */
+    size_t Size(void) const;
+
+private:
+    /** A cached output. */
+    struct Entry {
+        Key Id;
+        std::shared_ptr<const void> Value;
+        std::type_index Type;
+        size_t Size;
+    };
+
+    /** Hashes a key for the index. */
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    /** The entries from the most to the least recently used one. */
+    typedef std::list<Entry> EntryList;
+
+    ResultCache(void);
+
+    /** Evicts least recently used outputs without locking until 'size' is at most 'capacity'. */
+    void evictUnsafe(const size_t capacity);
+
+    std::shared_ptr<const void> find(const Key& key, const std::type_info& type);
+
+    void insert(const Key& key, std::shared_ptr<const void> value, const std::type_info& type, const size_t size);
+
+    size_t capacity;
+
+    EntryList entries;
+
+    size_t hits;
+
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+
+    mutable std::mutex lock;
+
+    size_t misses;
+
+    size_t size;
+};
+
+
+/**
+ * The opt-in of a module into the ResultCache. The module declares the
+ * parameters that feed its output, and the client derives the keys of the
+ * outputs from their values and the call delivering the input. All outputs
+ * of the module are evicted when the client is destroyed or when the input
+ * is connected to another module, as data hashes of different modules are
+ * not comparable.
+ *
+ * Inputs with a data hash of zero are considered as unknown, and outputs
+ * computed from them are not cached.
+ */
+class MEGAMOLCORE_API ResultCacheClient {
+public:
+    /**
+     * Initialises a new instance.
+     *
+     * @param owner The module computing the outputs.
+     */
+    ResultCacheClient(const void* owner);
+
+    /** Evicts all outputs of the owner. */
+    ~ResultCacheClient(void);
+
+    /**
+     * Declares a parameter that feeds the output.
+     *
+     * @param slot The slot of the parameter, which must live as long as the
+     *             client.
+     */
+    void AddParameter(const param::ParamSlot& slot);
+
+    /**
+     * Looks up the output for the current parameter values.
+     *
+     * @param input     The call delivering the input.
+     * @param inputHash The data hash of the input.
+     * @param frameID   The frame of the output.
+     *
+     * @return The output or nullptr if it must be computed.
+     */
+    template<class T>
+    inline std::shared_ptr<const T> Find(const Call& input, const uint64_t inputHash, const unsigned int frameID) {
+        return (inputHash != 0) ? ResultCache::Instance().Find<T>(this->MakeKey(input, inputHash, frameID))
+                                : nullptr;
+    }
+
+    /**
+     * Stores the output for the current parameter values.
+     *
+     * @param input     The call delivering the input.
+     * @param inputHash The data hash of the input.
+     * @param frameID   The frame of the output.
+     * @param value     The output.
+     * @param size      The number of bytes of the output.
+     */
+    template<class T>
+    inline void Insert(const Call& input, const uint64_t inputHash, const unsigned int frameID,
+        std::shared_ptr<const T> value, const size_t size) {
+        if (inputHash != 0) {
+            ResultCache::Instance().Insert(this->MakeKey(input, inputHash, frameID), value, size);
+        }
+    }
+
+    /**
+     * Answer the key of the output for the current parameter values. All
+     * outputs of the owner are evicted if 'input' is connected to another
+     * module than before.
+     *
+     * @param input     The call delivering the input.
+     * @param inputHash The data hash of the input.
+     * @param frameID   The frame of the output.
+     *
+     * @return The key of the output.
+     */
+    ResultCache::Key MakeKey(const Call& input, const uint64_t inputHash, const unsigned int frameID);
+
+    /**
+     * Answer the hash of the current values of the declared parameters. The
+     * hash is the same whenever the parameters have the same values, so it
+     * can be used as the local part of the data hash of the output.
+     *
+     * @return The hash of the parameter values.
+     */
+    uint64_t ParameterHash(void) const;
+
+    /**
+     * Answer the current values of the declared parameters.
+     *
+     * @return The concatenated values, each prefixed by its length.
+     */
+    std::string ParameterValues(void) const;
+
+private:
+    const void* owner;
+
+    std::vector<const param::ParamSlot*> parameters;
+
+    /** The call delivering the input for the cached outputs. */
+    const Call* source;
+
+    /** The class and slot of the module providing the input for the cached outputs. */
+    std::string sourceName;
+};
+
+} // namespace core
+} // namespace megamol
@@ -75,6 +75,32 @@ public:
      */
     virtual File::FileSize GetSize(void) const;
 
+    /**
+     * Hints the operating system that the given range of the file mapped by
+     * 'MapFile' will be accessed soon, such that it can be read ahead
+     * asynchronously. This is a no-op if the file is not mapped or if the
+     * platform does not support such hints.
+     *
+     * @param offset The offset of the range in bytes from the beginning of
+     *               the file.
+     * @param size   The size of the range in bytes.
+     */
+    void AdviseWillNeed(File::FileSize offset, File::FileSize size) const;
+
+    /**
+     * Maps the whole file read-only, independent from the current view used
+     * by 'Read' and 'Write', and answers the address of its first byte.
+     * Subsequent calls answer the same mapping. The mapping stays valid until
+     * 'UnmapFile' or 'Close' is called.
+     *
+     * @return Pointer to the mapped file content.
+     *
+     * @throws IllegalStateException if the file is not open or not opened
+     *                               for reading.
+     * @throws IOException if the mapping fails. Use GetLastError().
+     */
+    const char* MapFile(void);
+
     /**
      * behaves like File::Open except for WRITE_ONLY files. These are silently upgraded to READ_WRITE
      * since there is no such thing as a memory-mapped WRITE_ONLY file (also under linux even if no one
@@ -133,6 +159,14 @@ public:
      */
     virtual File::FileSize Tell(void) const;
 
+    /**
+     * Unmaps the whole-file mapping created by 'MapFile', if any. All
+     * pointers into this mapping become invalid.
+     *
+     * @throws IOException if unmapping fails. Use GetLastError().
+     */
+    void UnmapFile(void);
+
     /**
      * behaves like File::Write
      * Performs an implicit flush if the view is dirty and changed.
@@ -247,6 +281,12 @@ private:
      */
     char* mappedData;
 
+    /** pointer to the whole-file mapping created by 'MapFile' */
+    char* fileMapping;
+
+    /** the size of the whole-file mapping in bytes */
+    File::FileSize fileMappingSize;
+
     /**
      * mapping used to generate views
      */
@@ -12,9 +12,15 @@
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "mmcore/Module.h"
 #include "mmcore/utility/sys/Thread.h"
+#include "mmcore/view/FramePrefetchPolicy.h"
 #include "vislib/sys/CriticalSection.h"
 
 
@@ -39,6 +45,35 @@ public:
         return this->frameCnt;
     }
 
+    /**
+     * Answer the number of requests answered with exactly the requested
+     * frame since the frame cache has been initialised.
+     *
+     * @return The number of cache hits.
+     */
+    inline UINT64 CacheHits(void) const {
+        return this->cacheHits.load();
+    }
+
+    /**
+     * Answer the number of requests answered with a different frame than
+     * the requested one (or had to wait for it) since the frame cache has
+     * been initialised.
+     *
+     * @return The number of cache misses.
+     */
+    inline UINT64 CacheMisses(void) const {
+        return this->cacheMisses.load();
+    }
+
+    /**
+     * Resets the cache hit and miss counters.
+     */
+    inline void ResetCacheStatistics(void) {
+        this->cacheHits.store(0);
+        this->cacheMisses.store(0);
+    }
+
 protected:
     /**
      * Base class for holding all variable data of one time frame of the
@@ -48,15 +83,12 @@ protected:
     public:
         friend class ::megamol::core::view::AnimDataModule;
 
-        /** possible values for the state of the frame */
-        enum State { STATE_INVALID, STATE_LOADING, STATE_AVAILABLE, STATE_INUSE };
-
         /**
          * Ctor.
          *
          * @param owner The owning AnimDataModule
          */
-        Frame(AnimDataModule& owner) : frame(0), owner(owner), state(STATE_INVALID) {
+        Frame(AnimDataModule& owner) : frame(0), owner(owner), lockCnt(LOCK_INVALID), cachedIdx(0) {
             // intentionally empty
         }
 
@@ -80,17 +112,19 @@ protected:
          * @return 'true' if this frame is locked, 'false' otherwise.
          */
         inline bool IsLocked(void) const {
-            return (this->state == STATE_INUSE);
+            return (this->lockCnt.load() > 0);
         }
 
         /**
          * Unlocks the frame.
          * This should be called as soon as the frame is no longer used.
          * After you unlocked the frame, it's content is no longer
-         * guaranteed to be stable.
+         * guaranteed to be stable. Each successful request of a locked
+         * frame must be matched by exactly one call to this method, since
+         * several users may hold the same frame at once.
          */
         inline void Unlock(void) {
-            if (this->state == STATE_INUSE) {
+            if (this->lockCnt.load() > 0) {
                 owner.unlock(this);
             }
         };
@@ -100,11 +134,30 @@ protected:
         unsigned int frame;
 
     private:
+        /** value of 'lockCnt' of a frame not holding any data */
+        static constexpr int LOCK_INVALID = -2;
+
+        /** value of 'lockCnt' of a frame being loaded */
+        static constexpr int LOCK_LOADING = -1;
+
         /** The owning AnimDataModule */
         AnimDataModule& owner;
 
-        /** the state of this frame */
-        State state;
+#ifdef _WIN32
+#pragma warning(disable : 4251)
+#endif /* _WIN32 */
+        /**
+         * The number of users holding the frame if it is available, or one
+         * of 'LOCK_INVALID' and 'LOCK_LOADING'. All state transitions are
+         * atomic operations on this value.
+         */
+        std::atomic<int> lockCnt;
+
+        /** The frame index this object is registered for in the frame cache index */
+        std::atomic<unsigned int> cachedIdx;
+#ifdef _WIN32
+#pragma warning(default : 4251)
+#endif /* _WIN32 */
     };
 
     /**
@@ -161,7 +214,9 @@ protected:
      *                 exactly the requested idx, and not the closest
      *                 match.
      *
-     * @return The frame most suitable to the request.
+     * @return The frame most suitable to the request or NULL if there is
+     *         no frame cache. The call waits for a frame if none can be
+     *         locked at the moment.
      */
     Frame* requestLockedFrame(unsigned int idx);
     Frame* requestLockedFrame(unsigned int idx, bool forceIdx);
@@ -182,6 +237,25 @@ protected:
      */
     void setFrameCount(unsigned int cnt);
 
+    /**
+     * Sets the number of threads loading frames in parallel. Must not be
+     * called after the frame cache has been initialised! If more than one
+     * thread is used, 'loadFrame' must be safe to be called concurrently for
+     * different frame objects.
+     *
+     * @param cnt The number of loader threads. Values below one are
+     *            clamped to one.
+     */
+    void setLoaderThreadCount(unsigned int cnt);
+
+    /**
+     * Sets the policy deciding which frames are loaded into the frame cache.
+     * Must not be called after the frame cache has been initialised!
+     *
+     * @param policy The prefetch policy. Must not be NULL.
+     */
+    void setPrefetchPolicy(std::shared_ptr<FramePrefetchPolicy> policy);
+
     /** frame is a friend to be able to call 'unlock' */
     friend class ::megamol::core::view::AnimDataModule::Frame;
 
@@ -195,6 +269,48 @@ private:
      */
     static DWORD loaderFunction(void* userData);
 
+    /**
+     * Searches the frame cache for the frame most suitable for the
+     * requested frame index and locks it.
+     *
+     * @param idx The index of the requested frame.
+     *
+     * @return The locked frame or NULL if no frame is available.
+     */
+    Frame* findAndLockFrame(unsigned int idx);
+
+    /**
+     * Answer whether the given frame is loaded into the cache and can be
+     * locked. The answer may be outdated as soon as this method returns.
+     *
+     * @param idx The index of the frame.
+     *
+     * @return 'true' if the frame is available.
+     */
+    bool isFrameAvailable(unsigned int idx) const;
+
+    /**
+     * Locks the given frame for one more user if it is available and
+     * registered for 'idx'.
+     *
+     * @param frame The frame to lock.
+     * @param idx The frame index 'frame' is expected to hold.
+     *
+     * @return 'true' if the frame has been locked.
+     */
+    static bool tryLock(Frame* frame, unsigned int idx);
+
+    /**
+     * Notes a change of requests or frame states and wakes up sleeping
+     * loader threads.
+     */
+    void wakeLoaders(void);
+
+    /**
+     * Stops and joins all loader threads.
+     */
+    void stopLoaders(void);
+
     /**
      * Unlocks the given frame
      */
@@ -207,23 +323,54 @@ private:
     /** The number of time frames of the dataset */
     unsigned int frameCnt;
 
-    /** The loading thread */
-    vislib::sys::Thread loader;
+    /** The loading threads */
+    std::vector<std::thread> loaders;
+
+    /** The number of loading threads to start */
+    unsigned int loaderCnt;
+
+    /** The policy selecting the frames to be loaded */
+    std::shared_ptr<FramePrefetchPolicy> policy;
 
     /** The frame cache */
     Frame** frameCache;
 
+    /**
+     * The frame cache index mapping frame indices to positions in
+     * 'frameCache' or -1 if the frame is not cached.
+     */
+    std::unique_ptr<std::atomic<int>[]> frameSlots;
+
     /** the number of frames to be held in cache. */
     unsigned int cacheSize;
 
     /**
-     * The critical section to synchornise the state changes of the
-     * cached frames.
+     * The mutex the loader threads and threads waiting for forced frames
+     * sleep on. Requesting and unlocking frames never waits for it unless
+     * loader threads are sleeping.
      */
-    vislib::sys::CriticalSection stateLock;
+    std::mutex wakeLock;
+
+    /** Signals the loader threads that requests or frame states changed */
+    std::condition_variable loaderWakeup;
+
+    /** Signals threads waiting for a forced frame that a frame was loaded */
+    std::condition_variable frameLoaded;
+
+    /** Counts changes of requests and frame states */
+    std::atomic<unsigned int> stateEpoch;
+
+    /** The number of loader threads sleeping on 'loaderWakeup' */
+    std::atomic<unsigned int> sleepingLoaders;
 
     /** The frame number requested the last time 'requestLockedFrame' was called */
-    unsigned int lastRequested;
+    std::atomic<unsigned int> lastRequested;
+
+    /** Number of requests answered with the requested frame */
+    std::atomic<UINT64> cacheHits;
+
+    /** Number of requests not answered with the requested frame */
+    std::atomic<UINT64> cacheMisses;
 
     /** TODO: The Mueller shalt document his stuff */
     std::atomic_bool isRunning;
@@ -0,0 +1,156 @@
+/*
+ * FramePrefetchPolicy.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_FRAMEPREFETCHPOLICY_H_INCLUDED
+#define MEGAMOL_FRAMEPREFETCHPOLICY_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+#include <mutex>
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+
+namespace megamol {
+namespace core {
+namespace view {
+
+/**
+ * Abstract base class for strategies deciding which frames the loader
+ * threads of an 'AnimDataModule' should keep in its frame cache.
+ *
+ * Implementations must be thread-safe: 'Request' is called from the threads
+ * requesting frames, while 'Predict' is called from the loader threads.
+ */
+class MEGAMOLCORE_API FramePrefetchPolicy {
+public:
+    /** Dtor. */
+    virtual ~FramePrefetchPolicy(void);
+
+    /**
+     * Predicts the frames which will be requested next.
+     *
+     * @param frameCnt The number of time frames of the dataset.
+     * @param count The maximum number of frames to predict.
+     * @param outFrames Receives the distinct frame indices in descending
+     *                  order of importance. The first entry is the frame
+     *                  requested last.
+     */
+    virtual void Predict(unsigned int frameCnt, unsigned int count, std::vector<unsigned int>& outFrames) const = 0;
+
+    /**
+     * Records that a frame has been requested.
+     *
+     * @param idx The index of the requested frame.
+     * @param frameCnt The number of time frames of the dataset.
+     */
+    virtual void Request(unsigned int idx, unsigned int frameCnt) = 0;
+
+    /**
+     * Forgets all recorded requests.
+     */
+    virtual void Reset(void) = 0;
+
+protected:
+    /** Ctor. */
+    FramePrefetchPolicy(void);
+};
+
+
+/**
+ * Prefetches the frames following the frame requested last, wrapping around
+ * at the end of the dataset. This is the classic behaviour for forward
+ * playback.
+ */
+class MEGAMOLCORE_API LinearPrefetchPolicy : public FramePrefetchPolicy {
+public:
+    /** Ctor. */
+    LinearPrefetchPolicy(void);
+
+    /** Dtor. */
+    virtual ~LinearPrefetchPolicy(void);
+
+    /** See 'FramePrefetchPolicy::Predict' */
+    virtual void Predict(unsigned int frameCnt, unsigned int count, std::vector<unsigned int>& outFrames) const;
+
+    /** See 'FramePrefetchPolicy::Request' */
+    virtual void Request(unsigned int idx, unsigned int frameCnt);
+
+    /** See 'FramePrefetchPolicy::Reset' */
+    virtual void Reset(void);
+
+private:
+    /** The frame requested last */
+    unsigned int lastRequested;
+
+    /** Guards the recorded state */
+    mutable std::mutex lock;
+};
+
+
+/**
+ * Detects the playback direction and stride from the sequence of requests
+ * and prefetches along it. Looping playback (wrapping around at the end of
+ * the dataset) and ping-pong playback (reversing at either end) are
+ * recognised. Jumps larger than the maximum stride, e.g. from scrubbing, do
+ * not change the detected stride.
+ */
+class MEGAMOLCORE_API AdaptivePrefetchPolicy : public FramePrefetchPolicy {
+public:
+    /**
+     * Ctor.
+     *
+     * @param maxStride The largest distance between two subsequent requests
+     *                  still considered as playback stride.
+     */
+    AdaptivePrefetchPolicy(unsigned int maxStride = 8);
+
+    /** Dtor. */
+    virtual ~AdaptivePrefetchPolicy(void);
+
+    /** See 'FramePrefetchPolicy::Predict' */
+    virtual void Predict(unsigned int frameCnt, unsigned int count, std::vector<unsigned int>& outFrames) const;
+
+    /** See 'FramePrefetchPolicy::Request' */
+    virtual void Request(unsigned int idx, unsigned int frameCnt);
+
+    /** See 'FramePrefetchPolicy::Reset' */
+    virtual void Reset(void);
+
+private:
+    /** The largest distance considered as stride */
+    int maxStride;
+
+    /** The frame requested last */
+    unsigned int lastRequested;
+
+    /** The detected signed stride (never zero) */
+    int stride;
+
+    /** Flag whether ping-pong playback has been detected */
+    bool pingPong;
+
+    /** Guards the recorded state */
+    mutable std::mutex lock;
+
+    /**
+     * Marks the frames already predicted, kept between the calls to avoid
+     * an allocation per prediction. All entries are false between calls.
+     */
+    mutable std::vector<bool> predicted;
+
+    /** Guards 'predicted' against concurrent predictions */
+    mutable std::mutex predictLock;
+};
+
+} // namespace view
+} /* end namespace core */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_FRAMEPREFETCHPOLICY_H_INCLUDED */
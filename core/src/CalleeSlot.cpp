@@ -211,7 +211,8 @@ bool CalleeSlot::IsCallProfiling(const Call* c) const {
     // test if at least one function callback is a profiling callback
     for (unsigned int i = 0; i < func_cnt; i++) {
         unsigned int func_idx = c->funcMap[i];
-        ASSERT(func_idx < this->callbacks.Count());
+        if (func_idx >= this->callbacks.Count())
+            continue; // function not implemented by this slot
 
         Callback* cb = this->callbacks[func_idx];
         if (dynamic_cast<ProfilingCallback*>(cb) != nullptr) {
@@ -249,7 +250,8 @@ void CalleeSlot::AddCallProfiling(const Call* c) {
     // Change callbacks to be profiling
     for (unsigned int i = 0; i < func_cnt; i++) {
         unsigned int func_idx = c->funcMap[i];
-        ASSERT(func_idx < this->callbacks.Count());
+        if (func_idx >= this->callbacks.Count())
+            continue; // function not implemented by this slot
 
         ProfilingCallback* pcb = new ProfilingCallback(
             this->callbacks[func_idx], profiler::Connection::ptr_type(new profiler::Connection()));
@@ -287,7 +289,8 @@ void CalleeSlot::RemoveCallProfiling(const Call* c) {
     // switch from profiling callback to normal callbacks
     for (unsigned int i = 0; i < func_cnt; i++) {
         unsigned int func_idx = c->funcMap[i];
-        ASSERT(func_idx < this->callbacks.Count());
+        if (func_idx >= this->callbacks.Count())
+            continue; // function not implemented by this slot
 
         Callback* cb = this->callbacks[func_idx];
         if (dynamic_cast<ProfilingCallback*>(cb) != nullptr) {
@@ -22,6 +22,7 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/Module.h"
+#include "mmcore/ResultCache.h"
 #include "mmcore/cluster/ClusterController.h"
 #include "mmcore/job/JobThread.h"
 #include "mmcore/param/ButtonParam.h"
@@ -387,6 +388,18 @@ void megamol::core::CoreInstance::Initialise(bool mmconsole_frontend_compatible)
         profiler::Manager::Instance().SetMode(profiler::Manager::PROFILE_NONE);
     }
 
+    // size the result cache shared by all modules (in MiB)
+    if (this->config.IsConfigValueSet("ResultCacheSize")) {
+        vislib::StringA size(this->config.ConfigValue("ResultCacheSize"));
+        try {
+            const auto mib = vislib::CharTraitsA::ParseInt(size);
+            ResultCache::Instance().SetCapacity(static_cast<size_t>(mib < 0 ? 0 : mib) * 1024 * 1024);
+        } catch (...) {
+            megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                "The ResultCacheSize \"%s\" is not a number of MiB.", size.PeekBuffer());
+        }
+    }
+
 
     //////////////////////////////////////////////////////////////////////
     // register builtin descriptions
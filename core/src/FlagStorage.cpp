@@ -3,10 +3,75 @@
 #include "mmcore/CoreInstance.h"
 #include "mmcore/FlagCalls.h"
 #include "mmcore/param/StringParam.h"
+#include "mmcore/utility/log/Log.h"
+#include <chrono>
+#include <cstring>
 
 using namespace megamol;
 using namespace megamol::core;
 
+namespace {
+
+/** Marks serializedFlags values in the binary format, anything else is legacy JSON */
+const std::string bitmap_prefix = "mmfb1:";
+
+/** Bits in the order of FlagStorage::bitmaps */
+const std::array<FlagStorageTypes::flag_bits, 3> bitmap_bits = {FlagStorageTypes::flag_bits::ENABLED,
+    FlagStorageTypes::flag_bits::FILTERED, FlagStorageTypes::flag_bits::SELECTED};
+
+const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string encodeBase64(const std::vector<uint8_t>& data) {
+    std::string res;
+    res.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        const size_t n = std::min<size_t>(3, data.size() - i);
+        uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+        if (n > 1)
+            v |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (n > 2)
+            v |= data[i + 2];
+        for (size_t c = 0; c < 4; ++c) {
+            res.push_back(c <= n ? base64_chars[(v >> (18 - 6 * c)) & 0x3F] : '=');
+        }
+    }
+    return res;
+}
+
+bool decodeBase64(const std::string& str, std::vector<uint8_t>& data) {
+    if (str.size() % 4 != 0)
+        return false;
+    data.clear();
+    data.reserve(str.size() / 4 * 3);
+    for (size_t i = 0; i < str.size(); i += 4) {
+        uint32_t v = 0;
+        size_t pad = 0;
+        for (size_t c = 0; c < 4; ++c) {
+            const char ch = str[i + c];
+            uint32_t d = 0;
+            if (ch == '=' && i + 4 == str.size() && c >= 2) {
+                ++pad;
+            } else if (pad > 0) {
+                return false;
+            } else {
+                const char* p = std::strchr(base64_chars, ch);
+                if (ch == '\0' || p == nullptr)
+                    return false;
+                d = static_cast<uint32_t>(p - base64_chars);
+            }
+            v = (v << 6) | d;
+        }
+        data.push_back(static_cast<uint8_t>(v >> 16));
+        if (pad < 2)
+            data.push_back(static_cast<uint8_t>(v >> 8));
+        if (pad < 1)
+            data.push_back(static_cast<uint8_t>(v));
+    }
+    return true;
+}
+
+} // namespace
+
 
 FlagStorage::FlagStorage(void)
         : readCPUFlagsSlot("readCPUFlags", "Provides flag data to clients.")
@@ -91,21 +156,6 @@ bool FlagStorage::writeMetaDataCallback(core::Call& caller) {
 }
 
 
-nlohmann::json FlagStorage::make_bit_array(
-    const FlagStorageTypes::index_vector& bit_starts, const FlagStorageTypes::index_vector& bit_ends) {
-    auto the_array = nlohmann::json::array();
-    for (uint32_t x = 0; x < bit_starts.size(); ++x) {
-        const auto& s = bit_starts[x];
-        const auto& e = bit_ends[x];
-        if (s == e) {
-            the_array.push_back(s);
-        } else {
-            the_array.push_back(nlohmann::json::array({s, e}));
-        }
-    }
-    return the_array;
-}
-
 void FlagStorage::array_to_bits(const nlohmann::json& json, FlagStorageTypes::flag_bits flag_bit) {
     for (auto& j : json) {
         if (j.is_array()) {
@@ -138,56 +188,97 @@ FlagStorageTypes::index_type FlagStorage::array_max(const nlohmann::json& json)
 
 
 void FlagStorage::serializeCPUData() {
-    const auto& cdata = theCPUData->flags;
-
-    FlagStorageTypes::index_vector enabled_starts, enabled_ends;
-    FlagStorageTypes::index_vector filtered_starts, filtered_ends;
-    FlagStorageTypes::index_vector selected_starts, selected_ends;
-    FlagStorageTypes::index_type curr_enabled_start = -1, curr_filtered_start = -1, curr_selected_start = -1;
-
-#if 0 // serial version
-    const auto startSerialTime = std::chrono::high_resolution_clock::now();
-    for (index_type x = 0; x < cdata->size(); ++x) {
-        check_bits(FlagStorage::ENABLED, enabled_starts, enabled_ends, curr_enabled_start, x, cdata);
-        check_bits(FlagStorage::FILTERED, filtered_starts, filtered_ends, curr_filtered_start, x, cdata);
-        check_bits(FlagStorage::SELECTED, selected_starts, selected_ends, curr_selected_start, x, cdata);
+    const auto& cdata = *theCPUData->flags;
+
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    // only trust the marked ranges if they were made on the flags the bitmaps hold, i.e. the write directly follows
+    // the version the bitmaps were collected from, and nothing was removed
+    auto changes = theCPUData->changedRanges();
+    const bool incremental = !changes.empty() && bitmapsValid && (this->version == bitmapVersion + 1) &&
+                             bitmapFlagCount <= cdata.size();
+    if (incremental && bitmapFlagCount < cdata.size()) {
+        changes.emplace_back(static_cast<FlagStorageTypes::index_type>(bitmapFlagCount),
+            static_cast<FlagStorageTypes::index_type>(cdata.size() - 1));
+    }
+    for (size_t b = 0; b < bitmaps.size(); ++b) {
+        if (incremental) {
+            bitmaps[b].update(cdata, bitmap_bits[b], changes);
+        } else {
+            bitmaps[b] = FlagStorageBitmap::fromFlags(cdata, bitmap_bits[b]);
+        }
     }
-    terminate_bit(cdata, enabled_ends, curr_enabled_start);
-    terminate_bit(cdata, filtered_ends, curr_filtered_start);
-    terminate_bit(cdata, selected_ends, curr_selected_start);
-    const auto endSerialTime = std::chrono::high_resolution_clock::now();
-    ASSERT(enabled_starts.size() == enabled_ends.size());
-    ASSERT(filtered_starts.size() == filtered_ends.size());
-    ASSERT(selected_starts.size() == selected_ends.size());
-    nlohmann::json ser_data;
-    ser_data["enabled"] = make_bit_array(enabled_starts, enabled_ends);
-    ser_data["filtered"] = make_bit_array(filtered_starts, filtered_ends);
-    ser_data["selected"] = make_bit_array(selected_starts, selected_ends);
-    const std::chrono::duration<double, std::milli> diffSerialMillis = endSerialTime - startSerialTime;
-    Log::DefaultLog.WriteInfo("serial reduction: %lf ms", diffSerialMillis.count());
-    this->serializedFlags.Param<core::param::StringParam>()->SetValue(ser_data.dump().c_str());
-#else
-    const auto startParallelTime = std::chrono::high_resolution_clock::now();
-    BitsChecker bc(cdata);
-    tbb::parallel_reduce(tbb::blocked_range<int32_t>(0, static_cast<int32_t>(cdata->size()), 50000), bc);
-    const auto endParallelTime = std::chrono::high_resolution_clock::now();
-    ASSERT(bc.enabled_starts.size() == bc.enabled_ends.size());
-    ASSERT(bc.filtered_starts.size() == bc.filtered_ends.size());
-    ASSERT(bc.selected_starts.size() == bc.selected_ends.size());
-    nlohmann::json parallel_data;
-    parallel_data["enabled"] = make_bit_array(bc.enabled_starts, bc.enabled_ends);
-    parallel_data["filtered"] = make_bit_array(bc.filtered_starts, bc.filtered_ends);
-    parallel_data["selected"] = make_bit_array(bc.selected_starts, bc.selected_ends);
-    const std::chrono::duration<double, std::milli> diffParallelMillis = endParallelTime - startParallelTime;
-    Log::DefaultLog.WriteInfo("parallel reduction: %lf ms", diffParallelMillis.count());
-    this->serializedFlags.Param<core::param::StringParam>()->SetValue(parallel_data.dump().c_str());
-#endif
-    //ASSERT(parallel_data.dump() == ser_data.dump());
+    bitmapsValid = true;
+    bitmapVersion = this->version;
+    bitmapFlagCount = cdata.size();
+    theCPUData->clearChanged();
+    if (incremental) {
+        lastChanges = std::move(changes);
+    } else {
+        lastChanges.clear();
+    }
+
+    std::vector<uint8_t> blob;
+    for (size_t i = 0; i < 4; ++i) {
+        blob.push_back(static_cast<uint8_t>(static_cast<uint32_t>(cdata.size()) >> (8 * i)));
+    }
+    for (const auto& bm : bitmaps) {
+        bm.serialize(blob);
+    }
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    const std::chrono::duration<double, std::milli> diffMillis = endTime - startTime;
+    Log::DefaultLog.WriteInfo("%s flag compression: %lf ms, %zu bytes", incremental ? "incremental" : "full",
+        diffMillis.count(), blob.size());
+
+    this->serializedFlags.Param<core::param::StringParam>()->SetValue(
+        (bitmap_prefix + encodeBase64(blob)).c_str(), false);
 }
 
 void FlagStorage::deserializeCPUData() {
+    const std::string str = this->serializedFlags.Param<core::param::StringParam>()->Value();
+    if (str.empty())
+        return;
+    if (str.compare(0, bitmap_prefix.size(), bitmap_prefix) == 0) {
+        if (!deserializeBitmaps(str.substr(bitmap_prefix.size()))) {
+            utility::log::Log::DefaultLog.WriteError("%s: serialized flags are malformed", this->ClassName());
+        }
+    } else {
+        deserializeJSON(str);
+        bitmapsValid = false;
+    }
+    theCPUData->clearChanged();
+}
+
+bool FlagStorage::deserializeBitmaps(const std::string& str) {
+    std::vector<uint8_t> blob;
+    if (!decodeBase64(str, blob) || blob.size() < 4)
+        return false;
+    uint32_t num_flags = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        num_flags |= static_cast<uint32_t>(blob[i]) << (8 * i);
+    }
+    std::array<FlagStorageBitmap, 3> tmp;
+    const uint8_t* pos = blob.data() + 4;
+    const uint8_t* end = blob.data() + blob.size();
+    for (auto& bm : tmp) {
+        pos = bm.deserialize(pos, end);
+        if (pos == nullptr)
+            return false;
+    }
+
+    theCPUData->flags->resize(num_flags, 0);
+    for (size_t b = 0; b < bitmaps.size(); ++b) {
+        tmp[b].toFlags(*theCPUData->flags, bitmap_bits[b]);
+    }
+    bitmaps = std::move(tmp);
+    bitmapsValid = true;
+    bitmapVersion = this->version;
+    bitmapFlagCount = num_flags;
+    return true;
+}
+
+void FlagStorage::deserializeJSON(const std::string& str) {
     try {
-        auto j = nlohmann::json::parse(this->serializedFlags.Param<core::param::StringParam>()->Value());
+        auto j = nlohmann::json::parse(str);
         FlagStorageTypes::index_type num_flags = 10;
         // reset all flags
         if (j.contains("enabled")) {
@@ -204,20 +295,24 @@ void FlagStorage::deserializeCPUData() {
         if (j.contains("enabled")) {
             array_to_bits(j["enabled"], FlagStorageTypes::flag_bits::ENABLED);
         } else {
-            utility::log::Log::DefaultLog.WriteWarn("UniFlagStorage: serialized flags do not contain enabled items");
+            utility::log::Log::DefaultLog.WriteWarn(
+                "%s: serialized flags do not contain enabled items", this->ClassName());
         }
         if (j.contains("filtered")) {
             array_to_bits(j["filtered"], FlagStorageTypes::flag_bits::FILTERED);
         } else {
-            utility::log::Log::DefaultLog.WriteWarn("UniFlagStorage: serialized flags do not contain filtered items");
+            utility::log::Log::DefaultLog.WriteWarn(
+                "%s: serialized flags do not contain filtered items", this->ClassName());
         }
         if (j.contains("selected")) {
             array_to_bits(j["selected"], FlagStorageTypes::flag_bits::SELECTED);
         } else {
-            utility::log::Log::DefaultLog.WriteWarn("UniFlagStorage: serialized flags do not contain selected items");
+            utility::log::Log::DefaultLog.WriteWarn(
+                "%s: serialized flags do not contain selected items", this->ClassName());
         }
     } catch (nlohmann::detail::parse_error& e) {
-        utility::log::Log::DefaultLog.WriteError("UniFlagStorage: failed parsing serialized flags: %s", e.what());
+        utility::log::Log::DefaultLog.WriteError(
+            "%s: failed parsing serialized flags: %s", this->ClassName(), e.what());
     }
 }
 
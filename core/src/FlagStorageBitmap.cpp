@@ -0,0 +1,492 @@
+#include "mmcore/FlagStorageBitmap.h"
+
+#include <algorithm>
+#include <array>
+
+#include "tbb/tbb.h"
+
+using namespace megamol;
+using namespace megamol::core;
+
+namespace {
+
+using bitset_type = std::array<uint64_t, FlagStorageBitmap::chunk_size / 64>;
+
+inline int popcount(uint64_t w) {
+    int res = 0;
+    for (; w != 0; w &= w - 1) {
+        ++res;
+    }
+    return res;
+}
+
+/** Sets the bits [first, last] */
+void setRange(uint64_t* bits, uint32_t first, uint32_t last) {
+    uint32_t const firstWord = first / 64;
+    uint32_t const lastWord = last / 64;
+    uint64_t const firstMask = ~uint64_t(0) << (first % 64);
+    uint64_t const lastMask = ~uint64_t(0) >> (63 - last % 64);
+    if (firstWord == lastWord) {
+        bits[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    bits[firstWord] |= firstMask;
+    for (uint32_t w = firstWord + 1; w < lastWord; ++w) {
+        bits[w] = ~uint64_t(0);
+    }
+    bits[lastWord] |= lastMask;
+}
+
+/** Calls f(first, last) for all maximal runs of set bits */
+template<typename F>
+void forEachRun(const uint64_t* bits, uint32_t words, F f) {
+    bool inRun = false;
+    uint32_t start = 0;
+    for (uint32_t w = 0; w < words; ++w) {
+        uint64_t const word = bits[w];
+        if ((!inRun && word == 0) || (inRun && word == ~uint64_t(0))) {
+            continue;
+        }
+        for (uint32_t b = 0; b < 64; ++b) {
+            bool const set = (word >> b) & 1;
+            if (set && !inRun) {
+                start = w * 64 + b;
+                inRun = true;
+            } else if (!set && inRun) {
+                f(start, w * 64 + b - 1);
+                inRun = false;
+            }
+        }
+    }
+    if (inRun) {
+        f(start, words * 64 - 1);
+    }
+}
+
+/** Appends/merges [first, last] to 'ranges' */
+inline void appendRange(
+    FlagStorageBitmap::range_vector& ranges, FlagStorageBitmap::index_type first, FlagStorageBitmap::index_type last) {
+    if (!ranges.empty() && ranges.back().second + 1 == first) {
+        ranges.back().second = last;
+    } else {
+        ranges.emplace_back(first, last);
+    }
+}
+
+template<typename T>
+void writeLE(std::vector<uint8_t>& out, T val) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(val) >> (8 * i)));
+    }
+}
+
+template<typename T>
+bool readLE(const uint8_t*& pos, const uint8_t* end, T& val) {
+    if (end - pos < static_cast<ptrdiff_t>(sizeof(T))) {
+        return false;
+    }
+    uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        v |= static_cast<uint64_t>(*pos++) << (8 * i);
+    }
+    val = static_cast<T>(v);
+    return true;
+}
+
+} // namespace
+
+
+bool FlagStorageBitmap::compress(uint16_t key, const uint64_t* bits, chunk& c) {
+    uint32_t card = 0;
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint32_t w = 0; w < bitset_words; ++w) {
+        card += popcount(bits[w]);
+        // run starts: set bits whose predecessor is not set
+        runs += popcount(bits[w] & ~((bits[w] << 1) | carry));
+        carry = bits[w] >> 63;
+    }
+    if (card == 0) {
+        return false;
+    }
+
+    c.key = key;
+    c.cardinality = card;
+    c.values.clear();
+    c.bits.clear();
+
+    // sizes in bytes, ties prefer the cheaper container to query
+    size_t const arraySize = card <= max_array_size ? 2 * card : SIZE_MAX;
+    size_t const runsSize = 4 * static_cast<size_t>(runs);
+    size_t const bitsetSize = 8 * bitset_words;
+    if (arraySize <= runsSize && arraySize <= bitsetSize) {
+        c.type = container_type::ARRAY;
+        c.values.reserve(card);
+        for (uint32_t w = 0; w < bitset_words; ++w) {
+            for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+                int b = 0;
+                while (((word >> b) & 1) == 0) {
+                    ++b;
+                }
+                c.values.push_back(static_cast<uint16_t>(w * 64 + b));
+            }
+        }
+    } else if (runsSize <= bitsetSize) {
+        c.type = container_type::RUNS;
+        c.values.reserve(2 * runs);
+        forEachRun(bits, bitset_words, [&c](uint32_t first, uint32_t last) {
+            c.values.push_back(static_cast<uint16_t>(first));
+            c.values.push_back(static_cast<uint16_t>(last - first));
+        });
+    } else {
+        c.type = container_type::BITSET;
+        c.bits.assign(bits, bits + bitset_words);
+    }
+    return true;
+}
+
+
+void FlagStorageBitmap::decompress(const chunk& c, uint64_t* bits) {
+    switch (c.type) {
+    case container_type::ARRAY:
+        std::fill(bits, bits + bitset_words, 0);
+        for (auto v : c.values) {
+            bits[v / 64] |= uint64_t(1) << (v % 64);
+        }
+        break;
+    case container_type::RUNS:
+        std::fill(bits, bits + bitset_words, 0);
+        for (size_t r = 0; r + 1 < c.values.size(); r += 2) {
+            setRange(bits, c.values[r], c.values[r] + c.values[r + 1]);
+        }
+        break;
+    case container_type::BITSET:
+        std::copy(c.bits.begin(), c.bits.end(), bits);
+        break;
+    }
+}
+
+
+bool FlagStorageBitmap::collect(const FlagStorageTypes::flag_vector_type& flags,
+    FlagStorageTypes::flag_item_type mask, uint16_t key, chunk& c) {
+    bitset_type bits;
+    bits.fill(0);
+    size_t const base = static_cast<size_t>(key) << chunk_bits;
+    size_t const num = std::min<size_t>(chunk_size, flags.size() - base);
+    for (size_t i = 0; i < num; ++i) {
+        if (flags[base + i] & mask) {
+            bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
+    return compress(key, bits.data(), c);
+}
+
+
+FlagStorageBitmap FlagStorageBitmap::fromFlags(
+    const FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit) {
+    auto const mask = FlagStorageTypes::to_integral(bit);
+    size_t const numChunks = (flags.size() + chunk_size - 1) / chunk_size;
+    std::vector<chunk> tmp(numChunks);
+    std::vector<uint8_t> used(numChunks, 0);
+    tbb::parallel_for(size_t(0), numChunks,
+        [&](size_t k) { used[k] = collect(flags, mask, static_cast<uint16_t>(k), tmp[k]) ? 1 : 0; });
+
+    FlagStorageBitmap res;
+    for (size_t k = 0; k < numChunks; ++k) {
+        if (used[k]) {
+            res.chunks.push_back(std::move(tmp[k]));
+        }
+    }
+    return res;
+}
+
+
+void FlagStorageBitmap::update(
+    const FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit, const range_vector& ranges) {
+    auto const mask = FlagStorageTypes::to_integral(bit);
+    size_t const numChunks = (flags.size() + chunk_size - 1) / chunk_size;
+
+    std::vector<uint16_t> keys;
+    for (auto const& r : ranges) {
+        for (size_t k = r.first >> chunk_bits; k <= (static_cast<size_t>(r.second) >> chunk_bits) && k < numChunks;
+             ++k) {
+            keys.push_back(static_cast<uint16_t>(k));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<chunk> tmp(keys.size());
+    std::vector<uint8_t> used(keys.size(), 0);
+    tbb::parallel_for(
+        size_t(0), keys.size(), [&](size_t i) { used[i] = collect(flags, mask, keys[i], tmp[i]) ? 1 : 0; });
+
+    // merge the untouched chunks with the re-collected ones
+    std::vector<chunk> merged;
+    merged.reserve(this->chunks.size() + keys.size());
+    size_t i = 0;
+    for (auto& c : this->chunks) {
+        while (i < keys.size() && keys[i] < c.key) {
+            if (used[i])
+                merged.push_back(std::move(tmp[i]));
+            ++i;
+        }
+        if (i < keys.size() && keys[i] == c.key)
+            continue;
+        if (c.key < numChunks)
+            merged.push_back(std::move(c));
+    }
+    for (; i < keys.size(); ++i) {
+        if (used[i])
+            merged.push_back(std::move(tmp[i]));
+    }
+    this->chunks = std::move(merged);
+}
+
+
+void FlagStorageBitmap::toFlags(FlagStorageTypes::flag_vector_type& flags, FlagStorageTypes::flag_bits bit) const {
+    auto const mask = FlagStorageTypes::to_integral(bit);
+    size_t const numChunks = (flags.size() + chunk_size - 1) / chunk_size;
+    tbb::parallel_for(size_t(0), numChunks, [&](size_t k) {
+        size_t const base = k << chunk_bits;
+        size_t const num = std::min<size_t>(chunk_size, flags.size() - base);
+        auto const it = std::lower_bound(this->chunks.begin(), this->chunks.end(), k,
+            [](const chunk& c, size_t key) { return c.key < key; });
+        if (it == this->chunks.end() || it->key != k) {
+            for (size_t i = 0; i < num; ++i) {
+                flags[base + i] &= ~mask;
+            }
+            return;
+        }
+        bitset_type bits;
+        decompress(*it, bits.data());
+        for (size_t i = 0; i < num; ++i) {
+            if ((bits[i / 64] >> (i % 64)) & 1) {
+                flags[base + i] |= mask;
+            } else {
+                flags[base + i] &= ~mask;
+            }
+        }
+    });
+}
+
+
+void FlagStorageBitmap::add(index_type idx) {
+    this->addRange(idx, idx);
+}
+
+
+void FlagStorageBitmap::addRange(index_type first, index_type last) {
+    for (index_type k = first >> chunk_bits; k <= (last >> chunk_bits); ++k) {
+        auto it = std::lower_bound(this->chunks.begin(), this->chunks.end(), k,
+            [](const chunk& c, index_type key) { return c.key < key; });
+        bitset_type bits;
+        bits.fill(0);
+        if (it != this->chunks.end() && it->key == k) {
+            decompress(*it, bits.data());
+        } else {
+            it = this->chunks.insert(it, chunk());
+        }
+        index_type const base = k << chunk_bits;
+        setRange(bits.data(), std::max(first, base) - base, std::min(last, base + chunk_size - 1) - base);
+        compress(static_cast<uint16_t>(k), bits.data(), *it);
+    }
+}
+
+
+bool FlagStorageBitmap::contains(index_type idx) const {
+    auto const key = idx >> chunk_bits;
+    auto const it = std::lower_bound(
+        this->chunks.begin(), this->chunks.end(), key, [](const chunk& c, index_type key) { return c.key < key; });
+    if (it == this->chunks.end() || it->key != key) {
+        return false;
+    }
+    auto const low = static_cast<uint16_t>(idx & (chunk_size - 1));
+    switch (it->type) {
+    case container_type::ARRAY:
+        return std::binary_search(it->values.begin(), it->values.end(), low);
+    case container_type::RUNS: {
+        // binary search for the last run starting at or before 'low'
+        size_t lo = 0, hi = it->values.size() / 2;
+        while (lo < hi) {
+            size_t const mid = (lo + hi) / 2;
+            if (it->values[2 * mid] <= low) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo > 0 && low <= it->values[2 * (lo - 1)] + it->values[2 * (lo - 1) + 1];
+    }
+    case container_type::BITSET:
+        return (it->bits[low / 64] >> (low % 64)) & 1;
+    }
+    return false;
+}
+
+
+size_t FlagStorageBitmap::cardinality(void) const {
+    size_t res = 0;
+    for (auto const& c : this->chunks) {
+        res += c.cardinality;
+    }
+    return res;
+}
+
+
+void FlagStorageBitmap::ranges(range_vector& ranges) const {
+    for (auto const& c : this->chunks) {
+        index_type const base = static_cast<index_type>(c.key) << chunk_bits;
+        switch (c.type) {
+        case container_type::ARRAY:
+            for (auto v : c.values) {
+                appendRange(ranges, base + v, base + v);
+            }
+            break;
+        case container_type::RUNS:
+            for (size_t r = 0; r + 1 < c.values.size(); r += 2) {
+                appendRange(ranges, base + c.values[r], base + c.values[r] + c.values[r + 1]);
+            }
+            break;
+        case container_type::BITSET:
+            forEachRun(c.bits.data(), bitset_words,
+                [&](uint32_t first, uint32_t last) { appendRange(ranges, base + first, base + last); });
+            break;
+        }
+    }
+}
+
+
+template<typename OP>
+FlagStorageBitmap FlagStorageBitmap::combine(
+    const FlagStorageBitmap& a, const FlagStorageBitmap& b, bool keepA, bool keepB, OP op) {
+    FlagStorageBitmap res;
+    bitset_type bitsA, bitsB;
+    auto ia = a.chunks.begin();
+    auto ib = b.chunks.begin();
+    while (ia != a.chunks.end() || ib != b.chunks.end()) {
+        if (ib == b.chunks.end() || (ia != a.chunks.end() && ia->key < ib->key)) {
+            if (keepA)
+                res.chunks.push_back(*ia);
+            ++ia;
+        } else if (ia == a.chunks.end() || ib->key < ia->key) {
+            if (keepB)
+                res.chunks.push_back(*ib);
+            ++ib;
+        } else {
+            decompress(*ia, bitsA.data());
+            decompress(*ib, bitsB.data());
+            for (uint32_t w = 0; w < bitset_words; ++w) {
+                bitsA[w] = op(bitsA[w], bitsB[w]);
+            }
+            chunk c;
+            if (compress(ia->key, bitsA.data(), c)) {
+                res.chunks.push_back(std::move(c));
+            }
+            ++ia;
+            ++ib;
+        }
+    }
+    return res;
+}
+
+
+FlagStorageBitmap FlagStorageBitmap::operator|(const FlagStorageBitmap& rhs) const {
+    return combine(*this, rhs, true, true, [](uint64_t l, uint64_t r) { return l | r; });
+}
+
+
+FlagStorageBitmap FlagStorageBitmap::operator&(const FlagStorageBitmap& rhs) const {
+    return combine(*this, rhs, false, false, [](uint64_t l, uint64_t r) { return l & r; });
+}
+
+
+FlagStorageBitmap FlagStorageBitmap::operator-(const FlagStorageBitmap& rhs) const {
+    return combine(*this, rhs, true, false, [](uint64_t l, uint64_t r) { return l & ~r; });
+}
+
+
+bool FlagStorageBitmap::operator==(const FlagStorageBitmap& rhs) const {
+    // the container of a chunk only depends on its content, so equal sets have equal chunks
+    return this->chunks == rhs.chunks;
+}
+
+
+void FlagStorageBitmap::changedChunks(const FlagStorageBitmap& a, const FlagStorageBitmap& b, range_vector& changed) {
+    auto ia = a.chunks.begin();
+    auto ib = b.chunks.begin();
+    while (ia != a.chunks.end() || ib != b.chunks.end()) {
+        index_type key;
+        if (ib == b.chunks.end() || (ia != a.chunks.end() && ia->key < ib->key)) {
+            key = (ia++)->key;
+        } else if (ia == a.chunks.end() || ib->key < ia->key) {
+            key = (ib++)->key;
+        } else {
+            bool const same = *ia == *ib;
+            key = ia->key;
+            ++ia;
+            ++ib;
+            if (same)
+                continue;
+        }
+        appendRange(changed, key << chunk_bits, (key << chunk_bits) + chunk_size - 1);
+    }
+}
+
+
+void FlagStorageBitmap::serialize(std::vector<uint8_t>& out) const {
+    // little endian: chunk count, then per chunk key, container type, cardinality, value count and the values
+    writeLE<uint32_t>(out, static_cast<uint32_t>(this->chunks.size()));
+    for (auto const& c : this->chunks) {
+        writeLE<uint16_t>(out, c.key);
+        writeLE<uint8_t>(out, static_cast<uint8_t>(c.type));
+        writeLE<uint32_t>(out, c.cardinality);
+        if (c.type == container_type::BITSET) {
+            for (auto w : c.bits) {
+                writeLE<uint64_t>(out, w);
+            }
+        } else {
+            writeLE<uint32_t>(out, static_cast<uint32_t>(c.values.size()));
+            for (auto v : c.values) {
+                writeLE<uint16_t>(out, v);
+            }
+        }
+    }
+}
+
+
+const uint8_t* FlagStorageBitmap::deserialize(const uint8_t* pos, const uint8_t* end) {
+    this->chunks.clear();
+    uint32_t numChunks;
+    if (!readLE(pos, end, numChunks))
+        return nullptr;
+    for (uint32_t i = 0; i < numChunks; ++i) {
+        chunk c;
+        uint8_t type;
+        if (!readLE(pos, end, c.key) || !readLE(pos, end, type) || !readLE(pos, end, c.cardinality))
+            return nullptr;
+        if (type > static_cast<uint8_t>(container_type::BITSET))
+            return nullptr;
+        if (!this->chunks.empty() && this->chunks.back().key >= c.key)
+            return nullptr;
+        c.type = static_cast<container_type>(type);
+        if (c.type == container_type::BITSET) {
+            c.bits.resize(bitset_words);
+            for (auto& w : c.bits) {
+                if (!readLE(pos, end, w))
+                    return nullptr;
+            }
+        } else {
+            uint32_t numValues;
+            if (!readLE(pos, end, numValues) || numValues > 2 * max_array_size * 8)
+                return nullptr;
+            c.values.resize(numValues);
+            for (auto& v : c.values) {
+                if (!readLE(pos, end, v))
+                    return nullptr;
+            }
+        }
+        this->chunks.push_back(std::move(c));
+    }
+    return pos;
+}
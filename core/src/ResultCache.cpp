@@ -0,0 +1,259 @@
+/**
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "mmcore/ResultCache.h"
+#include "stdafx.h"
+
+#include <functional>
+#include <string>
+
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/Module.h"
+
+using namespace megamol;
+using namespace megamol::core;
+
+namespace {
+
+inline void hashCombine(uint64_t& seed, const uint64_t value) {
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+
+/*
+ * ResultCache::DEFAULT_CAPACITY
+ */
+const size_t ResultCache::DEFAULT_CAPACITY = static_cast<size_t>(512) * 1024 * 1024;
+
+
+/*
+ * ResultCache::Instance
+ */
+ResultCache& ResultCache::Instance(void) {
+    static ResultCache instance;
+    return instance;
+}
+
+
+/*
+ * ResultCache::Capacity
+ */
+size_t ResultCache::Capacity(void) const {
+    std::lock_guard<std::mutex> l(this->lock);
+    return this->capacity;
+}
+
+
+/*
+ * ResultCache::Clear
+ */
+void ResultCache::Clear(void) {
+    std::lock_guard<std::mutex> l(this->lock);
+    this->evictUnsafe(0);
+}
+
+
+/*
+ * ResultCache::Evict
+ */
+void ResultCache::Evict(const void* owner) {
+    std::lock_guard<std::mutex> l(this->lock);
+    for (auto it = this->entries.begin(); it != this->entries.end();) {
+        if (it->Id.Owner == owner) {
+            this->size -= it->Size;
+            this->index.erase(it->Id);
+            it = this->entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+
+/*
+ * ResultCache::Hits
+ */
+size_t ResultCache::Hits(void) const {
+    std::lock_guard<std::mutex> l(this->lock);
+    return this->hits;
+}
+
+
+/*
+ * ResultCache::Misses
+ */
+size_t ResultCache::Misses(void) const {
+    std::lock_guard<std::mutex> l(this->lock);
+    return this->misses;
+}
+
+
+/*
+ * ResultCache::SetCapacity
+ */
+void ResultCache::SetCapacity(const size_t capacity) {
+    std::lock_guard<std::mutex> l(this->lock);
+    this->capacity = capacity;
+    this->evictUnsafe(capacity);
+}
+
+
+/*
+ * ResultCache::Size
+ */
+size_t ResultCache::Size(void) const {
+    std::lock_guard<std::mutex> l(this->lock);
+    return this->size;
+}
+
+
+/*
+ * ResultCache::KeyHash::operator()
+ */
+size_t ResultCache::KeyHash::operator()(const Key& key) const {
+    uint64_t retval = std::hash<const void*>()(key.Owner);
+    hashCombine(retval, std::hash<std::string>()(key.Parameters));
+    hashCombine(retval, std::hash<std::string>()(key.Source));
+    hashCombine(retval, key.Inputs);
+    hashCombine(retval, key.FrameID);
+    return static_cast<size_t>(retval);
+}
+
+
+/*
+ * ResultCache::ResultCache
+ */
+ResultCache::ResultCache(void) : capacity(DEFAULT_CAPACITY), hits(0), misses(0), size(0) {
+    // intentionally empty
+}
+
+
+/*
+ * ResultCache::evictUnsafe
+ */
+void ResultCache::evictUnsafe(const size_t capacity) {
+    while ((this->size > capacity) && !this->entries.empty()) {
+        const auto& e = this->entries.back();
+        this->size -= e.Size;
+        this->index.erase(e.Id);
+        this->entries.pop_back();
+    }
+}
+
+
+/*
+ * ResultCache::find
+ */
+std::shared_ptr<const void> ResultCache::find(const Key& key, const std::type_info& type) {
+    std::lock_guard<std::mutex> l(this->lock);
+    auto it = this->index.find(key);
+    if ((it == this->index.end()) || (it->second->Type != std::type_index(type))) {
+        ++this->misses;
+        return nullptr;
+    }
+
+    ++this->hits;
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    return it->second->Value;
+}
+
+
+/*
+ * ResultCache::insert
+ */
+void ResultCache::insert(
+    const Key& key, std::shared_ptr<const void> value, const std::type_info& type, const size_t size) {
+    std::lock_guard<std::mutex> l(this->lock);
+
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+        this->size -= it->second->Size;
+        this->entries.erase(it->second);
+        this->index.erase(it);
+    }
+
+    if ((value == nullptr) || (size > this->capacity)) {
+        return;
+    }
+
+    this->evictUnsafe(this->capacity - size);
+    this->entries.push_front(Entry{key, std::move(value), std::type_index(type), size});
+    this->index[key] = this->entries.begin();
+    this->size += size;
+}
+
+
+/*
+ * ResultCacheClient::ResultCacheClient
+ */
+ResultCacheClient::ResultCacheClient(const void* owner) : owner(owner), source(nullptr) {
+    // intentionally empty
+}
+
+
+/*
+ * ResultCacheClient::~ResultCacheClient
+ */
+ResultCacheClient::~ResultCacheClient(void) {
+    ResultCache::Instance().Evict(this->owner);
+}
+
+
+/*
+ * ResultCacheClient::AddParameter
+ */
+void ResultCacheClient::AddParameter(const param::ParamSlot& slot) {
+    this->parameters.push_back(&slot);
+}
+
+
+/*
+ * ResultCacheClient::MakeKey
+ */
+ResultCache::Key ResultCacheClient::MakeKey(const Call& input, const uint64_t inputHash, const unsigned int frameID) {
+    std::string sourceName;
+    auto slot = input.PeekCalleeSlot();
+    if (slot != nullptr) {
+        auto module = dynamic_cast<const Module*>(slot->Parent().get());
+        sourceName = std::string((module != nullptr) ? module->ClassName() : "") + " " + slot->FullName().PeekBuffer();
+    }
+
+    // data hashes of another module are not comparable to the cached ones,
+    // which might also belong to a module replaced by this one
+    if ((&input != this->source) || (sourceName != this->sourceName)) {
+        ResultCache::Instance().Evict(this->owner);
+        this->source = &input;
+        this->sourceName = sourceName;
+    }
+
+    return ResultCache::Key{this->owner, this->ParameterValues(), sourceName, inputHash, frameID};
+}
+
+
+/*
+ * ResultCacheClient::ParameterHash
+ */
+uint64_t ResultCacheClient::ParameterHash(void) const {
+    return std::hash<std::string>()(this->ParameterValues());
+}
+
+
+/*
+ * ResultCacheClient::ParameterValues
+ */
+std::string ResultCacheClient::ParameterValues(void) const {
+    std::string retval;
+    for (auto p : this->parameters) {
+        auto param = p->Param<param::AbstractParam>();
+        const auto value = (param != nullptr) ? param->ValueString() : std::string();
+        retval += std::to_string(value.size());
+        retval += ':';
+        retval += value;
+    }
+    return retval;
+}
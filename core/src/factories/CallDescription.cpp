@@ -6,6 +6,9 @@
 
 #include "mmcore/factories/CallDescription.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mmcore/Call.h"
 
 using namespace megamol::core;
@@ -16,6 +19,8 @@ using namespace megamol::core;
 Call* factories::CallDescription::describeCall(Call* call) const {
     if (call != nullptr) {
         call->funcMap = new unsigned int[this->FunctionCount()];
+        // functions the callee does not implement must fail instead of invoking an arbitrary callback
+        std::fill(call->funcMap, call->funcMap + this->FunctionCount(), std::numeric_limits<unsigned int>::max());
     }
     return call;
 }
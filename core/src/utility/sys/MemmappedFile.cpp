@@ -30,10 +30,18 @@ vislib::sys::MemmappedFile::MemmappedFile(void)
         , viewStart(0)
         , viewSize(SystemInformation::AllocationGranularity())
         , mappedData(NULL)
+        , fileMapping(NULL)
+        , fileMappingSize(0)
         , viewDirty(false)
         , mapping(INVALID_HANDLE_VALUE) {
 #else  /* _WIN32 */
-        : File(), viewStart(0), viewSize(SystemInformation::AllocationGranularity()), mappedData(NULL), viewDirty(false) {
+        : File()
+        , viewStart(0)
+        , viewSize(SystemInformation::AllocationGranularity())
+        , mappedData(NULL)
+        , fileMapping(NULL)
+        , fileMappingSize(0)
+        , viewDirty(false) {
 #endif /* _WIN32 */
 }
 
@@ -186,12 +194,42 @@ inline vislib::sys::File::FileSize vislib::sys::MemmappedFile::AlignPosition(vis
     return position;
 }
 
+/*
+ * vislib::sys::MemmappedFile::AdviseWillNeed
+ */
+void vislib::sys::MemmappedFile::AdviseWillNeed(File::FileSize offset, File::FileSize size) const {
+    if ((this->fileMapping == NULL) || (offset >= this->fileMappingSize) || (size <= 0)) {
+        return;
+    }
+    size = vislib::math::Min(size, this->fileMappingSize - offset);
+
+    // the range must start at a page boundary
+    File::FileSize pageSize = SystemInformation::PageSize();
+    File::FileSize start = offset - (offset % pageSize);
+    size += offset - start;
+
+#ifdef _WIN32
+#if (_WIN32_WINNT >= 0x0602)
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = this->fileMapping + start;
+    range.NumberOfBytes = static_cast<SIZE_T>(size);
+    // this is only a hint, so failure is not an error
+    ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+#endif /* (_WIN32_WINNT >= 0x0602) */
+#else  /* _WIN32 */
+    // this is only a hint, so failure is not an error
+    ::madvise(this->fileMapping + start, static_cast<size_t>(size), MADV_WILLNEED);
+#endif /* _WIN32 */
+}
+
+
 /*
  * vislib::sys::MemmappedFile::Close
  */
 void vislib::sys::MemmappedFile::Close(void) {
     this->Flush();
     this->SafeUnmapView();
+    this->UnmapFile();
 #ifdef _WIN32
     this->SafeCloseMapping();
 #endif /* _WIN32 */
@@ -271,6 +309,49 @@ vislib::sys::File::FileSize vislib::sys::MemmappedFile::SetViewSize(File::FileSi
 }
 
 
+/*
+ * vislib::sys::MemmappedFile::MapFile
+ */
+const char* vislib::sys::MemmappedFile::MapFile(void) {
+    if (this->fileMapping != NULL) {
+        return this->fileMapping;
+    }
+#ifdef _WIN32
+    if (this->handle == INVALID_HANDLE_VALUE) {
+#else  /* _WIN32 */
+    if (this->handle == -1) {
+#endif /* _WIN32 */
+        throw IllegalStateException("MapFile while file not open", __FILE__, __LINE__);
+    }
+    if (this->access == WRITE_ONLY) {
+        throw IllegalStateException("MapFile on write-only file", __FILE__, __LINE__);
+    }
+    if (this->endPos == 0) {
+        // mapping an empty file is not possible
+        return NULL;
+    }
+
+#ifdef _WIN32
+    if (this->mapping == INVALID_HANDLE_VALUE || this->mapping == NULL) {
+        throw IllegalStateException("MapFile while mapping invalid", __FILE__, __LINE__);
+    }
+    this->fileMapping = static_cast<char*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+    if (this->fileMapping == NULL) {
+        throw IOException(::GetLastError(), __FILE__, __LINE__);
+    }
+#else  /* _WIN32 */
+    void* ret = mmap(0, static_cast<size_t>(this->endPos), PROT_READ, MAP_SHARED, this->handle, 0);
+    if (ret == MAP_FAILED) {
+        throw IOException(::GetLastError(), __FILE__, __LINE__);
+    }
+    this->fileMapping = static_cast<char*>(ret);
+#endif /* _WIN32 */
+    this->fileMappingSize = this->endPos;
+
+    return this->fileMapping;
+}
+
+
 /*
  * vislib::sys::MemmappedFile::Open
  */
@@ -513,6 +594,24 @@ vislib::sys::File::FileSize vislib::sys::MemmappedFile::Tell(void) const {
 }
 
 
+/*
+ * vislib::sys::MemmappedFile::UnmapFile
+ */
+void vislib::sys::MemmappedFile::UnmapFile(void) {
+    if (this->fileMapping != NULL) {
+#ifdef _WIN32
+        if (!UnmapViewOfFile(this->fileMapping)) {
+#else  /* _WIN32 */
+        if (munmap(this->fileMapping, static_cast<size_t>(this->fileMappingSize)) == -1) {
+#endif /* _WIN32 */
+            throw IOException(::GetLastError(), __FILE__, __LINE__);
+        }
+        this->fileMapping = NULL;
+        this->fileMappingSize = 0;
+    }
+}
+
+
 /*
  * vislib::sys::MemmappedFile::Write
  */
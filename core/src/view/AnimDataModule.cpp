@@ -10,12 +10,12 @@
 #include "mmcore/utility/sys/Thread.h"
 #include "stdafx.h"
 #include "vislib/assert.h"
+#include <algorithm>
 #include <chrono>
+#include <climits>
 
 using namespace megamol::core;
 
-#define MM_ADM_COUNT_LOCKED_FRAMES
-
 
 /*
  * view::AnimDataModule::AnimDataModule
@@ -23,11 +23,20 @@ using namespace megamol::core;
 view::AnimDataModule::AnimDataModule(void)
         : Module()
         , frameCnt(0)
-        , loader(loaderFunction)
+        , loaders()
+        , loaderCnt(1)
+        , policy(std::make_shared<AdaptivePrefetchPolicy>())
         , frameCache(NULL)
+        , frameSlots()
         , cacheSize(0)
-        , stateLock()
-        , lastRequested(0) {
+        , wakeLock()
+        , loaderWakeup()
+        , frameLoaded() {
+    this->stateEpoch.store(0);
+    this->sleepingLoaders.store(0);
+    this->lastRequested.store(0);
+    this->cacheHits.store(0);
+    this->cacheMisses.store(0);
     this->isRunning.store(false);
 }
 
@@ -40,10 +49,7 @@ view::AnimDataModule::~AnimDataModule(void) {
 
     Frame** frames = this->frameCache;
     //    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -51,6 +57,7 @@ view::AnimDataModule::~AnimDataModule(void) {
         }
         delete[] frames;
     }
+    this->frameSlots.reset();
 }
 
 
@@ -58,7 +65,7 @@ view::AnimDataModule::~AnimDataModule(void) {
  * view::AnimDataModule::initframeCache
  */
 void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cacheSize > 0);
     ASSERT(this->frameCnt > 0);
 
@@ -73,6 +80,11 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
         delete[] this->frameCache;
     }
 
+    this->frameSlots.reset(new std::atomic<int>[this->frameCnt]);
+    for (unsigned int i = 0; i < this->frameCnt; i++) {
+        this->frameSlots[i].store(-1);
+    }
+
     this->cacheSize = cacheSize;
     this->frameCache = new Frame*[this->cacheSize];
     bool frameConstructionError = false;
@@ -80,23 +92,27 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
         this->frameCache[i] = this->constructFrame();
         ASSERT(&this->frameCache[i]->owner == this);
         if (this->frameCache[i] != NULL) {
-            this->frameCache[i]->state = Frame::STATE_INVALID;
+            this->frameCache[i]->lockCnt.store(Frame::LOCK_INVALID);
         } else {
             frameConstructionError = true;
         }
     }
 
     if (!frameConstructionError) {
-        this->frameCache[0]->state = Frame::STATE_LOADING;
+        this->frameCache[0]->lockCnt.store(Frame::LOCK_LOADING);
         this->loadFrame(this->frameCache[0], 0); // load first frame directly.
-        this->frameCache[0]->state = Frame::STATE_AVAILABLE;
-        this->lastRequested = 0;
+        this->frameCache[0]->cachedIdx.store(0);
+        this->frameSlots[0].store(0);
+        this->frameCache[0]->lockCnt.store(0);
+        this->lastRequested.store(0);
+        this->stateEpoch.store(0);
+        this->policy->Reset();
+        this->ResetCacheStatistics();
 
         this->isRunning.store(true);
-        this->loader.Start(this);
-        // XXX Is there a race condition that requires higher sleep time (value originally was 250)?
-        // XXX Reduced for faster module creation, because called in ctor.
-        vislib::sys::Thread::Sleep(10);
+        for (unsigned int i = 0; i < this->loaderCnt; i++) {
+            this->loaders.emplace_back(&AnimDataModule::loaderFunction, this);
+        }
     } else {
         megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_ERROR,
             "Unable to create frame data cache ('constructFrame' returned 'NULL').");
@@ -108,30 +124,24 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
  * view::AnimDataModule::requestFrame
  */
 view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned int idx) {
-    Frame* retval = NULL;
-    int dist, minDist = this->frameCnt;
+    Frame* retval = this->findAndLockFrame(idx);
     static bool deadlockwarning = true;
 
-    this->stateLock.Lock();
-    this->lastRequested = idx; // TODO: choose better caching strategy!!!
-    for (unsigned int i = 0; i < this->cacheSize; i++) {
-        if ((this->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
-            (this->frameCache[i]->state == Frame::STATE_INUSE)) {
-            // note: do not wrap distance around!
-            dist = labs(this->frameCache[i]->frame - idx);
-            if (dist == 0) {
-                retval = this->frameCache[i];
-                break;
-            } else if (dist < minDist) {
-                retval = this->frameCache[i];
-                minDist = dist;
-            }
+    // the lock-free lookup fails under contention or while no frame has been
+    // loaded yet, so wait for the loader threads instead of answering NULL
+    while ((retval == NULL) && this->frameSlots && this->isRunning.load()) {
+        {
+            std::unique_lock<std::mutex> guard(this->wakeLock);
+            this->frameLoaded.wait_for(guard, std::chrono::milliseconds(10));
         }
+        retval = this->findAndLockFrame(idx);
     }
-    if (retval != NULL) {
-        retval->state = Frame::STATE_INUSE;
+
+    if ((retval != NULL) && (retval->cachedIdx.load() == idx)) {
+        this->cacheHits++;
+    } else {
+        this->cacheMisses++;
     }
-    this->stateLock.Unlock();
 
     if (deadlockwarning
 #if !(defined(DEBUG) || defined(_DEBUG))
@@ -141,7 +151,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
     ) {
         unsigned int clcf = 0;
         for (unsigned int i = 0; i < this->cacheSize; i++) {
-            if (this->frameCache[i]->state == Frame::STATE_INUSE) {
+            if (this->frameCache[i]->IsLocked()) {
                 clcf++;
             }
         }
@@ -164,25 +174,44 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
  */
 view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned int idx, bool forceIdx) {
     Frame* f = this->requestLockedFrame(idx);
-    if ((f->FrameNumber() == idx) || (!forceIdx))
+    if (((f != NULL) && (f->FrameNumber() == idx)) || (!forceIdx))
         return f;
-    // wrong frame number and frame is forced
+    // wrong frame number or no frame (contention) and frame is forced
 
     // clamp idx
     if (idx >= this->frameCnt) {
+        if (this->frameCnt == 0) {
+            if (f != NULL) {
+                f->Unlock();
+            }
+            return NULL;
+        }
         idx = this->frameCnt - 1;
-        f->Unlock();
-        f = this->requestLockedFrame(idx);
+        if (f != NULL) {
+            f->Unlock();
+        }
+        f = this->findAndLockFrame(idx);
     }
 
     // wait for the new frame
-    while (idx != f->FrameNumber()) {
-        f->Unlock();
+    while ((f == NULL) || (idx != f->FrameNumber())) {
+        if (f != NULL) {
+            f->Unlock();
+        }
+        if (!this->frameSlots) {
+            // the cache has been reset, the frame will never be loaded
+            return NULL;
+        }
 
         // HAZARD: This will wait for all eternity if the requested frame is never loaded
 
-        vislib::sys::Thread::Sleep(100); // time for the loader thread to load
-        f = this->requestLockedFrame(idx);
+        {
+            // time for the loader threads to load
+            std::unique_lock<std::mutex> guard(this->wakeLock);
+            this->frameLoaded.wait_for(guard, std::chrono::milliseconds(100),
+                [this, idx]() { return !this->isRunning.load() || this->isFrameAvailable(idx); });
+        }
+        f = this->findAndLockFrame(idx);
     }
 
     return f;
@@ -195,10 +224,7 @@ view::AnimDataModule::Frame* view::AnimDataModule::requestLockedFrame(unsigned i
 void view::AnimDataModule::resetFrameCache(void) {
     Frame** frames = this->frameCache;
     //    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -206,9 +232,11 @@ void view::AnimDataModule::resetFrameCache(void) {
         }
         delete[] frames;
     }
+    this->frameSlots.reset();
     this->frameCnt = 0;
     this->cacheSize = 0;
-    this->lastRequested = 0;
+    this->lastRequested.store(0);
+    this->policy->Reset();
 }
 
 
@@ -216,24 +244,44 @@ void view::AnimDataModule::resetFrameCache(void) {
  * view::AnimDataModule::setFrameCount
  */
 void view::AnimDataModule::setFrameCount(unsigned int cnt) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cnt > 0);
     this->frameCnt = cnt;
 }
 
 
+/*
+ * view::AnimDataModule::setLoaderThreadCount
+ */
+void view::AnimDataModule::setLoaderThreadCount(unsigned int cnt) {
+    ASSERT(this->loaders.empty());
+    this->loaderCnt = std::max(1u, cnt);
+}
+
+
+/*
+ * view::AnimDataModule::setPrefetchPolicy
+ */
+void view::AnimDataModule::setPrefetchPolicy(std::shared_ptr<FramePrefetchPolicy> policy) {
+    ASSERT(this->loaders.empty());
+    ASSERT(policy != nullptr);
+    this->policy = policy;
+}
+
+
 /*
  * view::AnimDataModule::loaderFunction
  */
 DWORD view::AnimDataModule::loaderFunction(void* userData) {
     AnimDataModule* This = static_cast<AnimDataModule*>(userData);
     ASSERT(This != NULL);
-    unsigned int index, i, j, req;
-#ifdef _LOADING_REPORTING
-    unsigned int l;
-#endif /* _LOADING_REPORTING */
+    unsigned int index, i, epoch, rank, slot, cachedCnt;
+    int victimCnt;
     Frame* frame;
     vislib::StringA fullName(This->FullName());
+    std::vector<unsigned int> wanted;
+    // the rank of every frame in 'wanted', UINT_MAX for frames not wanted
+    std::vector<unsigned int> wantedRank;
 
     std::chrono::high_resolution_clock::duration accumDuration = std::chrono::seconds(0);
     unsigned int accumCount = 0;
@@ -241,129 +289,141 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
     const std::chrono::system_clock::duration lastReportDistance = std::chrono::seconds(3);
 
     while (This->isRunning.load()) {
-        // sleep to enforce thread changes
-        vislib::sys::Thread::Sleep(1);
-        if (!This->isRunning.load())
-            break;
-
         // idea:
         //  1. search for the most important frame to be loaded.
         //  2. search for the best cached frame to be overwritten.
-        //  3. load the frame
+        //  3. claim the frame and load it
+        //  If there is nothing to do, sleep until a request or a frame
+        //  state changes.
 
         // 1.
-        // Note: we do not need to lock here, because we won't change the frame
-        // state now, and the different states that can be set outside this
-        // thread are aquivalent for us.
-        index = req = This->lastRequested;
-        for (j = 0; j < This->cacheSize; j++) {
-            for (i = 0; i < This->cacheSize; i++) {
-                if (!This->isRunning.load())
-                    break;
-                if (((This->frameCache[i]->state == Frame::STATE_AVAILABLE) ||
-                        (This->frameCache[i]->state == Frame::STATE_INUSE)) &&
-                    (This->frameCache[i]->frame == index)) {
-                    break;
-                }
-            }
-            if (!This->isRunning.load())
-                break;
-            if (i >= This->cacheSize) {
-                break;
+        // Note: the epoch is read before asking the policy, such that requests
+        // arriving in between will not be missed when going to sleep below.
+        epoch = This->stateEpoch.load();
+        if (wantedRank.size() != This->frameCnt) {
+            wantedRank.assign(This->frameCnt, UINT_MAX);
+        } else {
+            for (i = 0; i < wanted.size(); i++) {
+                wantedRank[wanted[i]] = UINT_MAX;
             }
-            index = (index + 1) % This->frameCnt;
+        }
+        This->policy->Predict(This->frameCnt, This->cacheSize, wanted);
+        for (i = 0; i < wanted.size(); i++) {
+            wantedRank[wanted[i]] = i;
         }
         if (!This->isRunning.load())
             break;
-        if (j >= This->cacheSize) {
-            if (j >= This->frameCnt) {
-                ASSERT(This->frameCnt == This->cacheSize);
-                megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO,
-                    "All frames of the dataset loaded into cache. Terminating loading Thread.");
+
+        // Note: frames being loaded by other loader threads count as cached.
+        cachedCnt = 0;
+        for (i = 0; i < This->cacheSize; i++) {
+            if (This->frameCache[i]->lockCnt.load() != Frame::LOCK_INVALID) {
+                cachedCnt++;
+            }
+        }
+        if (cachedCnt >= This->frameCnt) {
+            ASSERT(This->frameCnt == This->cacheSize);
+            megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO,
+                "All frames of the dataset loaded into cache. Terminating loading Thread.");
+            break;
+        }
+        for (rank = 0; rank < wanted.size(); rank++) {
+            if (This->frameSlots[wanted[rank]].load() < 0) {
                 break;
             }
-            continue;
         }
 
         // 2.
-        // Note: We now need to lock, because we must synchronise against
-        // frames changing from 'STATE_AVAILABLE' to 'STATE_INUSE'.
-        This->stateLock.Lock();
-        // core idea: search for the frame with the largest distance to the requested frame
+        // core idea: overwrite the unused cached frame least important to the policy
         frame = NULL; // the frame to be overwritten
-        j = 0;        // the distance to the found frame to be overwritten
-        for (i = 0; i < This->cacheSize; i++) {
-            if (This->frameCache[i]->state == Frame::STATE_INVALID) {
-                frame = This->frameCache[i];
-                // j = UINT_MAX; // not required, since we instantly leave the loop
-#ifdef _LOADING_REPORTING
-                l = i;
-#endif /* _LOADING_REPORTING */
-                break;
-            } else if (This->frameCache[i]->state == Frame::STATE_AVAILABLE) {
-                // distance to the frame[i];
-                long ld = static_cast<long>(This->frameCache[i]->frame) - static_cast<long>(req);
-                if (ld < 0) {
-                    if (ld < (static_cast<long>(This->frameCnt)) / 10) {
-                        ld += static_cast<long>(This->frameCnt);
-                        if (ld < 0)
-                            ld = 0; // should never happen
-                    } else {
-                        ld = -10 * ld;
-                    }
-                }
-
-                if (j < static_cast<unsigned int>(ld)) {
+        slot = 0;
+        victimCnt = Frame::LOCK_INVALID;
+        index = 0;
+        if (rank < wanted.size()) {
+            index = wanted[rank];
+            unsigned int worst = rank; // the importance of the found frame
+            for (i = 0; i < This->cacheSize; i++) {
+                int cnt = This->frameCache[i]->lockCnt.load();
+                if (cnt == Frame::LOCK_INVALID) {
                     frame = This->frameCache[i];
-                    j = static_cast<unsigned int>(ld);
-#ifdef _LOADING_REPORTING
-                    l = i;
-#endif /* _LOADING_REPORTING */
+                    slot = i;
+                    victimCnt = cnt;
+                    break;
+                } else if (cnt == 0) {
+                    unsigned int ci = This->frameCache[i]->cachedIdx.load();
+                    unsigned int fr = (ci < wantedRank.size()) ? wantedRank[ci] : UINT_MAX;
+                    if (fr > worst) {
+                        frame = This->frameCache[i];
+                        slot = i;
+                        victimCnt = cnt;
+                        worst = fr;
+                    }
                 }
             }
-            if (!This->isRunning.load())
-                break;
+        }
+
+        if (frame == NULL) {
+            // Either all wanted frames are cached, or no suitable cache buffer
+            // was found for loading. The latter is mostly the case if the
+            // cache is too small or if the data source locks too much frames.
+            std::unique_lock<std::mutex> guard(This->wakeLock);
+            This->sleepingLoaders++;
+            This->loaderWakeup.wait(
+                guard, [This, epoch]() { return !This->isRunning.load() || (This->stateEpoch.load() != epoch); });
+            This->sleepingLoaders--;
+            continue;
         }
 
         // 3.
-        if (frame != NULL) {
-            frame->state = Frame::STATE_LOADING;
+        // Note: users may lock the victim and other loader threads may claim
+        // the wanted frame concurrently. In both cases we simply start over.
+        if (!frame->lockCnt.compare_exchange_strong(victimCnt, Frame::LOCK_LOADING)) {
+            continue;
         }
-        // if frame is NULL no suitable cache buffer found for loading. This is
-        // mostly the case if the cache is too small or if the data source
-        // locks too much frames.
-        This->stateLock.Unlock();
+        int freeSlot = -1;
+        if (!This->frameSlots[index].compare_exchange_strong(freeSlot, static_cast<int>(slot))) {
+            frame->lockCnt.store(victimCnt);
+            continue;
+        }
+        if (victimCnt != Frame::LOCK_INVALID) {
+            int victimSlot = static_cast<int>(slot);
+            This->frameSlots[frame->cachedIdx.load()].compare_exchange_strong(victimSlot, -1);
+        }
+        frame->cachedIdx.store(index);
+        frame->frame = index;
 
-        if ((frame != NULL) && This->isRunning.load()) {
 #ifdef _LOADING_REPORTING
-            printf("Loading frame %i into cache %i\n", index, l);
+        printf("Loading frame %i into cache %i\n", index, slot);
 #endif /* _LOADING_REPORTING */
 
-            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-            This->loadFrame(frame, index);
+        This->loadFrame(frame, index);
 
-            std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
-            accumDuration += duration;
-            accumCount++;
+        std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
+        accumDuration += duration;
+        accumCount++;
 
-            std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
-            if ((reportTime - lastReportTime) > lastReportDistance) {
-                lastReportTime = reportTime;
-                if (accumCount > 0) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo(100, "[%s] Loading speed: %f ms/f (%u)",
-                        fullName.PeekBuffer(),
-                        1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() /
-                            static_cast<double>(accumCount),
-                        static_cast<unsigned int>(accumCount));
-                }
+        std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
+        if ((reportTime - lastReportTime) > lastReportDistance) {
+            lastReportTime = reportTime;
+            if (accumCount > 0) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(100,
+                    "[%s] Loading speed: %f ms/f (%u), cache hits: %llu, misses: %llu", fullName.PeekBuffer(),
+                    1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() /
+                        static_cast<double>(accumCount),
+                    static_cast<unsigned int>(accumCount), static_cast<unsigned long long>(This->CacheHits()),
+                    static_cast<unsigned long long>(This->CacheMisses()));
             }
+        }
 
-            // we no not need to lock here, because this transition from
-            // 'STATE_LOADING' to 'STATE_AVAILABLE' is safe for the using
-            // thread.
-            frame->state = Frame::STATE_AVAILABLE;
+        // publishing the frame makes it lockable for users
+        frame->lockCnt.store(0);
+        This->stateEpoch++;
+        {
+            std::lock_guard<std::mutex> guard(This->wakeLock);
         }
+        This->frameLoaded.notify_all();
     }
 
     if (accumCount > 0) {
@@ -379,13 +439,138 @@ DWORD view::AnimDataModule::loaderFunction(void* userData) {
 }
 
 
+/*
+ * view::AnimDataModule::findAndLockFrame
+ */
+view::AnimDataModule::Frame* view::AnimDataModule::findAndLockFrame(unsigned int idx) {
+    if (this->lastRequested.exchange(idx) != idx) {
+        this->policy->Request(idx, this->frameCnt);
+        this->wakeLoaders();
+    }
+    if (!this->frameSlots) {
+        return NULL;
+    }
+
+    // fast path: the requested frame is cached
+    if (idx < this->frameCnt) {
+        int slot = this->frameSlots[idx].load();
+        if ((slot >= 0) && tryLock(this->frameCache[slot], idx)) {
+            return this->frameCache[slot];
+        }
+    }
+
+    // otherwise answer the closest frame available
+    // note: do not wrap distance around!
+    for (unsigned int attempt = 0; attempt < 3; attempt++) {
+        Frame* retval = NULL;
+        unsigned int retvalIdx = 0;
+        unsigned int minDist = UINT_MAX;
+        for (unsigned int i = 0; i < this->cacheSize; i++) {
+            if (this->frameCache[i]->lockCnt.load() >= 0) {
+                unsigned int fi = this->frameCache[i]->cachedIdx.load();
+                unsigned int dist = (fi > idx) ? (fi - idx) : (idx - fi);
+                if (dist < minDist) {
+                    retval = this->frameCache[i];
+                    retvalIdx = fi;
+                    minDist = dist;
+                }
+            }
+        }
+        if (retval == NULL) {
+            return NULL;
+        }
+        if (tryLock(retval, retvalIdx)) {
+            return retval;
+        }
+        // the frame has been reused in the meantime
+    }
+
+    return NULL;
+}
+
+
+/*
+ * view::AnimDataModule::isFrameAvailable
+ */
+bool view::AnimDataModule::isFrameAvailable(unsigned int idx) const {
+    if (!this->frameSlots || (idx >= this->frameCnt)) {
+        return false;
+    }
+    int slot = this->frameSlots[idx].load();
+    return (slot >= 0) && (this->frameCache[slot]->lockCnt.load() >= 0) &&
+           (this->frameCache[slot]->cachedIdx.load() == idx);
+}
+
+
+/*
+ * view::AnimDataModule::stopLoaders
+ */
+void view::AnimDataModule::stopLoaders(void) {
+    this->isRunning.store(false);
+    {
+        std::lock_guard<std::mutex> guard(this->wakeLock);
+    }
+    this->loaderWakeup.notify_all();
+    this->frameLoaded.notify_all();
+    for (auto& l : this->loaders) {
+        if (l.joinable()) {
+            l.join();
+        }
+    }
+    this->loaders.clear();
+}
+
+
+/*
+ * view::AnimDataModule::tryLock
+ */
+bool view::AnimDataModule::tryLock(Frame* frame, unsigned int idx) {
+    int cnt = frame->lockCnt.load();
+    while (cnt >= 0) {
+        if (frame->lockCnt.compare_exchange_weak(cnt, cnt + 1)) {
+            if (frame->cachedIdx.load() == idx) {
+                return true;
+            }
+            // the frame has been reloaded with a different index before we got it
+            frame->owner.unlock(frame);
+            return false;
+        }
+    }
+    return false;
+}
+
+
 /*
  * view::AnimDataModule::unlock
  */
 void view::AnimDataModule::unlock(view::AnimDataModule::Frame* frame) {
     ASSERT(&frame->owner == this);
-    ASSERT(frame->state == Frame::STATE_INUSE);
-    this->stateLock.Lock();
-    frame->state = Frame::STATE_AVAILABLE;
-    this->stateLock.Unlock();
+    int cnt = frame->lockCnt.load();
+    ASSERT(cnt > 0);
+    while (cnt > 0) {
+        if (frame->lockCnt.compare_exchange_weak(cnt, cnt - 1)) {
+            if (cnt == 1) {
+                // the frame became available for overwriting
+                this->wakeLoaders();
+            }
+            return;
+        }
+    }
+}
+
+
+/*
+ * view::AnimDataModule::wakeLoaders
+ */
+void view::AnimDataModule::wakeLoaders(void) {
+    this->stateEpoch++;
+    // Note: the mutex is only touched if a loader sleeps. Since both counters
+    // are sequentially consistent, either we see the sleeping loader here or
+    // the loader sees the new epoch before going to sleep.
+    if (this->sleepingLoaders.load() > 0) {
+        {
+            std::lock_guard<std::mutex> guard(this->wakeLock);
+        }
+        this->loaderWakeup.notify_all();
+    }
 }
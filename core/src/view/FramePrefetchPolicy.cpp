@@ -0,0 +1,213 @@
+/*
+ * FramePrefetchPolicy.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "mmcore/view/FramePrefetchPolicy.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace megamol::core;
+
+
+/*
+ * view::FramePrefetchPolicy::FramePrefetchPolicy
+ */
+view::FramePrefetchPolicy::FramePrefetchPolicy(void) {
+    // intentionally empty
+}
+
+
+/*
+ * view::FramePrefetchPolicy::~FramePrefetchPolicy
+ */
+view::FramePrefetchPolicy::~FramePrefetchPolicy(void) {
+    // intentionally empty
+}
+
+/*****************************************************************************/
+
+
+/*
+ * view::LinearPrefetchPolicy::LinearPrefetchPolicy
+ */
+view::LinearPrefetchPolicy::LinearPrefetchPolicy(void) : FramePrefetchPolicy(), lastRequested(0), lock() {
+    // intentionally empty
+}
+
+
+/*
+ * view::LinearPrefetchPolicy::~LinearPrefetchPolicy
+ */
+view::LinearPrefetchPolicy::~LinearPrefetchPolicy(void) {
+    // intentionally empty
+}
+
+
+/*
+ * view::LinearPrefetchPolicy::Predict
+ */
+void view::LinearPrefetchPolicy::Predict(
+    unsigned int frameCnt, unsigned int count, std::vector<unsigned int>& outFrames) const {
+    outFrames.clear();
+    if ((frameCnt == 0) || (count == 0)) {
+        return;
+    }
+    unsigned int idx;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        idx = this->lastRequested;
+    }
+    count = std::min(count, frameCnt);
+    outFrames.reserve(count);
+    for (unsigned int i = 0; i < count; i++) {
+        outFrames.push_back((idx + i) % frameCnt);
+    }
+}
+
+
+/*
+ * view::LinearPrefetchPolicy::Request
+ */
+void view::LinearPrefetchPolicy::Request(unsigned int idx, unsigned int frameCnt) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->lastRequested = (frameCnt > 0) ? std::min(idx, frameCnt - 1) : 0;
+}
+
+
+/*
+ * view::LinearPrefetchPolicy::Reset
+ */
+void view::LinearPrefetchPolicy::Reset(void) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->lastRequested = 0;
+}
+
+/*****************************************************************************/
+
+
+/*
+ * view::AdaptivePrefetchPolicy::AdaptivePrefetchPolicy
+ */
+view::AdaptivePrefetchPolicy::AdaptivePrefetchPolicy(unsigned int maxStride)
+        : FramePrefetchPolicy()
+        , maxStride(std::max(1, static_cast<int>(maxStride)))
+        , lastRequested(0)
+        , stride(1)
+        , pingPong(false)
+        , lock()
+        , predicted()
+        , predictLock() {
+    // intentionally empty
+}
+
+
+/*
+ * view::AdaptivePrefetchPolicy::~AdaptivePrefetchPolicy
+ */
+view::AdaptivePrefetchPolicy::~AdaptivePrefetchPolicy(void) {
+    // intentionally empty
+}
+
+
+/*
+ * view::AdaptivePrefetchPolicy::Predict
+ */
+void view::AdaptivePrefetchPolicy::Predict(
+    unsigned int frameCnt, unsigned int count, std::vector<unsigned int>& outFrames) const {
+    outFrames.clear();
+    if ((frameCnt == 0) || (count == 0)) {
+        return;
+    }
+    long cur;
+    long step;
+    bool reflect;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        cur = static_cast<long>(std::min(this->lastRequested, frameCnt - 1));
+        step = this->stride;
+        reflect = this->pingPong;
+    }
+    const long n = static_cast<long>(frameCnt);
+    count = std::min(count, frameCnt);
+    outFrames.reserve(count);
+
+    std::lock_guard<std::mutex> guard(this->predictLock);
+    if (this->predicted.size() < frameCnt) {
+        this->predicted.resize(frameCnt, false);
+    }
+    auto& predicted = this->predicted;
+    outFrames.push_back(static_cast<unsigned int>(cur));
+    predicted[cur] = true;
+
+    // a stride > 1 may revisit frames, so limit the number of steps
+    for (long i = 0; (i < 2 * n) && (outFrames.size() < count); i++) {
+        long next = cur + step;
+        if ((next < 0) || (next >= n)) {
+            if (reflect) {
+                step = -step;
+                next = std::max(0l, std::min(n - 1, cur + step));
+            } else {
+                next = ((next % n) + n) % n;
+            }
+        }
+        cur = next;
+        if (!predicted[cur]) {
+            outFrames.push_back(static_cast<unsigned int>(cur));
+            predicted[cur] = true;
+        }
+    }
+
+    for (auto f : outFrames) {
+        predicted[f] = false;
+    }
+}
+
+
+/*
+ * view::AdaptivePrefetchPolicy::Request
+ */
+void view::AdaptivePrefetchPolicy::Request(unsigned int idx, unsigned int frameCnt) {
+    if (frameCnt == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(this->lock);
+    const long n = static_cast<long>(frameCnt);
+    const long last = static_cast<long>(this->lastRequested);
+    const long delta = static_cast<long>(std::min(idx, frameCnt - 1)) - last;
+    if (delta == 0) {
+        return;
+    }
+    const long wrapped = (delta > 0) ? (delta - n) : (delta + n);
+
+    if (std::labs(delta) <= this->maxStride) {
+        if ((delta > 0) != (this->stride > 0)) {
+            // reversing close to either end of the dataset means ping-pong,
+            // reversing somewhere in between is manual stepping
+            this->pingPong = (last < this->maxStride) || (last >= n - this->maxStride);
+        }
+        this->stride = static_cast<int>(delta);
+    } else if (std::labs(wrapped) <= this->maxStride) {
+        // wrapped around at the end of the dataset: looping playback
+        this->stride = static_cast<int>(wrapped);
+        this->pingPong = false;
+    }
+    // larger jumps (scrubbing) keep the detected stride
+
+    this->lastRequested = static_cast<unsigned int>(last + delta);
+}
+
+
+/*
+ * view::AdaptivePrefetchPolicy::Reset
+ */
+void view::AdaptivePrefetchPolicy::Reset(void) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->lastRequested = 0;
+    this->stride = 1;
+    this->pingPong = false;
+}
@@ -144,6 +144,10 @@ protected:
     std::unique_ptr<glowl::GLSLProgram> compressGPUFlagsProgram;
     std::shared_ptr<core_gl::FlagCollection_GL> theGLData;
     bool gpu_stale = true;
+
+    /** Ranges written on the CPU that still have to be uploaded, only valid if not gpu_pending_all */
+    core::FlagStorageBitmap::range_vector gpu_pending;
+    bool gpu_pending_all = true;
 };
 
 class FlagCollection_GL {
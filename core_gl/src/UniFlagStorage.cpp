@@ -123,10 +123,16 @@ bool UniFlagStorage::writeCPUDataCallback(core::Call& caller) {
 
     if (fc->version() > this->version) {
         // all but the GPU stuff happens in parent
-        //this->theCPUData = fc->getData();
-        //this->version = fc->version();
         gpu_stale = true;
-        //serializeCPUData();
+        if (!core::FlagStorage::writeCPUDataCallback(caller))
+            return false;
+        // the parent knows which ranges the write touched, only these need to be uploaded
+        if (lastChanges.empty()) {
+            gpu_pending_all = true;
+        } else {
+            gpu_pending.insert(gpu_pending.end(), lastChanges.begin(), lastChanges.end());
+        }
+        return true;
     }
     return core::FlagStorage::writeCPUDataCallback(caller);
 }
@@ -148,16 +154,32 @@ bool UniFlagStorage::onJSONChanged(core::param::ParamSlot& slot) {
     }
     deserializeCPUData();
     gpu_stale = true;
+    gpu_pending_all = true;
     return true;
 }
 
 void UniFlagStorage::CPU2GLCopy() {
-    theGLData->validateFlagCount(theCPUData->flags->size());
-    theGLData->flags->bufferSubData(*(theCPUData->flags));
+    auto const& cdata = *theCPUData->flags;
+    auto const item_size = sizeof(core::FlagStorageTypes::flag_item_type);
+    if (gpu_pending_all || theGLData->flags->getByteSize() != cdata.size() * item_size) {
+        theGLData->validateFlagCount(cdata.size());
+        theGLData->flags->bufferSubData(cdata);
+    } else {
+        for (auto const& r : gpu_pending) {
+            if (r.first < 0 || r.second < r.first || static_cast<size_t>(r.second) >= cdata.size())
+                continue;
+            theGLData->flags->bufferSubData(
+                cdata.data() + r.first, (r.second - r.first + 1) * item_size, r.first * item_size);
+        }
+    }
+    gpu_pending.clear();
+    gpu_pending_all = false;
 }
 
 void UniFlagStorage::GL2CPUCopy() {
     auto const num = theGLData->flags->getByteSize() / sizeof(core::FlagStorageTypes::flag_item_type);
     theCPUData->validateFlagCount(num);
     glGetNamedBufferSubData(theGLData->flags->getName(), 0, theGLData->flags->getByteSize(), theCPUData->flags->data());
+    // everything was overwritten, ranges marked before are meaningless now
+    theCPUData->clearChanged();
 }
@@ -112,6 +112,7 @@ static std::string guiscale_option = "guiscale";
 static std::string privacynote_option = "privacynote";
 static std::string versionnote_option = "versionnote";
 static std::string profile_log_option = "profiling-log";
+static std::string profile_trace_option = "profiling-trace";
 static std::string param_option = "param";
 static std::string remote_head_option = "headnode";
 static std::string remote_render_option = "rendernode";
@@ -172,6 +173,11 @@ static void profile_log_handler(
     config.profiling_output_file = parsed_options[option_name].as<std::string>();
 }
 
+static void profile_trace_handler(
+    std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
+    config.profiling_trace_file = parsed_options[option_name].as<std::string>();
+}
+
 static void remote_head_handler(
     std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config) {
     config.remote_headnode = parsed_options[option_name].as<bool>();
@@ -548,7 +554,9 @@ std::vector<OptionsListEntry> cli_options_list =
 #ifdef PROFILING
         ,
         {profile_log_option, "Enable performance counters and set output to file", cxxopts::value<std::string>(),
-            profile_log_handler}
+            profile_log_handler},
+        {profile_trace_option, "Record every call into a Chrome trace / Perfetto JSON file",
+            cxxopts::value<std::string>(), profile_trace_handler}
 #endif
         ,
         {param_option, "Set MegaMol Graph parameter to value: --param param=value",
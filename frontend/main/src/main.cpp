@@ -166,6 +166,7 @@ int main(const int argc, const char** argv) {
     megamol::frontend::Profiling_Service profiling_service;
     megamol::frontend::Profiling_Service::Config profiling_config;
     profiling_config.log_file = config.profiling_output_file;
+    profiling_config.trace_file = config.profiling_trace_file;
 #endif
 #ifdef MM_CUDA_ENABLED
     megamol::frontend::CUDA_Service cuda_service;
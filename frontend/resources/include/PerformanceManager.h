@@ -10,6 +10,8 @@
 #include <utility>
 #include <vector>
 
+#include "TraceRecorder.h"
+
 namespace megamol {
 namespace core {
 class Call;
@@ -216,11 +218,19 @@ public:
     void start_timer(handle_type h, frame_type frame);
     void stop_timer(handle_type h);
 
+    // records every CPU timer region into a Chrome trace / Perfetto JSON file until stop_trace is called
+    bool start_trace(const std::string& file_name);
+    void stop_trace();
+
 private:
     friend class frontend::Profiling_Service;
 
     handle_type add_timer(std::unique_ptr<Itimer> t);
 
+    void describe_for_trace(const Itimer& t);
+
+    void flush_trace();
+
     void startFrame() {
         gl_timer::last_query = 0;
     }
@@ -232,6 +242,8 @@ private:
     std::unordered_map<handle_type, std::unique_ptr<Itimer>> timers;
     frame_type current_frame = 0;
     std::vector<update_callback> subscribers;
+    // only exists while tracing, so the timers pay a single branch otherwise
+    std::unique_ptr<TraceRecorder> tracer;
 };
 
 } // namespace frontend_resources
@@ -76,6 +76,7 @@ struct RuntimeConfig {
     bool screenshot_show_privacy_note = true;
     bool show_version_note = true;
     std::string profiling_output_file;
+    std::string profiling_trace_file;
 
     struct Tile {
         UintPair global_framebuffer_resolution; // e.g. whole powerwall resolution, needed for tiling
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace megamol {
+namespace frontend_resources {
+
+// Records the begin and end of timed regions into a lock-free ring buffer and streams them to a file
+// in the Chrome trace event format, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+// The nesting of regions (caller -> callee -> callback) follows from the order of the events per thread.
+class TraceRecorder {
+public:
+    using handle_type = uint32_t;
+    using frame_type = uint32_t;
+    using argument_list = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr std::size_t default_capacity = 1 << 16;
+
+    explicit TraceRecorder(std::size_t capacity = default_capacity);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    // starts a new trace file, events are recorded from now on
+    bool open(const std::string& file_name);
+
+    // flushes the remaining events and finishes the trace file
+    void close();
+
+    [[nodiscard]] bool is_open() const {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    // names a region for the events written by subsequent flushes, must not be called concurrently to flush()
+    void describe(handle_type h, std::string name, std::string category, argument_list args = {});
+
+    // begin() and end() can be called concurrently from any thread
+    void begin(handle_type h, frame_type frame);
+    void end(handle_type h, frame_type frame);
+
+    // writes all recorded events to the file, only one thread may flush at a time
+    void flush();
+
+    // answers the number of events lost because the ring buffer was full, resets the count
+    uint64_t take_dropped_count() {
+        return dropped_events.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    enum class event_type : uint8_t { BEGIN, END };
+
+    struct event {
+        handle_type handle = 0;
+        frame_type frame = 0;
+        uint32_t thread = 0;
+        uint32_t depth = 0;
+        event_type type = event_type::BEGIN;
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    struct cell {
+        std::atomic<uint64_t> sequence;
+        event e;
+    };
+
+    struct region {
+        std::string name;
+        std::string category;
+        std::string args;
+    };
+
+    void push(const event& e);
+
+    void write(const event& e);
+
+    static uint32_t thread_index();
+
+    static std::string escape(const std::string& str);
+
+    std::unique_ptr<cell[]> cells;
+    uint64_t mask = 0;
+    alignas(64) std::atomic<uint64_t> enqueue_pos{0};
+    alignas(64) uint64_t dequeue_pos = 0;
+    std::atomic<uint64_t> dropped_events{0};
+    std::atomic<bool> recording{false};
+
+    std::unordered_map<handle_type, region> regions;
+    std::chrono::steady_clock::time_point origin;
+    std::ofstream out;
+};
+
+} // namespace frontend_resources
+} // namespace megamol
@@ -149,6 +149,8 @@ PerformanceManager::handle_vector PerformanceManager::add_timers(megamol::core::
 }
 
 void PerformanceManager::remove_timers(handle_vector handles) {
+    // the handles are recycled, so the events recorded for them need to be written first
+    flush_trace();
     for (auto handle : handles) {
         timers.erase(handle);
     }
@@ -212,11 +214,79 @@ void PerformanceManager::subscribe_to_updates(update_callback cb) {
 
 void PerformanceManager::start_timer(handle_type h, frame_type frame) {
     current_frame = frame;
-    timers[h]->start(frame);
+    auto& t = timers[h];
+    t->start(frame);
+    if (tracer && t->get_conf().api == query_api::CPU) {
+        tracer->begin(h, frame);
+    }
 }
 
 void PerformanceManager::stop_timer(handle_type h) {
-    timers[h]->end();
+    auto& t = timers[h];
+    if (tracer && t->get_conf().api == query_api::CPU) {
+        tracer->end(h, t->get_start_frame());
+    }
+    t->end();
+}
+
+bool PerformanceManager::start_trace(const std::string& file_name) {
+    auto t = std::make_unique<TraceRecorder>();
+    if (!t->open(file_name)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "PerformanceManager: cannot open trace file %s", file_name.c_str());
+        return false;
+    }
+    stop_trace();
+    tracer = std::move(t);
+    for (auto& [key, timer] : timers) {
+        describe_for_trace(*timer);
+    }
+    return true;
+}
+
+void PerformanceManager::stop_trace() {
+    if (tracer) {
+        flush_trace();
+        tracer->close();
+        tracer.reset();
+    }
+}
+
+void PerformanceManager::describe_for_trace(const Itimer& t) {
+    const auto& conf = t.get_conf();
+    if (conf.api != query_api::CPU) {
+        return;
+    }
+    switch (conf.parent_type) {
+    case parent_type::CALL: {
+        const auto c = static_cast<megamol::core::Call*>(conf.parent_pointer);
+        // "::caller_module::slot->::callee_module::slot", the callee is the module doing the work
+        const auto connection = c->GetDescriptiveText();
+        auto callee = connection.substr(connection.find("->") + 2);
+        callee = callee.substr(0, callee.rfind("::"));
+        tracer->describe(t.get_handle(), callee + "::" + conf.name, parent_type_string(conf.parent_type),
+            {{"call", c->ClassName()}, {"connection", connection}, {"callback", conf.name}});
+        break;
+    }
+    case parent_type::MODULE: {
+        const auto m = static_cast<megamol::core::Module*>(conf.parent_pointer);
+        const std::string module = m->Name().PeekBuffer();
+        tracer->describe(t.get_handle(), module + "::" + conf.name, parent_type_string(conf.parent_type),
+            {{"module", module}, {"region", conf.name}});
+        break;
+    }
+    }
+}
+
+void PerformanceManager::flush_trace() {
+    if (tracer) {
+        tracer->flush();
+        if (const auto dropped = tracer->take_dropped_count(); dropped > 0) {
+            megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                "PerformanceManager: trace buffer overflow, %llu events were dropped",
+                static_cast<unsigned long long>(dropped));
+        }
+    }
 }
 
 PerformanceManager::handle_type PerformanceManager::add_timer(std::unique_ptr<Itimer> t) {
@@ -229,6 +299,9 @@ PerformanceManager::handle_type PerformanceManager::add_timer(std::unique_ptr<It
         current_handle++;
     }
     t->h = my_handle;
+    if (tracer) {
+        describe_for_trace(*t);
+    }
     auto pair = std::make_pair(my_handle, std::move(t));
     timers.insert(std::move(pair));
     return my_handle;
@@ -285,6 +358,8 @@ void PerformanceManager::endFrame() {
     for (auto& subscriber : subscribers) {
         subscriber(this_frame);
     }
+
+    flush_trace();
 }
 } // namespace frontend_resources
 } // namespace megamol
@@ -30,12 +30,16 @@ bool Profiling_Service::init(void* configPtr) {
             }
         });
     }
+    if (conf != nullptr && !conf->trace_file.empty()) {
+        _perf_man.start_trace(conf->trace_file);
+    }
 #endif
     return true;
 }
 
 void Profiling_Service::close() {
 #ifdef PROFILING
+    _perf_man.stop_trace();
     if (log_file.is_open()) {
         log_file.close();
     }
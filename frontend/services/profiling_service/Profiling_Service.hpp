@@ -19,6 +19,7 @@ class Profiling_Service final : public AbstractFrontendService {
 public:
     struct Config {
         std::string log_file;
+        std::string trace_file;
     };
 
     std::string serviceName() const override {
@@ -0,0 +1,187 @@
+#include "TraceRecorder.h"
+
+#include <cstdio>
+
+namespace megamol {
+namespace frontend_resources {
+
+namespace {
+// the number of currently open regions of this thread
+thread_local uint32_t open_regions = 0;
+} // namespace
+
+TraceRecorder::TraceRecorder(std::size_t capacity) {
+    uint64_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    mask = size - 1;
+    cells = std::make_unique<cell[]>(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+bool TraceRecorder::open(const std::string& file_name) {
+    close();
+    out.open(file_name, std::ofstream::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    origin = std::chrono::steady_clock::now();
+    // JSON array format: viewers accept a missing closing bracket, so a trace of a crashed run is still readable
+    out << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"MegaMol\"}}";
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+void TraceRecorder::close() {
+    if (!out.is_open()) {
+        return;
+    }
+    recording.store(false, std::memory_order_release);
+    flush();
+    out << "\n]\n";
+    out.close();
+}
+
+void TraceRecorder::describe(handle_type h, std::string name, std::string category, argument_list args) {
+    region r;
+    r.name = escape(name);
+    r.category = escape(category);
+    for (const auto& [key, value] : args) {
+        r.args += ",\"" + escape(key) + "\":\"" + escape(value) + "\"";
+    }
+    regions[h] = std::move(r);
+}
+
+void TraceRecorder::begin(handle_type h, frame_type frame) {
+    if (!recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    event e;
+    e.handle = h;
+    e.frame = frame;
+    e.thread = thread_index();
+    e.depth = open_regions++;
+    e.type = event_type::BEGIN;
+    e.timestamp = std::chrono::steady_clock::now();
+    push(e);
+}
+
+void TraceRecorder::end(handle_type h, frame_type frame) {
+    if (!recording.load(std::memory_order_relaxed)) {
+        return;
+    }
+    event e;
+    e.timestamp = std::chrono::steady_clock::now();
+    e.handle = h;
+    e.frame = frame;
+    e.thread = thread_index();
+    if (open_regions > 0) {
+        --open_regions;
+    }
+    e.depth = open_regions;
+    e.type = event_type::END;
+    push(e);
+}
+
+void TraceRecorder::flush() {
+    if (!out.is_open()) {
+        return;
+    }
+    while (true) {
+        auto& c = cells[dequeue_pos & mask];
+        if (c.sequence.load(std::memory_order_acquire) != dequeue_pos + 1) {
+            break;
+        }
+        write(c.e);
+        c.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        ++dequeue_pos;
+    }
+    out.flush();
+}
+
+void TraceRecorder::push(const event& e) {
+    // bounded multi-producer queue with per-cell sequence numbers (D. Vyukov)
+    auto pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        auto& c = cells[pos & mask];
+        const auto seq = c.sequence.load(std::memory_order_acquire);
+        const auto dif = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (dif == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                c.e = e;
+                c.sequence.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (dif < 0) {
+            // full, the events are only consumed when flushing
+            dropped_events.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void TraceRecorder::write(const event& e) {
+    static const region unknown = {"unknown", "unknown", ""};
+    const auto it = regions.find(e.handle);
+    const auto& r = (it != regions.end()) ? it->second : unknown;
+
+    // timestamps are in microseconds
+    char ts[32];
+    std::snprintf(ts, sizeof(ts), "%.3f",
+        std::chrono::duration<double, std::micro>(e.timestamp - origin).count());
+
+    out << ",\n{\"name\":\"" << r.name << "\",\"cat\":\"" << r.category << "\",\"ph\":\""
+        << ((e.type == event_type::BEGIN) ? "B" : "E") << "\",\"ts\":" << ts << ",\"pid\":1,\"tid\":" << e.thread;
+    if (e.type == event_type::BEGIN) {
+        out << ",\"args\":{\"frame\":" << e.frame << ",\"depth\":" << e.depth << r.args << "}";
+    }
+    out << "}";
+}
+
+uint32_t TraceRecorder::thread_index() {
+    static std::atomic<uint32_t> next_index{0};
+    thread_local const uint32_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+std::string TraceRecorder::escape(const std::string& str) {
+    std::string ret;
+    ret.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            ret += "\\\"";
+            break;
+        case '\\':
+            ret += "\\\\";
+            break;
+        case '\n':
+            ret += "\\n";
+            break;
+        case '\t':
+            ret += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(c));
+                ret += buf;
+            } else {
+                ret += c;
+            }
+        }
+    }
+    return ret;
+}
+
+} // namespace frontend_resources
+} // namespace megamol
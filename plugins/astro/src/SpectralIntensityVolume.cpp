@@ -6,11 +6,15 @@
 
 #include <atomic>
 #include <fstream>
+#include <numeric>
 #include <random>
+#include <sstream>
+#include <unordered_map>
 
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
+#include "mmcore/param/StringParam.h"
 
 #include "mmcore/utility/sys/ConsoleProgressBar.h"
 
@@ -34,12 +38,13 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
         , cyclYSlot("cyclY", "Considers cyclic boundary conditions in Y direction")
         , cyclZSlot("cyclZ", "Considers cyclic boundary conditions in Z direction")
         , normalizeSlot("normalize", "Normalize the output volume")
-        //, wavelength_slot_("wavelength", "Set the wavelength for the spectral intensity (in nm)")
         , numSamplesSlot("numSamples", "Number of samples per particle in the darth volume case")
         , absorptionBiasSlot(
               "absorptionBias", "Determines influence of absorption coefficient in the darth volume case")
         , coneSampleNumSlot("coneNumSamples", "Number of samples for cone tracing in darth volume case")
-        , coneAngleSlot("coneAngle", "Angle of the cone in the darth volume case (degree)") {
+        , coneAngleSlot("coneAngle", "Angle of the cone in the darth volume case (degree)")
+        , wavelengths_slot_("wavelengths", "Wavelengths (in nm) for the spectral intensity, one output component per "
+                                           "wavelength. Empty for the frequency-integrated intensity") {
     volume_in_slot_.SetCompatibleCall<geocalls::VolumetricDataCallDescription>();
     MakeSlotAvailable(&volume_in_slot_);
 
@@ -73,6 +78,9 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->volume_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->volume_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &SpectralIntensityVolume::getBricksCallback);
     this->MakeSlotAvailable(&this->volume_out_slot_);
 
     this->lsu_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
@@ -93,6 +101,9 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->lsu_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->lsu_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &SpectralIntensityVolume::getBricksCallback);
     this->MakeSlotAvailable(&this->lsu_out_slot_);
 
     this->absorption_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
@@ -113,6 +124,9 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->absorption_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->absorption_out_slot_.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &SpectralIntensityVolume::getBricksCallback);
     this->MakeSlotAvailable(&this->absorption_out_slot_);
 
     this->xResSlot << new core::param::IntParam(16);
@@ -132,9 +146,6 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->normalizeSlot << new core::param::BoolParam(true);
     this->MakeSlotAvailable(&this->normalizeSlot);
 
-    /*this->wavelength_slot_ << new core::param::FloatParam(1.0f, std::numeric_limits<float>::min(), 1000.f);
-    MakeSlotAvailable(&wavelength_slot_);*/
-
     numSamplesSlot << new core::param::IntParam(256, 1);
     MakeSlotAvailable(&numSamplesSlot);
 
@@ -146,6 +157,9 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
 
     coneAngleSlot << new core::param::FloatParam(2.0f, 0.001f, 90.0f);
     MakeSlotAvailable(&coneAngleSlot);
+
+    wavelengths_slot_ << new core::param::StringParam("");
+    MakeSlotAvailable(&wavelengths_slot_);
 }
 
 
@@ -302,18 +316,18 @@ bool megamol::astro::SpectralIntensityVolume::getDataCallback(core::Call& c) {
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
-    metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
+    outVol->SetData(this->vol_.data());
+    metadata.Components = this->comp_min_.size();
     metadata.GridType = geocalls::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
     metadata.Resolution[1] = static_cast<size_t>(this->yResSlot.Param<core::param::IntParam>()->Value());
     metadata.Resolution[2] = static_cast<size_t>(this->zResSlot.Param<core::param::IntParam>()->Value());
     metadata.ScalarType = geocalls::ScalarType_t::FLOATING_POINT;
     metadata.ScalarLength = sizeof(float);
-    metadata.MinValues = new double[1];
-    metadata.MinValues[0] = this->min_dens_;
-    metadata.MaxValues = new double[1];
-    metadata.MaxValues[0] = this->max_dens_;
+    metadata.MinValues = new double[metadata.Components];
+    std::copy(this->comp_min_.cbegin(), this->comp_min_.cend(), metadata.MinValues);
+    metadata.MaxValues = new double[metadata.Components];
+    std::copy(this->comp_max_.cbegin(), this->comp_max_.cend(), metadata.MaxValues);
     auto const bbox = ast->AccessBoundingBoxes().ObjectSpaceBBox();
     metadata.Extents[0] = bbox.Width();
     metadata.Extents[1] = bbox.Height();
@@ -451,7 +465,7 @@ bool megamol::astro::SpectralIntensityVolume::getLSUDataCallback(core::Call& c)
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = geocalls::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -600,7 +614,7 @@ bool megamol::astro::SpectralIntensityVolume::getAbsorptionDataCallback(core::Ca
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = geocalls::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -658,12 +672,8 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(geocalls::Volumetr
 
     auto const numCells = sx * sy * sz;
 
-    vol_.resize(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol_[init].resize(numCells);
-        std::fill(vol_[init].begin(), vol_[init].end(), 0.0f);
-    }
+    auto const wavelengths = this->getWavelengths();
+    int const numComp = wavelengths.empty() ? 1 : static_cast<int>(wavelengths.size());
 
     auto const cycl_x = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
     auto const cycl_y = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
@@ -909,139 +919,227 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(geocalls::Volumetr
         }
     }*/
 
-    std::uniform_real_distribution<> distr(0.0, 1.0);
-    std::mt19937_64 rng(42);
+    // spectral shape of thermal bremsstrahlung, x e^-x with x = h c / (lambda k T), scaled to a maximum of one;
+    // the absorption is taken as gray
+    std::vector<double> spectral(positions.size() * numComp, 1.0);
+    if (!wavelengths.empty()) {
+        constexpr double kb = 1.380649e-23; // [J/K]
+        constexpr double hp = 6.626070e-34; // [J*s]
+        constexpr double c = 299792458.0;   // [m/s] (vacuum)
+#pragma omp parallel for
+        for (int64_t idx = 0; idx < static_cast<int64_t>(positions.size()); ++idx) {
+            for (int comp = 0; comp < numComp; ++comp) {
+                auto const x = hp * c / (wavelengths[comp] * kb * temps[idx]);
+                spectral[idx * numComp + comp] = std::isfinite(x) ? M_E * x * std::exp(-x) : 0.0;
+            }
+        }
+    }
+
+    // The rays of a particle cross the whole volume, so the output cannot be split among the threads. Instead, the
+    // particles are processed brick by brick, so the rays of one thread start close to each other, and every thread
+    // accumulates into its own copies of the bricks its rays cross (tiles). The tiles of all threads are added to the
+    // volume brick by brick at the end, so no locks are needed. A tile is never evicted: the rays sweep the whole
+    // volume, so any bounded cache would keep flushing tiles that are needed again shortly after.
+    int constexpr brickDim = 8;
+    int constexpr brickCells = brickDim * brickDim * brickDim;
+    int const bricksX = (sx + brickDim - 1) / brickDim;
+    int const bricksY = (sy + brickDim - 1) / brickDim;
+    int const bricksZ = (sz + brickDim - 1) / brickDim;
+    int64_t const numBricks = static_cast<int64_t>(bricksX) * bricksY * bricksZ;
+    auto brickOf = [bricksX, bricksY](int vx, int vy, int vz) -> int64_t {
+        return (static_cast<int64_t>(vz / brickDim) * bricksY + vy / brickDim) * bricksX + vx / brickDim;
+    };
 
-    // Implements the Bump Function from
-    // https://en.wikipedia.org/wiki/Radial_basis_function
-    auto rbf = [](float const dist, float const epsilon) -> float {
-        if (dist >= epsilon)
-            return 0.0f;
-        return std::exp(-1.0f / (1.0f - std::pow((1.0f / epsilon) * dist, 2.0f)));
+    std::vector<int64_t> brickOffsets(numBricks + 1, 0);
+    std::vector<int64_t> particleBrick(positions.size());
+    for (size_t idx = 0; idx < positions.size(); ++idx) {
+        auto const& v = voxel_idx[idx];
+        particleBrick[idx] = brickOf((v.x + 4 * sx) % sx, (v.y + 4 * sy) % sy, (v.z + 4 * sz) % sz);
+        ++brickOffsets[particleBrick[idx] + 1];
+    }
+    std::partial_sum(brickOffsets.cbegin(), brickOffsets.cend(), brickOffsets.begin());
+    std::vector<int64_t> brickParticles(positions.size());
+    {
+        auto fill = brickOffsets;
+        for (size_t idx = 0; idx < positions.size(); ++idx) {
+            brickParticles[fill[particleBrick[idx]]++] = idx;
+        }
+    }
+
+    vol_.assign(static_cast<size_t>(numCells) * numComp, 0.0f);
+    struct ThreadTiles {
+        /** Offset of the tile of a brick in values */
+        std::unordered_map<int64_t, size_t> offsets;
+        std::vector<float> values;
+    };
+    std::vector<ThreadTiles> threadTiles(omp_get_max_threads());
+    auto addTile = [&](int64_t brick, float const* tile) {
+        int const bx = static_cast<int>(brick % bricksX) * brickDim;
+        int const by = static_cast<int>((brick / bricksX) % bricksY) * brickDim;
+        int const bz = static_cast<int>(brick / (static_cast<int64_t>(bricksX) * bricksY)) * brickDim;
+        for (int lz = 0; lz < brickDim && bz + lz < sz; ++lz) {
+            for (int ly = 0; ly < brickDim && by + ly < sy; ++ly) {
+                for (int lx = 0; lx < brickDim && bx + lx < sx; ++lx) {
+                    auto const cell = (static_cast<size_t>(bz + lz) * sy + (by + ly)) * sx + (bx + lx);
+                    auto const local = (lz * brickDim + ly) * brickDim + lx;
+                    for (int comp = 0; comp < numComp; ++comp) {
+                        vol_[cell * numComp + comp] += tile[local * numComp + comp];
+                    }
+                }
+            }
+        }
     };
 
-#if 1
     cpb.Start("Volume Creation", positions.size());
-    auto const cone_factor = std::tan(coneAngleDeg * M_PI / 180.0f);
     auto const cone_angle = coneAngleDeg * M_PI / 180.0;
 
-#pragma omp parallel for
-    for (int64_t idx = 0; idx < positions.size(); ++idx) {
-        auto const pos = positions[idx];
-        /*auto x_base = pos.x;
-        auto x = voxel_idx[idx].x;
-        auto y_base = pos.y;
-        auto y = voxel_idx[idx].y;
-        auto z_base = pos.z;
-        auto z = voxel_idx[idx].z;*/
-        auto const rad = sl[idx];
-
-
-        for (int iter = 0; iter < numSamples; ++iter) {
-            // https://corysimon.github.io/articles/uniformdistn-on-sphere/
-            auto phi = 2.0 * M_PI * distr(rng);
-            auto theta = std::acos(1.0 - 2.0 * distr(rng));
-            glm::vec3 dir = glm::vec3(
-                rad * std::sin(theta) * std::cos(phi), rad * std::sin(theta) * std::sin(phi), rad * std::cos(theta));
-            glm::vec3 org = pos + dir;
-            dir = glm::normalize(dir);
-            auto org_dir = dir;
-
-            for (int cone_idx = 0; cone_idx < numConeSamples; ++cone_idx) {
-                auto e = radiance[idx];
-
-                // modify dir
-                // https://stackoverflow.com/questions/38997302/create-random-unit-vector-inside-a-defined-conical-region
-                try {
-                    auto const z = distr(rng) * (1.0 - std::cos(cone_angle)) + std::cos(cone_angle);
-                    auto const phi = distr(rng) * 2.0 * M_PI;
-                    auto const y = std::sqrt(1.0 - z * z) * sin(phi);
-                    auto const x = std::sqrt(1.0 - z * z) * cos(phi);
-                    glm::vec3 rand(x, y, z);
-                    glm::vec3 base(0, 0, 1);
-                    // TODO Careful: the next two method calls are adapted from the old new camera and may be broken
-                    auto const quat = quat_from_vectors(base, org_dir);
-                    dir = quat_rotate(rand, quat);
-                } catch (...) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError("SpectralIntensityVolume: Math gone wrong");
-                }
+#pragma omp parallel
+    {
+        auto& tiles = threadTiles[omp_get_thread_num()];
+        // consecutive ray steps mostly stay in the same brick, so skip the lookup for those
+        int64_t lastBrick = -1;
+        float* tile = nullptr;
+        std::vector<double> e(numComp);
+        std::uniform_real_distribution<> distr(0.0, 1.0);
+
+#pragma omp for schedule(dynamic)
+        for (int64_t brick = 0; brick < numBricks; ++brick) {
+            for (auto p = brickOffsets[brick]; p < brickOffsets[brick + 1]; ++p) {
+                auto const idx = brickParticles[p];
+                // one random sequence per particle, so the samples do not depend on the scheduling
+                std::mt19937_64 rng(42 + idx);
+                auto const pos = positions[idx];
+                auto const rad = sl[idx];
+
+                for (int iter = 0; iter < numSamples; ++iter) {
+                    // https://corysimon.github.io/articles/uniformdistn-on-sphere/
+                    auto phi = 2.0 * M_PI * distr(rng);
+                    auto theta = std::acos(1.0 - 2.0 * distr(rng));
+                    glm::vec3 dir = glm::vec3(rad * std::sin(theta) * std::cos(phi),
+                        rad * std::sin(theta) * std::sin(phi), rad * std::cos(theta));
+                    glm::vec3 org = pos + dir;
+                    dir = glm::normalize(dir);
+                    auto org_dir = dir;
+
+                    for (int cone_idx = 0; cone_idx < numConeSamples; ++cone_idx) {
+                        for (int comp = 0; comp < numComp; ++comp) {
+                            e[comp] = radiance[idx] * spectral[idx * numComp + comp];
+                        }
 
-                //double att = 0.0;
-                float t = 0.0f;
-                float t_max = std::sqrt(rangeOSx * rangeOSx + rangeOSy * rangeOSy + rangeOSz * rangeOSz);
-                float t_step = min_vol_dis;
-                while (t <= t_max && e > 0.0) {
-                    glm::vec3 const curr = org + t * dir;
-
-                    auto ax = static_cast<int>((curr.x - vol_orgx) / vol_disx);
-                    auto ay = static_cast<int>((curr.y - vol_orgy) / vol_disy);
-                    auto az = static_cast<int>((curr.z - vol_orgz) / vol_disz);
-
-                    ax = (ax + 4 * vol_sx) % vol_sx;
-                    ay = (ay + 4 * vol_sy) % vol_sy;
-                    az = (az + 4 * vol_sz) % vol_sz;
-
-                    double aps = optical[(az * vol_sy + ay) * vol_sx + ax];
-
-                    auto vx = static_cast<int>((curr.x - minOSx) / sliceDistX);
-                    auto vy = static_cast<int>((curr.y - minOSy) / sliceDistY);
-                    auto vz = static_cast<int>((curr.z - minOSz) / sliceDistZ);
-
-                    vx = (vx + 4 * sx) % sx;
-                    vy = (vy + 4 * sy) % sy;
-                    vz = (vz + 4 * sz) % sz;
-
-                    e -= e * aps;
-                    // att += aps * (1.0 - att);
-
-                    vol_[omp_get_thread_num()][(vz * sy + vy) * sx + vx] += e;
-
-                    /*auto const cone = cone_factor * t;
-                    auto const voxel_diff_x = static_cast<int>(cone / sliceDistX);
-                    auto const voxel_diff_y = static_cast<int>(cone / sliceDistY);
-                    auto const voxel_diff_z = static_cast<int>(cone / sliceDistZ);
-                    for (int vvz = vz - voxel_diff_z; vvz < vz + voxel_diff_z; ++vvz) {
-                        for (int vvy = vy - voxel_diff_y; vvy < vy + voxel_diff_y; ++vvy) {
-                            for (int vvx = vx - voxel_diff_x; vvx < vx + voxel_diff_x; ++vvx) {
-                                float const tmp_dis_x = sliceDistX * static_cast<float>(std::abs(vvx - vx));
-                                float const tmp_dis_y = sliceDistY * static_cast<float>(std::abs(vvy - vy));
-                                float const tmp_dis_z = sliceDistZ * static_cast<float>(std::abs(vvz - vz));
-                                auto const distance =
-                                    std::sqrt(tmp_dis_x * tmp_dis_x + tmp_dis_y * tmp_dis_y + tmp_dis_z * tmp_dis_z);
-                                auto const hvx = (vvx + 2 * sx) % sx;
-                                auto const hvy = (vvy + 2 * sy) % sy;
-                                auto const hvz = (vvz + 2 * sz) % sz;
-                                vol_[omp_get_thread_num()][(hvz * sy + hvy) * sx + hvx] += e * rbf(distance, cone);
+                        // modify dir
+                        // https://stackoverflow.com/questions/38997302/create-random-unit-vector-inside-a-defined-conical-region
+                        try {
+                            auto const z = distr(rng) * (1.0 - std::cos(cone_angle)) + std::cos(cone_angle);
+                            auto const phi = distr(rng) * 2.0 * M_PI;
+                            auto const y = std::sqrt(1.0 - z * z) * sin(phi);
+                            auto const x = std::sqrt(1.0 - z * z) * cos(phi);
+                            glm::vec3 rand(x, y, z);
+                            glm::vec3 base(0, 0, 1);
+                            // TODO Careful: the next two method calls are adapted from the old new camera and may be
+                            // broken
+                            auto const quat = quat_from_vectors(base, org_dir);
+                            dir = quat_rotate(rand, quat);
+                        } catch (...) {
+                            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                                "SpectralIntensityVolume: Math gone wrong");
+                        }
+
+                        float t = 0.0f;
+                        float t_max = std::sqrt(rangeOSx * rangeOSx + rangeOSy * rangeOSy + rangeOSz * rangeOSz);
+                        float t_step = min_vol_dis;
+                        bool emitting = true;
+                        while (t <= t_max && emitting) {
+                            glm::vec3 const curr = org + t * dir;
+
+                            auto ax = static_cast<int>((curr.x - vol_orgx) / vol_disx);
+                            auto ay = static_cast<int>((curr.y - vol_orgy) / vol_disy);
+                            auto az = static_cast<int>((curr.z - vol_orgz) / vol_disz);
+
+                            ax = (ax + 4 * vol_sx) % vol_sx;
+                            ay = (ay + 4 * vol_sy) % vol_sy;
+                            az = (az + 4 * vol_sz) % vol_sz;
+
+                            double aps = optical[(az * vol_sy + ay) * vol_sx + ax];
+
+                            auto vx = static_cast<int>((curr.x - minOSx) / sliceDistX);
+                            auto vy = static_cast<int>((curr.y - minOSy) / sliceDistY);
+                            auto vz = static_cast<int>((curr.z - minOSz) / sliceDistZ);
+
+                            vx = (vx + 4 * sx) % sx;
+                            vy = (vy + 4 * sy) % sy;
+                            vz = (vz + 4 * sz) % sz;
+
+                            auto const brick = brickOf(vx, vy, vz);
+                            if (brick != lastBrick) {
+                                auto it = tiles.offsets.find(brick);
+                                if (it == tiles.offsets.end()) {
+                                    it = tiles.offsets.emplace(brick, tiles.values.size()).first;
+                                    tiles.values.resize(tiles.values.size() + brickCells * numComp, 0.0f);
+                                }
+                                lastBrick = brick;
+                                tile = tiles.values.data() + it->second;
+                            }
+                            auto const local =
+                                ((vz % brickDim) * brickDim + (vy % brickDim)) * brickDim + (vx % brickDim);
+
+                            emitting = false;
+                            for (int comp = 0; comp < numComp; ++comp) {
+                                e[comp] -= e[comp] * aps;
+                                tile[local * numComp + comp] += e[comp];
+                                emitting = emitting || e[comp] > 0.0;
                             }
+
+                            t += t_step;
                         }
-                    }*/
+                    }
+                }
 
-                    t += t_step;
+                ++counter;
+                if (omp_get_thread_num() == 0) {
+                    cpb.Set(counter.load());
                 }
             }
         }
 
-        ++counter;
-        if (omp_get_thread_num() == 0) {
-            cpb.Set(counter.load());
+#pragma omp for schedule(dynamic)
+        for (int64_t brick = 0; brick < numBricks; ++brick) {
+            for (auto const& t : threadTiles) {
+                auto const it = t.offsets.find(brick);
+                if (it != t.offsets.end()) {
+                    addTile(brick, t.values.data() + it->second);
+                }
+            }
         }
     }
     cpb.Stop();
-#endif
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol_[i].begin(), vol_[i].end(), vol_[0].begin(), vol_[0].begin(), std::plus<>());
+    comp_min_.assign(numComp, std::numeric_limits<double>::max());
+    comp_max_.assign(numComp, std::numeric_limits<double>::lowest());
+    for (size_t cell = 0; cell < static_cast<size_t>(numCells); ++cell) {
+        for (int comp = 0; comp < numComp; ++comp) {
+            comp_min_[comp] = std::min<double>(comp_min_[comp], vol_[cell * numComp + comp]);
+            comp_max_[comp] = std::max<double>(comp_max_[comp], vol_[cell * numComp + comp]);
+        }
     }
-
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(comp_max_.cbegin(), comp_max_.cend());
+    min_dens_ = *std::min_element(comp_min_.cbegin(), comp_min_.cend());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
-        auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
-            [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
+        std::vector<float> rcpValRange(numComp);
+        for (int comp = 0; comp < numComp; ++comp) {
+            rcpValRange[comp] = 1.0f / static_cast<float>(comp_max_[comp] - comp_min_[comp]);
+        }
+#pragma omp parallel for
+        for (int64_t cell = 0; cell < static_cast<int64_t>(numCells); ++cell) {
+            for (int comp = 0; comp < numComp; ++comp) {
+                auto& val = vol_[cell * numComp + comp];
+                val = (val - static_cast<float>(comp_min_[comp])) * rcpValRange[comp];
+            }
+        }
+        std::fill(comp_min_.begin(), comp_min_.end(), 0.0);
+        std::fill(comp_max_.begin(), comp_max_.end(), 1.0);
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
     }
@@ -1049,18 +1147,37 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(geocalls::Volumetr
 //#define SIV_DEBUG_OUTPUT
 #ifdef SIV_DEBUG_OUTPUT
     std::ofstream raw_file{"int.raw", std::ios::binary};
-    raw_file.write(reinterpret_cast<char const*>(vol_[0].data()), vol_[0].size() * sizeof(float));
+    raw_file.write(reinterpret_cast<char const*>(vol_.data()), vol_.size() * sizeof(float));
     raw_file.close();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("SpectralIntensityVolume: Debug file written\n");
 #endif
 
-    // Cleanup
-    vol_.resize(1);
-
     return true;
 }
 
 
+std::vector<double> megamol::astro::SpectralIntensityVolume::getWavelengths() const {
+    std::vector<double> wavelengths;
+    auto list = this->wavelengths_slot_.Param<core::param::StringParam>()->Value();
+    std::replace_if(
+        list.begin(), list.end(), [](char ch) { return ch == ',' || ch == ';'; }, ' ');
+    std::istringstream stream(list);
+    std::string token;
+    while (stream >> token) {
+        try {
+            auto const nm = std::stod(token);
+            if (nm > 0.0) {
+                wavelengths.push_back(nm * 1e-9);
+                continue;
+            }
+        } catch (...) {}
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "SpectralIntensityVolume: Ignoring invalid wavelength \"%s\"", token.c_str());
+    }
+    return wavelengths;
+}
+
+
 bool megamol::astro::SpectralIntensityVolume::createBremsstrahlungVolume(geocalls::VolumetricDataCall const& volumeIn,
     geocalls::VolumetricDataCall const& tempIn, geocalls::VolumetricDataCall const& massIn,
     geocalls::VolumetricDataCall const& mwIn, AstroDataCall& astroIn) {
@@ -1118,23 +1235,24 @@ bool megamol::astro::SpectralIntensityVolume::createBremsstrahlungVolume(geocall
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(density, density + numCells, temperature, vol_[0].begin(),
+    vol_.resize(numCells);
+    std::transform(density, density + numCells, temperature, vol_.begin(),
         [cell_vol](float d, float t) { return d * d * std::sqrt(t) * cell_vol; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
     }
+    comp_min_.assign(1, min_dens_);
+    comp_max_.assign(1, max_dens_);
 
     return true;
 }
@@ -1209,30 +1327,31 @@ bool megamol::astro::SpectralIntensityVolume::createAbsorptionVolume(geocalls::V
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(mw, mw + numCells, temperature, vol_[0].begin(), [](float mw, float t) {
+    vol_.resize(numCells);
+    std::transform(mw, mw + numCells, temperature, vol_.begin(), [](float mw, float t) {
         return 0.018 * std::pow(static_cast<double>(t), -1.5) * 0.0134 * 0.0134 * static_cast<double>(mw) * 1.2;
     });
-    std::transform(mass, mass + numCells, vol_[0].cbegin(), vol_[0].begin(), [](float m, double o) { return o / m; });
-    auto const minmax_optical = std::minmax_element(vol_[0].cbegin(), vol_[0].cend());
+    std::transform(mass, mass + numCells, vol_.cbegin(), vol_.begin(), [](float m, double o) { return o / m; });
+    auto const minmax_optical = std::minmax_element(vol_.cbegin(), vol_.cend());
     auto const min_optical = *minmax_optical.first;
     auto const minmax_optical_rcp = 1.0 / (*minmax_optical.second - min_optical);
-    std::transform(vol_[0].cbegin(), vol_[0].cend(), vol_[0].begin(),
+    std::transform(vol_.cbegin(), vol_.cend(), vol_.begin(),
         [min_optical, minmax_optical_rcp](float o) { return (o - min_optical) * minmax_optical_rcp; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
     }
+    comp_min_.assign(1, min_dens_);
+    comp_max_.assign(1, max_dens_);
 
     return true;
 }
@@ -54,6 +54,11 @@ private:
         return true;
     }
 
+    /** Answers the request for bricks with false, the volumes are only computed as a whole. */
+    bool getBricksCallback(megamol::core::Call& c) {
+        return false;
+    }
+
     bool createVolumeCPU(geocalls::VolumetricDataCall const& volumeIn, geocalls::VolumetricDataCall const& tempIn,
         geocalls::VolumetricDataCall const& massIn, geocalls::VolumetricDataCall const& mwIn, AstroDataCall& astroIn);
 
@@ -68,7 +73,7 @@ private:
     bool anythingDirty() const {
         return this->xResSlot.IsDirty() || this->yResSlot.IsDirty() || this->zResSlot.IsDirty() ||
                this->cyclXSlot.IsDirty() || this->cyclYSlot.IsDirty() || this->cyclZSlot.IsDirty() ||
-               this->normalizeSlot.IsDirty() /*|| wavelength_slot_.IsDirty()*/ || numSamplesSlot.IsDirty() ||
+               this->normalizeSlot.IsDirty() || wavelengths_slot_.IsDirty() || numSamplesSlot.IsDirty() ||
                absorptionBiasSlot.IsDirty();
     }
 
@@ -80,7 +85,7 @@ private:
         this->cyclYSlot.ResetDirty();
         this->cyclZSlot.ResetDirty();
         this->normalizeSlot.ResetDirty();
-        //wavelength_slot_.ResetDirty();
+        wavelengths_slot_.ResetDirty();
         numSamplesSlot.ResetDirty();
         absorptionBiasSlot.ResetDirty();
     }
@@ -132,9 +137,17 @@ private:
 
     core::param::ParamSlot coneAngleSlot;
 
-    // core::param::ParamSlot wavelength_slot_;
+    core::param::ParamSlot wavelengths_slot_;
+
+    /** Parses the wavelengths parameter, answers the wavelengths in m */
+    std::vector<double> getWavelengths() const;
+
+    /** Output volume, the components of a voxel are interleaved */
+    std::vector<float> vol_;
 
-    std::vector<std::vector<float>> vol_;
+    /** Value range per component of the spectral intensity volume */
+    std::vector<double> comp_min_;
+    std::vector<double> comp_max_;
 
     float max_dens_ = 0.0f;
     float min_dens_ = std::numeric_limits<float>::max();
@@ -8,6 +8,8 @@
 #include "VolumetricGlobalMinMax.h"
 #include "stdafx.h"
 
+#include <limits>
+
 #include "mmcore/utility/log/Log.h"
 
 /*
@@ -40,6 +42,9 @@ megamol::astro::VolumetricGlobalMinMax::VolumetricGlobalMinMax(void)
     this->slotVolumetricDataOut.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &VolumetricGlobalMinMax::onUnsupportedCallback);
+    this->slotVolumetricDataOut.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &VolumetricGlobalMinMax::onGetBricks);
     this->MakeSlotAvailable(&this->slotVolumetricDataOut);
 }
 
@@ -62,6 +67,44 @@ bool megamol::astro::VolumetricGlobalMinMax::create(void) {
  */
 void megamol::astro::VolumetricGlobalMinMax::release(void) {}
 
+bool megamol::astro::VolumetricGlobalMinMax::getBrickMinMax(
+    geocalls::VolumetricDataCall& src, std::vector<double>& outMin, std::vector<double>& outMax) {
+    using geocalls::VolumetricDataCall;
+
+    // the coarsest level of the whole volume is usually a single brick, but
+    // only existing bricks are used, building them would read every frame
+    const size_t regionMin[3] = {0, 0, 0};
+    const size_t regionMax[3] = {std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max(),
+        std::numeric_limits<size_t>::max()};
+    src.SetRegion(regionMin, regionMax, std::numeric_limits<unsigned int>::max(), false);
+    if (!src(VolumetricDataCall::IDX_GET_BRICKS) || (src.GetBrickCount() == 0) || (src.GetMetadata() == nullptr)) {
+        return false;
+    }
+
+    const auto components = src.GetMetadata()->Components;
+    outMin.assign(components, std::numeric_limits<double>::max());
+    outMax.assign(components, std::numeric_limits<double>::lowest());
+    for (size_t i = 0; i < src.GetBrickCount(); ++i) {
+        const auto& brick = src.GetBricks()[i];
+        if ((brick.MinValues == nullptr) || (brick.MaxValues == nullptr)) {
+            return false;
+        }
+        for (size_t j = 0; j < components; ++j) {
+            if (brick.MinValues[j] < outMin[j]) {
+                outMin[j] = brick.MinValues[j];
+            }
+            if (brick.MaxValues[j] > outMax[j]) {
+                outMax[j] = brick.MaxValues[j];
+            }
+        }
+    }
+    return true;
+}
+
+bool megamol::astro::VolumetricGlobalMinMax::onGetBricks(megamol::core::Call& call) {
+    return pipeVolumetricDataCall(call, geocalls::VolumetricDataCall::IDX_GET_BRICKS);
+}
+
 bool megamol::astro::VolumetricGlobalMinMax::onGetData(megamol::core::Call& call) {
     return pipeVolumetricDataCall(call, geocalls::VolumetricDataCall::IDX_GET_DATA);
 }
@@ -110,27 +153,32 @@ bool megamol::astro::VolumetricGlobalMinMax::pipeVolumetricDataCall(megamol::cor
         this->minValues.clear();
         this->maxValues.clear();
 
+        std::vector<double> frameMinValues, frameMaxValues;
         auto frames = src->FrameCount();
         for (unsigned int i = 0; i < frames; ++i) {
             src->SetFrameID(i, true);
-            VolumetricDataCall::GetMetadata(*src);
-            const auto metadata = src->GetMetadata();
+            if (!this->getBrickMinMax(*src, frameMinValues, frameMaxValues)) {
+                VolumetricDataCall::GetMetadata(*src);
+                const auto metadata = src->GetMetadata();
+                frameMinValues.assign(metadata->MinValues, metadata->MinValues + metadata->Components);
+                frameMaxValues.assign(metadata->MaxValues, metadata->MaxValues + metadata->Components);
+            }
             if (i == 0) {
-                this->minValues.resize(metadata->Components, std::numeric_limits<double>::max());
-                this->maxValues.resize(metadata->Components, std::numeric_limits<double>::lowest());
+                this->minValues.resize(frameMinValues.size(), std::numeric_limits<double>::max());
+                this->maxValues.resize(frameMaxValues.size(), std::numeric_limits<double>::lowest());
             } else {
-                if (this->minValues.size() != metadata->Components) {
+                if (this->minValues.size() != frameMinValues.size()) {
                     Log::DefaultLog.WriteError("Unexpected number of components.");
                     return false;
                 }
             }
 
-            for (size_t j = 0; j < metadata->Components; ++j) {
-                if (metadata->MinValues[j] < this->minValues[j]) {
-                    this->minValues[j] = metadata->MinValues[j];
+            for (size_t j = 0; j < frameMinValues.size(); ++j) {
+                if (frameMinValues[j] < this->minValues[j]) {
+                    this->minValues[j] = frameMinValues[j];
                 }
-                if (metadata->MaxValues[j] > this->maxValues[j]) {
-                    this->maxValues[j] = metadata->MaxValues[j];
+                if (frameMaxValues[j] > this->maxValues[j]) {
+                    this->maxValues[j] = frameMaxValues[j];
                 }
             }
         }
@@ -143,10 +191,21 @@ bool megamol::astro::VolumetricGlobalMinMax::pipeVolumetricDataCall(megamol::cor
         for (const auto& m : this->maxValues) {
             Log::DefaultLog.WriteInfo("    %f", m);
         }
+
+        if (funcIdx == VolumetricDataCall::IDX_GET_BRICKS) {
+            // the bricks of the statistics replaced the requested ones
+            *src = *dst;
+            if (!(*src)(funcIdx)) {
+                Log::DefaultLog.WriteError("%hs failed to call %hs.", VolumetricGlobalMinMax::ClassName(),
+                    VolumetricDataCall::FunctionName(funcIdx));
+                return false;
+            }
+            *dst = *src;
+        }
     }
 
     auto metadata = dst->GetMetadata();
-    if (metadata != nullptr) {
+    if ((metadata != nullptr) && (metadata->MinValues != nullptr) && (metadata->MaxValues != nullptr)) {
         if (this->minValues.size() != metadata->Components) {
             Log::DefaultLog.WriteError("Unexpected number of components.");
             return false;
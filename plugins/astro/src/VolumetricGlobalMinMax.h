@@ -12,6 +12,7 @@
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
 #include <array>
+#include <vector>
 
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
@@ -52,6 +53,16 @@ protected:
 
     virtual void release(void);
 
+    /// <summary>
+    /// Answer the min/max values of the current frame of <paramref name="src" />
+    /// from the statistics of its coarsest bricks, which avoids loading the frame.
+    /// Bricks are only used if the source has already built them.
+    /// </summary>
+    /// <returns><c>false</c> if the source does not provide existing bricks with statistics.</returns>
+    bool getBrickMinMax(geocalls::VolumetricDataCall& src, std::vector<double>& outMin, std::vector<double>& outMax);
+
+    bool onGetBricks(core::Call& call);
+
     bool onGetData(core::Call& call);
 
     bool onGetExtents(core::Call& call);
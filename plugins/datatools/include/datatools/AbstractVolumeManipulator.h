@@ -94,6 +94,12 @@ private:
 
     bool tryGetDataCallback(megamol::core::Call& c);
 
+    /**
+     * Answers the request for bricks with false, because the manipulation
+     * is only applied to whole frames.
+     */
+    bool getBricksCallback(megamol::core::Call& c);
+
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
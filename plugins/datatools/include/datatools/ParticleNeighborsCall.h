@@ -0,0 +1,170 @@
+/*
+ * ParticleNeighborsCall.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#pragma once
+
+#include "mmcore/AbstractGetDataCall.h"
+#include "mmcore/factories/CallAutoDescription.h"
+#include <cstdint>
+
+namespace megamol {
+namespace datatools {
+
+/**
+ * Call transports the neighbor lists of all particles in CSR layout. The caller sets the query (radius or number of
+ * neighbors) and the frame, the callee answers with one list per particle and the cyclic boundaries it has used. The
+ * particle indices enumerate all particles with float positions of all lists of the particle data the callee is
+ * connected to.
+ *
+ * Every list contains the particle itself and is sorted by ascending distance.
+ */
+class ParticleNeighborsCall : public core::AbstractGetDataCall {
+public:
+    /** Type for particle indices */
+    typedef uint32_t index_t;
+
+    /** Type for offsets into the neighbor arrays */
+    typedef uint64_t offset_t;
+
+    enum SearchType : int { RADIUS = 0, NUM_NEIGHBORS = 1 };
+
+    typedef struct _neighbor_list_t {
+        /** Pointer to the first neighbor index */
+        index_t const* indices;
+        /** Pointer to the first squared neighbor distance */
+        float const* sqDistances;
+        /** Number of neighbors */
+        offset_t length;
+
+        index_t const* begin() const {
+            return indices;
+        }
+        index_t const* end() const {
+            return indices + length;
+        }
+    } neighbor_list_t;
+
+    /** Possible call functions/intends */
+    enum CallFunctionName : int { GET_DATA = 0, GET_EXTENT = 1 };
+
+    /** Factory metadata */
+    static const char* ClassName(void) {
+        return "ParticleNeighborsCall";
+    }
+    static const char* Description(void) {
+        return "Call transports the neighbor lists of all particles, computed for a radius or a number of neighbors.";
+    }
+    static unsigned int FunctionCount(void) {
+        return 2;
+    }
+    static const char* FunctionName(unsigned int idx) {
+        switch (idx) {
+        case GET_DATA:
+            return "GetData";
+        case GET_EXTENT:
+            return "GetExtent";
+        }
+        return nullptr;
+    }
+
+    /** ctor */
+    ParticleNeighborsCall();
+    /** dtor */
+    virtual ~ParticleNeighborsCall();
+
+    /** Sets the query. The radius is used for RADIUS, the count for NUM_NEIGHBORS */
+    inline void SetQuery(SearchType type, float radius, unsigned int count) {
+        this->type = type;
+        this->radius = radius;
+        this->count = count;
+    }
+    /** Sets the dimensions with cyclic boundary conditions the lists have been computed with */
+    inline void SetCyclicBoundaries(bool x, bool y, bool z) {
+        this->cyclX = x;
+        this->cyclY = y;
+        this->cyclZ = z;
+    }
+    inline SearchType GetSearchType() const {
+        return type;
+    }
+    inline float Radius() const {
+        return radius;
+    }
+    inline unsigned int NeighborCount() const {
+        return count;
+    }
+    inline bool CyclicX() const {
+        return cyclX;
+    }
+    inline bool CyclicY() const {
+        return cyclY;
+    }
+    inline bool CyclicZ() const {
+        return cyclZ;
+    }
+
+    /** Number of particles, i.e. neighbor lists */
+    inline size_t ParticleCount() const {
+        return particleCnt;
+    }
+    /** The neighbors of particle 'idx' */
+    inline neighbor_list_t Neighbors(size_t idx) const {
+        return {indices + offsets[idx], sqDistances + offsets[idx], offsets[idx + 1] - offsets[idx]};
+    }
+    /** Current frame ID (zero-based) */
+    inline unsigned int FrameID() const {
+        return frameID;
+    }
+    /** Number of frames available (set by GetExtent) */
+    inline unsigned int FrameCount() const {
+        return frameCnt;
+    }
+
+    /**
+     * Sets the neighbor lists. No deep copy. Caller must keep memory alive.
+     *
+     * @param particleCnt Number of particles
+     * @param offsets particleCnt + 1 offsets into 'indices' and 'sqDistances'
+     * @param indices The neighbor indices of all particles
+     * @param sqDistances The squared neighbor distances of all particles
+     */
+    inline void Set(size_t particleCnt, offset_t const* offsets, index_t const* indices, float const* sqDistances) {
+        this->particleCnt = particleCnt;
+        this->offsets = offsets;
+        this->indices = indices;
+        this->sqDistances = sqDistances;
+    }
+    /** Sets current frame ID (zero-based) */
+    inline void SetFrameID(unsigned int fid) {
+        frameID = fid;
+    }
+    /** Sets number of frames available */
+    inline void SetFrameCount(unsigned int cnt) {
+        frameCnt = cnt;
+    }
+
+private:
+    /* query */
+    SearchType type;
+    float radius;
+    unsigned int count;
+
+    /* data */
+    bool cyclX;
+    bool cyclY;
+    bool cyclZ;
+    size_t particleCnt;
+    offset_t const* offsets;
+    index_t const* indices;
+    float const* sqDistances;
+    unsigned int frameCnt;
+    unsigned int frameID;
+};
+
+typedef core::factories::CallAutoDescription<ParticleNeighborsCall> ParticleNeighborsCallDescription;
+
+} // namespace datatools
+} // namespace megamol
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <list>
 #include <memory>
 #include <vector>
 
@@ -489,4 +494,191 @@ inline cluster_result_t GROWING_with_similarity_and_score(std::shared_ptr<kd_tre
 }
 
 
+namespace detail {
+
+/**
+ * Lock-free union-find (disjoint set) over the indices [0, size). Sets are
+ * linked towards the smaller index, so the representative of every set is
+ * its smallest member, independent of the order of the unions.
+ */
+class concurrent_union_find {
+public:
+    explicit concurrent_union_find(index_t size) : _size(size), _parent(new std::atomic<index_t>[size]) {
+#pragma omp parallel for
+        for (std::int64_t idx = 0; idx < static_cast<std::int64_t>(size); ++idx) {
+            _parent[idx].store(static_cast<index_t>(idx), std::memory_order_relaxed);
+        }
+    }
+
+    index_t find(index_t x) {
+        while (true) {
+            auto p = _parent[x].load(std::memory_order_acquire);
+            if (p == x) {
+                return x;
+            }
+            auto const gp = _parent[p].load(std::memory_order_acquire);
+            if (p != gp) {
+                // path halving, losing the race is harmless
+                _parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+            }
+            x = gp;
+        }
+    }
+
+    void unite(index_t a, index_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            // a is a root larger than b; another thread may have linked it meanwhile
+            auto expected = a;
+            if (_parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+                return;
+            }
+        }
+    }
+
+    index_t size() const {
+        return _size;
+    }
+
+private:
+    index_t _size;
+
+    std::unique_ptr<std::atomic<index_t>[]> _parent;
+};
+
+
+/**
+ * Parallel DBSCAN in three passes:
+ * 1. the core points are detected concurrently,
+ * 2. core points within eps of each other are merged in a lock-free
+ *    union-find, while every other point remembers its smallest core
+ *    neighbour,
+ * 3. the sets are numbered in order of their smallest member and the border
+ *    points are assigned to the cluster of their core neighbour.
+ *
+ * The kd-tree is shared by all threads, as the nanoflann search is const.
+ * If 'similarity' is given, only neighbours for which it answers true are
+ * considered; it is called concurrently and must be thread-safe and
+ * symmetric.
+ */
+template<typename T, int DIM>
+inline cluster_result_t parallel_DBSCAN(std::shared_ptr<kd_tree_t<T, DIM>> const& D, T eps, index_t minPts,
+    std::function<bool(index_t, index_t)> const* similarity) {
+    auto const& data = D->dataset;
+    auto const num_points = static_cast<index_t>(data.kdtree_get_point_count());
+    auto const snum_points = static_cast<std::int64_t>(num_points);
+    cluster_result_t clusters(num_points, static_cast<cluster_type_ut>(cluster_type::NOISE));
+    if (num_points == 0) {
+        return clusters;
+    }
+
+    nanoflann::SearchParams params;
+    params.sorted = false;
+
+    auto const count_neighbours = [similarity](index_t idx, search_res_t<T> const& res) -> index_t {
+        if (similarity == nullptr) {
+            return static_cast<index_t>(res.size());
+        }
+        return static_cast<index_t>(std::count_if(
+            res.cbegin(), res.cend(), [idx, similarity](auto const& el) { return (*similarity)(idx, el.first); }));
+    };
+
+    // 1. core point detection
+    std::vector<char> is_core(num_points, 0);
+#pragma omp parallel
+    {
+        search_res_t<T> tmp_res;
+        tmp_res.reserve(minPts);
+#pragma omp for schedule(dynamic, 1024)
+        for (std::int64_t sidx = 0; sidx < snum_points; ++sidx) {
+            auto const idx = static_cast<index_t>(sidx);
+            D->radiusSearch(data.get_position(idx), eps, tmp_res, params);
+            is_core[idx] = (count_neighbours(idx, tmp_res) >= minPts) ? 1 : 0;
+        }
+    }
+
+    // 2. merge core points, remember a core neighbour of the other points
+    concurrent_union_find sets(num_points);
+    auto constexpr no_core = std::numeric_limits<index_t>::max();
+    std::vector<index_t> border_of(num_points, no_core);
+#pragma omp parallel
+    {
+        search_res_t<T> tmp_res;
+        tmp_res.reserve(minPts);
+#pragma omp for schedule(dynamic, 1024)
+        for (std::int64_t sidx = 0; sidx < snum_points; ++sidx) {
+            auto const idx = static_cast<index_t>(sidx);
+            D->radiusSearch(data.get_position(idx), eps, tmp_res, params);
+            for (auto const& el : tmp_res) {
+                auto const n = el.first;
+                if ((n == idx) || (is_core[n] == 0)) {
+                    continue;
+                }
+                if ((similarity != nullptr) && !(*similarity)(idx, n)) {
+                    continue;
+                }
+                if (is_core[idx] != 0) {
+                    // every edge is seen from both ends, one union suffices
+                    if (n < idx) {
+                        sets.unite(idx, n);
+                    }
+                } else if (n < border_of[idx]) {
+                    border_of[idx] = n;
+                }
+            }
+        }
+    }
+
+    // 3. number the clusters and label all points
+    std::vector<index_t> cluster_of_root(num_points, 0);
+    index_t cluster_idx = static_cast<cluster_type_ut>(cluster_type::NOISE);
+    for (index_t idx = 0; idx < num_points; ++idx) {
+        if ((is_core[idx] != 0) && (sets.find(idx) == idx)) {
+            cluster_of_root[idx] = ++cluster_idx;
+        }
+    }
+#pragma omp parallel for
+    for (std::int64_t sidx = 0; sidx < snum_points; ++sidx) {
+        auto const idx = static_cast<index_t>(sidx);
+        if (is_core[idx] != 0) {
+            clusters[idx] = cluster_of_root[sets.find(idx)];
+        } else if (border_of[idx] != no_core) {
+            clusters[idx] = cluster_of_root[sets.find(border_of[idx])];
+        }
+    }
+
+    return clusters;
+}
+
+} // namespace detail
+
+
+/**
+ * Parallel variant of 'DBSCAN'. Border points reachable from several
+ * clusters may be assigned differently than by the serial version.
+ */
+template<typename T, int DIM>
+inline cluster_result_t DBSCAN_parallel(std::shared_ptr<kd_tree_t<T, DIM>> const& D, T eps, index_t minPts) {
+    return detail::parallel_DBSCAN(D, eps, minPts, nullptr);
+}
+
+
+/**
+ * Parallel variant of 'DBSCAN_with_similarity'. 'similarity' is called
+ * concurrently and must be thread-safe and symmetric.
+ */
+template<typename T, int DIM>
+inline cluster_result_t DBSCAN_parallel_with_similarity(std::shared_ptr<kd_tree_t<T, DIM>> const& D, T eps,
+    index_t minPts, std::function<bool(index_t, index_t)> const& similarity) {
+    return detail::parallel_DBSCAN(D, eps, minPts, &similarity);
+}
+
+
 } // namespace megamol::datatools::clustering
@@ -30,13 +30,14 @@ protected:
 
 private:
     bool isDirty() {
-        return _eps_slot.IsDirty() || _minpts_slot.IsDirty() || _icol_weight.IsDirty();
+        return _eps_slot.IsDirty() || _minpts_slot.IsDirty() || _icol_weight.IsDirty() || _parallel_slot.IsDirty();
     }
 
     void resetDirty() {
         _eps_slot.ResetDirty();
         _minpts_slot.ResetDirty();
         _icol_weight.ResetDirty();
+        _parallel_slot.ResetDirty();
     }
 
     core::param::ParamSlot _eps_slot;
@@ -45,6 +46,8 @@ private:
 
     core::param::ParamSlot _icol_weight;
 
+    core::param::ParamSlot _parallel_slot;
+
     std::vector<std::shared_ptr<genericPointcloud<float, 4>>> _points;
 
     std::vector<std::shared_ptr<kd_tree_t<float, 4>>> _kd_trees;
@@ -0,0 +1,359 @@
+/*
+ * ColumnarTableDataCall.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED
+#define MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED
+#pragma once
+
+#include "datatools/table/TableDataCall.h"
+#include "mmcore/AbstractGetDataCall.h"
+#include "mmcore/factories/CallAutoDescription.h"
+#include "vislib/macro_utils.h"
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+namespace table {
+
+/**
+ * Call for passing around tabular data stored column by column.
+ *
+ * In contrast to 'TableDataCall' every column is a separate consecutive
+ * array with its own element type, so scanning a column does not stride
+ * through whole rows and 64 bit integers or doubles keep their precision.
+ * Categorical columns are dictionary encoded: the cells hold 32 bit codes
+ * indexing into a per-column array of strings.
+ *
+ * The call never owns any data, the columns are views into memory of the
+ * providing module. Filtering modules can pass the columns of their input
+ * through unchanged and only provide a selection of rows, such that chains
+ * of filters do not copy the table.
+ */
+class ColumnarTableDataCall : public core::AbstractGetDataCall {
+public:
+    static const char* ClassName(void) {
+        return "ColumnarTableDataCall";
+    }
+    static const char* Description(void) {
+        return "Data of a table stored as typed columns";
+    }
+    static unsigned int FunctionCount(void) {
+        return 2;
+    }
+    static const char* FunctionName(unsigned int idx) {
+        switch (idx) {
+        case 0:
+            return "GetData";
+        case 1:
+            return "GetHash";
+        }
+        return nullptr;
+    }
+
+    /** The possible element types of the cells of a column */
+    enum class DataType { FLOAT, DOUBLE, INT32, INT64, DICTIONARY };
+
+    /**
+     * Non-owning view of one column.
+     */
+    class Column {
+    public:
+        Column(void);
+        Column(const Column& src) = default;
+        ~Column(void) = default;
+        Column& operator=(const Column& rhs) = default;
+
+        inline const std::string& Name(void) const {
+            return name;
+        }
+        inline DataType Type(void) const {
+            return type;
+        }
+        inline double MinimumValue(void) const {
+            return minVal;
+        }
+        inline double MaximumValue(void) const {
+            return maxVal;
+        }
+
+        /**
+         * Answer the semantics of the column as used by 'TableDataCall'.
+         * Dictionary encoded columns are categorical, all others are
+         * quantitative.
+         */
+        inline TableDataCall::ColumnType Semantic(void) const {
+            return (type == DataType::DICTIONARY) ? TableDataCall::ColumnType::CATEGORICAL
+                                                  : TableDataCall::ColumnType::QUANTITATIVE;
+        }
+
+        /**
+         * Answer the cells of the column. 'T' must match the element type,
+         * i.e. float, double, int32_t, int64_t or uint32_t (dictionary codes).
+         *
+         * @return Pointer to the first cell
+         */
+        template<class T>
+        inline const T* Values(void) const {
+            assert(isType<T>() && "Requested element type does not match the column");
+            return static_cast<const T*>(data);
+        }
+
+        /** Answer the raw pointer to the first cell */
+        inline const void* RawValues(void) const {
+            return data;
+        }
+
+        /** Answer the size of one cell in bytes */
+        size_t ElementSize(void) const;
+
+        /** Answer the number of entries of the dictionary */
+        inline size_t DictionarySize(void) const {
+            return dictSize;
+        }
+
+        /** Answer the string of a dictionary code */
+        inline const std::string& DictionaryEntry(uint32_t code) const {
+            assert(type == DataType::DICTIONARY);
+            assert(code < dictSize);
+            return dict[code];
+        }
+
+        /**
+         * Answer one cell converted to double. Dictionary encoded cells
+         * answer their code.
+         */
+        inline double GetAsDouble(size_t row) const {
+            switch (type) {
+            case DataType::FLOAT:
+                return static_cast<const float*>(data)[row];
+            case DataType::DOUBLE:
+                return static_cast<const double*>(data)[row];
+            case DataType::INT32:
+                return static_cast<const int32_t*>(data)[row];
+            case DataType::INT64:
+                return static_cast<double>(static_cast<const int64_t*>(data)[row]);
+            case DataType::DICTIONARY:
+                return static_cast<const uint32_t*>(data)[row];
+            }
+            return 0.0;
+        }
+
+        /**
+         * Converts a range of cells to float.
+         *
+         * @param first The first row to convert.
+         * @param cnt The number of rows to convert.
+         * @param dst Receives the values, separated by 'dstStride' floats.
+         * @param dstStride The distance of two values in 'dst' in floats.
+         */
+        void CopyAsFloat(size_t first, size_t cnt, float* dst, size_t dstStride = 1) const;
+
+        /**
+         * Converts arbitrary cells to float.
+         *
+         * @param rows The rows to convert.
+         * @param cnt The number of entries in 'rows'.
+         * @param dst Receives the values, separated by 'dstStride' floats.
+         * @param dstStride The distance of two values in 'dst' in floats.
+         */
+        void GatherAsFloat(const size_t* rows, size_t cnt, float* dst, size_t dstStride = 1) const;
+
+        /** Answer the 'TableDataCall' description of the column */
+        TableDataCall::ColumnInfo ToColumnInfo(void) const;
+
+        inline Column& SetName(const std::string& n) {
+            name = n;
+            return *this;
+        }
+        inline Column& SetMinimumValue(double v) {
+            minVal = v;
+            return *this;
+        }
+        inline Column& SetMaximumValue(double v) {
+            maxVal = v;
+            return *this;
+        }
+        inline Column& SetData(const float* d) {
+            return setData(DataType::FLOAT, d);
+        }
+        inline Column& SetData(const double* d) {
+            return setData(DataType::DOUBLE, d);
+        }
+        inline Column& SetData(const int32_t* d) {
+            return setData(DataType::INT32, d);
+        }
+        inline Column& SetData(const int64_t* d) {
+            return setData(DataType::INT64, d);
+        }
+
+        /**
+         * Sets dictionary encoded data.
+         *
+         * @param codes The codes of the cells.
+         * @param dictionary The strings referenced by the codes.
+         * @param dictionarySize The number of strings in 'dictionary'.
+         */
+        inline Column& SetData(const uint32_t* codes, const std::string* dictionary, size_t dictionarySize) {
+            dict = dictionary;
+            dictSize = dictionarySize;
+            return setData(DataType::DICTIONARY, codes);
+        }
+
+    private:
+        template<class T>
+        inline bool isType(void) const {
+            switch (type) {
+            case DataType::FLOAT:
+                return std::is_same<T, float>::value;
+            case DataType::DOUBLE:
+                return std::is_same<T, double>::value;
+            case DataType::INT32:
+                return std::is_same<T, int32_t>::value;
+            case DataType::INT64:
+                return std::is_same<T, int64_t>::value;
+            case DataType::DICTIONARY:
+                return std::is_same<T, uint32_t>::value;
+            }
+            return false;
+        }
+
+        inline Column& setData(DataType t, const void* d) {
+            type = t;
+            data = d;
+            if (t != DataType::DICTIONARY) {
+                dict = nullptr;
+                dictSize = 0;
+            }
+            return *this;
+        }
+
+        VISLIB_MSVC_SUPPRESS_WARNING(4251)
+        std::string name;
+        DataType type;
+        double minVal;
+        double maxVal;
+        const void* data;
+        const std::string* dict;
+        size_t dictSize;
+    };
+
+    ColumnarTableDataCall(void);
+    virtual ~ColumnarTableDataCall(void);
+
+    inline size_t GetColumnsCount(void) const {
+        return columns_count;
+    }
+
+    inline size_t GetRowsCount(void) const {
+        return rows_count;
+    }
+
+    inline const Column* GetColumns(void) const {
+        return columns;
+    }
+
+    inline const Column& GetColumn(size_t col) const {
+        assert(col < columns_count);
+        return columns[col];
+    }
+
+    /**
+     * Answer the index of the column with the given name.
+     *
+     * @return The index of the column or -1 if there is no such column
+     */
+    size_t FindColumn(const std::string& name) const;
+
+    /**
+     * Sets the columns. This removes any selection of rows.
+     */
+    inline void Set(size_t col_cnt, size_t row_cnt, const Column* cols) {
+        columns_count = col_cnt;
+        rows_count = row_cnt;
+        columns = cols;
+        selection = nullptr;
+        selection_count = 0;
+    }
+
+    /**
+     * Answer the indices of the selected rows in ascending order.
+     *
+     * @return The indices or nullptr if all rows are selected
+     */
+    inline const size_t* GetSelection(void) const {
+        return selection;
+    }
+
+    /** Answer the number of selected rows */
+    inline size_t GetSelectedRowsCount(void) const {
+        return (selection != nullptr) ? selection_count : rows_count;
+    }
+
+    /** Answer whether only a subset of the rows is selected */
+    inline bool HasSelection(void) const {
+        return selection != nullptr;
+    }
+
+    /**
+     * Restricts the table to a subset of its rows.
+     *
+     * @param indices The indices of the selected rows in ascending order or
+     *                nullptr to select all rows.
+     * @param cnt The number of entries in 'indices'.
+     */
+    inline void SetSelection(const size_t* indices, size_t cnt) {
+        selection = indices;
+        selection_count = (indices != nullptr) ? cnt : 0;
+    }
+
+    /**
+     * Produces the row-major layout of 'TableDataCall' from the selected
+     * rows. Dictionary encoded cells are stored as their code, as done by
+     * the data sources of 'TableDataCall'.
+     *
+     * @param outInfos Receives the column infos.
+     * @param outData Receives the cells in row-major order.
+     */
+    void MaterializeRowMajor(std::vector<TableDataCall::ColumnInfo>& outInfos, std::vector<float>& outData) const;
+
+    inline void SetFrameCount(const unsigned int frameCount) {
+        this->frameCount = frameCount;
+    }
+
+    inline unsigned int GetFrameCount(void) const {
+        return this->frameCount;
+    }
+
+    inline void SetFrameID(const unsigned int frameID) {
+        this->frameID = frameID;
+    }
+
+    inline unsigned int GetFrameID(void) const {
+        return this->frameID;
+    }
+
+private:
+    size_t columns_count;
+    size_t rows_count;
+    const Column* columns;
+    const size_t* selection;
+    size_t selection_count;
+    unsigned int frameCount;
+    unsigned int frameID;
+};
+
+typedef core::factories::CallAutoDescription<ColumnarTableDataCall> ColumnarTableDataCallDescription;
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED */
@@ -0,0 +1,291 @@
+/*
+ * TablePredicate.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLEPREDICATE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLEPREDICATE_H_INCLUDED
+#pragma once
+
+#include "datatools/table/ColumnarTableDataCall.h"
+#include "datatools/table/TableDataCall.h"
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+namespace table {
+
+/**
+ * Bitmap of the selected rows of a table. Bit 'i % 64' of word 'i / 64'
+ * represents row 'i'; the bits beyond the last row are always zero.
+ */
+class TableSelection {
+public:
+    /** Ctor. */
+    TableSelection(void);
+
+    /**
+     * Ctor.
+     *
+     * @param rowCnt The number of rows of the table.
+     * @param selected The initial state of all rows.
+     */
+    TableSelection(size_t rowCnt, bool selected);
+
+    /**
+     * Creates a selection from a list of row indices.
+     *
+     * @param indices The indices of the selected rows.
+     * @param cnt The number of entries in 'indices'.
+     * @param rowCnt The number of rows of the table.
+     */
+    static TableSelection FromIndices(const size_t* indices, size_t cnt, size_t rowCnt);
+
+    /** Answer the number of selected rows */
+    size_t Count(void) const;
+
+    /** Answer whether a row is selected */
+    inline bool IsSelected(size_t row) const {
+        assert(row < rowsCount);
+        return ((words[row / 64] >> (row % 64)) & 1) != 0;
+    }
+
+    /**
+     * Resets the selection.
+     *
+     * @param rowCnt The number of rows of the table.
+     * @param selected The new state of all rows.
+     */
+    void Resize(size_t rowCnt, bool selected);
+
+    /** Answer the number of rows of the table */
+    inline size_t RowsCount(void) const {
+        return rowsCount;
+    }
+
+    /** Changes the state of one row */
+    inline void Select(size_t row, bool selected) {
+        assert(row < rowsCount);
+        const uint64_t bit = uint64_t(1) << (row % 64);
+        if (selected) {
+            words[row / 64] |= bit;
+        } else {
+            words[row / 64] &= ~bit;
+        }
+    }
+
+    /**
+     * Writes the indices of the selected rows in ascending order.
+     *
+     * @param outIndices Receives the indices.
+     */
+    void ToIndices(std::vector<size_t>& outIndices) const;
+
+    /** Answer the words of the bitmap */
+    inline uint64_t* Words(void) {
+        return words.data();
+    }
+
+    /** Answer the words of the bitmap */
+    inline const uint64_t* Words(void) const {
+        return words.data();
+    }
+
+    /** Answer the number of words of the bitmap */
+    inline size_t WordsCount(void) const {
+        return words.size();
+    }
+
+    /** Intersects with another selection of the same table */
+    TableSelection& operator&=(const TableSelection& rhs);
+
+    /** Unites with another selection of the same table */
+    TableSelection& operator|=(const TableSelection& rhs);
+
+private:
+    /** The number of rows */
+    size_t rowsCount;
+
+    /** The bitmap */
+    std::vector<uint64_t> words;
+};
+
+
+/**
+ * Predicate selecting rows of a table by comparing cells against constants.
+ *
+ * The predicate is a list of comparisons which are combined by AND and OR,
+ * AND taking precedence over OR. All comparisons are evaluated in a single
+ * parallel pass over blocks of rows, each comparison producing 64 rows of
+ * the selection bitmap at once.
+ *
+ * The textual form is e.g. 'x > 0.5 && y <= 3 || type == "fluid"'. Column
+ * names containing special characters are enclosed in single quotes, string
+ * constants (only for dictionary encoded columns) in double quotes. The
+ * connectives may also be written as 'and' and 'or'.
+ */
+class TablePredicate {
+public:
+    /** The comparison operators */
+    enum class Operator { LESS, LESS_OR_EQUAL, EQUAL, GREATER_OR_EQUAL, GREATER, NOT_EQUAL };
+
+    /** The connectives of a comparison with the preceding one */
+    enum class Connective { AND, OR };
+
+    /** Ctor. */
+    TablePredicate(void);
+
+    /**
+     * Appends a comparison with a number.
+     *
+     * @param column The name of the column.
+     * @param op The comparison operator.
+     * @param reference The value to compare to.
+     * @param connective The connective with the preceding comparison.
+     */
+    void Add(const std::string& column, Operator op, double reference, Connective connective = Connective::AND);
+
+    /**
+     * Appends a comparison with an entry of the dictionary of a dictionary
+     * encoded column.
+     *
+     * @param column The name of the column.
+     * @param op The comparison operator, must be EQUAL or NOT_EQUAL.
+     * @param reference The dictionary entry to compare to.
+     * @param connective The connective with the preceding comparison.
+     */
+    void Add(
+        const std::string& column, Operator op, const std::string& reference, Connective connective = Connective::AND);
+
+    /** Removes all comparisons */
+    void Clear(void);
+
+    /**
+     * Evaluates the predicate on a row-major table.
+     *
+     * @param infos The column infos of the table.
+     * @param colCnt The number of columns.
+     * @param data The cells of the table.
+     * @param rowCnt The number of rows.
+     * @param outSelection Receives the selected rows.
+     *
+     * @return 'true' on success, 'false' if a column does not exist or a
+     *         comparison cannot be applied to it.
+     */
+    bool Evaluate(const TableDataCall::ColumnInfo* infos, size_t colCnt, const float* data, size_t rowCnt,
+        TableSelection& outSelection) const;
+
+    /**
+     * Evaluates the predicate on all rows of a columnar table, ignoring its
+     * selection.
+     *
+     * @param table The call holding the table.
+     * @param outSelection Receives the selected rows.
+     *
+     * @return 'true' on success, 'false' if a column does not exist or a
+     *         comparison cannot be applied to it.
+     */
+    bool Evaluate(const ColumnarTableDataCall& table, TableSelection& outSelection) const;
+
+    /**
+     * Answers whether any row of a block of a row-major float table may
+     * satisfy the predicate, given the value ranges of the cells of each
+     * column in the block. Used to skip blocks by their statistics.
+     *
+     * @param infos The column infos of the table.
+     * @param colCnt The number of columns.
+     * @param minimums The smallest value of each column in the block,
+     *                 ignoring NaN.
+     * @param maximums The largest value of each column in the block,
+     *                 ignoring NaN. A column without any number has a
+     *                 maximum below its minimum.
+     *
+     * @return 'false' only if no row of the block can be selected. Unknown
+     *         columns and string comparisons never rule out a block.
+     */
+    bool MayMatch(
+        const TableDataCall::ColumnInfo* infos, size_t colCnt, const float* minimums, const float* maximums) const;
+
+    /**
+     * Answer the names of the columns the comparisons refer to, each one
+     * once.
+     *
+     * @param outColumns Receives the names.
+     */
+    void Columns(std::vector<std::string>& outColumns) const;
+
+    /** Answer whether there are no comparisons */
+    inline bool IsEmpty(void) const {
+        return clauses.empty();
+    }
+
+    /**
+     * Parses the textual form of a predicate, replacing all comparisons.
+     *
+     * @param expression The textual form.
+     * @param outError Receives a description of the error if the expression
+     *                 is invalid.
+     *
+     * @return 'true' on success, 'false' otherwise.
+     */
+    bool Parse(const std::string& expression, std::string& outError);
+
+    /** Answer the tolerance of (in-) equality tests */
+    inline double Epsilon(void) const {
+        return epsilon;
+    }
+
+    /** Sets the tolerance of (in-) equality tests */
+    inline void SetEpsilon(double e) {
+        epsilon = e;
+    }
+
+private:
+    /** One comparison */
+    struct Clause {
+        std::string column;
+        Operator op;
+        double reference;
+        /** The reference if it is an integer, which INT64 cells are compared to exactly */
+        int64_t integer;
+        bool isInteger;
+        std::string text;
+        bool isText;
+        Connective connective;
+    };
+
+    /** A comparison bound to the cells it is applied to */
+    struct BoundClause {
+        const void* data;
+        size_t stride;
+        ColumnarTableDataCall::DataType type;
+        Operator op;
+        double reference;
+        int64_t integer;
+        bool isInteger;
+        double epsilon;
+        bool constant;
+        bool constantValue;
+        bool startsGroup;
+    };
+
+    /** Evaluates bound comparisons into 'outSelection' */
+    void evaluate(const std::vector<BoundClause>& bound, size_t rowCnt, TableSelection& outSelection) const;
+
+    /** The comparisons */
+    std::vector<Clause> clauses;
+
+    /** The tolerance of (in-) equality tests */
+    double epsilon;
+};
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_TABLEPREDICATE_H_INCLUDED */
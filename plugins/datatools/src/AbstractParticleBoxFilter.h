@@ -177,19 +177,17 @@ bool AbstractParticleBoxFilter<T>::manipulateData(T& outData, T& inData) {
         auto& cur_numPts = numPts_[plidx];
         auto& cur_stride = stride_[plidx];
 
-        auto const& store = part.GetParticleStore();
-        auto const& xacc = store.GetXAcc();
-        auto const& yacc = store.GetYAcc();
-        auto const& zacc = store.GetZAcc();
-
-        for (size_t pidx = 0; pidx < pcount; ++pidx) {
-            // check for each particle whether it is contained within the box
-            vislib::math::Point<float, 3> pt(xacc->Get_f(pidx), yacc->Get_f(pidx), zacc->Get_f(pidx));
-            if (box.Contains(pt, true)) {
-                std::copy(base_ptr + pidx * stride, base_ptr + (pidx + 1) * stride, cur_data_ptr + cur_numPts * stride);
-                ++cur_numPts;
+        part.GetParticleStore().VisitVertices([&](auto const& xacc, auto const& yacc, auto const& zacc, auto const&) {
+            for (size_t pidx = 0; pidx < pcount; ++pidx) {
+                // check for each particle whether it is contained within the box
+                vislib::math::Point<float, 3> pt(xacc.Get_f(pidx), yacc.Get_f(pidx), zacc.Get_f(pidx));
+                if (box.Contains(pt, true)) {
+                    std::copy(
+                        base_ptr + pidx * stride, base_ptr + (pidx + 1) * stride, cur_data_ptr + cur_numPts * stride);
+                    ++cur_numPts;
+                }
             }
-        }
+        });
 
         data_[plidx].resize(cur_numPts * stride);
         cur_stride = stride;
@@ -37,6 +37,9 @@ datatools::AbstractVolumeManipulator::AbstractVolumeManipulator(const char* outS
     this->outDataSlot.SetCallback(megamol::geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &AbstractVolumeManipulator::tryGetDataCallback);
+    this->outDataSlot.SetCallback(megamol::geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &AbstractVolumeManipulator::getBricksCallback);
     this->MakeSlotAvailable(&this->outDataSlot);
 
     this->inDataSlot.SetCompatibleCall<geocalls::VolumetricDataCallDescription>();
@@ -241,3 +244,7 @@ bool datatools::AbstractVolumeManipulator::tryGetDataCallback(megamol::core::Cal
 
     return true;
 }
+
+bool datatools::AbstractVolumeManipulator::getBricksCallback(megamol::core::Call& c) {
+    return false;
+}
@@ -31,17 +31,15 @@ bool megamol::datatools::ColorToDir::manipulateData(
                 auto& data = data_[pl_idx];
                 auto const p_count = parts.GetCount();
 
-                auto const dx_acc = parts.GetParticleStore().GetCRAcc();
-                auto const dy_acc = parts.GetParticleStore().GetCGAcc();
-                auto const dz_acc = parts.GetParticleStore().GetCBAcc();
-
                 data.resize(3 * p_count);
 
-                for (std::remove_cv_t<decltype(p_count)> p_idx = 0; p_idx < p_count; ++p_idx) {
-                    data[p_idx * 3 + 0] = dx_acc->Get_f(p_idx);
-                    data[p_idx * 3 + 1] = dy_acc->Get_f(p_idx);
-                    data[p_idx * 3 + 2] = dz_acc->Get_f(p_idx);
-                }
+                parts.GetParticleStore().VisitColors([&](auto const& dx, auto const& dy, auto const& dz, auto const&) {
+                    for (std::remove_cv_t<decltype(p_count)> p_idx = 0; p_idx < p_count; ++p_idx) {
+                        data[p_idx * 3 + 0] = dx.Get_f(p_idx);
+                        data[p_idx * 3 + 1] = dy.Get_f(p_idx);
+                        data[p_idx * 3 + 2] = dz.Get_f(p_idx);
+                    }
+                });
 
                 parts.SetDirData(geocalls::SimpleSphericalParticles::DIRDATA_FLOAT_XYZ, data.data());
             }
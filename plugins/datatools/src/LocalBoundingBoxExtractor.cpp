@@ -257,14 +257,21 @@ void LocalBoundingBoxExtractor::calcLocalBox(
     if (!(parts.GetCount() > 0))
         return;
 
-    for (int i = 0; i < parts.GetCount(); i++) {
-        box.SetLeft(std::min(box.GetLeft(), parts.GetParticleStore().GetXAcc()->Get_f(i)));
-        box.SetRight(std::max(box.GetRight(), parts.GetParticleStore().GetXAcc()->Get_f(i)));
-        box.SetBottom(std::min(box.GetBottom(), parts.GetParticleStore().GetYAcc()->Get_f(i)));
-        box.SetTop(std::max(box.GetTop(), parts.GetParticleStore().GetYAcc()->Get_f(i)));
-        box.SetFront(std::min(box.GetFront(), parts.GetParticleStore().GetZAcc()->Get_f(i)));
-        box.SetBack(std::max(box.GetBack(), parts.GetParticleStore().GetZAcc()->Get_f(i)));
-    }
+    auto const count = parts.GetCount();
+    parts.GetParticleStore().VisitVertices([&box, count](auto const& x, auto const& y, auto const& z, auto const&) {
+        float left = box.GetLeft(), right = box.GetRight();
+        float bottom = box.GetBottom(), top = box.GetTop();
+        float front = box.GetFront(), back = box.GetBack();
+        for (uint64_t i = 0; i < count; i++) {
+            left = std::min(left, x.Get_f(i));
+            right = std::max(right, x.Get_f(i));
+            bottom = std::min(bottom, y.Get_f(i));
+            top = std::max(top, y.Get_f(i));
+            front = std::min(front, z.Get_f(i));
+            back = std::max(back, z.Get_f(i));
+        }
+        box.Set(left, bottom, back, right, top, front);
+    });
 }
 
 } // namespace datatools
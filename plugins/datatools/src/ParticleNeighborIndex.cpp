@@ -0,0 +1,325 @@
+/*
+ * ParticleNeighborIndex.cpp
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+
+#include "ParticleNeighborIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <omp.h>
+
+using namespace megamol;
+
+
+datatools::ParticleNeighborIndex::ParticleNeighborIndex(void)
+        : positions()
+        , particleCnt(0)
+        , points()
+        , ghostOrigin()
+        , box()
+        , cyclic({false, false, false})
+        , margin(-1.0f)
+        , tree(nullptr) {
+    this->points.pos = &this->positions;
+}
+
+
+void datatools::ParticleNeighborIndex::setData(geocalls::MultiParticleDataCall& dat) {
+    using geocalls::SimpleSphericalParticles;
+
+    this->tree.reset();
+    this->margin = -1.0f;
+    this->ghostOrigin.clear();
+    this->positions.clear();
+
+    for (unsigned int pli = 0; pli < dat.GetParticleListCount(); ++pli) {
+        auto& pl = dat.AccessParticles(pli);
+        unsigned int vert_stride = 0;
+        if (pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZ) {
+            vert_stride = 12;
+        } else if (pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR) {
+            vert_stride = 16;
+        } else {
+            continue;
+        }
+        vert_stride = std::max<unsigned int>(vert_stride, pl.GetVertexDataStride());
+        const unsigned char* vert = static_cast<const unsigned char*>(pl.GetVertexData());
+
+        auto const offset = this->positions.size();
+        this->positions.resize(offset + 3 * pl.GetCount());
+        for (UINT64 i = 0; i < pl.GetCount(); ++i) {
+            const float* v = reinterpret_cast<const float*>(vert + i * vert_stride);
+            std::copy(v, v + 3, this->positions.begin() + offset + 3 * i);
+        }
+    }
+    this->particleCnt = this->positions.size() / 3;
+}
+
+
+void datatools::ParticleNeighborIndex::setBoundaries(
+    vislib::math::Cuboid<float> const& box, bool cyclX, bool cyclY, bool cyclZ) {
+    bool const changed = box.Left() != this->box.Left() || box.Bottom() != this->box.Bottom() ||
+                         box.Back() != this->box.Back() || box.Right() != this->box.Right() ||
+                         box.Top() != this->box.Top() || box.Front() != this->box.Front() ||
+                         cyclX != this->cyclic[0] || cyclY != this->cyclic[1] || cyclZ != this->cyclic[2];
+    if (changed) {
+        this->box = box;
+        this->cyclic = {cyclX, cyclY, cyclZ};
+        this->tree.reset();
+        this->margin = -1.0f;
+    }
+}
+
+
+void datatools::ParticleNeighborIndex::radiusSearch(
+    float const* pos, float radius, std::vector<std::pair<size_t, float>>& matches) {
+    matches.clear();
+    if (this->particleCnt == 0)
+        return;
+    this->assertTree(radius);
+    std::vector<std::pair<size_t, float>> tmp;
+    this->radiusQuery(pos, radius * radius, tmp, matches);
+}
+
+
+void datatools::ParticleNeighborIndex::knnSearch(
+    float const* pos, size_t k, std::vector<std::pair<size_t, float>>& matches) {
+    matches.clear();
+    if (this->particleCnt == 0 || k == 0)
+        return;
+    this->assertTree(this->estimateKnnMargin(k));
+    std::vector<size_t> idxTmp;
+    std::vector<float> distTmp;
+    this->knnQuery(pos, k, idxTmp, distTmp, matches);
+
+    // a closer periodic image might be missing if the farthest neighbor is beyond the ghost margin
+    if (this->anyCyclic() && !matches.empty() && this->margin < this->maxMargin() &&
+        std::sqrt(matches.back().second) > this->margin) {
+        this->assertTree(1.01f * std::sqrt(matches.back().second));
+        this->knnQuery(pos, k, idxTmp, distTmp, matches);
+    }
+}
+
+
+void datatools::ParticleNeighborIndex::radiusLists(float radius, NeighborLists& lists) {
+    if (this->particleCnt == 0) {
+        lists = NeighborLists();
+        lists.offsets.assign(this->particleCnt + 1, 0);
+        return;
+    }
+    this->assertTree(radius);
+    this->computeLists(false, 0, radius * radius, lists);
+}
+
+
+void datatools::ParticleNeighborIndex::knnLists(size_t k, NeighborLists& lists) {
+    if (this->particleCnt == 0 || k == 0) {
+        lists = NeighborLists();
+        lists.offsets.assign(this->particleCnt + 1, 0);
+        return;
+    }
+    this->assertTree(this->estimateKnnMargin(k));
+    auto const maxDist = this->computeLists(true, k, 0.0f, lists);
+
+    // a single rebuild suffices: more ghosts can only make the neighbors closer
+    if (this->anyCyclic() && this->margin < this->maxMargin() && maxDist > this->margin) {
+        this->assertTree(1.01f * maxDist);
+        this->computeLists(true, k, 0.0f, lists);
+    }
+}
+
+
+void datatools::ParticleNeighborIndex::assertTree(float margin) {
+    margin = this->anyCyclic() ? std::min(margin, this->maxMargin()) : 0.0f;
+    if (this->tree != nullptr && this->margin >= margin) {
+        return;
+    }
+
+    std::array<float, 3> const lo = {this->box.Left(), this->box.Bottom(), this->box.Back()};
+    std::array<float, 3> const hi = {this->box.Right(), this->box.Top(), this->box.Front()};
+    std::array<float, 3> const size = {this->box.Width(), this->box.Height(), this->box.Depth()};
+
+    this->positions.resize(3 * this->particleCnt);
+    this->ghostOrigin.clear();
+    if (this->anyCyclic()) {
+        for (size_t i = 0; i < this->particleCnt; ++i) {
+            float const p[3] = {this->positions[3 * i], this->positions[3 * i + 1], this->positions[3 * i + 2]};
+
+            // shifts per dimension, the first one is always 0
+            std::array<std::array<float, 3>, 3> shifts;
+            std::array<int, 3> shiftCnt;
+            for (int d = 0; d < 3; ++d) {
+                shifts[d][0] = 0.0f;
+                shiftCnt[d] = 1;
+                if (!this->cyclic[d])
+                    continue;
+                if (p[d] < lo[d] + margin)
+                    shifts[d][shiftCnt[d]++] = size[d];
+                if (p[d] > hi[d] - margin)
+                    shifts[d][shiftCnt[d]++] = -size[d];
+            }
+
+            for (int x = 0; x < shiftCnt[0]; ++x) {
+                for (int y = 0; y < shiftCnt[1]; ++y) {
+                    for (int z = 0; z < shiftCnt[2]; ++z) {
+                        if (x == 0 && y == 0 && z == 0)
+                            continue;
+                        this->positions.push_back(p[0] + shifts[0][x]);
+                        this->positions.push_back(p[1] + shifts[1][y]);
+                        this->positions.push_back(p[2] + shifts[2][z]);
+                        this->ghostOrigin.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+
+    this->tree = std::make_unique<tree_t>(
+        3 /* dim */, this->points, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
+    this->tree->buildIndex();
+    this->margin = margin;
+}
+
+
+float datatools::ParticleNeighborIndex::estimateKnnMargin(size_t k) const {
+    double const volume = static_cast<double>(this->box.Width()) * this->box.Height() * this->box.Depth();
+    if (this->particleCnt == 0 || !(volume > 0.0)) {
+        return this->maxMargin();
+    }
+    // twice the radius of a sphere that contains k particles on average
+    auto const radius = std::cbrt(3.0 * k * volume / (4.0 * M_PI * this->particleCnt));
+    return static_cast<float>(2.0 * radius);
+}
+
+
+float datatools::ParticleNeighborIndex::maxMargin(void) const {
+    float res = 0.0f;
+    if (this->cyclic[0])
+        res = std::max(res, this->box.Width());
+    if (this->cyclic[1])
+        res = std::max(res, this->box.Height());
+    if (this->cyclic[2])
+        res = std::max(res, this->box.Depth());
+    return res;
+}
+
+
+void datatools::ParticleNeighborIndex::radiusQuery(float const* pos, float sqRadius,
+    std::vector<std::pair<size_t, float>>& tmp, std::vector<std::pair<size_t, float>>& matches) const {
+    nanoflann::SearchParams params;
+    params.sorted = false;
+    // the criterion is < radius, like nanoflann
+    this->tree->radiusSearch(pos, sqRadius, tmp, params);
+    matches.assign(tmp.begin(), tmp.end());
+    this->reduceMatches(matches);
+}
+
+
+void datatools::ParticleNeighborIndex::knnQuery(float const* pos, size_t k, std::vector<size_t>& idxTmp,
+    std::vector<float>& distTmp, std::vector<std::pair<size_t, float>>& matches) const {
+    auto const treeCnt = this->positions.size() / 3;
+    auto kk = std::min(k, treeCnt);
+    nanoflann::SearchParams params;
+    params.sorted = false;
+    while (true) {
+        idxTmp.resize(kk);
+        distTmp.resize(kk);
+        nanoflann::KNNResultSet<float> resultSet(kk);
+        resultSet.init(idxTmp.data(), distTmp.data());
+        this->tree->findNeighbors(resultSet, pos, params);
+
+        matches.clear();
+        for (size_t i = 0; i < resultSet.size(); ++i) {
+            matches.emplace_back(idxTmp[i], distTmp[i]);
+        }
+        this->reduceMatches(matches);
+
+        // images of the same particle may take several places if the box is small
+        if (matches.size() >= k || kk >= treeCnt)
+            break;
+        kk = std::min(2 * kk, treeCnt);
+    }
+    if (matches.size() > k) {
+        matches.resize(k);
+    }
+}
+
+
+void datatools::ParticleNeighborIndex::reduceMatches(std::vector<std::pair<size_t, float>>& matches) const {
+    if (!this->ghostOrigin.empty()) {
+        for (auto& m : matches) {
+            if (m.first >= this->particleCnt) {
+                m.first = this->ghostOrigin[m.first - this->particleCnt];
+            }
+        }
+        std::sort(matches.begin(), matches.end());
+        matches.erase(std::unique(matches.begin(), matches.end(),
+                          [](std::pair<size_t, float> const& l, std::pair<size_t, float> const& r) {
+                              return l.first == r.first;
+                          }),
+            matches.end());
+    }
+    std::sort(matches.begin(), matches.end(), [](std::pair<size_t, float> const& l, std::pair<size_t, float> const& r) {
+        return l.second < r.second || (l.second == r.second && l.first < r.first);
+    });
+}
+
+
+float datatools::ParticleNeighborIndex::computeLists(bool knn, size_t k, float sqRadius, NeighborLists& lists) const {
+    auto const cnt = static_cast<int64_t>(this->particleCnt);
+    lists.offsets.assign(this->particleCnt + 1, 0);
+    float maxSqDist = 0.0f;
+
+#pragma omp parallel
+    {
+        // contiguous ranges per thread, so the local results can be copied into place afterwards
+        int64_t const threads = omp_get_num_threads();
+        int64_t const thread = omp_get_thread_num();
+        int64_t const begin = cnt * thread / threads;
+        int64_t const end = cnt * (thread + 1) / threads;
+
+        std::vector<index_t> locIndices;
+        std::vector<float> locSqDistances;
+        std::vector<std::pair<size_t, float>> matches;
+        std::vector<std::pair<size_t, float>> tmp;
+        std::vector<size_t> idxTmp;
+        std::vector<float> distTmp;
+        float locMaxSqDist = 0.0f;
+
+        for (int64_t i = begin; i < end; ++i) {
+            if (knn) {
+                this->knnQuery(this->position(i), k, idxTmp, distTmp, matches);
+            } else {
+                this->radiusQuery(this->position(i), sqRadius, tmp, matches);
+            }
+            for (auto const& m : matches) {
+                locIndices.push_back(static_cast<index_t>(m.first));
+                locSqDistances.push_back(m.second);
+            }
+            lists.offsets[i + 1] = matches.size();
+            if (!matches.empty()) {
+                locMaxSqDist = std::max(locMaxSqDist, matches.back().second);
+            }
+        }
+
+#pragma omp critical
+        maxSqDist = std::max(maxSqDist, locMaxSqDist);
+
+#pragma omp barrier
+#pragma omp single
+        {
+            std::partial_sum(lists.offsets.cbegin(), lists.offsets.cend(), lists.offsets.begin());
+            lists.indices.resize(lists.offsets.back());
+            lists.sqDistances.resize(lists.offsets.back());
+        }
+
+        std::copy(locIndices.cbegin(), locIndices.cend(), lists.indices.begin() + lists.offsets[begin]);
+        std::copy(locSqDistances.cbegin(), locSqDistances.cend(), lists.sqDistances.begin() + lists.offsets[begin]);
+    }
+
+    return std::sqrt(maxSqDist);
+}
@@ -0,0 +1,158 @@
+/*
+ * ParticleNeighborIndex.h
+ *
+ * Copyright (C) 2021 by MegaMol team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include "geometry_calls/MultiParticleDataCall.h"
+#include "vislib/math/Cuboid.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <nanoflann.hpp>
+#include <utility>
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+
+/**
+ * Persistent kd-tree over all particles with float positions of a MultiParticleDataCall.
+ *
+ * Cyclic boundary conditions are handled by ghost particles: every particle closer than a margin to a cyclic face of
+ * the bounding box is added once more, shifted by the box size. A single query then finds all periodic images within
+ * the margin, instead of querying up to eight shifted positions. The margin grows (and the tree is rebuilt) only when
+ * a query needs more than the current one.
+ *
+ * The positions are copied, so the data call does not need to stay locked.
+ */
+class ParticleNeighborIndex {
+public:
+    typedef uint32_t index_t;
+
+    /** Neighbor lists of all particles in CSR layout, every list sorted by distance */
+    struct NeighborLists {
+        std::vector<uint64_t> offsets;
+        std::vector<index_t> indices;
+        std::vector<float> sqDistances;
+    };
+
+    ParticleNeighborIndex(void);
+
+    ParticleNeighborIndex(ParticleNeighborIndex const&) = delete;
+    ParticleNeighborIndex& operator=(ParticleNeighborIndex const&) = delete;
+
+    /**
+     * Copies the positions of all lists with float positions. The tree is rebuilt on the next query.
+     */
+    void setData(geocalls::MultiParticleDataCall& dat);
+
+    /**
+     * Sets the box and the dimensions with cyclic boundary conditions. The tree is rebuilt on the next query if
+     * anything changed.
+     */
+    void setBoundaries(vislib::math::Cuboid<float> const& box, bool cyclX, bool cyclY, bool cyclZ);
+
+    /** Number of particles (without ghosts) */
+    inline size_t count(void) const {
+        return this->particleCnt;
+    }
+
+    inline float const* position(size_t idx) const {
+        return this->positions.data() + 3 * idx;
+    }
+
+    /**
+     * Finds all particles closer than 'radius' to 'pos', considering all periodic images.
+     *
+     * @param matches Receives pairs of particle index and squared distance, sorted by distance.
+     */
+    void radiusSearch(float const* pos, float radius, std::vector<std::pair<size_t, float>>& matches);
+
+    /**
+     * Finds the 'k' nearest particles of 'pos', considering all periodic images.
+     *
+     * @param matches Receives pairs of particle index and squared distance, sorted by distance.
+     */
+    void knnSearch(float const* pos, size_t k, std::vector<std::pair<size_t, float>>& matches);
+
+    /** Computes the neighbors within 'radius' of all particles in parallel */
+    void radiusLists(float radius, NeighborLists& lists);
+
+    /** Computes the 'k' nearest neighbors of all particles in parallel */
+    void knnLists(size_t k, NeighborLists& lists);
+
+private:
+    /** nanoflann adaptor for the particles followed by the ghosts */
+    struct Points {
+        std::vector<float> const* pos;
+
+        inline size_t kdtree_get_point_count() const {
+            return pos->size() / 3;
+        }
+        inline float kdtree_get_pt(const size_t idx, int dim) const {
+            return (*pos)[3 * idx + dim];
+        }
+        template<class BBOX>
+        bool kdtree_get_bbox(BBOX&) const {
+            return false;
+        }
+    };
+
+    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, Points>, Points, 3 /* dim */>
+        tree_t;
+
+    /** Rebuilds the tree if it is missing or its ghost margin is smaller than 'margin' */
+    void assertTree(float margin);
+
+    /** Margin that most likely covers the k nearest neighbors of all particles, from the mean density */
+    float estimateKnnMargin(size_t k) const;
+
+    /** Largest margin that is meaningful for the cyclic dimensions */
+    float maxMargin(void) const;
+
+    void radiusQuery(float const* pos, float sqRadius, std::vector<std::pair<size_t, float>>& tmp,
+        std::vector<std::pair<size_t, float>>& matches) const;
+
+    void knnQuery(float const* pos, size_t k, std::vector<size_t>& idxTmp, std::vector<float>& distTmp,
+        std::vector<std::pair<size_t, float>>& matches) const;
+
+    /** Maps ghosts to their particles and keeps the closest image of every particle, sorted by distance */
+    void reduceMatches(std::vector<std::pair<size_t, float>>& matches) const;
+
+    /**
+     * Computes the lists of all particles, either the 'k' nearest neighbors or those closer than sqrt('sqRadius').
+     *
+     * @return The largest neighbor distance found.
+     */
+    float computeLists(bool knn, size_t k, float sqRadius, NeighborLists& lists) const;
+
+    inline bool anyCyclic(void) const {
+        return this->cyclic[0] || this->cyclic[1] || this->cyclic[2];
+    }
+
+    /** Positions of the particles followed by the ghosts */
+    std::vector<float> positions;
+
+    /** Number of particles without ghosts */
+    size_t particleCnt;
+
+    Points points;
+
+    /** Particle of every ghost */
+    std::vector<size_t> ghostOrigin;
+
+    vislib::math::Cuboid<float> box;
+    std::array<bool, 3> cyclic;
+
+    /** Ghost margin of the current tree, negative if there is no tree */
+    float margin;
+
+    std::unique_ptr<tree_t> tree;
+};
+
+} /* end namespace datatools */
+} /* end namespace megamol */
@@ -5,6 +5,7 @@
  * Alle Rechte vorbehalten.
  */
 #include "ParticleNeighborhood.h"
+#include "datatools/ParticleNeighborsCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
@@ -30,14 +31,23 @@ datatools::ParticleNeighborhood::ParticleNeighborhood(void)
         , searchTypeSlot("searchType", "num of neighbors or radius")
         , particleNumberSlot("idx", "the particle to track")
         , outDataSlot("outData", "Provides colors based on local particle temperature")
+        , outNeighborsSlot(
+              "outNeighbors", "Provides the neighbor lists of all particles with the cyclic boundaries of cyclX/Y/Z")
         , inDataSlot("inData", "Takes the directional particle data")
         , datahash(0)
         , lastTime(-1)
         , newColors()
         , maxDist(0)
-        , allParts()
-        , particleTree(nullptr)
-        , myPts(nullptr) {
+        , index()
+        , indexVersion(0)
+        , colorsVersion(0)
+        , lists()
+        , listsVersion(0)
+        , listsType(-1)
+        , listsRadius(0.0f)
+        , listsCount(0)
+        , listsCyclic({false, false, false})
+        , listsHash(0) {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -69,6 +79,12 @@ datatools::ParticleNeighborhood::ParticleNeighborhood(void)
         geocalls::MultiParticleDataCall::ClassName(), "GetExtent", &ParticleNeighborhood::getExtentCallback);
     this->MakeSlotAvailable(&this->outDataSlot);
 
+    this->outNeighborsSlot.SetCallback(
+        ParticleNeighborsCall::ClassName(), "GetData", &ParticleNeighborhood::getNeighborsCallback);
+    this->outNeighborsSlot.SetCallback(
+        ParticleNeighborsCall::ClassName(), "GetExtent", &ParticleNeighborhood::getNeighborsExtentCallback);
+    this->MakeSlotAvailable(&this->outNeighborsSlot);
+
     this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
 }
@@ -118,6 +134,24 @@ UINT64 getListCount(megamol::core::AbstractGetData3DCall* c, unsigned int i) {
     return 0;
 }
 
+bool datatools::ParticleNeighborhood::assertIndex(geocalls::MultiParticleDataCall* in, unsigned int time) {
+    if (this->lastTime != time || this->datahash != in->DataHash()) {
+        in->SetFrameID(time, true);
+
+        if (!(*in)(0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "ParticleNeighborhood: could not get frame (%u)", time);
+            return false;
+        }
+
+        this->index.setData(*in);
+        ++this->indexVersion;
+        this->datahash = in->DataHash();
+        this->lastTime = time;
+    }
+    return true;
+}
+
 bool datatools::ParticleNeighborhood::assertData(
     megamol::core::AbstractGetData3DCall* in, megamol::core::AbstractGetData3DCall* out) {
 
@@ -128,64 +162,23 @@ bool datatools::ParticleNeighborhood::assertData(
 
     unsigned int time = out->FrameID();
 
-    unsigned int plc = inMpdc->GetParticleListCount();
-
     float theRadius = this->radiusSlot.Param<core::param::FloatParam>()->Value();
-    theRadius = theRadius * theRadius;
     int theNumber = this->numNeighborSlot.Param<core::param::IntParam>()->Value();
     auto theSearchType = this->searchTypeSlot.Param<core::param::EnumParam>()->Value();
     int thePart = this->particleNumberSlot.Param<core::param::IntParam>()->Value();
 
-    if (this->lastTime != time || this->datahash != in->DataHash()) {
-        in->SetFrameID(time, true);
-
-        if (!(*in)(0)) {
-            megamol::core::utility::log::Log::DefaultLog.WriteError(
-                "ParticleNeighborhood: could not get frame (%u)", time);
-            return false;
-        }
-
-        plc = inMpdc->GetParticleListCount();
-
-        size_t totalParts = 0;
-        for (unsigned int i = 0; i < plc; i++) {
-            if (isListOK(in, i))
-                totalParts += getListCount(in, i);
-        }
+    if (!this->assertIndex(inMpdc, time)) {
+        return false;
+    }
+    unsigned int plc = inMpdc->GetParticleListCount();
 
+    if (this->colorsVersion != this->indexVersion) {
         if (theSearchType == searchTypeEnum::RADIUS) {
-            this->newColors.resize(totalParts, theRadius);
+            this->newColors.resize(this->index.count(), theRadius * theRadius);
         } else {
-            this->newColors.resize(totalParts);
-        }
-
-        allParts.clear();
-        allParts.reserve(totalParts);
-
-        // we could now filter particles according to something. but currently we need not.
-        size_t allpartcnt = 0;
-        for (unsigned int pli = 0; pli < plc; pli++) {
-            if (!isListOK(in, pli)) {
-                continue;
-            }
-
-            UINT64 part_cnt = getListCount(in, pli);
-
-            for (int part_i = 0; part_i < part_cnt; ++part_i) {
-                allParts.push_back(allpartcnt + part_i);
-            }
-            allpartcnt += getListCount(in, pli);
+            this->newColors.resize(this->index.count());
         }
-
-        // allocate nanoflann data structures for border
-        assert(allpartcnt == totalParts);
-
-        this->myPts = std::make_shared<simplePointcloud>(inMpdc, allParts);
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
-        this->datahash = in->DataHash();
-        this->lastTime = time;
+        this->colorsVersion = this->indexVersion;
         this->radiusSlot.ForceSetDirty();
     }
 
@@ -205,83 +198,27 @@ bool datatools::ParticleNeighborhood::assertData(
                 }
             }
 
-            const float* vbase = myPts->get_position(thePart);
-            float theVertex[3];
-            maxDist = 0.0f;
-            std::vector<std::pair<size_t, float>> ret_matches;
-            std::vector<std::pair<size_t, float>> ret_localMatches;
-            std::vector<size_t> ret_index(theNumber);
-            std::vector<float> out_dist_sqr(theNumber);
-            nanoflann::KNNResultSet<float> resultSet(theNumber);
-            nanoflann::SearchParams params;
-            params.sorted = false;
-
             // final computation
             bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
             bool cycl_y = this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value();
             bool cycl_z = this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value();
-            auto bbox = in->AccessBoundingBoxes().ObjectSpaceBBox();
-            //bbox.EnforcePositiveSize(); // paranoia
-            auto bbox_cntr = bbox.CalcCenter();
-
-            ret_matches.clear();
-            ret_matches.reserve(100);
-
-            for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                    for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                        theVertex[0] = vbase[0];
-                        theVertex[1] = vbase[1];
-                        theVertex[2] = vbase[2];
-                        if (x_s > 0)
-                            theVertex[0] =
-                                theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                        if (y_s > 0)
-                            theVertex[1] =
-                                theVertex[1] + ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                        if (z_s > 0)
-                            theVertex[2] =
-                                theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                        if (theSearchType == searchTypeEnum::RADIUS) {
-                            particleTree->radiusSearch(theVertex, theRadius, ret_localMatches, params);
-                            ret_matches.insert(ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                        } else {
-                            resultSet.init(ret_index.data(), out_dist_sqr.data());
-                            particleTree->findNeighbors(resultSet, theVertex, params);
-                            for (size_t i = 0; i < resultSet.size(); ++i) {
-                                ret_matches.push_back(std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
-                            }
-                        }
-                    }
-                }
-            }
-
-            size_t num_matches = 0;
-
-            // TODO this probably is not even worth it, writing something several times is probably cheaper.
-            //sort(ret_matches.begin(), ret_matches.end());
-            //ret_matches.erase(unique(ret_matches.begin(), ret_matches.end()), ret_matches.end());
+            this->index.setBoundaries(in->AccessBoundingBoxes().ObjectSpaceBBox(), cycl_x, cycl_y, cycl_z);
 
-            // reset all colors
+            // the index returns the closest periodic image of every neighbor, sorted by distance
+            std::vector<std::pair<size_t, float>> ret_matches;
             if (theSearchType == searchTypeEnum::RADIUS) {
-                maxDist = theRadius;
-                num_matches = ret_matches.size();
+                this->index.radiusSearch(this->index.position(thePart), theRadius, ret_matches);
+                maxDist = theRadius * theRadius;
             } else {
-                // find overall closest! we did search around periodic boundary conditions, so there will be huge distances!
-                sort(ret_matches.begin(), ret_matches.end(),
-                    [](const decltype(ret_matches)::value_type& left, const decltype(ret_matches)::value_type& right) {
-                        return left.second < right.second;
-                    });
-                // the furthest is theNumber closest or the last one if fewer.
-                num_matches = ret_matches.size() >= theNumber ? theNumber : ret_matches.size();
-                maxDist = ret_matches[num_matches - 1].second;
+                this->index.knnSearch(this->index.position(thePart), std::max(theNumber, 0), ret_matches);
+                maxDist = ret_matches.empty() ? 0.0f : ret_matches.back().second;
             }
+
+            // reset all colors
             std::fill(newColors.begin(), newColors.end(), maxDist);
 
-            for (size_t i = 0; i < num_matches; ++i) {
-                this->newColors[ret_matches[i].first] = ret_matches[i].second;
+            for (auto const& m : ret_matches) {
+                this->newColors[m.first] = m.second;
             }
         } else {
             // reset all colors
@@ -381,3 +318,78 @@ bool datatools::ParticleNeighborhood::getDataCallback(megamol::core::Call& c) {
 
     return true;
 }
+
+
+bool datatools::ParticleNeighborhood::getNeighborsExtentCallback(megamol::core::Call& c) {
+    using geocalls::MultiParticleDataCall;
+
+    ParticleNeighborsCall* outPnc = dynamic_cast<ParticleNeighborsCall*>(&c);
+    if (outPnc == nullptr)
+        return false;
+
+    MultiParticleDataCall* inMpdc = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inMpdc == nullptr)
+        return false;
+
+    inMpdc->SetFrameID(outPnc->FrameID(), true);
+    if (!(*inMpdc)(1)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleNeighborhood: could not get current frame extents (%u)", outPnc->FrameID());
+        return false;
+    }
+    outPnc->SetFrameCount(inMpdc->FrameCount());
+    outPnc->SetDataHash(this->listsHash);
+    inMpdc->SetUnlocker(nullptr, false);
+    inMpdc->Unlock();
+
+    return true;
+}
+
+bool datatools::ParticleNeighborhood::getNeighborsCallback(megamol::core::Call& c) {
+    using geocalls::MultiParticleDataCall;
+
+    ParticleNeighborsCall* outPnc = dynamic_cast<ParticleNeighborsCall*>(&c);
+    if (outPnc == nullptr)
+        return false;
+
+    MultiParticleDataCall* inMpdc = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inMpdc == nullptr)
+        return false;
+
+    if (!this->assertIndex(inMpdc, outPnc->FrameID()))
+        return false;
+
+    // the index is shared with outData, so both use the boundaries of our parameters
+    std::array<bool, 3> const cyclic = {this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value(),
+        this->cyclYSlot.Param<megamol::core::param::BoolParam>()->Value(),
+        this->cyclZSlot.Param<megamol::core::param::BoolParam>()->Value()};
+    this->index.setBoundaries(inMpdc->AccessBoundingBoxes().ObjectSpaceBBox(), cyclic[0], cyclic[1], cyclic[2]);
+    // the index holds a copy of the positions
+    inMpdc->SetUnlocker(nullptr, false);
+    inMpdc->Unlock();
+
+    bool const radiusQuery = outPnc->GetSearchType() == ParticleNeighborsCall::RADIUS;
+    if (this->listsVersion != this->indexVersion || this->listsType != outPnc->GetSearchType() ||
+        this->listsCyclic != cyclic || (radiusQuery && this->listsRadius != outPnc->Radius()) ||
+        (!radiusQuery && this->listsCount != outPnc->NeighborCount())) {
+        if (radiusQuery) {
+            this->index.radiusLists(outPnc->Radius(), this->lists);
+        } else {
+            this->index.knnLists(outPnc->NeighborCount(), this->lists);
+        }
+        this->listsVersion = this->indexVersion;
+        this->listsType = outPnc->GetSearchType();
+        this->listsRadius = outPnc->Radius();
+        this->listsCount = outPnc->NeighborCount();
+        this->listsCyclic = cyclic;
+        ++this->listsHash;
+    }
+
+    outPnc->Set(this->index.count(), this->lists.offsets.data(), this->lists.indices.data(),
+        this->lists.sqDistances.data());
+    outPnc->SetCyclicBoundaries(cyclic[0], cyclic[1], cyclic[2]);
+    outPnc->SetDataHash(this->listsHash);
+    outPnc->SetUnlocker(nullptr);
+
+    return true;
+}
@@ -7,12 +7,13 @@
 
 #pragma once
 
-#include "datatools/PointcloudHelpers.h"
+#include "ParticleNeighborIndex.h"
+#include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
-#include <nanoflann.hpp>
+#include <array>
 #include <vector>
 
 namespace megamol {
@@ -20,6 +21,10 @@ namespace datatools {
 
 /**
  * Module overriding global attributes of particles
+ *
+ * The neighbor index of the current frame is kept until the data changes, so changing the tracked particle or the
+ * query only runs the query. The neighbor lists of all particles are provided to other modules through a
+ * ParticleNeighborsCall.
  */
 class ParticleNeighborhood : public megamol::core::Module {
 public:
@@ -64,6 +69,24 @@ public:
      */
     bool getExtentCallback(megamol::core::Call& c);
 
+    /**
+     * Called when the neighbor lists are requested by this module
+     *
+     * @param c The incoming call
+     *
+     * @return True on success
+     */
+    bool getNeighborsCallback(megamol::core::Call& c);
+
+    /**
+     * Called when the extend information of the neighbor lists is requested by this module
+     *
+     * @param c The incoming call
+     *
+     * @return True on success
+     */
+    bool getNeighborsExtentCallback(megamol::core::Call& c);
+
 protected:
     /** Lazy initialization of the module */
     virtual bool create(void);
@@ -74,6 +97,9 @@ protected:
 private:
     bool assertData(megamol::core::AbstractGetData3DCall* in, megamol::core::AbstractGetData3DCall* out);
 
+    /** Fetches frame 'time' and rebuilds the neighbor index if the frame or the data changed */
+    bool assertIndex(geocalls::MultiParticleDataCall* in, unsigned int time);
+
     core::param::ParamSlot cyclXSlot;
     core::param::ParamSlot cyclYSlot;
     core::param::ParamSlot cyclZSlot;
@@ -84,20 +110,31 @@ private:
     size_t datahash;
     int lastTime;
     std::vector<float> newColors;
-    std::vector<size_t> allParts;
     float maxDist;
 
-    typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, simplePointcloud>, simplePointcloud,
-        3 /* dim */
-        >
-        my_kd_tree_t;
+    ParticleNeighborIndex index;
+
+    /** Incremented whenever the index gets new data */
+    size_t indexVersion;
 
-    std::shared_ptr<my_kd_tree_t> particleTree;
-    std::shared_ptr<simplePointcloud> myPts;
+    /** Index version the colors were computed for */
+    size_t colorsVersion;
+
+    /** Cached neighbor lists of the last ParticleNeighborsCall and the query they belong to */
+    ParticleNeighborIndex::NeighborLists lists;
+    size_t listsVersion;
+    int listsType;
+    float listsRadius;
+    unsigned int listsCount;
+    std::array<bool, 3> listsCyclic;
+    size_t listsHash;
 
     /** The slot providing access to the manipulated data */
     megamol::core::CalleeSlot outDataSlot;
 
+    /** The slot providing the neighbor lists of all particles */
+    megamol::core::CalleeSlot outNeighborsSlot;
+
     /** The slot accessing the original data */
     megamol::core::CallerSlot inDataSlot;
 };
@@ -1,6 +1,7 @@
 #include "ParticleNeighborhoodGraph.h"
 #include "datatools/GraphDataCall.h"
 #include "datatools/MultiParticleDataAdaptor.h"
+#include "datatools/ParticleNeighborsCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
@@ -21,6 +22,7 @@ ParticleNeighborhoodGraph::ParticleNeighborhoodGraph()
         : Module()
         , outGraphDataSlot("outGraphData", "Publishes graph edge data")
         , inParticleDataSlot("inParticle", "Fetches particle data")
+        , inNeighborsSlot("inNeighbors", "Fetches the neighbor lists of the particles (optional)")
         , radiusSlot("radius", "The neighborhood radius")
         , autoRadiusSlot("autoRadius::detect", "Flag to automatically assess the neighborhood radius")
         , autoRadiusSamplesSlot("autoRadius::samples", "Number of samples to determine the neighborhood radius")
@@ -47,6 +49,9 @@ ParticleNeighborhoodGraph::ParticleNeighborhoodGraph()
     inParticleDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     MakeSlotAvailable(&inParticleDataSlot);
 
+    inNeighborsSlot.SetCompatibleCall<ParticleNeighborsCallDescription>();
+    MakeSlotAvailable(&inNeighborsSlot);
+
     autoRadiusSlot.SetParameter(new core::param::BoolParam(true));
     MakeSlotAvailable(&autoRadiusSlot);
 
@@ -230,6 +235,17 @@ void ParticleNeighborhoodGraph::calcData(geocalls::MultiParticleDataCall* data)
     }
     float neiRadSq = neiRad * neiRad;
 
+    bool cycX = boundaryXCyclicSlot.Param<core::param::BoolParam>()->Value();
+    bool cycY = boundaryYCyclicSlot.Param<core::param::BoolParam>()->Value();
+    bool cycZ = boundaryZCyclicSlot.Param<core::param::BoolParam>()->Value();
+
+    if (this->edgesFromNeighbors(d.get_count(), data->FrameID(), neiRad, cycX, cycY, cycZ)) {
+        end = high_resolution_clock::now();
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG edges taken from neighbor lists in %u ms",
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+        return;
+    }
+
     vislib::math::Cuboid<float> box(vislib::math::ShallowPoint<float, 3>(const_cast<float*>(d.get_position(0))),
         vislib::math::Dimension<float, 3>(0.0f, 0.0f, 0.0f));
     for (size_t i = 1; i < d.get_count(); ++i) {
@@ -300,10 +316,6 @@ void ParticleNeighborhoodGraph::calcData(geocalls::MultiParticleDataCall* data)
 
     edges.reserve(d.get_count() * 2 * 4); // something
 
-    bool cycX = boundaryXCyclicSlot.Param<core::param::BoolParam>()->Value();
-    bool cycY = boundaryYCyclicSlot.Param<core::param::BoolParam>()->Value();
-    bool cycZ = boundaryZCyclicSlot.Param<core::param::BoolParam>()->Value();
-
     // iterate over cells
     int cellCnt = static_cast<int>(x_size * y_size * z_size);
     int maxThreads = omp_get_max_threads();
@@ -589,3 +601,44 @@ void ParticleNeighborhoodGraph::calcData(geocalls::MultiParticleDataCall* data)
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "PNhG completed in %u ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
 }
+
+bool ParticleNeighborhoodGraph::edgesFromNeighbors(
+    size_t count, unsigned int frame, float radius, bool cycX, bool cycY, bool cycZ) {
+    ParticleNeighborsCall* neighbors = this->inNeighborsSlot.CallAs<ParticleNeighborsCall>();
+    if (neighbors == nullptr)
+        return false;
+
+    neighbors->SetFrameID(frame);
+    neighbors->SetQuery(ParticleNeighborsCall::RADIUS, radius, 0);
+    if (!(*neighbors)(ParticleNeighborsCall::GET_DATA)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn("PNhG could not get neighbor lists, searching locally");
+        return false;
+    }
+    if (neighbors->ParticleCount() != count) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "PNhG neighbor lists cover %zu instead of %zu particles, searching locally", neighbors->ParticleCount(),
+            count);
+        neighbors->Unlock();
+        return false;
+    }
+    if (neighbors->CyclicX() != cycX || neighbors->CyclicY() != cycY || neighbors->CyclicZ() != cycZ) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "PNhG neighbor lists use other cyclic boundaries, searching locally");
+        neighbors->Unlock();
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        for (index_t j : neighbors->Neighbors(i)) {
+            // we only every construct edges from small to large indices
+            if (i < j) {
+                edges.push_back(static_cast<index_t>(i));
+                edges.push_back(j);
+            }
+        }
+    }
+    edges.shrink_to_fit();
+    neighbors->Unlock();
+
+    return true;
+}
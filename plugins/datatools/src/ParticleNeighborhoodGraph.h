@@ -50,8 +50,12 @@ protected:
 private:
     void calcData(geocalls::MultiParticleDataCall* data);
 
+    /** Takes the edges from the lists of a connected ParticleNeighborsCall, returns false if there are none */
+    bool edgesFromNeighbors(size_t count, unsigned int frame, float radius, bool cycX, bool cycY, bool cycZ);
+
     core::CalleeSlot outGraphDataSlot;
     core::CallerSlot inParticleDataSlot;
+    core::CallerSlot inNeighborsSlot;
     core::param::ParamSlot radiusSlot;
     core::param::ParamSlot autoRadiusSlot;
     core::param::ParamSlot autoRadiusSamplesSlot;
@@ -0,0 +1,35 @@
+/*
+ * ParticleNeighborsCall.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+
+#include "datatools/ParticleNeighborsCall.h"
+
+using namespace megamol;
+
+datatools::ParticleNeighborsCall::ParticleNeighborsCall()
+        : AbstractGetDataCall()
+        , type(NUM_NEIGHBORS)
+        , radius(0.0f)
+        , count(0)
+        , cyclX(false)
+        , cyclY(false)
+        , cyclZ(false)
+        , particleCnt(0)
+        , offsets(nullptr)
+        , indices(nullptr)
+        , sqDistances(nullptr)
+        , frameCnt(0)
+        , frameID(0) {
+    // intentionally empty
+}
+
+datatools::ParticleNeighborsCall::~ParticleNeighborsCall() {
+    // not our memory, we do not delete
+    offsets = nullptr;
+    indices = nullptr;
+    sqDistances = nullptr;
+}
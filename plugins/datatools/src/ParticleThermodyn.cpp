@@ -5,6 +5,7 @@
  * Alle Rechte vorbehalten.
  */
 #include "ParticleThermodyn.h"
+#include "datatools/ParticleNeighborsCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
@@ -57,7 +58,8 @@ datatools::ParticleThermodyn::ParticleThermodyn(void)
         , particleTree(nullptr)
         , myPts(nullptr)
         , outDataSlot("outData", "Provides intensities based on a local particle metric")
-        , inDataSlot("inData", "Takes the directional particle data") {
+        , inDataSlot("inData", "Takes the directional particle data")
+        , inNeighborsSlot("inNeighbors", "Takes the neighbor lists of the particles (optional)") {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -130,6 +132,9 @@ datatools::ParticleThermodyn::ParticleThermodyn(void)
 
     this->inDataSlot.SetCompatibleCall<geocalls::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    this->inNeighborsSlot.SetCompatibleCall<ParticleNeighborsCallDescription>();
+    this->MakeSlotAvailable(&this->inNeighborsSlot);
 }
 
 
@@ -266,13 +271,8 @@ bool datatools::ParticleThermodyn::assertData(
         // allocate nanoflann data structures for border
         assert(allpartcnt == totalParts);
         this->myPts = std::make_shared<simplePointcloud>(in, allParts);
-
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-            "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+        // built on demand, unless the neighbors are provided
+        this->particleTree.reset();
 
         this->datahash = in->DataHash();
         this->lastTime = time;
@@ -313,6 +313,41 @@ bool datatools::ParticleThermodyn::assertData(
         auto const T_c = tcSlot.Param<core::param::FloatParam>()->Value();
         auto const rho_c = rhocSlot.Param<core::param::FloatParam>()->Value();
 
+        // use the neighbor lists of a connected ParticleNeighborhood if they match our particles
+        ParticleNeighborsCall* neighbors = this->inNeighborsSlot.CallAs<ParticleNeighborsCall>();
+        if (neighbors != nullptr) {
+            float const eps = sqrt(std::numeric_limits<float>::epsilon());
+            neighbors->SetFrameID(time);
+            neighbors->SetQuery(theSearchType == searchTypeEnum::RADIUS ? ParticleNeighborsCall::RADIUS
+                                                                        : ParticleNeighborsCall::NUM_NEIGHBORS,
+                std::sqrt(theSquaredRadius + eps), static_cast<unsigned int>(std::max(theNumber, 0)));
+            if (!(*neighbors)(ParticleNeighborsCall::GET_DATA)) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleThermodyn: could not get neighbor lists, searching locally");
+                neighbors = nullptr;
+            } else if (neighbors->ParticleCount() != newColors.size()) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleThermodyn: neighbor lists cover %zu instead of %zu particles, searching locally",
+                    neighbors->ParticleCount(), newColors.size());
+                neighbors->Unlock();
+                neighbors = nullptr;
+            } else if (neighbors->CyclicX() != cycl_x || neighbors->CyclicY() != cycl_y ||
+                       neighbors->CyclicZ() != cycl_z) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleThermodyn: neighbor lists use other cyclic boundaries, searching locally");
+                neighbors->Unlock();
+                neighbors = nullptr;
+            }
+        }
+        if (neighbors == nullptr && this->particleTree == nullptr) {
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "ParticleThermodyn: building acceleration structure for frame %u...", out->FrameID());
+            particleTree = std::make_shared<my_kd_tree_t>(
+                3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
+            particleTree->buildIndex();
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
+        }
+
         allpartcnt = 0;
         INT64 counter = 0;
         for (unsigned int pli = 0; pli < plc; pli++) {
@@ -354,45 +389,56 @@ bool datatools::ParticleThermodyn::assertData(
                     const float* vertexBase = this->myPts->get_position(myIndex);
                     // const float *velocityBase = this->myPts->get_velocity(myIndex);
 
-                    for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
-                        for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
-                            for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
-
-                                theVertex[0] = vertexBase[0];
-                                theVertex[1] = vertexBase[1];
-                                theVertex[2] = vertexBase[2];
-                                if (x_s > 0)
-                                    theVertex[0] =
-                                        theVertex[0] + ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
-                                if (y_s > 0)
-                                    theVertex[1] = theVertex[1] +
-                                                   ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
-                                if (z_s > 0)
-                                    theVertex[2] =
-                                        theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
-
-                                if (theSearchType == searchTypeEnum::RADIUS) {
-                                    // the documentation says the parameter radius for L2 is squared
-                                    // caution: the criterion is < radius, not <= !!!!
-                                    particleTree->radiusSearch(
-                                        theVertex, theSquaredRadius + eps, ret_localMatches, params);
-                                    if (remove_self) {
-                                        ret_localMatches.erase(
-                                            std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
-                                                [&](decltype(ret_localMatches)::value_type& elem) {
-                                                    return elem.first == myIndex;
-                                                }),
-                                            ret_localMatches.end());
-                                    }
-                                    ret_matches.insert(
-                                        ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
-                                } else {
-                                    resultSet.init(ret_index.data(), out_dist_sqr.data());
-                                    particleTree->findNeighbors(resultSet, theVertex, params);
-                                    for (size_t i = 0; i < resultSet.size(); ++i) {
-                                        if (!remove_self || ret_index[i] != myIndex) {
-                                            ret_matches.push_back(
-                                                std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
+                    if (neighbors != nullptr) {
+                        // the lists contain the closest periodic image of every neighbor only
+                        auto const nl = neighbors->Neighbors(myIndex);
+                        for (ParticleNeighborsCall::offset_t n = 0; n < nl.length; ++n) {
+                            if (!remove_self || nl.indices[n] != myIndex) {
+                                ret_matches.push_back(std::pair<size_t, float>(nl.indices[n], nl.sqDistances[n]));
+                            }
+                        }
+                    } else {
+                        for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
+                            for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
+                                for (int z_s = 0; z_s < (cycl_z ? 2 : 1); ++z_s) {
+
+                                    theVertex[0] = vertexBase[0];
+                                    theVertex[1] = vertexBase[1];
+                                    theVertex[2] = vertexBase[2];
+                                    if (x_s > 0)
+                                        theVertex[0] = theVertex[0] +
+                                                       ((theVertex[0] > bbox_cntr.X()) ? -bbox.Width() : bbox.Width());
+                                    if (y_s > 0)
+                                        theVertex[1] =
+                                            theVertex[1] +
+                                            ((theVertex[1] > bbox_cntr.Y()) ? -bbox.Height() : bbox.Height());
+                                    if (z_s > 0)
+                                        theVertex[2] = theVertex[2] +
+                                                       ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
+
+                                    if (theSearchType == searchTypeEnum::RADIUS) {
+                                        // the documentation says the parameter radius for L2 is squared
+                                        // caution: the criterion is < radius, not <= !!!!
+                                        particleTree->radiusSearch(
+                                            theVertex, theSquaredRadius + eps, ret_localMatches, params);
+                                        if (remove_self) {
+                                            ret_localMatches.erase(
+                                                std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
+                                                    [&](decltype(ret_localMatches)::value_type& elem) {
+                                                        return elem.first == myIndex;
+                                                    }),
+                                                ret_localMatches.end());
+                                        }
+                                        ret_matches.insert(
+                                            ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
+                                    } else {
+                                        resultSet.init(ret_index.data(), out_dist_sqr.data());
+                                        particleTree->findNeighbors(resultSet, theVertex, params);
+                                        for (size_t i = 0; i < resultSet.size(); ++i) {
+                                            if (!remove_self || ret_index[i] != myIndex) {
+                                                ret_matches.push_back(
+                                                    std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
+                                            }
                                         }
                                     }
                                 }
@@ -521,6 +567,9 @@ bool datatools::ParticleThermodyn::assertData(
             allpartcnt += pl.GetCount();
         }
         cpb.Stop();
+        if (neighbors != nullptr) {
+            neighbors->Unlock();
+        }
 
         this->minMetricSlot.Param<core::param::FloatParam>()->SetValue(theMinTemp);
         this->maxMetricSlot.Param<core::param::FloatParam>()->SetValue(theMaxTemp);
@@ -134,6 +134,9 @@ private:
 
     /** The slot accessing the original data */
     megamol::core::CallerSlot inDataSlot;
+
+    /** The optional slot fetching precomputed neighbor lists instead of searching here */
+    megamol::core::CallerSlot inNeighborsSlot;
 };
 
 } /* end namespace datatools */
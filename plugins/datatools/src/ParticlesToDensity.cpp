@@ -37,6 +37,168 @@
 
 using namespace megamol;
 
+
+namespace {
+
+/** Minimum edge length of the bricks the particles are binned into, in voxels */
+constexpr int minBrickSize = 32;
+
+/** A particle prepared for splatting */
+struct Splat {
+    float x, y, z, rad;
+    float val[3];
+    /** The voxel containing the particle and the half extents of its footprint */
+    int cx, cy, cz, fx, fy, fz;
+    /** The rank of the brick the particle belongs to, -1 if it is skipped */
+    int brick;
+};
+
+/** A part of the volume extended by a halo, in unwrapped voxel coordinates */
+struct Tile {
+    int x0, y0, z0, sx, sy, sz;
+};
+
+/**
+ * The partition of one axis of the volume into bricks. All bricks are at
+ * least twice as large as the halo, i.e. the largest footprint of a particle.
+ */
+struct BrickAxis {
+    BrickAxis(int size, int halo, bool cyclic) : size(size), halo(halo), cyclic(cyclic) {
+        count = std::max(1, size / std::max(minBrickSize, 2 * halo));
+        // bricks adjacent across a cyclic boundary need a third colour if the count is odd
+        colours = (cyclic && (count > 1) && (count % 2 == 1)) ? 3 : std::min(count, 2);
+    }
+
+    int start(int brick) const {
+        return static_cast<int>(static_cast<int64_t>(brick) * size / count);
+    }
+
+    int brickOf(int voxel) const {
+        voxel = std::min(std::max(voxel, 0), size - 1);
+        return static_cast<int>((static_cast<int64_t>(voxel + 1) * count - 1) / size);
+    }
+
+    int colourOf(int brick) const {
+        return ((colours == 3) && (brick == count - 1)) ? 2 : (brick % 2);
+    }
+
+    void tileOf(int brick, int& outOrigin, int& outSize) const {
+        auto lo = start(brick) - halo;
+        auto hi = start(brick + 1) + halo;
+        if (!cyclic) {
+            lo = std::max(lo, 0);
+            hi = std::min(hi, size);
+        }
+        outOrigin = lo;
+        outSize = hi - lo;
+    }
+
+    int size, halo, count, colours;
+    bool cyclic;
+};
+
+/** Interleaves the lower 21 bits of the brick coordinates */
+uint64_t mortonCode(uint32_t x, uint32_t y, uint32_t z) {
+    auto spread = [](uint64_t v) -> uint64_t {
+        v &= 0x1fffff;
+        v = (v | (v << 32)) & 0x1f00000000ffffull;
+        v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+        v = (v | (v << 8)) & 0x100f00f00f00f00full;
+        v = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+        v = (v | (v << 2)) & 0x1249249249249249ull;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
+
+/** Moves a coordinate along a cyclic axis to the image having its voxel inside the volume */
+inline void wrapToVolume(int& voxel, float& pos, int size, float sliceDist) {
+    if ((voxel < 0) || (voxel >= size)) {
+        auto const shift = (voxel >= 0) ? (voxel / size) : -((size - 1 - voxel) / size);
+        voxel -= shift * size;
+        pos -= static_cast<float>(shift * size) * sliceDist;
+    }
+}
+
+/** Answers the voxel coordinate along a cyclic axis inside the volume */
+inline int wrapVoxel(int voxel, int size) {
+    voxel %= size;
+    return (voxel < 0) ? (voxel + size) : voxel;
+}
+
+/**
+ * Adds the bump function from https://en.wikipedia.org/wiki/Radial_basis_function
+ * of one particle to the voxels of a tile, clipped to the tile.
+ */
+void splatParticle(Splat const& p, float sigma, Tile const& t, float minX, float minY, float minZ, float sliceDistX,
+    float sliceDistY, float sliceDistZ, bool isVector, float* tile, float* tileWeights) {
+    auto const epsilon = sigma * p.rad;
+    auto const rcpEpsSq = 1.0f / (epsilon * epsilon);
+
+    auto const loX = std::max(p.cx - p.fx, t.x0), hiX = std::min(p.cx + p.fx, t.x0 + t.sx - 1);
+    auto const loY = std::max(p.cy - p.fy, t.y0), hiY = std::min(p.cy + p.fy, t.y0 + t.sy - 1);
+    auto const loZ = std::max(p.cz - p.fz, t.z0), hiZ = std::min(p.cz + p.fz, t.z0 + t.sz - 1);
+    auto const val0 = p.val[0], val1 = p.val[1], val2 = p.val[2];
+
+    for (int hz = loZ; hz <= hiZ; ++hz) {
+        auto const dz = static_cast<float>(hz) * sliceDistZ + minZ - p.z;
+        for (int hy = loY; hy <= hiY; ++hy) {
+            auto const dy = static_cast<float>(hy) * sliceDistY + minY - p.y;
+            auto const dyzSq = dy * dy + dz * dz;
+            if (dyzSq * rcpEpsSq >= 1.0f) {
+                continue;
+            }
+            auto const row = (static_cast<std::size_t>(hz - t.z0) * t.sy + (hy - t.y0)) * t.sx;
+
+            if (isVector) {
+                float* dst = tile + row * 3;
+                float* dstWeights = tileWeights + row;
+                for (int hx = loX; hx <= hiX; ++hx) {
+                    auto const dx = static_cast<float>(hx) * sliceDistX + minX - p.x;
+                    auto const q = (dx * dx + dyzSq) * rcpEpsSq;
+                    auto const w = (q < 1.0f) ? std::exp(-1.0f / (1.0f - q)) : 0.0f;
+                    auto const i = hx - t.x0;
+                    dst[i * 3 + 0] += w * val0;
+                    dst[i * 3 + 1] += w * val1;
+                    dst[i * 3 + 2] += w * val2;
+                    dstWeights[i] += w;
+                }
+            } else {
+                float* dst = tile + row;
+                for (int hx = loX; hx <= hiX; ++hx) {
+                    auto const dx = static_cast<float>(hx) * sliceDistX + minX - p.x;
+                    auto const q = (dx * dx + dyzSq) * rcpEpsSq;
+                    auto const w = (q < 1.0f) ? std::exp(-1.0f / (1.0f - q)) : 0.0f;
+                    dst[hx - t.x0] += w * val0;
+                }
+            }
+        }
+    }
+}
+
+/** Adds a tile to the volume, wrapping the halo around cyclic boundaries */
+void mergeTile(Tile const& t, float const* tile, int comps, int sx, int sy, int sz, float* vol) {
+    for (int tz = 0; tz < t.sz; ++tz) {
+        auto const gz = wrapVoxel(t.z0 + tz, sz);
+        for (int ty = 0; ty < t.sy; ++ty) {
+            auto const gy = wrapVoxel(t.y0 + ty, sy);
+            auto const src = tile + (static_cast<std::size_t>(tz) * t.sy + ty) * t.sx * comps;
+            auto const dst = vol + (static_cast<std::size_t>(gz) * sy + gy) * sx * comps;
+            auto gx = wrapVoxel(t.x0, sx);
+            for (int tx = 0; tx < t.sx; ++tx) {
+                for (int c = 0; c < comps; ++c) {
+                    dst[gx * comps + c] += src[tx * comps + c];
+                }
+                if (++gx == sx) {
+                    gx = 0;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
 /*
  * datatools::ParticlesToDensity::create
  */
@@ -113,6 +275,9 @@ datatools::ParticlesToDensity::ParticlesToDensity(void)
     this->outDataSlot.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &ParticlesToDensity::dummyCallback);
+    this->outDataSlot.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &ParticlesToDensity::getBricksCallback);
     this->MakeSlotAvailable(&this->outDataSlot);
 
     this->outParticlesSlot.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
@@ -402,16 +567,9 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
 
     bool const is_vector = this->aggregatorSlot.Param<core::param::EnumParam>()->Value() == 2;
 
-    vol.resize(omp_get_max_threads());
-    std::vector<std::vector<float>> weights(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol[init].resize(sx * sy * sz * (is_vector ? 3 : 1));
-        std::fill(vol[init].begin(), vol[init].end(), 0.0f);
-
-        weights[init].resize(sx * sy * sz);
-        std::fill(weights[init].begin(), weights[init].end(), 0.0f);
-    }
+    vol.resize(1);
+    vol[0].assign(static_cast<std::size_t>(sx) * sy * sz * (is_vector ? 3 : 1), 0.0f);
+    std::vector<float> weights(is_vector ? static_cast<std::size_t>(sx) * sy * sz : 0, 0.0f);
 
     // TODO: the whole code is wrong since we might not have the bounding box for the actual cyclic boundary conditions.
 
@@ -459,25 +617,31 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
         }
     }
 
+    auto const aggregator = this->aggregatorSlot.Param<core::param::EnumParam>()->Value();
+    auto const sigma = this->sigmaSlot.Param<core::param::FloatParam>()->Value();
+
+    // gather the particles into one array, together with their footprint
+    std::vector<std::size_t> listOffsets(c2->GetParticleListCount() + 1, 0);
+    for (unsigned int i = 0; i < c2->GetParticleListCount(); ++i) {
+        auto const& parts = c2->AccessParticles(i);
+        auto const cnt = (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE)
+                             ? 0
+                             : parts.GetCount();
+        listOffsets[i + 1] = listOffsets[i] + cnt;
+    }
+    totalParticles = listOffsets.back();
+
+    std::vector<Splat> unsorted(totalParticles);
+    int maxFilterX = 0, maxFilterY = 0, maxFilterZ = 0;
     for (unsigned int i = 0; i < c2->GetParticleListCount(); ++i) {
         geocalls::MultiParticleDataCall::Particles& parts = c2->AccessParticles(i);
+        if (listOffsets[i + 1] == listOffsets[i]) {
+            continue;
+        }
         const float globRad = parts.GetGlobalRadius();
         const bool useGlobRad =
             (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ) ||
             (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_DOUBLE_XYZ);
-        if (parts.GetVertexDataType() == geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE) {
-            continue;
-        }
-
-        totalParticles += parts.GetCount();
-
-        // Implements the Bump Function from
-        // https://en.wikipedia.org/wiki/Radial_basis_function
-        auto rbf = [](float const dist, float const epsilon) -> float {
-            if (dist >= epsilon)
-                return 0.0f;
-            return std::exp(-1.0f / (1.0f - std::pow((1.0f / epsilon) * dist, 2.0f)));
-        };
 
         auto const& parStore = parts.GetParticleStore();
         auto const& xAcc = parStore.GetXAcc();
@@ -489,144 +653,166 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
         auto const& dyAcc = parStore.GetDYAcc();
         auto const& dzAcc = parStore.GetDZAcc();
 
-        auto const sigma = this->sigmaSlot.Param<core::param::FloatParam>()->Value();
-
-        std::function<void(int, int, int, int, float, float)> volOp;
-        switch (this->aggregatorSlot.Param<core::param::EnumParam>()->Value()) {
-        case 2: {
-            volOp = [this, &rbf, &weights, dxAcc, dyAcc, dzAcc, sx, sy, sigma](int const pidx, int const x, int const y,
-                        int const z, float const dis, float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                auto const val_x = dxAcc->Get_f(pidx);
-                auto const val_y = dyAcc->Get_f(pidx);
-                auto const val_z = dzAcc->Get_f(pidx);
-
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 0] += rbf(dis, sigma * rad) * val_x;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 1] += rbf(dis, sigma * rad) * val_y;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 2] += rbf(dis, sigma * rad) * val_z;
-
-                weights[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
-        } break;
-        case 1: {
-            volOp = [this, &rbf, iAcc, sx, sy, sigma](int const pidx, int const x, int const y, int const z,
-                        float const dis, float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                auto const val = iAcc->Get_f(pidx);
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad) * val;
-            };
-        } break;
-        default:
-        case 0: {
-            volOp = [this, &rbf, sx, sy, sigma](int const pidx, int const x, int const y, int const z, float const dis,
-                        float const rad) -> void {
-                if (rad == 0.0f)
-                    return;
-
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
-            };
-        }
-        }
+        auto const offset = listOffsets[i];
+        auto const cnt = static_cast<int64_t>(listOffsets[i + 1] - offset);
+        // reduction(max) needs OpenMP 3.1, so merge per-thread maxima instead
+#pragma omp parallel
+        {
+            int localMaxX = 0, localMaxY = 0, localMaxZ = 0;
+#pragma omp for
+            for (int64_t j = 0; j < cnt; ++j) {
+                auto& splat = unsorted[offset + j];
+                splat.rad = useGlobRad ? globRad : rAcc->Get_f(j);
+                if (splat.rad == 0.0f) {
+                    splat.brick = -1;
+                    continue;
+                }
+                splat.x = xAcc->Get_f(j);
+                splat.y = yAcc->Get_f(j);
+                splat.z = zAcc->Get_f(j);
+                splat.cx = static_cast<int>((splat.x - minOSx) / sliceDistX);
+                splat.cy = static_cast<int>((splat.y - minOSy) / sliceDistY);
+                splat.cz = static_cast<int>((splat.z - minOSz) / sliceDistZ);
+                splat.fx = static_cast<int>(std::ceil(splat.rad / sliceDistX));
+                splat.fy = static_cast<int>(std::ceil(splat.rad / sliceDistY));
+                splat.fz = static_cast<int>(std::ceil(splat.rad / sliceDistZ));
+                switch (aggregator) {
+                case 2:
+                    splat.val[0] = dxAcc->Get_f(j);
+                    splat.val[1] = dyAcc->Get_f(j);
+                    splat.val[2] = dzAcc->Get_f(j);
+                    break;
+                case 1:
+                    splat.val[0] = iAcc->Get_f(j);
+                    break;
+                default:
+                    splat.val[0] = 1.0f;
+                    break;
+                }
 
-#if 0
-#pragma omp parallel for collapse(4)
-        for (int z = 0; z < sz; ++z) {
-            for (int y = 0; y < sy; ++y) {
-                for (int x = 0; x < sx; ++x) {
-                    for (int64_t j = 0; j < parts.GetCount(); ++j) {
-                        auto const x_base = xAcc->Get_f(j);
-                        auto const y_base = yAcc->Get_f(j);
-                        auto const z_base = zAcc->Get_f(j);
-                        auto rad = globRad;
-                        if (!useGlobRad) rad = rAcc->Get_f(j);
-
-                        float x_diff = static_cast<float>(x) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        if (cycl_x && x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(y) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        if (cycl_y && y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(z) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        if (cycl_z && z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, x, y, z, dis, rad);
-                    }
+                // move particles outside the volume to their periodic image inside
+                if (cycl_x) {
+                    wrapToVolume(splat.cx, splat.x, sx, sliceDistX);
                 }
+                if (cycl_y) {
+                    wrapToVolume(splat.cy, splat.y, sy, sliceDistY);
+                }
+                if (cycl_z) {
+                    wrapToVolume(splat.cz, splat.z, sz, sliceDistZ);
+                }
+                localMaxX = std::max(localMaxX, splat.fx);
+                localMaxY = std::max(localMaxY, splat.fy);
+                localMaxZ = std::max(localMaxZ, splat.fz);
+                splat.brick = 0;
+            }
+#pragma omp critical
+            {
+                maxFilterX = std::max(maxFilterX, localMaxX);
+                maxFilterY = std::max(maxFilterY, localMaxY);
+                maxFilterZ = std::max(maxFilterZ, localMaxZ);
             }
         }
-#endif
+    }
+
+    // Bricks are at least twice as large as the largest footprint, so tiles of
+    // bricks which are not adjacent never overlap.
+    BrickAxis const bricksX(sx, maxFilterX, cycl_x);
+    BrickAxis const bricksY(sy, maxFilterY, cycl_y);
+    BrickAxis const bricksZ(sz, maxFilterZ, cycl_z);
+    auto const brickCnt = bricksX.count * bricksY.count * bricksZ.count;
+
+    // number the bricks in Morton order and sort the particles accordingly
+    std::vector<int> brickOrder(brickCnt);
+    std::iota(brickOrder.begin(), brickOrder.end(), 0);
+    std::vector<uint64_t> brickCodes(brickCnt);
+    for (int b = 0; b < brickCnt; ++b) {
+        brickCodes[b] = mortonCode(b % bricksX.count, (b / bricksX.count) % bricksY.count,
+            b / (bricksX.count * bricksY.count));
+    }
+    std::sort(brickOrder.begin(), brickOrder.end(),
+        [&brickCodes](int l, int r) { return brickCodes[l] < brickCodes[r]; });
+    std::vector<int> brickRank(brickCnt);
+    for (int r = 0; r < brickCnt; ++r) {
+        brickRank[brickOrder[r]] = r;
+    }
 
 #pragma omp parallel for
-        for (int64_t j = 0; j < parts.GetCount(); ++j) {
-            auto const x_base = xAcc->Get_f(j);
-            auto x = static_cast<int>((x_base - minOSx) / sliceDistX);
-            auto const y_base = yAcc->Get_f(j);
-            auto y = static_cast<int>((y_base - minOSy) / sliceDistY);
-            auto const z_base = zAcc->Get_f(j);
-            auto z = static_cast<int>((z_base - minOSz) / sliceDistZ);
-            auto rad = globRad;
-            if (!useGlobRad)
-                rad = rAcc->Get_f(j);
-
-            int const filterSizeX = static_cast<int>(std::ceil(rad / sliceDistX));
-            int const filterSizeY = static_cast<int>(std::ceil(rad / sliceDistY));
-            int const filterSizeZ = static_cast<int>(std::ceil(rad / sliceDistZ));
-
-            for (int hz = z - filterSizeZ; hz <= z + filterSizeZ; ++hz) {
-                for (int hy = y - filterSizeY; hy <= y + filterSizeY; ++hy) {
-                    for (int hx = x - filterSizeX; hx <= x + filterSizeX; ++hx) {
-                        auto tmp_hx = hx;
-                        auto tmp_hy = hy;
-                        auto tmp_hz = hz;
-                        if (cycl_x) {
-                            tmp_hx = (hx + 2 * sx) % sx;
-                        } else {
-                            if (hx < 0 || hx > sx - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_y) {
-                            tmp_hy = (hy + 2 * sy) % sy;
-                        } else {
-                            if (hy < 0 || hy > sy - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_z) {
-                            tmp_hz = (hz + 2 * sz) % sz;
-                        } else {
-                            if (hz < 0 || hz > sz - 1) {
-                                continue;
-                            }
-                        }
-
-                        float x_diff = static_cast<float>(hx) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        // if (x_diff > halfRangeOSx) x_diff -= rangeOSx;
-                        float y_diff = static_cast<float>(hy) * sliceDistY + minOSy;
-                        y_diff = std::fabs(y_diff - y_base);
-                        // if (y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(hz) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        // if (z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
-
-                        volOp(j, tmp_hx, tmp_hy, tmp_hz, dis, rad);
-                    }
-                }
+    for (int64_t j = 0; j < static_cast<int64_t>(unsorted.size()); ++j) {
+        auto& splat = unsorted[j];
+        if (splat.brick < 0) {
+            continue;
+        }
+        auto const b = bricksX.brickOf(splat.cx) +
+                       bricksX.count * (bricksY.brickOf(splat.cy) + bricksY.count * bricksZ.brickOf(splat.cz));
+        splat.brick = brickRank[b];
+    }
+
+    std::vector<std::size_t> brickStart(brickCnt + 1, 0);
+    for (auto const& splat : unsorted) {
+        if (splat.brick >= 0) {
+            ++brickStart[splat.brick + 1];
+        }
+    }
+    std::partial_sum(brickStart.begin(), brickStart.end(), brickStart.begin());
+    std::vector<Splat> splats(brickStart.back());
+    {
+        std::vector<std::size_t> fill(brickStart.begin(), brickStart.end() - 1);
+        for (auto const& splat : unsorted) {
+            if (splat.brick >= 0) {
+                splats[fill[splat.brick]++] = splat;
             }
         }
     }
+    unsorted.clear();
+    unsorted.shrink_to_fit();
+
+    // Splat the bricks phase by phase, a phase containing the bricks of one
+    // colour. Bricks of the same colour are never adjacent, thus their tiles
+    // can be added to the volume without synchronisation.
+    auto const colourCnt = bricksX.colours * bricksY.colours * bricksZ.colours;
+    auto const comps = is_vector ? 3 : 1;
+    for (int colour = 0; colour < colourCnt; ++colour) {
+        std::vector<int> phaseBricks;
+        for (int r = 0; r < brickCnt; ++r) {
+            auto const b = brickOrder[r];
+            auto const bx = b % bricksX.count;
+            auto const by = (b / bricksX.count) % bricksY.count;
+            auto const bz = b / (bricksX.count * bricksY.count);
+            auto const c = bricksX.colourOf(bx) +
+                           bricksX.colours * (bricksY.colourOf(by) + bricksY.colours * bricksZ.colourOf(bz));
+            if ((c == colour) && (brickStart[r + 1] > brickStart[r])) {
+                phaseBricks.push_back(r);
+            }
+        }
+
+#pragma omp parallel
+        {
+            std::vector<float> tile, tileWeights;
+#pragma omp for schedule(dynamic)
+            for (int64_t pb = 0; pb < static_cast<int64_t>(phaseBricks.size()); ++pb) {
+                auto const r = phaseBricks[pb];
+                auto const b = brickOrder[r];
+                Tile t;
+                bricksX.tileOf(b % bricksX.count, t.x0, t.sx);
+                bricksY.tileOf((b / bricksX.count) % bricksY.count, t.y0, t.sy);
+                bricksZ.tileOf(b / (bricksX.count * bricksY.count), t.z0, t.sz);
+                auto const tileSize = static_cast<std::size_t>(t.sx) * t.sy * t.sz;
+                tile.assign(tileSize * comps, 0.0f);
+                if (is_vector) {
+                    tileWeights.assign(tileSize, 0.0f);
+                }
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol[i].begin(), vol[i].end(), vol[0].begin(), vol[0].begin(), std::plus<>());
-        std::transform(weights[i].begin(), weights[i].end(), weights[0].begin(), weights[0].begin(), std::plus<>());
+                for (auto j = brickStart[r]; j < brickStart[r + 1]; ++j) {
+                    splatParticle(splats[j], sigma, t, minOSx, minOSy, minOSz, sliceDistX, sliceDistY, sliceDistZ,
+                        is_vector, tile.data(), tileWeights.data());
+                }
+
+                mergeTile(t, tile.data(), comps, sx, sy, sz, vol[0].data());
+                if (is_vector) {
+                    mergeTile(t, tileWeights.data(), 1, sx, sy, sz, weights.data());
+                }
+            }
+        }
     }
 
     if (is_vector) {
@@ -636,9 +822,9 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
         maxDens = 0.0f;
         minDens = std::numeric_limits<float>::max();
         for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
-            vol[0][i * 3 + 0] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 1] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 2] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
+            vol[0][i * 3 + 0] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[0][i * 3 + 1] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[0][i * 3 + 2] /= weights[i] == 0.0f ? 1.0f : weights[i];
 
             const float density =
                 std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
@@ -738,9 +924,6 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class geocalls::MultiParticl
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticlesToDensity: Debug file written\n");
 #endif
 
-    // Cleanup
-    vol.resize(1);
-
     const auto endTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<float, std::milli> diffMillis = endTime - startTime;
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
@@ -806,3 +989,8 @@ void datatools::ParticlesToDensity::modifyBBox(geocalls::MultiParticleDataCall*
 bool datatools::ParticlesToDensity::dummyCallback(megamol::core::Call& c) {
     return true;
 }
+
+
+bool datatools::ParticlesToDensity::getBricksCallback(megamol::core::Call& c) {
+    return false;
+}
@@ -72,6 +72,9 @@ private:
 
     bool dummyCallback(megamol::core::Call& c);
 
+    /** Answers the request for bricks with false, the density is only computed as a whole. */
+    bool getBricksCallback(megamol::core::Call& c);
+
     bool createVolumeCPU(geocalls::MultiParticleDataCall* c2);
 
     void modifyBBox(geocalls::MultiParticleDataCall* c2);
@@ -1,6 +1,7 @@
 #include "datatools/clustering/ParticleIColClustering.h"
 #include "stdafx.h"
 
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 
@@ -9,7 +10,8 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
         : AbstractParticleManipulator("outData", "inData")
         , _eps_slot("eps", "")
         , _minpts_slot("minpts", "")
-        , _icol_weight("icol weight", "") {
+        , _icol_weight("icol weight", "")
+        , _parallel_slot("parallel", "Use the parallel DBSCAN") {
     _eps_slot << new core::param::FloatParam(0.1f, 0.0f, 1.0f);
     MakeSlotAvailable(&_eps_slot);
 
@@ -18,6 +20,9 @@ megamol::datatools::clustering::ParticleIColClustering::ParticleIColClustering()
 
     _icol_weight << new core::param::FloatParam(0.5f, 0.0f, 1.0f);
     MakeSlotAvailable(&_icol_weight);
+
+    _parallel_slot << new core::param::BoolParam(true);
+    MakeSlotAvailable(&_parallel_slot);
 }
 
 
@@ -38,6 +43,7 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
         auto const eps = _eps_slot.Param<core::param::FloatParam>()->Value();
         auto const minpts = static_cast<index_t>(_minpts_slot.Param<core::param::IntParam>()->Value());
         auto const icol_weight = _icol_weight.Param<core::param::FloatParam>()->Value();
+        auto const parallel = _parallel_slot.Param<core::param::BoolParam>()->Value();
 
         std::array<float, 4> weights = {(1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
 
@@ -61,17 +67,17 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
 
                 std::vector<float> cur_points(p_count * 4);
 
-                auto const xAcc = parts.GetParticleStore().GetXAcc();
-                auto const yAcc = parts.GetParticleStore().GetYAcc();
-                auto const zAcc = parts.GetParticleStore().GetZAcc();
-                auto const iAcc = parts.GetParticleStore().GetCRAcc();
-
-                for (std::remove_const_t<decltype(p_count)> pidx = 0; pidx < p_count; ++pidx) {
-                    cur_points[pidx * 4 + 0] = xAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 1] = yAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 2] = zAcc->Get_f(pidx);
-                    cur_points[pidx * 4 + 3] = iAcc->Get_f(pidx);
-                }
+                auto const& store = parts.GetParticleStore();
+                store.VisitVertices([&](auto const& xAcc, auto const& yAcc, auto const& zAcc, auto const&) {
+                    store.VisitColors([&](auto const& iAcc, auto const&, auto const&, auto const&) {
+                        for (std::remove_const_t<decltype(p_count)> pidx = 0; pidx < p_count; ++pidx) {
+                            cur_points[pidx * 4 + 0] = xAcc.Get_f(pidx);
+                            cur_points[pidx * 4 + 1] = yAcc.Get_f(pidx);
+                            cur_points[pidx * 4 + 2] = zAcc.Get_f(pidx);
+                            cur_points[pidx * 4 + 3] = iAcc.Get_f(pidx);
+                        }
+                    });
+                });
 
                 std::array<float, 8> bbox = {p_bbox.GetLeft(), p_bbox.GetRight(), p_bbox.GetBottom(), p_bbox.GetTop(),
                     p_bbox.GetBack(), p_bbox.GetFront(), parts.GetMinColourIndexValue(),
@@ -85,7 +91,8 @@ bool megamol::datatools::clustering::ParticleIColClustering::manipulateData(
                 _kd_trees[pl_idx]->buildIndex();
             }
 
-            auto const cluster_res = DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
+            auto const cluster_res = parallel ? DBSCAN_parallel(_kd_trees[pl_idx], eps * eps, minpts)
+                                              : DBSCAN(_kd_trees[pl_idx], eps * eps, minpts);
 
             _ret_cols[pl_idx].resize(p_count);
             std::transform(cluster_res.cbegin(), cluster_res.cend(), _ret_cols[pl_idx].begin(),
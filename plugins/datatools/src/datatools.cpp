@@ -66,12 +66,16 @@
 #include "datatools/GraphDataCall.h"
 #include "datatools/MultiIndexListDataCall.h"
 #include "datatools/ParticleFilterMapDataCall.h"
+#include "datatools/ParticleNeighborsCall.h"
 #include "datatools/clustering/ParticleIColClustering.h"
+#include "datatools/table/ColumnarTableDataCall.h"
 #include "datatools/table/TableDataCall.h"
 #include "io/CPERAWDataSource.h"
 #include "io/MMGDDDataSource.h"
 #include "io/MMGDDWriter.h"
 #include "table/CSVDataSource.h"
+#include "table/ColumnarTableToTable.h"
+#include "table/ColumnarTableWhere.h"
 #include "table/MMFTDataSource.h"
 #include "table/MMFTDataWriter.h"
 #include "table/ParticlesToTable.h"
@@ -85,6 +89,7 @@
 #include "table/TableSampler.h"
 #include "table/TableSort.h"
 #include "table/TableSplit.h"
+#include "table/TableToColumnarTable.h"
 #include "table/TableToLines.h"
 #include "table/TableToParticles.h"
 #include "table/TableWhere.h"
@@ -180,11 +185,16 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::TableInspector>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::ParticleListFilter>();
         this->module_descriptions.RegisterAutoDescription<megamol::datatools::SiffCSplineFitter>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::table::ColumnarTableToTable>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::table::TableToColumnarTable>();
+        this->module_descriptions.RegisterAutoDescription<megamol::datatools::table::ColumnarTableWhere>();
         // register calls
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::table::TableDataCall>();
+        this->call_descriptions.RegisterAutoDescription<megamol::datatools::table::ColumnarTableDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::ParticleFilterMapDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::GraphDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::datatools::MultiIndexListDataCall>();
+        this->call_descriptions.RegisterAutoDescription<megamol::datatools::ParticleNeighborsCall>();
     }
 };
 } // namespace megamol::datatools
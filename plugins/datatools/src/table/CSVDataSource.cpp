@@ -16,14 +16,16 @@
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/StringParam.h"
 
-#include "mmcore/utility/sys/ASCIIFileBuffer.h"
 #include "vislib/StringTokeniser.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <limits>
-#include <list>
-#include <map>
 #include <omp.h>
 #include <random>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 using namespace megamol::datatools;
@@ -80,6 +82,213 @@ double parseValue(const char* tokenStart, const char* tokenEnd) {
     return NAN;
 }
 
+namespace {
+
+/** Size of the blocks the data rows are read in */
+constexpr size_t streamBlockSize = 64 * 1024 * 1024;
+
+/** Identifies the files caching parsed CSV files */
+constexpr char cacheMagicID[8] = "MMCSVC";
+
+/** Version of the cache file format */
+constexpr uint16_t cacheVersion = 1;
+
+/** Powers of ten which are exactly representable as double */
+constexpr double exactPowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+    1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/** The rows parsed from one chunk of a block */
+struct ParsedChunk {
+    /** The cells in row-major order, categories as index into 'categoryNames' */
+    std::vector<float> values;
+
+    /** The number of rows */
+    size_t rowCnt = 0;
+
+    /** The number of rows up to and including the last row having all columns */
+    size_t completeRowCnt = 0;
+
+    /** The categories per column in the order of their first occurrence */
+    std::vector<std::vector<std::string>> categoryNames;
+
+    /** Maps the categories of the chunk to the global ones, per column */
+    std::vector<std::vector<float>> remap;
+};
+
+template<class T>
+T readBinary(std::istream& is) {
+    T retval;
+    is.read(reinterpret_cast<char*>(&retval), sizeof(T));
+    return retval;
+}
+
+template<class T>
+void writeBinary(std::ostream& os, const T value) {
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * Parses a plain decimal number without going through a stream. Answers
+ * 'false' for everything which cannot be converted exactly this way, e.g.
+ * timestamps, more than 19 significant digits or large exponents.
+ */
+bool parseNumber(const char* start, const char* end, double& outValue) {
+    const char* p = start;
+    while ((p != end) && ((*p == ' ') || (*p == '\t'))) {
+        ++p;
+    }
+
+    bool negative = false;
+    if ((p != end) && ((*p == '-') || (*p == '+'))) {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+    for (; (p != end) && (*p >= '0') && (*p <= '9'); ++p) {
+        anyDigit = true;
+        if ((mantissa == 0) && (*p == '0')) {
+            continue;
+        }
+        if (++digits > 19) {
+            return false;
+        }
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+    }
+    if ((p != end) && (*p == '.')) {
+        for (++p; (p != end) && (*p >= '0') && (*p <= '9'); ++p) {
+            anyDigit = true;
+            --exponent;
+            if ((mantissa == 0) && (*p == '0')) {
+                continue;
+            }
+            if (++digits > 19) {
+                return false;
+            }
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        }
+    }
+    if (!anyDigit) {
+        return false;
+    }
+
+    if ((p != end) && ((*p == 'e') || (*p == 'E'))) {
+        ++p;
+        bool negativeExp = false;
+        if ((p != end) && ((*p == '-') || (*p == '+'))) {
+            negativeExp = (*p == '-');
+            ++p;
+        }
+        int e = 0;
+        bool anyExpDigit = false;
+        for (; (p != end) && (*p >= '0') && (*p <= '9'); ++p) {
+            anyExpDigit = true;
+            if (e < 10000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        if (!anyExpDigit) {
+            return false;
+        }
+        exponent += negativeExp ? -e : e;
+    }
+    if (p != end) {
+        return false;
+    }
+
+    // exact only if the mantissa and the power of ten are exact doubles
+    if (mantissa > (uint64_t(1) << 53)) {
+        return false;
+    }
+    double value = static_cast<double>(mantissa);
+    if ((mantissa != 0) && (exponent != 0)) {
+        if ((exponent < -22) || (exponent > 22)) {
+            return false;
+        }
+        value = (exponent < 0) ? (value / exactPowersOfTen[-exponent]) : (value * exactPowersOfTen[exponent]);
+    }
+    outValue = negative ? -value : value;
+    return true;
+}
+
+/** Answer the begin of the next separator or 'end' */
+inline char* findSeparator(char* start, char* end, const std::string& sep) {
+    if (sep.size() == 1) {
+        auto retval = static_cast<char*>(std::memchr(start, sep[0], end - start));
+        return (retval != nullptr) ? retval : end;
+    }
+    return std::search(start, end, sep.begin(), sep.end());
+}
+
+/**
+ * Parses the lines in [begin, end), which must start at a line boundary.
+ */
+void parseChunk(char* begin, char* end, const std::string& sep, bool decimalComma,
+    const std::vector<TableDataCall::ColumnInfo>& columns, ParsedChunk& out) {
+    const size_t colCnt = columns.size();
+    std::vector<std::unordered_map<std::string, float>> catMaps(colCnt);
+    out.categoryNames.resize(colCnt);
+
+    char* lineStart = begin;
+    while (lineStart < end) {
+        char* lineEnd = static_cast<char*>(std::memchr(lineStart, '\n', end - lineStart));
+        char* next = (lineEnd != nullptr) ? (lineEnd + 1) : end;
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        if ((lineEnd != lineStart) && (*(lineEnd - 1) == '\r')) {
+            --lineEnd;
+        }
+
+        char* start = lineStart;
+        size_t col = 0;
+        while ((start != lineEnd) && (col < colCnt)) {
+            char* tokenEnd = findSeparator(start, lineEnd, sep);
+            float value;
+            if (columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
+                std::string token(start, tokenEnd);
+                auto cmi = catMaps[col].find(token);
+                if (cmi == catMaps[col].end()) {
+                    cmi = catMaps[col].insert(std::make_pair(token, static_cast<float>(catMaps[col].size()))).first;
+                    out.categoryNames[col].push_back(token);
+                }
+                value = cmi->second;
+            } else {
+                if (decimalComma) {
+                    std::replace(start, tokenEnd, ',', '.');
+                }
+                double number;
+                if (!parseNumber(start, tokenEnd, number)) {
+                    number = parseValue(start, tokenEnd);
+                }
+                value = static_cast<float>(number);
+            }
+            out.values.push_back(value);
+            col++;
+
+            start = tokenEnd;
+            if (start != lineEnd) {
+                start += sep.size();
+            }
+        }
+        ++out.rowCnt;
+        if (col >= colCnt) {
+            out.completeRowCnt = out.rowCnt;
+        }
+        for (; col < colCnt; ++col) {
+            out.values.push_back(std::numeric_limits<float>::quiet_NaN());
+        }
+
+        lineStart = next;
+    }
+}
+
+} // namespace
+
+
 CSVDataSource::CSVDataSource(void)
         : core::Module()
         , filenameSlot("filename", "Filename to read from")
@@ -91,6 +300,7 @@ CSVDataSource::CSVDataSource(void)
         , colSepSlot("colSep", "The column separator (detected if empty)")
         , decSepSlot("decSep", "The decimal point parser format type")
         , shuffleSlot("shuffle", "Shuffle data points")
+        , useCacheSlot("useCache", "Cache the parsed table in a binary file beside the CSV file (<file>.cache)")
         , getDataSlot("getData", "Slot providing the data")
         , dataHash(0)
         , columns()
@@ -127,6 +337,10 @@ CSVDataSource::CSVDataSource(void)
     this->shuffleSlot.SetParameter(new core::param::BoolParam(false));
     this->MakeSlotAvailable(&this->shuffleSlot);
 
+    // off by default, as the cache file is written into the directory of the data
+    this->useCacheSlot.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->useCacheSlot);
+
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetData", &CSVDataSource::getDataCallback);
     this->getDataSlot.SetCallback(TableDataCall::ClassName(), "GetHash", &CSVDataSource::getHashCallback);
     this->MakeSlotAvailable(&this->getDataSlot);
@@ -171,16 +385,43 @@ void CSVDataSource::assertData(void) {
     this->values.clear();
 
     auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
+    const bool useCache = this->useCacheSlot.Param<core::param::BoolParam>()->Value();
+    std::filesystem::path cacheFilename = filename;
+    cacheFilename += ".cache";
 
     try {
-        vislib::sys::ASCIIFileBuffer file;
+        // 0. Use the cached table if it is still valid
+        //////////////////////////////////////////////////////////////////////
+        if (useCache && this->loadCache(filename, cacheFilename)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "Tabular data loaded from cache: %u dimensions; %u samples\n",
+                static_cast<unsigned int>(this->columns.size()),
+                static_cast<unsigned int>(this->values.size() / std::max<size_t>(1, this->columns.size())));
+            shuffleData();
+            this->dataHash++;
+            return;
+        }
 
-        // 1. Load the whole file into memory (FAST!)
+        // 1. Read the lines preceding the data on demand
         //////////////////////////////////////////////////////////////////////
-        if (!file.LoadFile(filename.native().c_str(), vislib::sys::ASCIIFileBuffer::PARSING_LINES))
-            throw vislib::Exception(__FILE__, __LINE__);
-        if (file.Count() < 2)
-            throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open())
+            throw vislib::Exception("Unable to open file", __FILE__, __LINE__);
+
+        std::vector<std::string> headLines;
+        std::vector<std::streamoff> headOffsets;
+        auto headLine = [&file, &headLines, &headOffsets](int idx) -> const char* {
+            while (static_cast<int>(headLines.size()) <= idx) {
+                std::string line;
+                headOffsets.push_back(file.tellg());
+                if (!std::getline(file, line))
+                    throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
+                if (!line.empty() && (line.back() == '\r'))
+                    line.pop_back();
+                headLines.push_back(std::move(line));
+            }
+            return headLines[idx].c_str();
+        };
 
         // 2. Determine the first row, column separator, and decimal point
         //////////////////////////////////////////////////////////////////////
@@ -194,8 +435,8 @@ void CSVDataSource::assertData(void) {
         auto comment = vislib::StringA(this->commentPrefixSlot.Param<core::param::StringParam>()->Value().c_str());
         if (!comment.IsEmpty()) {
             // Skip comments at the beginning of the file.
-            while (firstHeaRow < file.Count()) {
-                if (!vislib::StringA(file[firstHeaRow]).StartsWith(comment)) {
+            while (true) {
+                if (!vislib::StringA(headLine(firstHeaRow)).StartsWith(comment)) {
                     break;
                 }
                 firstHeaRow++;
@@ -207,8 +448,8 @@ void CSVDataSource::assertData(void) {
         if (colSep.IsEmpty()) {
             // Detect column separator
             const char ColSepCanidates[] = {'\t', ';', ',', '|'};
-            vislib::StringA l1(file[firstHeaRow]);
-            vislib::StringA l2(file[firstHeaRow]);
+            vislib::StringA l1(headLine(firstHeaRow));
+            vislib::StringA l2(headLine(firstHeaRow));
             for (int i = 0; i < sizeof(ColSepCanidates) / sizeof(char); ++i) {
                 SIZE_T c1 = l1.Count(ColSepCanidates[i]);
                 if ((c1 > 0) && (c1 == l2.Count(ColSepCanidates[i]))) {
@@ -225,7 +466,8 @@ void CSVDataSource::assertData(void) {
             static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
         if (decType == DecimalSeparator::Unknown) {
             // Detect decimal type
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstDatRow], colSep, false));
+            vislib::Array<vislib::StringA> tokens(
+                vislib::StringTokeniserA::Split(headLine(firstDatRow), colSep, false));
             for (SIZE_T i = 0; i < tokens.Count(); i++) {
                 bool hasDot = tokens[i].Contains('.');
                 bool hasComma = tokens[i].Contains(',');
@@ -247,10 +489,10 @@ void CSVDataSource::assertData(void) {
         //////////////////////////////////////////////////////////////////////
         vislib::Array<vislib::StringA> dimNames;
         if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
+            dimNames = vislib::StringTokeniserA::Split(headLine(firstHeaRow), colSep, false);
             firstHeaRow++;
         } else {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
+            dimNames = vislib::StringTokeniserA::Split(headLine(firstHeaRow), colSep, false);
             for (SIZE_T i = 0; i < dimNames.Count(); ++i) {
                 dimNames[i].Format("Dim %d", static_cast<int>(i));
             }
@@ -258,14 +500,13 @@ void CSVDataSource::assertData(void) {
         this->columns.resize(dimNames.Count());
         this->values.clear();
 
-        bool hasCatDims = false;
         if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false));
+            vislib::Array<vislib::StringA> tokens(
+                vislib::StringTokeniserA::Split(headLine(firstHeaRow), colSep, false));
             for (SIZE_T i = 0; i < dimNames.Count(); i++) {
                 TableDataCall::ColumnType type = TableDataCall::ColumnType::QUANTITATIVE;
                 if (tokens.Count() > i && tokens[i].Equals("CATEGORICAL", true)) {
                     type = TableDataCall::ColumnType::CATEGORICAL;
-                    hasCatDims = true;
                 }
                 this->columns[i]
                     .SetName(dimNames[i].PeekBuffer())
@@ -283,94 +524,150 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        // 4. Data format is now clear... finally parse actual data
+        // 4. Data format is now clear... stream the data rows in blocks,
+        //    each block being split at line boundaries and parsed in parallel
         //////////////////////////////////////////////////////////////////////
-        size_t colCnt = static_cast<size_t>(this->columns.size());
-        size_t rowCnt = static_cast<size_t>(file.Count() - firstDatRow);
-        int colSepEnd = colSep.Length() - 1;
-
-        // Test for empty lines at the end
-        for (; rowCnt > 0; --rowCnt) {
-            const char* start = file[firstDatRow + rowCnt - 1];
-            const char* end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos])
-                        colSepPos++;
-                    else
-                        colSepPos = 0;
-                    ++end;
+        const size_t colCnt = static_cast<size_t>(this->columns.size());
+        const std::string sep(colSep.PeekBuffer());
+        const bool decimalComma = (decType == DecimalSeparator::DE);
+
+        headLine(firstDatRow);
+        file.clear();
+        file.seekg(headOffsets[firstDatRow]);
+
+        // categories are numbered in the order of their first occurrence
+        std::vector<std::unordered_map<std::string, float>> categories(colCnt);
+        size_t rowCnt = 0;
+        size_t completeRowCnt = 0;
+
+        std::vector<char> block;
+        size_t carry = 0;
+        bool isEof = false;
+        while (!isEof) {
+            block.resize(carry + streamBlockSize);
+            file.read(block.data() + carry, streamBlockSize);
+            const size_t len = carry + static_cast<size_t>(file.gcount());
+            isEof = (file.gcount() < static_cast<std::streamsize>(streamBlockSize));
+
+            size_t parseLen = len;
+            if (!isEof) {
+                while ((parseLen > carry) && (block[parseLen - 1] != '\n')) {
+                    --parseLen;
+                }
+                if (parseLen == carry) {
+                    // line longer than a block: read more before parsing
+                    carry = len;
+                    continue;
                 }
-                col++;
             }
-            if (col >= colCnt)
-                break; // we found the last line containing a full data set
-        }
 
-        // Parse in parallel, assuming all lines will work
-        std::vector<std::map<std::string, float>> catMaps;
-        int thCnt = omp_get_max_threads();
-        catMaps.resize(colCnt * thCnt);
-        values.resize(colCnt * rowCnt);
-        bool hasInvalids = false;
-
-#pragma omp parallel for
-        for (long long idx = 0; idx < static_cast<long long>(rowCnt); ++idx) {
-            int thId = omp_get_thread_num();
-            const char* start = file[static_cast<size_t>(firstDatRow + idx)];
-            const char* end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                std::map<std::string, float>& catMap = catMaps[thId + col * thCnt];
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos])
-                        colSepPos++;
-                    else
-                        colSepPos = 0;
-                    ++end;
+            // split the block at line boundaries into chunks for the threads
+            const size_t chunkCnt = static_cast<size_t>(omp_get_max_threads()) * 4;
+            std::vector<size_t> bounds(1, 0);
+            for (size_t i = 1; i < chunkCnt; ++i) {
+                size_t b = std::max(bounds.back(), i * parseLen / chunkCnt);
+                while ((b > 0) && (b < parseLen) && (block[b - 1] != '\n')) {
+                    ++b;
+                }
+                if (b > bounds.back()) {
+                    bounds.push_back(b);
                 }
+            }
+            if (parseLen > bounds.back()) {
+                bounds.push_back(parseLen);
+            }
 
-                if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
-                    if (decType == DecimalSeparator::DE) {
-                        for (char* ez = const_cast<char*>(start); ez != end; ++ez)
-                            if (*ez == ',')
-                                *ez = '.';
-                    }
-                    double value = parseValue(start, end);
-                    values[static_cast<size_t>(idx * colCnt + col)] = static_cast<float>(value);
-                    if (std::isnan(value)) {
-                        hasInvalids = true;
+            std::vector<ParsedChunk> chunks(bounds.size() - 1);
+#pragma omp parallel for schedule(dynamic)
+            for (long long c = 0; c < static_cast<long long>(chunks.size()); ++c) {
+                parseChunk(block.data() + bounds[c], block.data() + bounds[c + 1], sep, decimalComma,
+                    this->columns, chunks[c]);
+            }
+
+            // merge the categories of the chunks into the global numbering
+            std::vector<size_t> rowOffsets(chunks.size() + 1, rowCnt);
+            for (size_t c = 0; c < chunks.size(); ++c) {
+                auto& chunk = chunks[c];
+                rowOffsets[c + 1] = rowOffsets[c] + chunk.rowCnt;
+                if (chunk.completeRowCnt > 0) {
+                    completeRowCnt = rowOffsets[c] + chunk.completeRowCnt;
+                }
+                chunk.remap.resize(colCnt);
+                for (size_t col = 0; col < colCnt; ++col) {
+                    for (const auto& name : chunk.categoryNames[col]) {
+                        auto cmi = categories[col].find(name);
+                        if (cmi == categories[col].end()) {
+                            cmi = categories[col]
+                                      .insert(std::make_pair(name, static_cast<float>(categories[col].size())))
+                                      .first;
+                        }
+                        chunk.remap[col].push_back(cmi->second);
                     }
-                } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
-                    assert(hasCatDims);
-                    std::map<std::string, float>::iterator cmi = catMap.find(start);
-                    if (cmi == catMap.end()) {
-                        cmi = catMap
-                                  .insert(std::pair<std::string, float>(
-                                      start, static_cast<float>(thId + thCnt * catMap.size())))
-                                  .first;
+                }
+            }
+            rowCnt = rowOffsets.back();
+            this->values.resize(rowCnt * colCnt);
+
+#pragma omp parallel for schedule(dynamic)
+            for (long long c = 0; c < static_cast<long long>(chunks.size()); ++c) {
+                auto& chunk = chunks[c];
+                float* dst = this->values.data() + rowOffsets[c] * colCnt;
+                std::copy(chunk.values.begin(), chunk.values.end(), dst);
+                for (size_t col = 0; col < colCnt; ++col) {
+                    if (chunk.remap[col].empty())
+                        continue;
+                    for (size_t r = 0; r < chunk.rowCnt; ++r) {
+                        float& v = dst[r * colCnt + col];
+                        if (!std::isnan(v)) {
+                            v = chunk.remap[col][static_cast<size_t>(v)];
+                        }
                     }
-                    values[static_cast<size_t>(idx * colCnt + col)] = cmi->second;
-                } else {
-                    assert(false);
                 }
+            }
+
+            carry = len - parseLen;
+            std::memmove(block.data(), block.data() + parseLen, carry);
+        }
 
-                col++;
-                if (*end != '\0') {
-                    start = end + 1;
-                    end = start;
+        // Drop the incomplete (e.g. empty) lines at the end
+        rowCnt = completeRowCnt;
+        this->values.resize(rowCnt * colCnt);
+        this->values.shrink_to_fit();
+
+        // Collect min/max and report invalid data if present (note: do not drop data!)
+        std::vector<float> minVals(colCnt, std::numeric_limits<float>::max());
+        std::vector<float> maxVals(colCnt, -std::numeric_limits<float>::max());
+        bool hasInvalids = false;
+#pragma omp parallel
+        {
+            std::vector<float> thMinVals(minVals);
+            std::vector<float> thMaxVals(maxVals);
+            bool thHasInvalids = false;
+#pragma omp for
+            for (long long r = 0; r < static_cast<long long>(rowCnt); ++r) {
+                for (size_t c = 0; c < colCnt; ++c) {
+                    float f = values[r * colCnt + c];
+                    if (std::isnan(f))
+                        thHasInvalids = true;
+                    if (f < thMinVals[c])
+                        thMinVals[c] = f;
+                    if (f > thMaxVals[c])
+                        thMaxVals[c] = f;
                 }
             }
-            for (; col < colCnt; ++col) {
-                values[static_cast<size_t>(idx * colCnt + col)] = std::numeric_limits<float>::quiet_NaN();
-                hasInvalids = true;
+#pragma omp critical
+            {
+                hasInvalids = hasInvalids || thHasInvalids;
+                for (size_t c = 0; c < colCnt; ++c) {
+                    minVals[c] = std::min(minVals[c], thMinVals[c]);
+                    maxVals[c] = std::max(maxVals[c], thMaxVals[c]);
+                }
             }
         }
+        for (size_t c = 0; c < colCnt; ++c) {
+            columns[c].SetMinimumValue(minVals[c]).SetMaximumValue(maxVals[c]);
+        }
 
-        // Report invalid data if present (note: do not drop data!)
         if (hasInvalids) {
             megamol::core::utility::log::Log::DefaultLog.WriteWarn("CSV file contains invalid data:");
             for (size_t c = 0; c < colCnt; ++c) {
@@ -395,55 +692,15 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        // Merge categorical data so that all `value indices` map to one `string key`
-        if (hasCatDims) {
-            for (size_t c = 0; c < colCnt; ++c) {
-                if (columns[c].Type() != TableDataCall::ColumnType::CATEGORICAL)
-                    continue;
-                std::map<int, int> catRemap;
-                std::map<std::string, int> catMap;
-                for (int ci = static_cast<int>(c) * thCnt; ci < static_cast<int>(c + 1) * thCnt; ++ci) {
-                    for (const std::pair<std::string, float>& p : catMaps[ci]) {
-                        int vi = static_cast<int>(p.second + 0.49f);
-                        std::map<std::string, int>::iterator cmi = catMap.find(p.first);
-                        if (cmi == catMap.end()) {
-                            int nv = static_cast<int>(catMap.size());
-                            catMap[p.first] = nv;
-                            catRemap[vi] = nv;
-                        } else {
-                            catRemap[vi] = cmi->second;
-                        }
-                    }
-                }
-
-                for (size_t r = 0; r < rowCnt; ++r) {
-                    int vi = static_cast<int>(values[r * colCnt + c] + 0.49f);
-                    values[r * colCnt + c] = static_cast<float>(catRemap[vi]);
-                }
-            }
-        }
-
-        // Collect min/max
-        std::vector<float> minVals(colCnt, std::numeric_limits<float>::max());
-        std::vector<float> maxVals(colCnt, -std::numeric_limits<float>::max());
-        for (size_t r = 0; r < rowCnt; ++r) {
-            for (size_t c = 0; c < colCnt; ++c) {
-                float f = values[r * colCnt + c];
-                if (f < minVals[c])
-                    minVals[c] = f;
-                if (f > maxVals[c])
-                    maxVals[c] = f;
-            }
-        }
-        for (size_t c = 0; c < colCnt; ++c) {
-            columns[c].SetMinimumValue(minVals[c]).SetMaximumValue(maxVals[c]);
-        }
-
-        // 5. All done... report summary
+        // 5. All done... report summary and update the cache
         //////////////////////////////////////////////////////////////////////
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("Tabular data loaded: %u dimensions; %u samples\n",
             static_cast<unsigned int>(colCnt), static_cast<unsigned int>(rowCnt));
 
+        if (useCache) {
+            this->saveCache(filename, cacheFilename);
+        }
+
     } catch (const vislib::Exception& ex) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("Could not load \"%s\": %s [%s, %d]",
             filename.generic_u8string().c_str(), ex.GetMsgA(), ex.GetFile(), ex.GetLine());
@@ -459,6 +716,132 @@ void CSVDataSource::assertData(void) {
     this->dataHash++;
 }
 
+std::string CSVDataSource::cacheKey(void) const {
+    std::stringstream ss;
+    ss << this->skipPrefaceSlot.Param<core::param::IntParam>()->Value() << '\n'
+       << this->headerNamesSlot.Param<core::param::BoolParam>()->Value() << '\n'
+       << this->headerTypesSlot.Param<core::param::BoolParam>()->Value() << '\n'
+       << this->commentPrefixSlot.Param<core::param::StringParam>()->Value() << '\n'
+       << this->colSepSlot.Param<core::param::StringParam>()->Value() << '\n'
+       << this->decSepSlot.Param<core::param::EnumParam>()->Value();
+    return ss.str();
+}
+
+bool CSVDataSource::loadCache(const std::filesystem::path& filename, const std::filesystem::path& cacheFilename) {
+    std::error_code ec;
+    if (!std::filesystem::exists(cacheFilename, ec)) {
+        return false;
+    }
+    const uint64_t csvSize = static_cast<uint64_t>(std::filesystem::file_size(filename, ec));
+    if (ec) {
+        return false;
+    }
+    const int64_t csvTime =
+        static_cast<int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+    if (ec) {
+        return false;
+    }
+
+    std::ifstream file(cacheFilename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        file.exceptions(std::ios::failbit | std::ios::badbit);
+
+        char magicID[sizeof(cacheMagicID)];
+        file.read(magicID, sizeof(cacheMagicID));
+        if (std::memcmp(magicID, cacheMagicID, sizeof(cacheMagicID)) != 0) {
+            return false;
+        }
+        if ((readBinary<uint16_t>(file) != cacheVersion) || (readBinary<uint64_t>(file) != csvSize) ||
+            (readBinary<int64_t>(file) != csvTime)) {
+            return false;
+        }
+        std::string key(readBinary<uint32_t>(file), '\0');
+        file.read(&key[0], key.size());
+        if (key != this->cacheKey()) {
+            return false;
+        }
+
+        auto colCnt = readBinary<uint32_t>(file);
+        std::vector<TableDataCall::ColumnInfo> cols(colCnt);
+        for (uint32_t c = 0; c < colCnt; ++c) {
+            std::string name(readBinary<uint16_t>(file), '\0');
+            file.read(&name[0], name.size());
+            cols[c].SetName(name);
+            cols[c].SetType((readBinary<uint8_t>(file) == 1) ? TableDataCall::ColumnType::CATEGORICAL
+                                                             : TableDataCall::ColumnType::QUANTITATIVE);
+            cols[c].SetMinimumValue(readBinary<float>(file));
+            cols[c].SetMaximumValue(readBinary<float>(file));
+        }
+
+        auto rowCnt = readBinary<uint64_t>(file);
+        std::vector<float> vals(rowCnt * colCnt);
+        file.read(reinterpret_cast<char*>(vals.data()), vals.size() * sizeof(float));
+
+        this->columns = std::move(cols);
+        this->values = std::move(vals);
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Ignoring unreadable cache file \"%s\".", cacheFilename.generic_u8string().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void CSVDataSource::saveCache(const std::filesystem::path& filename, const std::filesystem::path& cacheFilename) {
+    std::error_code ec;
+    const uint64_t csvSize = static_cast<uint64_t>(std::filesystem::file_size(filename, ec));
+    if (ec) {
+        return;
+    }
+    const int64_t csvTime =
+        static_cast<int64_t>(std::filesystem::last_write_time(filename, ec).time_since_epoch().count());
+    if (ec) {
+        return;
+    }
+
+    std::ofstream file(cacheFilename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Unable to create cache file \"%s\".", cacheFilename.generic_u8string().c_str());
+        return;
+    }
+
+    try {
+        file.exceptions(std::ios::failbit | std::ios::badbit);
+
+        file.write(cacheMagicID, sizeof(cacheMagicID));
+        writeBinary<uint16_t>(file, cacheVersion);
+        writeBinary<uint64_t>(file, csvSize);
+        writeBinary<int64_t>(file, csvTime);
+        const auto key = this->cacheKey();
+        writeBinary<uint32_t>(file, static_cast<uint32_t>(key.size()));
+        file.write(key.data(), key.size());
+
+        writeBinary<uint32_t>(file, static_cast<uint32_t>(this->columns.size()));
+        for (const auto& ci : this->columns) {
+            writeBinary<uint16_t>(file, static_cast<uint16_t>(ci.Name().size()));
+            file.write(ci.Name().data(), ci.Name().size());
+            writeBinary<uint8_t>(file, (ci.Type() == TableDataCall::ColumnType::CATEGORICAL) ? 1 : 0);
+            writeBinary<float>(file, ci.MinimumValue());
+            writeBinary<float>(file, ci.MaximumValue());
+        }
+
+        const uint64_t rowCnt = this->columns.empty() ? 0 : (this->values.size() / this->columns.size());
+        writeBinary<uint64_t>(file, rowCnt);
+        file.write(reinterpret_cast<const char*>(this->values.data()), this->values.size() * sizeof(float));
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Unable to write cache file \"%s\".", cacheFilename.generic_u8string().c_str());
+        file.close();
+        std::filesystem::remove(cacheFilename, ec);
+    }
+}
+
 void CSVDataSource::shuffleData() {
     if (!this->shuffleSlot.Param<core::param::BoolParam>()->Value()) {
         // Do not shuffle, unless requested
@@ -14,6 +14,8 @@
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include <filesystem>
+#include <string>
 #include <vector>
 
 namespace megamol {
@@ -47,6 +49,20 @@ private:
     bool clearData(core::param::ParamSlot& caller);
     void shuffleData();
 
+    /** Answer the parameters the cached table depends on */
+    std::string cacheKey(void) const;
+
+    /**
+     * Loads the table from the cache file if it is still valid for the CSV
+     * file and the current parameters.
+     *
+     * @return 'true' if the table has been loaded, 'false' otherwise.
+     */
+    bool loadCache(const std::filesystem::path& filename, const std::filesystem::path& cacheFilename);
+
+    /** Writes the current table to the cache file */
+    void saveCache(const std::filesystem::path& filename, const std::filesystem::path& cacheFilename);
+
     core::param::ParamSlot filenameSlot;
     core::param::ParamSlot skipPrefaceSlot;
     core::param::ParamSlot headerNamesSlot;
@@ -56,6 +72,7 @@ private:
     core::param::ParamSlot colSepSlot;
     core::param::ParamSlot decSepSlot;
     core::param::ParamSlot shuffleSlot;
+    core::param::ParamSlot useCacheSlot;
 
     core::CalleeSlot getDataSlot;
 
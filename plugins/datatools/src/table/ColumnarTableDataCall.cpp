@@ -0,0 +1,208 @@
+/*
+ * ColumnarTableDataCall.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+#include "datatools/table/ColumnarTableDataCall.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::table;
+using namespace megamol;
+
+
+namespace {
+
+/** Number of rows converted in one block by 'MaterializeRowMajor' */
+constexpr size_t materializeBlockSize = 4096;
+
+template<class T>
+void copyAsFloat(const T* src, size_t cnt, float* dst, size_t dstStride) {
+    for (size_t i = 0; i < cnt; ++i) {
+        dst[i * dstStride] = static_cast<float>(src[i]);
+    }
+}
+
+template<class T>
+void gatherAsFloat(const T* src, const size_t* rows, size_t cnt, float* dst, size_t dstStride) {
+    for (size_t i = 0; i < cnt; ++i) {
+        dst[i * dstStride] = static_cast<float>(src[rows[i]]);
+    }
+}
+
+} // namespace
+
+
+/*
+ * ColumnarTableDataCall::Column::Column
+ */
+ColumnarTableDataCall::Column::Column(void)
+        : name()
+        , type(DataType::FLOAT)
+        , minVal(0.0)
+        , maxVal(0.0)
+        , data(nullptr)
+        , dict(nullptr)
+        , dictSize(0) {
+    // intentionally empty
+}
+
+
+/*
+ * ColumnarTableDataCall::Column::ElementSize
+ */
+size_t ColumnarTableDataCall::Column::ElementSize(void) const {
+    switch (type) {
+    case DataType::FLOAT:
+        return sizeof(float);
+    case DataType::DOUBLE:
+        return sizeof(double);
+    case DataType::INT32:
+        return sizeof(int32_t);
+    case DataType::INT64:
+        return sizeof(int64_t);
+    case DataType::DICTIONARY:
+        return sizeof(uint32_t);
+    }
+    return 0;
+}
+
+
+/*
+ * ColumnarTableDataCall::Column::CopyAsFloat
+ */
+void ColumnarTableDataCall::Column::CopyAsFloat(size_t first, size_t cnt, float* dst, size_t dstStride) const {
+    switch (type) {
+    case DataType::FLOAT:
+        copyAsFloat(static_cast<const float*>(data) + first, cnt, dst, dstStride);
+        break;
+    case DataType::DOUBLE:
+        copyAsFloat(static_cast<const double*>(data) + first, cnt, dst, dstStride);
+        break;
+    case DataType::INT32:
+        copyAsFloat(static_cast<const int32_t*>(data) + first, cnt, dst, dstStride);
+        break;
+    case DataType::INT64:
+        copyAsFloat(static_cast<const int64_t*>(data) + first, cnt, dst, dstStride);
+        break;
+    case DataType::DICTIONARY:
+        copyAsFloat(static_cast<const uint32_t*>(data) + first, cnt, dst, dstStride);
+        break;
+    }
+}
+
+
+/*
+ * ColumnarTableDataCall::Column::GatherAsFloat
+ */
+void ColumnarTableDataCall::Column::GatherAsFloat(const size_t* rows, size_t cnt, float* dst, size_t dstStride) const {
+    switch (type) {
+    case DataType::FLOAT:
+        gatherAsFloat(static_cast<const float*>(data), rows, cnt, dst, dstStride);
+        break;
+    case DataType::DOUBLE:
+        gatherAsFloat(static_cast<const double*>(data), rows, cnt, dst, dstStride);
+        break;
+    case DataType::INT32:
+        gatherAsFloat(static_cast<const int32_t*>(data), rows, cnt, dst, dstStride);
+        break;
+    case DataType::INT64:
+        gatherAsFloat(static_cast<const int64_t*>(data), rows, cnt, dst, dstStride);
+        break;
+    case DataType::DICTIONARY:
+        gatherAsFloat(static_cast<const uint32_t*>(data), rows, cnt, dst, dstStride);
+        break;
+    }
+}
+
+
+/*
+ * ColumnarTableDataCall::Column::ToColumnInfo
+ */
+TableDataCall::ColumnInfo ColumnarTableDataCall::Column::ToColumnInfo(void) const {
+    TableDataCall::ColumnInfo info;
+    info.SetName(name)
+        .SetType(this->Semantic())
+        .SetMinimumValue(static_cast<float>(minVal))
+        .SetMaximumValue(static_cast<float>(maxVal));
+    return info;
+}
+
+
+/*
+ * ColumnarTableDataCall::ColumnarTableDataCall
+ */
+ColumnarTableDataCall::ColumnarTableDataCall(void)
+        : core::AbstractGetDataCall()
+        , columns_count(0)
+        , rows_count(0)
+        , columns(nullptr)
+        , selection(nullptr)
+        , selection_count(0)
+        , frameCount(0)
+        , frameID(0) {
+    // intentionally empty
+}
+
+
+/*
+ * ColumnarTableDataCall::~ColumnarTableDataCall
+ */
+ColumnarTableDataCall::~ColumnarTableDataCall(void) {
+    columns_count = 0; // paranoia
+    rows_count = 0;    // paranoia
+    columns = nullptr; // do not delete, since we do not own the memory of the objects
+    selection = nullptr;
+}
+
+
+/*
+ * ColumnarTableDataCall::FindColumn
+ */
+size_t ColumnarTableDataCall::FindColumn(const std::string& name) const {
+    for (size_t i = 0; i < columns_count; ++i) {
+        if (columns[i].Name() == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+/*
+ * ColumnarTableDataCall::MaterializeRowMajor
+ */
+void ColumnarTableDataCall::MaterializeRowMajor(
+    std::vector<TableDataCall::ColumnInfo>& outInfos, std::vector<float>& outData) const {
+    outInfos.resize(columns_count);
+    for (size_t c = 0; c < columns_count; ++c) {
+        outInfos[c] = columns[c].ToColumnInfo();
+    }
+
+    const size_t rowCnt = this->GetSelectedRowsCount();
+    outData.resize(columns_count * rowCnt);
+    if (outData.empty()) {
+        return;
+    }
+
+    // blocks of rows keep the written part of the output in cache while
+    // every column is read sequentially
+    const auto blockCnt = static_cast<int64_t>((rowCnt + materializeBlockSize - 1) / materializeBlockSize);
+#pragma omp parallel for
+    for (int64_t b = 0; b < blockCnt; ++b) {
+        const size_t first = static_cast<size_t>(b) * materializeBlockSize;
+        const size_t cnt = std::min(materializeBlockSize, rowCnt - first);
+        float* dst = outData.data() + first * columns_count;
+        for (size_t c = 0; c < columns_count; ++c) {
+            if (selection != nullptr) {
+                columns[c].GatherAsFloat(selection + first, cnt, dst + c, columns_count);
+            } else {
+                columns[c].CopyAsFloat(first, cnt, dst + c, columns_count);
+            }
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * ColumnarTableToTable.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "ColumnarTableToTable.h"
+#include "stdafx.h"
+
+#include "mmcore/utility/log/Log.h"
+#include <limits>
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::table;
+using namespace megamol;
+
+std::string ColumnarTableToTable::ModuleName = std::string("ColumnarTableToTable");
+
+ColumnarTableToTable::ColumnarTableToTable(void)
+        : core::Module()
+        , dataOutSlot("dataOut", "Output")
+        , dataInSlot("dataIn", "Input")
+        , frameID(-1)
+        , datahash(std::numeric_limits<unsigned long>::max()) {
+
+    this->dataInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataInSlot);
+
+    this->dataOutSlot.SetCallback(
+        TableDataCall::ClassName(), TableDataCall::FunctionName(0), &ColumnarTableToTable::processData);
+    this->dataOutSlot.SetCallback(
+        TableDataCall::ClassName(), TableDataCall::FunctionName(1), &ColumnarTableToTable::getExtent);
+    this->MakeSlotAvailable(&this->dataOutSlot);
+}
+
+ColumnarTableToTable::~ColumnarTableToTable(void) {
+    this->Release();
+}
+
+bool ColumnarTableToTable::create(void) {
+    return true;
+}
+
+void ColumnarTableToTable::release(void) {}
+
+bool ColumnarTableToTable::processData(core::Call& c) {
+    try {
+        TableDataCall* outCall = dynamic_cast<TableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        ColumnarTableDataCall* inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)())
+            return false;
+
+        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+            inCall->MaterializeRowMajor(this->columnInfos, this->data);
+        }
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetFrameID(this->frameID);
+        outCall->SetDataHash(this->datahash);
+
+        if (this->columnInfos.size() != 0) {
+            outCall->Set(this->columnInfos.size(), this->data.size() / this->columnInfos.size(),
+                this->columnInfos.data(), this->data.data());
+        } else {
+            outCall->Set(0, 0, NULL, NULL);
+        }
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("Failed to execute %hs::processData\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool ColumnarTableToTable::getExtent(core::Call& c) {
+    try {
+        TableDataCall* outCall = dynamic_cast<TableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        ColumnarTableDataCall* inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(1))
+            return false;
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetDataHash(inCall->DataHash());
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("Failed to execute %hs::getExtent\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
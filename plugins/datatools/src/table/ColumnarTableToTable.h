@@ -0,0 +1,90 @@
+/*
+ * ColumnarTableToTable.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLETOTABLE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLETOTABLE_H_INCLUDED
+
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+
+#include "datatools/table/ColumnarTableDataCall.h"
+#include "datatools/table/TableDataCall.h"
+
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+namespace table {
+
+/*
+ * Module providing the row-major layout of a columnar table to consumers of
+ * 'TableDataCall'. The layout is only materialised if the data changed.
+ */
+class ColumnarTableToTable : public core::Module {
+public:
+    static std::string ModuleName;
+
+    /** Return module class name */
+    static const char* ClassName(void) {
+        return ModuleName.c_str();
+    }
+
+    /** Return module class description */
+    static const char* Description(void) {
+        return "Converts a columnar table into a row-major table of floats";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor */
+    ColumnarTableToTable(void);
+
+    /** Dtor */
+    virtual ~ColumnarTableToTable(void);
+
+protected:
+    /** Lazy initialization of the module */
+    virtual bool create(void);
+
+    /** Resource release */
+    virtual void release(void);
+
+private:
+    /** Data callback */
+    bool processData(core::Call& c);
+
+    bool getExtent(core::Call& c);
+
+    /** Data output slot */
+    core::CalleeSlot dataOutSlot;
+
+    /** Data input slot */
+    core::CallerSlot dataInSlot;
+
+    /** ID of the current frame */
+    int frameID;
+
+    /** Hash of the current data */
+    size_t datahash;
+
+    /** Vector storing information about columns */
+    std::vector<TableDataCall::ColumnInfo> columnInfos;
+
+    /** Vector storing the materialised float data */
+    std::vector<float> data;
+}; /* end class ColumnarTableToTable */
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace megamol */
+
+#endif /* end ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLETOTABLE_H_INCLUDED */
@@ -0,0 +1,159 @@
+/*
+ * ColumnarTableWhere.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "ColumnarTableWhere.h"
+#include "stdafx.h"
+
+#include "mmcore/param/FloatParam.h"
+#include "mmcore/param/StringParam.h"
+
+#include "mmcore/utility/log/Log.h"
+#include <limits>
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::table;
+using namespace megamol;
+
+std::string ColumnarTableWhere::ModuleName = std::string("ColumnarTableWhere");
+
+ColumnarTableWhere::ColumnarTableWhere(void)
+        : core::Module()
+        , dataOutSlot("dataOut", "Output")
+        , dataInSlot("dataIn", "Input")
+        , expressionSlot("expression", "The predicate rows must fulfil, e.g. \"x > 0.5 && y <= 3 || type == \"a\"\"")
+        , epsilonSlot("epsilon", "The epsilon value for testing (in-) equality.")
+        , frameID(-1)
+        , datahash(std::numeric_limits<unsigned long>::max())
+        , localHash(0)
+        , rowsCount(0)
+        , selectAll(true) {
+
+    this->dataInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataInSlot);
+
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(), ColumnarTableDataCall::FunctionName(0),
+        &ColumnarTableWhere::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(), ColumnarTableDataCall::FunctionName(1),
+        &ColumnarTableWhere::getExtent);
+    this->MakeSlotAvailable(&this->dataOutSlot);
+
+    this->expressionSlot << new core::param::StringParam("");
+    this->MakeSlotAvailable(&this->expressionSlot);
+
+    this->epsilonSlot << new core::param::FloatParam(0.0f, 0.0f);
+    this->MakeSlotAvailable(&this->epsilonSlot);
+}
+
+ColumnarTableWhere::~ColumnarTableWhere(void) {
+    this->Release();
+}
+
+bool ColumnarTableWhere::create(void) {
+    return true;
+}
+
+void ColumnarTableWhere::release(void) {}
+
+size_t ColumnarTableWhere::outputHash(size_t inputHash) const {
+    auto retval = inputHash;
+    retval ^= this->localHash + 0x9e3779b9 + (retval << 6) + (retval >> 2);
+    return retval;
+}
+
+bool ColumnarTableWhere::processData(core::Call& c) {
+    using megamol::core::utility::log::Log;
+
+    try {
+        ColumnarTableDataCall* outCall = dynamic_cast<ColumnarTableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        ColumnarTableDataCall* inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)())
+            return false;
+
+        const bool isParamsChanged = this->expressionSlot.IsDirty() || this->epsilonSlot.IsDirty();
+        if (isParamsChanged) {
+            this->expressionSlot.ResetDirty();
+            this->epsilonSlot.ResetDirty();
+            ++this->localHash;
+
+            std::string error;
+            if (!this->predicate.Parse(this->expressionSlot.Param<core::param::StringParam>()->Value(), error)) {
+                Log::DefaultLog.WriteError("%s: %s. All rows will be selected.", ModuleName.c_str(), error.c_str());
+                this->predicate.Clear();
+            }
+            this->predicate.SetEpsilon(this->epsilonSlot.Param<core::param::FloatParam>()->Value());
+        }
+
+        if (isParamsChanged || this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+
+            this->columns.assign(inCall->GetColumns(), inCall->GetColumns() + inCall->GetColumnsCount());
+            this->rowsCount = inCall->GetRowsCount();
+
+            TableSelection selected;
+            if (this->predicate.IsEmpty() || !this->predicate.Evaluate(*inCall, selected)) {
+                selected.Resize(this->rowsCount, true);
+            }
+            if (inCall->HasSelection()) {
+                selected &= TableSelection::FromIndices(
+                    inCall->GetSelection(), inCall->GetSelectedRowsCount(), this->rowsCount);
+            }
+
+            this->selectAll = (selected.Count() == this->rowsCount);
+            if (this->selectAll) {
+                this->selection.clear();
+            } else {
+                selected.ToIndices(this->selection);
+            }
+        }
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetFrameID(this->frameID);
+        outCall->SetDataHash(this->outputHash(this->datahash));
+        outCall->Set(this->columns.size(), this->rowsCount, this->columns.data());
+        if (!this->selectAll) {
+            outCall->SetSelection(this->selection.data(), this->selection.size());
+        }
+    } catch (...) {
+        Log::DefaultLog.WriteError(_T("Failed to execute %hs::processData\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool ColumnarTableWhere::getExtent(core::Call& c) {
+    try {
+        ColumnarTableDataCall* outCall = dynamic_cast<ColumnarTableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        ColumnarTableDataCall* inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(1))
+            return false;
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetDataHash(this->outputHash(inCall->DataHash()));
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("Failed to execute %hs::getExtent\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,114 @@
+/*
+ * ColumnarTableWhere.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLEWHERE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLEWHERE_H_INCLUDED
+
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+
+#include "mmcore/param/ParamSlot.h"
+
+#include "datatools/table/ColumnarTableDataCall.h"
+#include "datatools/table/TablePredicate.h"
+
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+namespace table {
+
+/*
+ * Module selecting rows of a columnar table by a predicate. The columns of
+ * the input are passed through, only the selection of rows is replaced, so
+ * the table is never copied.
+ */
+class ColumnarTableWhere : public core::Module {
+public:
+    static std::string ModuleName;
+
+    /** Return module class name */
+    static const char* ClassName(void) {
+        return ModuleName.c_str();
+    }
+
+    /** Return module class description */
+    static const char* Description(void) {
+        return "Selects rows from a columnar table without copying it";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor */
+    ColumnarTableWhere(void);
+
+    /** Dtor */
+    virtual ~ColumnarTableWhere(void);
+
+protected:
+    /** Lazy initialization of the module */
+    virtual bool create(void);
+
+    /** Resource release */
+    virtual void release(void);
+
+private:
+    /** Data callback */
+    bool processData(core::Call& c);
+
+    bool getExtent(core::Call& c);
+
+    /** Computes the hash of the output from the input hash */
+    size_t outputHash(size_t inputHash) const;
+
+    /** Data output slot */
+    core::CalleeSlot dataOutSlot;
+
+    /** Data input slot */
+    core::CallerSlot dataInSlot;
+
+    /** Parameter slot for the predicate */
+    core::param::ParamSlot expressionSlot;
+
+    /** Parameter slot for the tolerance of (in-) equality tests */
+    core::param::ParamSlot epsilonSlot;
+
+    /** ID of the current frame */
+    int frameID;
+
+    /** Hash of the current input data */
+    size_t datahash;
+
+    /** Counts the changes of the predicate */
+    size_t localHash;
+
+    /** The parsed predicate */
+    TablePredicate predicate;
+
+    /** The column views of the input */
+    std::vector<ColumnarTableDataCall::Column> columns;
+
+    /** The number of rows of the input */
+    size_t rowsCount;
+
+    /** The indices of the selected rows */
+    std::vector<size_t> selection;
+
+    /** Flag whether all rows are selected */
+    bool selectAll;
+}; /* end class ColumnarTableWhere */
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace megamol */
+
+#endif /* end ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTABLEWHERE_H_INCLUDED */
@@ -6,9 +6,16 @@
 
 #include "MMFTDataSource.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <sstream>
+
+#include "MMFTFormat.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/ButtonParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/StringParam.h"
 
 using namespace megamol::datatools::table;
 using namespace megamol;
@@ -46,6 +53,17 @@ std::string read_string(std::istream& stream, std::size_t size, bool trim_null =
     return str;
 }
 
+std::string trim(const std::string& str) {
+    const auto first = str.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return std::string();
+    }
+    return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+}
+
+/** Number of rows per block when reading row-major files */
+constexpr std::size_t ROW_MAJOR_BLOCK_SIZE = 1 << 16;
+
 } // namespace
 
 MMFTDataSource::MMFTDataSource()
@@ -53,6 +71,9 @@ MMFTDataSource::MMFTDataSource()
         , getDataSlot_("getData", "Slot providing the data")
         , filenameSlot_("filename", "The file name")
         , reloadSlot_("reload", "Reload file")
+        , columnsSlot_("columns", "Comma-separated names of the columns to load, all if empty")
+        , filterSlot_("filter", "Only load rows matching this predicate, e.g. 'x > 0.5 && y <= 3'. Row groups of "
+                                "chunked files whose statistics cannot match are not read at all")
         , dataHash_(0)
         , reload_(false)
         , columns_()
@@ -63,6 +84,10 @@ MMFTDataSource::MMFTDataSource()
     reloadSlot_ << new core::param::ButtonParam();
     reloadSlot_.SetUpdateCallback(this, &MMFTDataSource::reloadCallback);
     MakeSlotAvailable(&reloadSlot_);
+    columnsSlot_ << new core::param::StringParam("");
+    MakeSlotAvailable(&columnsSlot_);
+    filterSlot_ << new core::param::StringParam("");
+    MakeSlotAvailable(&filterSlot_);
 
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetData", &MMFTDataSource::getDataCallback);
     getDataSlot_.SetCallback(TableDataCall::ClassName(), "GetHash", &MMFTDataSource::getHashCallback);
@@ -81,20 +106,24 @@ bool MMFTDataSource::create() {
 void MMFTDataSource::release() {
     columns_.clear();
     values_.clear();
+    fileColumns_.clear();
 }
 
 void MMFTDataSource::assertData() {
     using namespace std::string_literals;
 
-    if (!filenameSlot_.IsDirty() && !reload_) {
+    if (!filenameSlot_.IsDirty() && !columnsSlot_.IsDirty() && !filterSlot_.IsDirty() && !reload_) {
         return; // nothing to do
     }
 
     filenameSlot_.ResetDirty();
+    columnsSlot_.ResetDirty();
+    filterSlot_.ResetDirty();
     reload_ = false;
 
     columns_.clear();
     values_.clear();
+    dataHash_++;
 
     auto filename = filenameSlot_.Param<core::param::FilePathParam>()->Value();
     std::ifstream file(filename, std::ios::binary);
@@ -110,15 +139,15 @@ void MMFTDataSource::assertData() {
         }
 
         auto version = read<uint16_t>(file);
-        if (version != 0) {
+        if (version != mmft::VERSION_ROW_MAJOR && version != mmft::VERSION_CHUNKED) {
             throw std::runtime_error("Wrong file format version number");
         }
 
         auto colCount = read<uint32_t>(file);
-        columns_.resize(colCount);
+        fileColumns_.resize(colCount);
 
         for (uint32_t c = 0; c < colCount; ++c) {
-            TableDataCall::ColumnInfo& ci = columns_[c];
+            TableDataCall::ColumnInfo& ci = fileColumns_[c];
             auto nameLen = read<uint16_t>(file);
             ci.SetName(read_string(file, nameLen));
             auto type = read<uint8_t>(file);
@@ -129,9 +158,81 @@ void MMFTDataSource::assertData() {
 
         auto rowCount = read<uint64_t>(file);
 
-        values_ = read_vector<float>(file, rowCount * colCount);
+        // projection
+        std::vector<std::size_t> projected;
+        std::istringstream names(columnsSlot_.Param<core::param::StringParam>()->Value());
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            name = trim(name);
+            if (name.empty()) {
+                continue;
+            }
+            auto it = std::find_if(fileColumns_.begin(), fileColumns_.end(),
+                [&name](const TableDataCall::ColumnInfo& ci) { return ci.Name() == name; });
+            if (it == fileColumns_.end()) {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "MMFTDataSource: column \"%s\" does not exist.", name.c_str());
+                continue;
+            }
+            projected.push_back(std::distance(fileColumns_.begin(), it));
+        }
+        if (projected.empty()) {
+            for (std::size_t c = 0; c < colCount; ++c) {
+                projected.push_back(c);
+            }
+        }
 
-        dataHash_++;
+        std::string error;
+        filter_.Clear();
+        if (!filter_.Parse(filterSlot_.Param<core::param::StringParam>()->Value(), error)) {
+            throw std::runtime_error("Invalid filter: " + error);
+        }
+        std::vector<std::string> filterColumns;
+        filter_.Columns(filterColumns);
+
+        // the filter is evaluated on the loaded columns, so these include the ones it refers to
+        loadColumns_ = projected;
+        for (const auto& fc : filterColumns) {
+            for (std::size_t c = 0; c < colCount; ++c) {
+                if (fileColumns_[c].Name() == fc &&
+                    std::find(loadColumns_.begin(), loadColumns_.end(), c) == loadColumns_.end()) {
+                    loadColumns_.push_back(c);
+                }
+            }
+        }
+        loadInfos_.clear();
+        for (auto c : loadColumns_) {
+            loadInfos_.push_back(fileColumns_[c]);
+        }
+        for (auto c : projected) {
+            columns_.push_back(fileColumns_[c]);
+        }
+
+        if (filter_.IsEmpty()) {
+            values_.reserve(rowCount * columns_.size());
+        }
+        if (version == mmft::VERSION_CHUNKED) {
+            readChunked(file, rowCount);
+        } else {
+            readRowMajor(file, rowCount);
+        }
+
+        if (!filter_.IsEmpty()) {
+            // the ranges of the remaining rows are narrower than those stored in the file
+            const std::size_t outCnt = columns_.size();
+            for (std::size_t c = 0; c < outCnt; ++c) {
+                float minVal = std::numeric_limits<float>::max();
+                float maxVal = std::numeric_limits<float>::lowest();
+                for (std::size_t i = c; i < values_.size(); i += outCnt) {
+                    minVal = std::min(minVal, values_[i]);
+                    maxVal = std::max(maxVal, values_[i]);
+                }
+                if (minVal <= maxVal) {
+                    columns_[c].SetMinimumValue(minVal);
+                    columns_[c].SetMaximumValue(maxVal);
+                }
+            }
+        }
 
     } catch (std::exception& ex) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(ex.what());
@@ -141,6 +242,136 @@ void MMFTDataSource::assertData() {
     }
 }
 
+void MMFTDataSource::readRowMajor(std::istream& file, uint64_t rowCount) {
+    const std::size_t colCount = fileColumns_.size();
+    if (filter_.IsEmpty() && loadColumns_.size() == colCount &&
+        std::is_sorted(loadColumns_.begin(), loadColumns_.end())) {
+        values_ = read_vector<float>(file, rowCount * colCount);
+        return;
+    }
+
+    // only one block of all columns is held in memory at a time
+    const std::size_t loadCnt = loadColumns_.size();
+    Block block;
+    for (uint64_t first = 0; first < rowCount; first += ROW_MAJOR_BLOCK_SIZE) {
+        const auto cnt = static_cast<std::size_t>(std::min<uint64_t>(ROW_MAJOR_BLOCK_SIZE, rowCount - first));
+        const auto rows = read_vector<float>(file, cnt * colCount);
+        block.rows = cnt;
+        block.values.resize(cnt * loadCnt);
+        for (std::size_t r = 0; r < cnt; ++r) {
+            for (std::size_t i = 0; i < loadCnt; ++i) {
+                block.values[r * loadCnt + i] = rows[r * colCount + loadColumns_[i]];
+            }
+        }
+        appendBlock(block);
+    }
+}
+
+void MMFTDataSource::readChunked(std::istream& file, uint64_t rowCount) {
+    const std::size_t colCount = fileColumns_.size();
+
+    file.seekg(static_cast<std::streamoff>(read<uint64_t>(file)));
+    if (!file.good()) {
+        throw std::runtime_error("Invalid row group directory offset!");
+    }
+    auto groupCount = read<uint32_t>(file);
+    std::vector<mmft::RowGroupInfo> groups(groupCount);
+    uint64_t directoryRows = 0;
+    for (auto& group : groups) {
+        group.rowCount = read<uint64_t>(file);
+        directoryRows += group.rowCount;
+        group.chunks.resize(colCount);
+        for (auto& chunk : group.chunks) {
+            chunk.offset = read<uint64_t>(file);
+            chunk.size = read<uint64_t>(file);
+            chunk.compression = static_cast<mmft::Compression>(read<uint8_t>(file));
+            chunk.minimum = read<float>(file);
+            chunk.maximum = read<float>(file);
+        }
+    }
+    if (directoryRows != rowCount) {
+        throw std::runtime_error("Row groups do not match the row count!");
+    }
+
+    const std::size_t loadCnt = loadColumns_.size();
+    std::vector<float> minimums(colCount), maximums(colCount);
+    std::vector<std::vector<uint8_t>> stored(loadCnt);
+    Block block;
+    std::size_t skipped = 0;
+    for (const auto& group : groups) {
+        if (!filter_.IsEmpty()) {
+            for (std::size_t c = 0; c < colCount; ++c) {
+                minimums[c] = group.chunks[c].minimum;
+                maximums[c] = group.chunks[c].maximum;
+            }
+            if (!filter_.MayMatch(fileColumns_.data(), colCount, minimums.data(), maximums.data())) {
+                ++skipped;
+                continue;
+            }
+        }
+
+        // reading is serial, decompressing the chunks is not
+        for (std::size_t i = 0; i < loadCnt; ++i) {
+            const auto& chunk = group.chunks[loadColumns_[i]];
+            file.seekg(static_cast<std::streamoff>(chunk.offset));
+            stored[i] = read_vector<uint8_t>(file, chunk.size);
+        }
+
+        const auto rows = static_cast<std::size_t>(group.rowCount);
+        block.rows = rows;
+        block.values.resize(rows * loadCnt);
+        std::atomic<bool> valid(true);
+#pragma omp parallel
+        {
+            std::vector<float> column(rows);
+#pragma omp for schedule(dynamic, 1)
+            for (int64_t i = 0; i < static_cast<int64_t>(loadCnt); ++i) {
+                const auto& chunk = group.chunks[loadColumns_[i]];
+                if (!mmft::DecompressChunk(stored[i].data(), stored[i].size(), chunk.compression, rows, column.data())) {
+                    valid.store(false);
+                    continue;
+                }
+                for (std::size_t r = 0; r < rows; ++r) {
+                    block.values[r * loadCnt + i] = column[r];
+                }
+            }
+        }
+        if (!valid.load()) {
+            throw std::runtime_error("Corrupt column chunk!");
+        }
+        appendBlock(block);
+    }
+
+    if (!filter_.IsEmpty()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("MMFTDataSource: skipped %zu of %u row groups, %zu of "
+                                                               "%llu rows match the filter.",
+            skipped, groupCount, values_.size() / std::max<std::size_t>(columns_.size(), 1),
+            static_cast<unsigned long long>(rowCount));
+    }
+}
+
+void MMFTDataSource::appendBlock(const Block& block) {
+    const std::size_t loadCnt = loadColumns_.size();
+    const std::size_t outCnt = columns_.size();
+    if (filter_.IsEmpty()) {
+        if (loadCnt == outCnt) {
+            values_.insert(values_.end(), block.values.begin(), block.values.end());
+            return;
+        }
+        selection_.Resize(block.rows, true);
+    } else if (!filter_.Evaluate(loadInfos_.data(), loadCnt, block.values.data(), block.rows, selection_)) {
+        throw std::runtime_error("Cannot apply the filter to the table!");
+    }
+
+    for (std::size_t r = 0; r < block.rows; ++r) {
+        if (selection_.IsSelected(r)) {
+            for (std::size_t c = 0; c < outCnt; ++c) {
+                values_.push_back(block.values[r * loadCnt + c]);
+            }
+        }
+    }
+}
+
 bool MMFTDataSource::getDataCallback(core::Call& caller) {
     TableDataCall* tfd = dynamic_cast<TableDataCall*>(&caller);
     if (tfd == nullptr) {
@@ -7,9 +7,11 @@
 #ifndef MEGAMOL_DATATOOLS_MMFTDATASOURCE_H_INCLUDED
 #define MEGAMOL_DATATOOLS_MMFTDATASOURCE_H_INCLUDED
 
+#include <istream>
 #include <vector>
 
 #include "datatools/table/TableDataCall.h"
+#include "datatools/table/TablePredicate.h"
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/Module.h"
@@ -39,14 +41,40 @@ protected:
     bool reloadCallback(core::param::ParamSlot& caller);
 
 private:
+    /** Rows of one block of the table that are filtered and projected together */
+    struct Block {
+        /** Row-major cells of the loaded columns */
+        std::vector<float> values;
+        std::size_t rows;
+    };
+
     inline void assertData();
     bool getDataCallback(core::Call& caller);
     bool getHashCallback(core::Call& caller);
 
+    /** Reads the row-major cells of a version 0 file in blocks */
+    void readRowMajor(std::istream& file, uint64_t rowCount);
+
+    /** Reads the row groups of a version 2 file, skipping those the filter cannot match */
+    void readChunked(std::istream& file, uint64_t rowCount);
+
+    /** Applies the filter to a block and appends the projected cells of its remaining rows */
+    void appendBlock(const Block& block);
+
     core::CalleeSlot getDataSlot_;
 
     core::param::ParamSlot filenameSlot_;
     core::param::ParamSlot reloadSlot_;
+    core::param::ParamSlot columnsSlot_;
+    core::param::ParamSlot filterSlot_;
+
+    /** All columns of the file */
+    std::vector<TableDataCall::ColumnInfo> fileColumns_;
+    /** The columns read from the file, the projected ones first, then those only the filter refers to */
+    std::vector<std::size_t> loadColumns_;
+    std::vector<TableDataCall::ColumnInfo> loadInfos_;
+    TablePredicate filter_;
+    TableSelection selection_;
 
     std::size_t dataHash_;
     bool reload_;
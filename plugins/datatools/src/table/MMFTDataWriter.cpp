@@ -6,10 +6,15 @@
 
 #include "MMFTDataWriter.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 
+#include "MMFTFormat.h"
+#include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 
 using namespace megamol::datatools;
@@ -19,12 +24,28 @@ using namespace megamol;
 MMFTDataWriter::MMFTDataWriter()
         : core::AbstractDataWriter()
         , filenameSlot("filename", "The path to the MMFT file to be written")
+        , chunkedSlot("chunked", "Write row groups of column chunks with statistics (version 2) instead of one "
+                                 "row-major block (version 0)")
+        , rowGroupSizeSlot("rowGroupSize", "The number of rows per row group")
+        , compressionSlot("compression", "The compression of the column chunks")
         , dataSlot("data", "The slot requesting the data to be written") {
 
     this->filenameSlot << new core::param::FilePathParam(
         "", megamol::core::param::FilePathParam::Flag_File_ToBeCreatedWithRestrExts, {"mmft"});
     this->MakeSlotAvailable(&this->filenameSlot);
 
+    this->chunkedSlot << new core::param::BoolParam(false);
+    this->MakeSlotAvailable(&this->chunkedSlot);
+
+    this->rowGroupSizeSlot << new core::param::IntParam(1 << 16, 1);
+    this->MakeSlotAvailable(&this->rowGroupSizeSlot);
+
+    auto* cp = new core::param::EnumParam(static_cast<int>(mmft::Compression::NONE));
+    cp->SetTypePair(static_cast<int>(mmft::Compression::NONE), "None");
+    cp->SetTypePair(static_cast<int>(mmft::Compression::SHUFFLE_DEFLATE), "Deflate");
+    this->compressionSlot << cp;
+    this->MakeSlotAvailable(&this->compressionSlot);
+
     this->dataSlot.SetCompatibleCall<TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataSlot);
 }
@@ -76,7 +97,8 @@ bool MMFTDataWriter::run() {
         std::string magicID("MMFTD");
         file.write(magicID.data(), 6);
 
-        uint16_t version = 0;
+        const bool chunked = this->chunkedSlot.Param<core::param::BoolParam>()->Value();
+        uint16_t version = chunked ? mmft::VERSION_CHUNKED : mmft::VERSION_ROW_MAJOR;
         file.write(reinterpret_cast<const char*>(&version), sizeof(uint16_t));
 
         uint32_t colCnt = static_cast<uint32_t>(cftd->GetColumnsCount());
@@ -100,7 +122,11 @@ bool MMFTDataWriter::run() {
         uint64_t rowCnt = static_cast<uint64_t>(cftd->GetRowsCount());
         file.write(reinterpret_cast<const char*>(&rowCnt), sizeof(uint64_t));
 
-        file.write(reinterpret_cast<const char*>(cftd->GetData()), rowCnt * colCnt * sizeof(float));
+        if (chunked) {
+            writeChunked(file, *cftd);
+        } else {
+            writeRowMajor(file, *cftd);
+        }
 
     } catch (...) {
         Log::DefaultLog.WriteError("Write error \"%s\".", filename.generic_u8string().c_str());
@@ -113,6 +139,81 @@ bool MMFTDataWriter::run() {
     return true;
 }
 
+void MMFTDataWriter::writeRowMajor(std::ostream& file, const TableDataCall& table) {
+    file.write(reinterpret_cast<const char*>(table.GetData()),
+        static_cast<std::streamsize>(table.GetRowsCount() * table.GetColumnsCount() * sizeof(float)));
+}
+
+void MMFTDataWriter::writeChunked(std::ostream& file, const TableDataCall& table) {
+    const size_t colCnt = table.GetColumnsCount();
+    const size_t rowCnt = table.GetRowsCount();
+    const size_t groupSize = static_cast<size_t>(this->rowGroupSizeSlot.Param<core::param::IntParam>()->Value());
+    const auto compression =
+        static_cast<mmft::Compression>(this->compressionSlot.Param<core::param::EnumParam>()->Value());
+
+    // the directory offset is patched once the chunks are written
+    const auto directoryPos = file.tellp();
+    uint64_t directoryOffset = 0;
+    file.write(reinterpret_cast<const char*>(&directoryOffset), sizeof(uint64_t));
+
+    std::vector<mmft::RowGroupInfo> groups;
+    std::vector<std::vector<float>> values(colCnt);
+    std::vector<std::vector<uint8_t>> compressed(colCnt);
+    std::vector<uint8_t> isCompressed(colCnt);
+    for (size_t first = 0; first < rowCnt; first += groupSize) {
+        const size_t cnt = std::min(groupSize, rowCnt - first);
+        mmft::RowGroupInfo group;
+        group.rowCount = cnt;
+        group.chunks.resize(colCnt);
+
+        // gathering and compressing the columns is independent, only the writing is serial
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int64_t c = 0; c < static_cast<int64_t>(colCnt); ++c) {
+            auto& v = values[c];
+            v.resize(cnt);
+            for (size_t r = 0; r < cnt; ++r) {
+                v[r] = table.GetData(c, first + r);
+            }
+            auto& chunk = group.chunks[c];
+            mmft::ChunkStatistics(v.data(), cnt, chunk.minimum, chunk.maximum);
+            isCompressed[c] = (compression != mmft::Compression::NONE) &&
+                              mmft::CompressChunk(v.data(), cnt, compressed[c]);
+            chunk.compression = isCompressed[c] ? compression : mmft::Compression::NONE;
+        }
+
+        for (size_t c = 0; c < colCnt; ++c) {
+            auto& chunk = group.chunks[c];
+            chunk.offset = static_cast<uint64_t>(file.tellp());
+            if (isCompressed[c]) {
+                chunk.size = compressed[c].size();
+                file.write(reinterpret_cast<const char*>(compressed[c].data()), compressed[c].size());
+            } else {
+                chunk.size = cnt * sizeof(float);
+                file.write(reinterpret_cast<const char*>(values[c].data()), chunk.size);
+            }
+        }
+        groups.push_back(std::move(group));
+    }
+
+    directoryOffset = static_cast<uint64_t>(file.tellp());
+    uint32_t groupCnt = static_cast<uint32_t>(groups.size());
+    file.write(reinterpret_cast<const char*>(&groupCnt), sizeof(uint32_t));
+    for (const auto& group : groups) {
+        file.write(reinterpret_cast<const char*>(&group.rowCount), sizeof(uint64_t));
+        for (const auto& chunk : group.chunks) {
+            file.write(reinterpret_cast<const char*>(&chunk.offset), sizeof(uint64_t));
+            file.write(reinterpret_cast<const char*>(&chunk.size), sizeof(uint64_t));
+            file.write(reinterpret_cast<const char*>(&chunk.compression), sizeof(uint8_t));
+            file.write(reinterpret_cast<const char*>(&chunk.minimum), sizeof(float));
+            file.write(reinterpret_cast<const char*>(&chunk.maximum), sizeof(float));
+        }
+    }
+
+    file.seekp(directoryPos);
+    file.write(reinterpret_cast<const char*>(&directoryOffset), sizeof(uint64_t));
+    file.seekp(0, std::ios::end);
+}
+
 bool MMFTDataWriter::getCapabilities(core::DataWriterCtrlCall& call) {
     call.SetAbortable(false);
     return true;
@@ -91,9 +91,24 @@ protected:
     bool getCapabilities(core::DataWriterCtrlCall& call) override;
 
 private:
+    /** Writes the cells as one row-major block (version 0) */
+    static void writeRowMajor(std::ostream& file, const TableDataCall& table);
+
+    /** Writes the cells as column chunks of row groups with statistics (version 2) */
+    void writeChunked(std::ostream& file, const TableDataCall& table);
+
     /** The file name of the file to be written */
     core::param::ParamSlot filenameSlot;
 
+    /** Whether to write the chunked format */
+    core::param::ParamSlot chunkedSlot;
+
+    /** The number of rows per row group */
+    core::param::ParamSlot rowGroupSizeSlot;
+
+    /** The compression of the column chunks */
+    core::param::ParamSlot compressionSlot;
+
     /** The slot asking for data */
     core::CallerSlot dataSlot;
 };
@@ -0,0 +1,81 @@
+/*
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "MMFTFormat.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "zlib.h"
+
+using namespace megamol::datatools::table;
+
+void mmft::ChunkStatistics(const float* values, size_t cnt, float& outMin, float& outMax) {
+    outMin = std::numeric_limits<float>::infinity();
+    outMax = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < cnt; ++i) {
+        const float v = values[i];
+        // comparisons with NaN are false, so NaN never changes the bounds
+        if (v < outMin) {
+            outMin = v;
+        }
+        if (v > outMax) {
+            outMax = v;
+        }
+    }
+}
+
+bool mmft::CompressChunk(const float* values, size_t cnt, std::vector<uint8_t>& outData) {
+    const size_t byteSize = cnt * sizeof(float);
+
+    // byte planes: all first bytes, all second bytes, ... the exponent bytes of similar values deflate well
+    std::vector<uint8_t> shuffled(byteSize);
+    const auto* src = reinterpret_cast<const uint8_t*>(values);
+    for (size_t i = 0; i < cnt; ++i) {
+        for (size_t b = 0; b < sizeof(float); ++b) {
+            shuffled[b * cnt + i] = src[i * sizeof(float) + b];
+        }
+    }
+
+    uLongf destLen = compressBound(static_cast<uLong>(byteSize));
+    outData.resize(destLen);
+    if (compress2(outData.data(), &destLen, shuffled.data(), static_cast<uLong>(byteSize), Z_DEFAULT_COMPRESSION) !=
+            Z_OK ||
+        destLen >= byteSize) {
+        outData.clear();
+        return false;
+    }
+    outData.resize(destLen);
+    return true;
+}
+
+bool mmft::DecompressChunk(const uint8_t* data, size_t size, Compression compression, size_t cnt, float* outValues) {
+    const size_t byteSize = cnt * sizeof(float);
+    switch (compression) {
+    case Compression::NONE:
+        if (size != byteSize) {
+            return false;
+        }
+        std::memcpy(outValues, data, byteSize);
+        return true;
+    case Compression::SHUFFLE_DEFLATE: {
+        std::vector<uint8_t> shuffled(byteSize);
+        uLongf destLen = static_cast<uLongf>(byteSize);
+        if (uncompress(shuffled.data(), &destLen, data, static_cast<uLong>(size)) != Z_OK || destLen != byteSize) {
+            return false;
+        }
+        auto* dst = reinterpret_cast<uint8_t*>(outValues);
+        for (size_t i = 0; i < cnt; ++i) {
+            for (size_t b = 0; b < sizeof(float); ++b) {
+                dst[i * sizeof(float) + b] = shuffled[b * cnt + i];
+            }
+        }
+        return true;
+    }
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+/*
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
+#define MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * MMFT file layout (all values little endian):
+ *
+ *   char[6]  magic "MMFTD\0"
+ *   uint16   version
+ *   uint32   column count
+ *   per column: uint16 name length, char[] name, uint8 type (1 = categorical), float min, float max
+ *   uint64   row count
+ *
+ * Version 0 continues with all cells in row-major order.
+ *
+ * Version 2 (chunked) continues with
+ *
+ *   uint64   offset of the row group directory
+ *   column chunks, i.e. the cells of one column of one row group
+ *   row group directory:
+ *     uint32 row group count
+ *     per row group: uint64 row count
+ *                    per column: uint64 offset, uint64 stored size, uint8 compression, float min, float max
+ *
+ * Version 1 was never assigned; the chunked layout is MMFT v2, so readers that only know version 0 reject it
+ * instead of misreading it. The writer still defaults to version 0.
+ *
+ * The directory is written last, so the writer can stream the chunks. The per-chunk minimum and maximum ignore NaN,
+ * a chunk without any number has min = +inf and max = -inf.
+ */
+namespace megamol::datatools::table::mmft {
+
+constexpr uint16_t VERSION_ROW_MAJOR = 0;
+constexpr uint16_t VERSION_CHUNKED = 2;
+
+enum class Compression : uint8_t {
+    NONE = 0,
+    /** Bytes of the floats shuffled into four planes, then deflated */
+    SHUFFLE_DEFLATE = 1
+};
+
+struct ChunkInfo {
+    uint64_t offset;
+    uint64_t size;
+    Compression compression;
+    float minimum;
+    float maximum;
+};
+
+struct RowGroupInfo {
+    uint64_t rowCount;
+    /** One entry per column */
+    std::vector<ChunkInfo> chunks;
+};
+
+/** Computes minimum and maximum of 'cnt' values, ignoring NaN */
+void ChunkStatistics(const float* values, size_t cnt, float& outMin, float& outMax);
+
+/**
+ * Compresses 'cnt' values.
+ *
+ * @return 'false' if the compressed chunk would not be smaller than the plain one.
+ */
+bool CompressChunk(const float* values, size_t cnt, std::vector<uint8_t>& outData);
+
+/**
+ * Reconstructs 'cnt' values of a chunk from its stored bytes.
+ *
+ * @return 'false' if the data is malformed.
+ */
+bool DecompressChunk(const uint8_t* data, size_t size, Compression compression, size_t cnt, float* outValues);
+
+} // namespace megamol::datatools::table::mmft
+
+#endif // MEGAMOL_DATATOOLS_MMFTFORMAT_H_INCLUDED
@@ -102,23 +102,23 @@ bool ParticlesToTable::assertMPDC(geocalls::MultiParticleDataCall* in, table::Ta
 
             everything.resize(column_names.size() * total_particles);
             uint32_t particle_idx = 0;
+            std::vector<float> column;
             for (auto l = 0; l < in->GetParticleListCount(); ++l) {
                 auto pl = in->AccessParticles(l);
                 const auto& store = pl.GetParticleStore();
-                for (auto idx = 0; idx < pl.GetCount(); ++idx) {
-                    store_and_compute_extents(particle_idx, 0, store.GetXAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 1, store.GetYAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 2, store.GetZAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 3, store.GetRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 4, store.GetCRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 5, store.GetCGAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 6, store.GetCBAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 7, store.GetCRAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 8, store.GetDXAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 9, store.GetDYAcc()->Get_f(idx));
-                    store_and_compute_extents(particle_idx, 10, store.GetDZAcc()->Get_f(idx));
-                    particle_idx++;
+                const std::array<const std::shared_ptr<geocalls::Accessor>*, 11> accs = {&store.GetXAcc(),
+                    &store.GetYAcc(), &store.GetZAcc(), &store.GetRAcc(), &store.GetCRAcc(), &store.GetCGAcc(),
+                    &store.GetCBAcc(), &store.GetCRAcc(), &store.GetDXAcc(), &store.GetDYAcc(), &store.GetDZAcc()};
+                const auto count = static_cast<uint32_t>(pl.GetCount());
+                // fetch one whole column per accessor call instead of one value
+                column.resize(count);
+                for (uint32_t col = 0; col < accs.size(); ++col) {
+                    (*accs[col])->Copy_f(0, count, column.data());
+                    for (uint32_t idx = 0; idx < count; ++idx) {
+                        store_and_compute_extents(particle_idx + idx, col, column[idx]);
+                    }
                 }
+                particle_idx += count;
             }
 
             for (auto i = 0; i < column_infos.size(); ++i) {
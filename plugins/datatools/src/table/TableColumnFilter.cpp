@@ -112,12 +112,15 @@ bool TableColumnFilter::processData(core::Call& c) {
                 return false;
             }
 
-            this->data.clear();
-            this->data.reserve(rows_count * this->columnInfos.size());
-
-            for (size_t row = 0; row < rows_count; row++) {
-                for (auto& cidx : indexMask) {
-                    this->data.push_back(in_data[cidx + row * column_count]);
+            const auto out_column_count = indexMask.size();
+            this->data.resize(rows_count * out_column_count);
+
+#pragma omp parallel for
+            for (int64_t row = 0; row < static_cast<int64_t>(rows_count); row++) {
+                const float* src = in_data + row * column_count;
+                float* dst = this->data.data() + row * out_column_count;
+                for (size_t i = 0; i < out_column_count; i++) {
+                    dst[i] = src[indexMask[i]];
                 }
             }
         }
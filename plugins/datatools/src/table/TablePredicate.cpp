@@ -0,0 +1,724 @@
+/*
+ * TablePredicate.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+#include "datatools/table/TablePredicate.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::table;
+using namespace megamol;
+
+
+namespace {
+
+/** Number of bitmap words processed by one thread at once */
+constexpr size_t wordsPerChunk = 64;
+
+inline unsigned int popCount(uint64_t w) {
+#ifdef _MSC_VER
+    return static_cast<unsigned int>(__popcnt64(w));
+#else  /* _MSC_VER */
+    return static_cast<unsigned int>(__builtin_popcountll(w));
+#endif /* _MSC_VER */
+}
+
+inline unsigned int trailingZeros(uint64_t w) {
+    assert(w != 0);
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward64(&idx, w);
+    return static_cast<unsigned int>(idx);
+#else  /* _MSC_VER */
+    return static_cast<unsigned int>(__builtin_ctzll(w));
+#endif /* _MSC_VER */
+}
+
+/** Answer a mask with the lowest 'cnt' bits set */
+inline uint64_t lowBits(size_t cnt) {
+    return (cnt >= 64) ? ~uint64_t(0) : ((uint64_t(1) << cnt) - 1);
+}
+
+/** The type in which cells of type 'T' are compared */
+template<class T>
+struct CompareType {
+    typedef double type;
+};
+template<>
+struct CompareType<float> {
+    typedef float type;
+};
+
+/**
+ * Compares up to 64 cells and answers the results as bitmask. The contiguous
+ * case is kept separate such that the compiler can vectorise it.
+ */
+template<class T, class V, class C>
+inline uint64_t maskWord(const T* src, size_t stride, size_t cnt, C cmp) {
+    uint64_t mask = 0;
+    if (stride == 1) {
+        for (size_t i = 0; i < cnt; ++i) {
+            mask |= static_cast<uint64_t>(cmp(static_cast<V>(src[i]))) << i;
+        }
+    } else {
+        for (size_t i = 0; i < cnt; ++i) {
+            mask |= static_cast<uint64_t>(cmp(static_cast<V>(src[i * stride]))) << i;
+        }
+    }
+    return mask;
+}
+
+template<class T>
+uint64_t compareWord(
+    const T* src, size_t stride, size_t cnt, TablePredicate::Operator op, double reference, double epsilon) {
+    typedef typename CompareType<T>::type V;
+    const V r = static_cast<V>(reference);
+    const V e = static_cast<V>(epsilon);
+    switch (op) {
+    case TablePredicate::Operator::LESS:
+        return maskWord<T, V>(src, stride, cnt, [r](const V v) { return v < r; });
+    case TablePredicate::Operator::LESS_OR_EQUAL:
+        return maskWord<T, V>(src, stride, cnt, [r](const V v) { return v <= r; });
+    case TablePredicate::Operator::EQUAL:
+        return maskWord<T, V>(src, stride, cnt, [r, e](const V v) { return std::abs(v - r) <= e; });
+    case TablePredicate::Operator::GREATER_OR_EQUAL:
+        return maskWord<T, V>(src, stride, cnt, [r](const V v) { return v >= r; });
+    case TablePredicate::Operator::GREATER:
+        return maskWord<T, V>(src, stride, cnt, [r](const V v) { return v > r; });
+    case TablePredicate::Operator::NOT_EQUAL:
+        return maskWord<T, V>(src, stride, cnt, [r, e](const V v) { return std::abs(v - r) > e; });
+    }
+    return 0;
+}
+
+/**
+ * Compares up to 64 cells of an INT64 column to an integer. This does not go
+ * through double like compareWord, which cannot tell apart the integers beyond
+ * 2^53.
+ */
+inline uint64_t compareInt64Word(const int64_t* src, size_t stride, size_t cnt, TablePredicate::Operator op,
+    int64_t reference, double epsilon) {
+    typedef std::numeric_limits<int64_t> limits;
+    const int64_t r = reference;
+    // |v - r| <= e holds for the integers in [r - floor(e), r + floor(e)]
+    int64_t lo = limits::min(), hi = limits::max();
+    if (!(epsilon >= 0.0)) {
+        lo = limits::max();
+        hi = limits::min();
+    } else if (epsilon < 9223372036854775808.0) {
+        const auto d = static_cast<int64_t>(epsilon);
+        lo = (r < limits::min() + d) ? limits::min() : r - d;
+        hi = (r > limits::max() - d) ? limits::max() : r + d;
+    }
+    switch (op) {
+    case TablePredicate::Operator::LESS:
+        return maskWord<int64_t, int64_t>(src, stride, cnt, [r](const int64_t v) { return v < r; });
+    case TablePredicate::Operator::LESS_OR_EQUAL:
+        return maskWord<int64_t, int64_t>(src, stride, cnt, [r](const int64_t v) { return v <= r; });
+    case TablePredicate::Operator::EQUAL:
+        return maskWord<int64_t, int64_t>(
+            src, stride, cnt, [lo, hi](const int64_t v) { return (lo <= v) && (v <= hi); });
+    case TablePredicate::Operator::GREATER_OR_EQUAL:
+        return maskWord<int64_t, int64_t>(src, stride, cnt, [r](const int64_t v) { return v >= r; });
+    case TablePredicate::Operator::GREATER:
+        return maskWord<int64_t, int64_t>(src, stride, cnt, [r](const int64_t v) { return v > r; });
+    case TablePredicate::Operator::NOT_EQUAL:
+        return maskWord<int64_t, int64_t>(
+            src, stride, cnt, [lo, hi](const int64_t v) { return (v < lo) || (hi < v); });
+    }
+    return 0;
+}
+
+/**
+ * Answers whether 'value' is an integer in the range of int64_t, which is
+ * returned in 'outValue' then.
+ */
+inline bool toInt64(double value, int64_t& outValue) {
+    // -2^63 and 2^63 are exact doubles
+    if (!(value >= -9223372036854775808.0) || !(value < 9223372036854775808.0) || (std::trunc(value) != value)) {
+        return false;
+    }
+    outValue = static_cast<int64_t>(value);
+    return true;
+}
+
+inline bool isSpecialChar(char c) {
+    return (std::isspace(static_cast<unsigned char>(c)) != 0) || (c == '<') || (c == '>') || (c == '=') ||
+           (c == '!') || (c == '&') || (c == '|') || (c == '"') || (c == '\'');
+}
+
+/** Token of the textual form of a predicate */
+struct Token {
+    enum class Kind { WORD, QUOTED_NAME, STRING, OPERATOR, CONNECTIVE } kind;
+    std::string text;
+    TablePredicate::Operator op;
+    TablePredicate::Connective connective;
+};
+
+bool tokenise(const std::string& expression, std::vector<Token>& outTokens, std::string& outError) {
+    outTokens.clear();
+    size_t i = 0;
+    while (i < expression.size()) {
+        const char c = expression[i];
+        const char n = (i + 1 < expression.size()) ? expression[i + 1] : '\0';
+        Token t;
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+            continue;
+
+        } else if ((c == '"') || (c == '\'')) {
+            const auto end = expression.find(c, i + 1);
+            if (end == std::string::npos) {
+                outError = "Unterminated quote at position " + std::to_string(i);
+                return false;
+            }
+            t.kind = (c == '"') ? Token::Kind::STRING : Token::Kind::QUOTED_NAME;
+            t.text = expression.substr(i + 1, end - i - 1);
+            i = end + 1;
+
+        } else if ((c == '&') && (n == '&')) {
+            t.kind = Token::Kind::CONNECTIVE;
+            t.connective = TablePredicate::Connective::AND;
+            i += 2;
+
+        } else if ((c == '|') && (n == '|')) {
+            t.kind = Token::Kind::CONNECTIVE;
+            t.connective = TablePredicate::Connective::OR;
+            i += 2;
+
+        } else if ((c == '<') || (c == '>') || (c == '=') || (c == '!')) {
+            t.kind = Token::Kind::OPERATOR;
+            const bool withEqual = (n == '=');
+            switch (c) {
+            case '<':
+                t.op = withEqual ? TablePredicate::Operator::LESS_OR_EQUAL : TablePredicate::Operator::LESS;
+                break;
+            case '>':
+                t.op = withEqual ? TablePredicate::Operator::GREATER_OR_EQUAL : TablePredicate::Operator::GREATER;
+                break;
+            case '=':
+                t.op = TablePredicate::Operator::EQUAL;
+                break;
+            default:
+                if (!withEqual) {
+                    outError = "Unexpected '!' at position " + std::to_string(i);
+                    return false;
+                }
+                t.op = TablePredicate::Operator::NOT_EQUAL;
+                break;
+            }
+            i += withEqual ? 2 : 1;
+
+        } else if ((c == '&') || (c == '|')) {
+            outError = std::string("Unexpected '") + c + "' at position " + std::to_string(i);
+            return false;
+
+        } else {
+            const auto begin = i;
+            while ((i < expression.size()) && !isSpecialChar(expression[i])) {
+                ++i;
+            }
+            t.text = expression.substr(begin, i - begin);
+            std::string lower(t.text);
+            std::transform(lower.begin(), lower.end(), lower.begin(), [](char x) { return std::tolower(x); });
+            if (lower == "and") {
+                t.kind = Token::Kind::CONNECTIVE;
+                t.connective = TablePredicate::Connective::AND;
+            } else if (lower == "or") {
+                t.kind = Token::Kind::CONNECTIVE;
+                t.connective = TablePredicate::Connective::OR;
+            } else {
+                t.kind = Token::Kind::WORD;
+            }
+        }
+        outTokens.push_back(t);
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * TableSelection::TableSelection
+ */
+TableSelection::TableSelection(void) : rowsCount(0), words() {
+    // intentionally empty
+}
+
+
+/*
+ * TableSelection::TableSelection
+ */
+TableSelection::TableSelection(size_t rowCnt, bool selected) : rowsCount(0), words() {
+    this->Resize(rowCnt, selected);
+}
+
+
+/*
+ * TableSelection::FromIndices
+ */
+TableSelection TableSelection::FromIndices(const size_t* indices, size_t cnt, size_t rowCnt) {
+    TableSelection retval(rowCnt, false);
+    for (size_t i = 0; i < cnt; ++i) {
+        retval.Select(indices[i], true);
+    }
+    return retval;
+}
+
+
+/*
+ * TableSelection::Count
+ */
+size_t TableSelection::Count(void) const {
+    const auto wordCnt = static_cast<int64_t>(this->words.size());
+    int64_t cnt = 0;
+#pragma omp parallel for reduction(+ : cnt)
+    for (int64_t w = 0; w < wordCnt; ++w) {
+        cnt += popCount(this->words[w]);
+    }
+    return static_cast<size_t>(cnt);
+}
+
+
+/*
+ * TableSelection::Resize
+ */
+void TableSelection::Resize(size_t rowCnt, bool selected) {
+    this->rowsCount = rowCnt;
+    this->words.assign((rowCnt + 63) / 64, selected ? ~uint64_t(0) : 0);
+    if (selected && ((rowCnt % 64) != 0)) {
+        this->words.back() = lowBits(rowCnt % 64);
+    }
+}
+
+
+/*
+ * TableSelection::ToIndices
+ */
+void TableSelection::ToIndices(std::vector<size_t>& outIndices) const {
+    const auto chunkCnt = static_cast<int64_t>((this->words.size() + wordsPerChunk - 1) / wordsPerChunk);
+    std::vector<size_t> offsets(chunkCnt + 1, 0);
+
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCnt; ++c) {
+        const size_t end = std::min(this->words.size(), (c + 1) * wordsPerChunk);
+        size_t cnt = 0;
+        for (size_t w = c * wordsPerChunk; w < end; ++w) {
+            cnt += popCount(this->words[w]);
+        }
+        offsets[c + 1] = cnt;
+    }
+    for (int64_t c = 0; c < chunkCnt; ++c) {
+        offsets[c + 1] += offsets[c];
+    }
+
+    outIndices.resize(offsets.back());
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCnt; ++c) {
+        const size_t end = std::min(this->words.size(), (c + 1) * wordsPerChunk);
+        size_t pos = offsets[c];
+        for (size_t w = c * wordsPerChunk; w < end; ++w) {
+            uint64_t bits = this->words[w];
+            while (bits != 0) {
+                outIndices[pos++] = w * 64 + trailingZeros(bits);
+                bits &= bits - 1;
+            }
+        }
+    }
+}
+
+
+/*
+ * TableSelection::operator&=
+ */
+TableSelection& TableSelection::operator&=(const TableSelection& rhs) {
+    assert(this->rowsCount == rhs.rowsCount);
+    for (size_t w = 0; w < this->words.size(); ++w) {
+        this->words[w] &= rhs.words[w];
+    }
+    return *this;
+}
+
+
+/*
+ * TableSelection::operator|=
+ */
+TableSelection& TableSelection::operator|=(const TableSelection& rhs) {
+    assert(this->rowsCount == rhs.rowsCount);
+    for (size_t w = 0; w < this->words.size(); ++w) {
+        this->words[w] |= rhs.words[w];
+    }
+    return *this;
+}
+
+/*****************************************************************************/
+
+
+/*
+ * TablePredicate::TablePredicate
+ */
+TablePredicate::TablePredicate(void) : clauses(), epsilon(0.0) {
+    // intentionally empty
+}
+
+
+/*
+ * TablePredicate::Add
+ */
+void TablePredicate::Add(const std::string& column, Operator op, double reference, Connective connective) {
+    Clause clause{column, op, reference, 0, false, std::string(), false, connective};
+    clause.isInteger = toInt64(reference, clause.integer);
+    this->clauses.push_back(clause);
+}
+
+
+/*
+ * TablePredicate::Add
+ */
+void TablePredicate::Add(
+    const std::string& column, Operator op, const std::string& reference, Connective connective) {
+    assert((op == Operator::EQUAL) || (op == Operator::NOT_EQUAL));
+    this->clauses.push_back(Clause{column, op, 0.0, 0, false, reference, true, connective});
+}
+
+
+/*
+ * TablePredicate::Clear
+ */
+void TablePredicate::Clear(void) {
+    this->clauses.clear();
+}
+
+
+/*
+ * TablePredicate::Columns
+ */
+void TablePredicate::Columns(std::vector<std::string>& outColumns) const {
+    outColumns.clear();
+    for (const auto& clause : this->clauses) {
+        if (std::find(outColumns.begin(), outColumns.end(), clause.column) == outColumns.end()) {
+            outColumns.push_back(clause.column);
+        }
+    }
+}
+
+
+/*
+ * TablePredicate::Evaluate
+ */
+bool TablePredicate::Evaluate(const TableDataCall::ColumnInfo* infos, size_t colCnt, const float* data,
+    size_t rowCnt, TableSelection& outSelection) const {
+    using megamol::core::utility::log::Log;
+
+    std::vector<BoundClause> bound;
+    bound.reserve(this->clauses.size());
+    for (size_t i = 0; i < this->clauses.size(); ++i) {
+        const auto& clause = this->clauses[i];
+        size_t col = 0;
+        while ((col < colCnt) && (infos[col].Name() != clause.column)) {
+            ++col;
+        }
+        if (col == colCnt) {
+            Log::DefaultLog.WriteError("The column \"%s\" does not exist.", clause.column.c_str());
+            return false;
+        }
+        if (clause.isText) {
+            Log::DefaultLog.WriteError(
+                "The column \"%s\" cannot be compared to the string \"%s\".", clause.column.c_str(), clause.text.c_str());
+            return false;
+        }
+        bound.push_back(BoundClause{data + col, colCnt, ColumnarTableDataCall::DataType::FLOAT, clause.op,
+            clause.reference, clause.integer, clause.isInteger, this->epsilon, false, false,
+            (i > 0) && (clause.connective == Connective::OR)});
+    }
+
+    this->evaluate(bound, rowCnt, outSelection);
+    return true;
+}
+
+
+/*
+ * TablePredicate::MayMatch
+ */
+bool TablePredicate::MayMatch(
+    const TableDataCall::ColumnInfo* infos, size_t colCnt, const float* minimums, const float* maximums) const {
+    if (this->clauses.empty()) {
+        return true;
+    }
+
+    // same arithmetic as compareWord on float cells
+    const float e = static_cast<float>(this->epsilon);
+    bool group = true;
+    for (size_t i = 0; i < this->clauses.size(); ++i) {
+        const auto& clause = this->clauses[i];
+        if ((i > 0) && (clause.connective == Connective::OR)) {
+            if (group) {
+                return true;
+            }
+            group = true;
+        }
+        if (!group || clause.isText) {
+            continue;
+        }
+        size_t col = 0;
+        while ((col < colCnt) && (infos[col].Name() != clause.column)) {
+            ++col;
+        }
+        if (col == colCnt) {
+            continue;
+        }
+
+        const float lo = minimums[col];
+        const float hi = maximums[col];
+        const float r = static_cast<float>(clause.reference);
+        bool possible = true;
+        if (!(lo <= hi)) {
+            // only NaN, which fails every comparison
+            possible = false;
+        } else {
+            switch (clause.op) {
+            case Operator::LESS:
+                possible = lo < r;
+                break;
+            case Operator::LESS_OR_EQUAL:
+                possible = lo <= r;
+                break;
+            case Operator::EQUAL:
+                possible = (lo - r <= e) && (r - hi <= e);
+                break;
+            case Operator::GREATER_OR_EQUAL:
+                possible = hi >= r;
+                break;
+            case Operator::GREATER:
+                possible = hi > r;
+                break;
+            case Operator::NOT_EQUAL:
+                possible = !((std::abs(lo - r) <= e) && (std::abs(hi - r) <= e));
+                break;
+            }
+        }
+        group = group && possible;
+    }
+    return group;
+}
+
+
+/*
+ * TablePredicate::Evaluate
+ */
+bool TablePredicate::Evaluate(const ColumnarTableDataCall& table, TableSelection& outSelection) const {
+    using megamol::core::utility::log::Log;
+
+    std::vector<BoundClause> bound;
+    bound.reserve(this->clauses.size());
+    for (size_t i = 0; i < this->clauses.size(); ++i) {
+        const auto& clause = this->clauses[i];
+        const auto col = table.FindColumn(clause.column);
+        if (col == static_cast<size_t>(-1)) {
+            Log::DefaultLog.WriteError("The column \"%s\" does not exist.", clause.column.c_str());
+            return false;
+        }
+        const auto& column = table.GetColumn(col);
+
+        BoundClause b{column.RawValues(), 1, column.Type(), clause.op, clause.reference, clause.integer,
+            clause.isInteger, this->epsilon, false, false, (i > 0) && (clause.connective == Connective::OR)};
+        if (column.Type() == ColumnarTableDataCall::DataType::DICTIONARY) {
+            // codes are compared exactly
+            b.epsilon = 0.0;
+        }
+
+        if (clause.isText) {
+            if (column.Type() != ColumnarTableDataCall::DataType::DICTIONARY) {
+                Log::DefaultLog.WriteError("The column \"%s\" cannot be compared to the string \"%s\".",
+                    clause.column.c_str(), clause.text.c_str());
+                return false;
+            }
+            if ((clause.op != Operator::EQUAL) && (clause.op != Operator::NOT_EQUAL)) {
+                Log::DefaultLog.WriteError(
+                    "Strings in column \"%s\" can only be tested for (in-) equality.", clause.column.c_str());
+                return false;
+            }
+            uint32_t code = 0;
+            while ((code < column.DictionarySize()) && (column.DictionaryEntry(code) != clause.text)) {
+                ++code;
+            }
+            if (code < column.DictionarySize()) {
+                b.reference = code;
+            } else {
+                // an unknown string is never equal to any cell
+                b.constant = true;
+                b.constantValue = (clause.op == Operator::NOT_EQUAL);
+            }
+        }
+        bound.push_back(b);
+    }
+
+    this->evaluate(bound, table.GetRowsCount(), outSelection);
+    return true;
+}
+
+
+/*
+ * TablePredicate::Parse
+ */
+bool TablePredicate::Parse(const std::string& expression, std::string& outError) {
+    std::vector<Token> tokens;
+    if (!tokenise(expression, tokens, outError)) {
+        return false;
+    }
+
+    std::vector<Clause> parsed;
+    auto connective = Connective::AND;
+    size_t i = 0;
+    while (i < tokens.size()) {
+        if (i + 3 > tokens.size()) {
+            outError = "Incomplete comparison at the end of the expression";
+            return false;
+        }
+        const auto& name = tokens[i];
+        const auto& op = tokens[i + 1];
+        const auto& value = tokens[i + 2];
+
+        if ((name.kind != Token::Kind::WORD) && (name.kind != Token::Kind::QUOTED_NAME)) {
+            outError = "Expected a column name in comparison " + std::to_string(parsed.size() + 1);
+            return false;
+        }
+        if (op.kind != Token::Kind::OPERATOR) {
+            outError = "Expected a comparison operator after \"" + name.text + "\"";
+            return false;
+        }
+
+        Clause clause{name.text, op.op, 0.0, 0, false, std::string(), false, connective};
+        if (value.kind == Token::Kind::STRING) {
+            if ((op.op != Operator::EQUAL) && (op.op != Operator::NOT_EQUAL)) {
+                outError = "Strings can only be tested for (in-) equality in the comparison of \"" + name.text + "\"";
+                return false;
+            }
+            clause.text = value.text;
+            clause.isText = true;
+        } else if (value.kind == Token::Kind::WORD) {
+            char* end = nullptr;
+            clause.reference = std::strtod(value.text.c_str(), &end);
+            if ((end == value.text.c_str()) || (*end != '\0')) {
+                outError = "\"" + value.text + "\" is not a number";
+                return false;
+            }
+            // integer literals are kept exactly, strtod rounds them beyond 2^53
+            errno = 0;
+            const long long integer = std::strtoll(value.text.c_str(), &end, 10);
+            if ((*end == '\0') && (errno != ERANGE)) {
+                clause.integer = static_cast<int64_t>(integer);
+                clause.isInteger = true;
+            } else {
+                clause.isInteger = toInt64(clause.reference, clause.integer);
+            }
+        } else {
+            outError = "Expected a value after the operator of the comparison of \"" + name.text + "\"";
+            return false;
+        }
+        parsed.push_back(clause);
+        i += 3;
+
+        if (i < tokens.size()) {
+            if (tokens[i].kind != Token::Kind::CONNECTIVE) {
+                outError = "Expected '&&' or '||' after the comparison of \"" + name.text + "\"";
+                return false;
+            }
+            connective = tokens[i].connective;
+            ++i;
+            if (i == tokens.size()) {
+                outError = "Expected a comparison after the last connective";
+                return false;
+            }
+        }
+    }
+
+    this->clauses = std::move(parsed);
+    return true;
+}
+
+
+/*
+ * TablePredicate::evaluate
+ */
+void TablePredicate::evaluate(const std::vector<BoundClause>& bound, size_t rowCnt, TableSelection& outSelection) const {
+    outSelection.Resize(rowCnt, bound.empty());
+    if (bound.empty()) {
+        return;
+    }
+
+    uint64_t* words = outSelection.Words();
+    const auto wordCnt = static_cast<int64_t>(outSelection.WordsCount());
+
+#pragma omp parallel for schedule(static, wordsPerChunk)
+    for (int64_t w = 0; w < wordCnt; ++w) {
+        const size_t first = static_cast<size_t>(w) * 64;
+        const size_t cnt = std::min<size_t>(64, rowCnt - first);
+        uint64_t result = 0;
+        uint64_t group = lowBits(cnt);
+
+        for (const auto& b : bound) {
+            if (b.startsGroup) {
+                result |= group;
+                group = lowBits(cnt);
+            }
+            if (group == 0) {
+                // the conjunction is already false for all rows of the word
+                continue;
+            }
+            if (b.constant) {
+                group &= b.constantValue ? ~uint64_t(0) : 0;
+                continue;
+            }
+            uint64_t mask = 0;
+            switch (b.type) {
+            case ColumnarTableDataCall::DataType::FLOAT:
+                mask = compareWord(static_cast<const float*>(b.data) + first * b.stride, b.stride, cnt, b.op,
+                    b.reference, b.epsilon);
+                break;
+            case ColumnarTableDataCall::DataType::DOUBLE:
+                mask = compareWord(static_cast<const double*>(b.data) + first * b.stride, b.stride, cnt, b.op,
+                    b.reference, b.epsilon);
+                break;
+            case ColumnarTableDataCall::DataType::INT32:
+                mask = compareWord(static_cast<const int32_t*>(b.data) + first * b.stride, b.stride, cnt, b.op,
+                    b.reference, b.epsilon);
+                break;
+            case ColumnarTableDataCall::DataType::INT64:
+                if (b.isInteger) {
+                    mask = compareInt64Word(static_cast<const int64_t*>(b.data) + first * b.stride, b.stride, cnt,
+                        b.op, b.integer, b.epsilon);
+                } else {
+                    // the reference is fractional, thus below 2^52, or beyond int64_t, so rounding the cells to
+                    // double keeps their order to it
+                    mask = compareWord(static_cast<const int64_t*>(b.data) + first * b.stride, b.stride, cnt, b.op,
+                        b.reference, b.epsilon);
+                }
+                break;
+            case ColumnarTableDataCall::DataType::DICTIONARY:
+                mask = compareWord(static_cast<const uint32_t*>(b.data) + first * b.stride, b.stride, cnt, b.op,
+                    b.reference, b.epsilon);
+                break;
+            }
+            group &= mask;
+        }
+
+        words[w] = result | group;
+    }
+}
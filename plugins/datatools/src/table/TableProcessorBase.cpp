@@ -34,6 +34,38 @@ megamol::datatools::table::TableProcessorBase::TableProcessorBase(void)
 }
 
 
+/*
+ * megamol::datatools::table::TableProcessorBase::restoreCached
+ */
+bool megamol::datatools::table::TableProcessorBase::restoreCached(
+    core::ResultCacheClient& cache, const TableDataCall& src) {
+    auto cached = cache.Find<CachedTable>(src, src.DataHash(), src.GetFrameID());
+    if (cached == nullptr) {
+        return false;
+    }
+
+    this->cachedOutput = std::move(cached);
+    return true;
+}
+
+
+/*
+ * megamol::datatools::table::TableProcessorBase::storeCached
+ */
+void megamol::datatools::table::TableProcessorBase::storeCached(
+    core::ResultCacheClient& cache, const TableDataCall& src) {
+    auto cached = std::make_shared<CachedTable>();
+    cached->Columns = std::move(this->columns);
+    cached->Values = std::move(this->values);
+    this->columns.clear();
+    this->values.clear();
+
+    const auto size = cached->Columns.size() * sizeof(ColumnInfo) + cached->Values.size() * sizeof(float);
+    this->cachedOutput = cached;
+    cache.Insert<CachedTable>(src, src.DataHash(), src.GetFrameID(), this->cachedOutput, size);
+}
+
+
 /*
  * megamol::datatools::table::TableProcessorBase::getData
  */
@@ -62,8 +94,11 @@ bool megamol::datatools::table::TableProcessorBase::getData(core::Call& call) {
     dst->SetFrameCount(src->GetFrameCount());
     dst->SetFrameID(this->frameID);
     dst->SetDataHash(this->getHash());
-    dst->Set(
-        this->columns.size(), this->values.size() / this->columns.size(), this->columns.data(), this->values.data());
+    {
+        const auto& columns = (this->cachedOutput != nullptr) ? this->cachedOutput->Columns : this->columns;
+        const auto& values = (this->cachedOutput != nullptr) ? this->cachedOutput->Values : this->values;
+        dst->Set(columns.size(), values.size() / columns.size(), columns.data(), values.data());
+    }
 
     return true;
 }
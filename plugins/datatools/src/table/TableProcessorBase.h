@@ -10,6 +10,7 @@
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
+#include "mmcore/ResultCache.h"
 
 #include "mmcore/param/ParamSlot.h"
 
@@ -34,6 +35,12 @@ public:
 protected:
     typedef megamol::datatools::table::TableDataCall::ColumnInfo ColumnInfo;
 
+    /** The output of a processor as stored in the result cache. */
+    struct CachedTable {
+        std::vector<ColumnInfo> Columns;
+        std::vector<float> Values;
+    };
+
     /**
      * Initialises a new instance.
      */
@@ -61,6 +68,34 @@ protected:
      */
     virtual bool prepareData(TableDataCall& src, const unsigned int frameID) = 0;
 
+    /**
+     * Makes the cached output for the current parameters and the data in
+     * 'src' the output of the processor, if there is one. The cached output
+     * is shared with the cache, not copied.
+     *
+     * @param cache The opt-in of the processor into the result cache.
+     * @param src   The call providing the input data.
+     *
+     * @return true if the output was restored, false if it must be computed.
+     */
+    bool restoreCached(core::ResultCacheClient& cache, const TableDataCall& src);
+
+    /**
+     * Moves 'columns' and 'values' into an immutable output, which becomes
+     * the output of the processor and is stored in the result cache for the
+     * current parameters and the data in 'src'.
+     *
+     * @param cache The opt-in of the processor into the result cache.
+     * @param src   The call providing the input data.
+     */
+    void storeCached(core::ResultCacheClient& cache, const TableDataCall& src);
+
+    /**
+     * Holds the output shared with the result cache, which replaces
+     * 'columns' and 'values' if set.
+     */
+    std::shared_ptr<const CachedTable> cachedOutput;
+
     /** Holds the columns of the (filtered) table. */
     std::vector<ColumnInfo> columns;
 
@@ -24,7 +24,8 @@
 megamol::datatools::table::TableSort::TableSort(void)
         : paramColumn("column", "The column to be filtered.")
         , paramIsDescending("descending", "Sort in descending instead of ascending order.")
-        , paramIsStable("stableSort", "Use a stable sorting algorithm.") {
+        , paramIsStable("stableSort", "Use a stable sorting algorithm.")
+        , resultCache(this) {
     /* Configure and export the parameters. */
     this->paramColumn << new core::param::FlexEnumParam("");
     this->MakeSlotAvailable(&this->paramColumn);
@@ -34,6 +35,10 @@ megamol::datatools::table::TableSort::TableSort(void)
 
     this->paramIsStable << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->paramIsStable);
+
+    this->resultCache.AddParameter(this->paramColumn);
+    this->resultCache.AddParameter(this->paramIsDescending);
+    this->resultCache.AddParameter(this->paramIsStable);
 }
 
 
@@ -74,6 +79,23 @@ bool megamol::datatools::table::TableSort::prepareData(TableDataCall& src, const
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash()) || (this->frameID != src.GetFrameID())) {
+        /* Use the output of previous parameters and inputs if it is cached. */
+        if (this->restoreCached(this->resultCache, src)) {
+            auto param = this->paramColumn.Param<FlexEnumParam>();
+            param->ClearValues();
+            for (auto& c : this->cachedOutput->Columns) {
+                param->AddValue(c.Name());
+            }
+
+            this->frameID = frameID;
+            this->inputHash = src.DataHash();
+            this->localHash = static_cast<std::size_t>(this->resultCache.ParameterHash());
+            this->paramColumn.ResetDirty();
+            this->paramIsDescending.ResetDirty();
+            this->paramIsStable.ResetDirty();
+            return true;
+        }
+
         auto column = 0;
         const auto data = src.GetData();
         std::vector<std::size_t> proxy(src.GetRowsCount());
@@ -133,12 +155,15 @@ bool megamol::datatools::table::TableSort::prepareData(TableDataCall& src, const
             dst += this->columns.size();
         }
 
+        this->storeCached(this->resultCache, src);
+
         /* Persist the state of the data. */
         this->frameID = frameID;
         this->inputHash = src.DataHash();
+        // equal parameters yield an equal hash, so a cached output gets back its previous hash
+        this->localHash = static_cast<std::size_t>(this->resultCache.ParameterHash());
 
         if (isParamsChanged) {
-            ++this->localHash;
             this->paramColumn.ResetDirty();
             this->paramIsDescending.ResetDirty();
             this->paramIsStable.ResetDirty();
@@ -68,6 +68,9 @@ private:
     core::param::ParamSlot paramColumn;
     core::param::ParamSlot paramIsDescending;
     core::param::ParamSlot paramIsStable;
+
+    /** The sorted tables of previous parameters and inputs. */
+    core::ResultCacheClient resultCache;
 };
 
 } /* end namespace table */
@@ -0,0 +1,152 @@
+/*
+ * TableToColumnarTable.cpp
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "TableToColumnarTable.h"
+#include "stdafx.h"
+
+#include "mmcore/utility/log/Log.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::table;
+using namespace megamol;
+
+std::string TableToColumnarTable::ModuleName = std::string("TableToColumnarTable");
+
+TableToColumnarTable::TableToColumnarTable(void)
+        : core::Module()
+        , dataOutSlot("dataOut", "Output")
+        , dataInSlot("dataIn", "Input")
+        , frameID(-1)
+        , datahash(std::numeric_limits<unsigned long>::max())
+        , rowsCount(0) {
+
+    this->dataInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataInSlot);
+
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(), ColumnarTableDataCall::FunctionName(0),
+        &TableToColumnarTable::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(), ColumnarTableDataCall::FunctionName(1),
+        &TableToColumnarTable::getExtent);
+    this->MakeSlotAvailable(&this->dataOutSlot);
+}
+
+TableToColumnarTable::~TableToColumnarTable(void) {
+    this->Release();
+}
+
+bool TableToColumnarTable::create(void) {
+    return true;
+}
+
+void TableToColumnarTable::release(void) {}
+
+bool TableToColumnarTable::processData(core::Call& c) {
+    try {
+        ColumnarTableDataCall* outCall = dynamic_cast<ColumnarTableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        TableDataCall* inCall = this->dataInSlot.CallAs<TableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)())
+            return false;
+
+        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+
+            const auto column_count = inCall->GetColumnsCount();
+            const auto column_infos = inCall->GetColumnsInfos();
+            const auto rows_count = inCall->GetRowsCount();
+            const auto in_data = inCall->GetData();
+
+            this->rowsCount = rows_count;
+            this->columns.resize(column_count);
+            this->floatData.resize(column_count);
+            this->codeData.resize(column_count);
+            this->dictionaries.resize(column_count);
+
+#pragma omp parallel for
+            for (int64_t col = 0; col < static_cast<int64_t>(column_count); ++col) {
+                const auto& info = column_infos[col];
+                auto& column = this->columns[col];
+                column.SetName(info.Name()).SetMinimumValue(info.MinimumValue()).SetMaximumValue(info.MaximumValue());
+
+                if (info.Type() == TableDataCall::ColumnType::CATEGORICAL) {
+                    auto& codes = this->codeData[col];
+                    auto& dict = this->dictionaries[col];
+                    codes.resize(rows_count);
+                    uint32_t maxCode = 0;
+                    for (size_t row = 0; row < rows_count; ++row) {
+                        // categories are stored as their index, NaN and negative values become the first one
+                        const float v = in_data[col + row * column_count];
+                        const long long code = (v > 0.0f) ? std::llround(std::min(v, 4294967295.0f)) : 0;
+                        codes[row] = static_cast<uint32_t>(std::min<long long>(code, 4294967295ll));
+                        maxCode = std::max(maxCode, codes[row]);
+                    }
+                    dict.resize((rows_count > 0) ? (static_cast<size_t>(maxCode) + 1) : 0);
+                    for (size_t i = 0; i < dict.size(); ++i) {
+                        dict[i] = std::to_string(i);
+                    }
+                    this->floatData[col].clear();
+                    column.SetData(codes.data(), dict.data(), dict.size());
+                } else {
+                    auto& values = this->floatData[col];
+                    values.resize(rows_count);
+                    for (size_t row = 0; row < rows_count; ++row) {
+                        values[row] = in_data[col + row * column_count];
+                    }
+                    this->codeData[col].clear();
+                    this->dictionaries[col].clear();
+                    column.SetData(values.data());
+                }
+            }
+        }
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetFrameID(this->frameID);
+        outCall->SetDataHash(this->datahash);
+        outCall->Set(this->columns.size(), this->rowsCount, this->columns.data());
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("Failed to execute %hs::processData\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool TableToColumnarTable::getExtent(core::Call& c) {
+    try {
+        ColumnarTableDataCall* outCall = dynamic_cast<ColumnarTableDataCall*>(&c);
+        if (outCall == NULL)
+            return false;
+
+        TableDataCall* inCall = this->dataInSlot.CallAs<TableDataCall>();
+        if (inCall == NULL)
+            return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(1))
+            return false;
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetDataHash(inCall->DataHash());
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("Failed to execute %hs::getExtent\n"), ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,104 @@
+/*
+ * TableToColumnarTable.h
+ *
+ * Copyright (C) 2022 by MegaMol Dev Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNARTABLE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNARTABLE_H_INCLUDED
+
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+
+#include "datatools/table/ColumnarTableDataCall.h"
+#include "datatools/table/TableDataCall.h"
+
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace datatools {
+namespace table {
+
+/*
+ * Module transposing a row-major table of floats into a columnar table.
+ * Quantitative columns become float columns, categorical columns are
+ * dictionary encoded with the category indices as dictionary entries.
+ * TableDataCall carries neither other cell types nor the names of the
+ * categories, so the output cannot have them either; double, int64 and named
+ * categories need a source producing ColumnarTableDataCall itself.
+ */
+class TableToColumnarTable : public core::Module {
+public:
+    static std::string ModuleName;
+
+    /** Return module class name */
+    static const char* ClassName(void) {
+        return ModuleName.c_str();
+    }
+
+    /** Return module class description */
+    static const char* Description(void) {
+        return "Converts a row-major table of floats into a columnar table";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor */
+    TableToColumnarTable(void);
+
+    /** Dtor */
+    virtual ~TableToColumnarTable(void);
+
+protected:
+    /** Lazy initialization of the module */
+    virtual bool create(void);
+
+    /** Resource release */
+    virtual void release(void);
+
+private:
+    /** Data callback */
+    bool processData(core::Call& c);
+
+    bool getExtent(core::Call& c);
+
+    /** Data output slot */
+    core::CalleeSlot dataOutSlot;
+
+    /** Data input slot */
+    core::CallerSlot dataInSlot;
+
+    /** ID of the current frame */
+    int frameID;
+
+    /** Hash of the current data */
+    size_t datahash;
+
+    /** The number of rows */
+    size_t rowsCount;
+
+    /** The column views handed out */
+    std::vector<ColumnarTableDataCall::Column> columns;
+
+    /** The cells of the quantitative columns, one vector per column */
+    std::vector<std::vector<float>> floatData;
+
+    /** The codes of the categorical columns, one vector per column */
+    std::vector<std::vector<uint32_t>> codeData;
+
+    /** The dictionaries of the categorical columns */
+    std::vector<std::vector<std::string>> dictionaries;
+}; /* end class TableToColumnarTable */
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace megamol */
+
+#endif /* end ifndef MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNARTABLE_H_INCLUDED */
@@ -20,6 +20,8 @@
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/StringParam.h"
 
+#include "datatools/table/TablePredicate.h"
+
 
 /// <summary>
 /// The list of possible comparison operators.
@@ -46,9 +48,13 @@ enum Operator : int {
 megamol::datatools::table::TableWhere::TableWhere(void)
         : paramColumn("column", "The column to be filtered.")
         , paramEpsilon("epsilon", "The epsilon value for testing (in-) equality.")
+        , paramExpression("expression", "A predicate combining multiple comparisons, e.g. "
+                                        "\"x > 0.5 && y <= 3 || z == 1\". If set, it replaces the comparison "
+                                        "defined by column, operator and reference.")
         , paramOperator("operator", "The comparison operator.")
         , paramReference("reference", "The reference value to compare to.")
-        , paramUpdateRange("updateRange", "Update the min/max range as the filter changes.") {
+        , paramUpdateRange("updateRange", "Update the min/max range as the filter changes.")
+        , resultCache(this) {
     /* Configure and export the parameters. */
     this->paramColumn << new core::param::FlexEnumParam("");
     this->MakeSlotAvailable(&this->paramColumn);
@@ -56,6 +62,9 @@ megamol::datatools::table::TableWhere::TableWhere(void)
     this->paramEpsilon << new core::param::FloatParam(0.0f);
     this->MakeSlotAvailable(&this->paramEpsilon);
 
+    this->paramExpression << new core::param::StringParam("");
+    this->MakeSlotAvailable(&this->paramExpression);
+
     {
         auto param = new core::param::EnumParam(0);
         param->SetTypePair(Operator::Less, "less than");
@@ -79,6 +88,13 @@ megamol::datatools::table::TableWhere::TableWhere(void)
 
     this->paramUpdateRange << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->paramUpdateRange);
+
+    this->resultCache.AddParameter(this->paramColumn);
+    this->resultCache.AddParameter(this->paramEpsilon);
+    this->resultCache.AddParameter(this->paramExpression);
+    this->resultCache.AddParameter(this->paramOperator);
+    this->resultCache.AddParameter(this->paramReference);
+    this->resultCache.AddParameter(this->paramUpdateRange);
 }
 
 
@@ -121,14 +137,36 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
     }
 
     auto isParamsChanged = this->paramUpdateRange.IsDirty() || this->paramColumn.IsDirty() ||
-                           this->paramOperator.IsDirty() || this->paramReference.IsDirty();
+                           this->paramOperator.IsDirty() || this->paramReference.IsDirty() ||
+                           this->paramEpsilon.IsDirty() || this->paramExpression.IsDirty();
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash()) || (this->frameID != src.GetFrameID())) {
+        /* Use the output of previous parameters and inputs if it is cached. */
+        if (this->restoreCached(this->resultCache, src)) {
+            auto param = this->paramColumn.Param<FlexEnumParam>();
+            param->ClearValues();
+            for (auto& c : this->cachedOutput->Columns) {
+                param->AddValue(c.Name());
+            }
+
+            this->frameID = frameID;
+            this->inputHash = src.DataHash();
+            this->localHash = static_cast<std::size_t>(this->resultCache.ParameterHash());
+            this->paramColumn.ResetDirty();
+            this->paramEpsilon.ResetDirty();
+            this->paramExpression.ResetDirty();
+            this->paramOperator.ResetDirty();
+            this->paramReference.ResetDirty();
+            this->paramUpdateRange.ResetDirty();
+            return true;
+        }
+
         auto column = 0;
         const auto data = src.GetData();
         auto isSort = false;
         std::function<bool(const float)> selector;
+        TablePredicate predicate;
 
         /* Process updates in the configuration. */
         {
@@ -136,6 +174,7 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
             auto e = this->paramEpsilon.Param<FloatParam>()->Value();
             auto o = this->paramOperator.Param<EnumParam>()->Value();
             auto r = this->paramReference.Param<FloatParam>()->Value();
+            auto x = this->paramExpression.Param<StringParam>()->Value();
 
             this->columns.resize(src.GetColumnsCount());
             std::copy(src.GetColumnsInfos(), src.GetColumnsInfos() + this->columns.size(), this->columns.begin());
@@ -155,32 +194,42 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
                 ++column;
             }
 
-            if (column != this->columns.size()) {
+            predicate.SetEpsilon(e);
+            if (!x.empty()) {
+                std::string error;
+                if (!predicate.Parse(x, error)) {
+                    Log::DefaultLog.WriteError(_T("The expression \"%hs\" is invalid: %hs. The %hs module will ")
+                                               _T("copy all input rows."),
+                        x.c_str(), error.c_str(), TableWhere::ClassName());
+                    predicate.Clear();
+                }
+
+            } else if (column != this->columns.size()) {
                 auto range = std::make_pair(this->columns[column].MinimumValue(), this->columns[column].MaximumValue());
 
                 switch (o) {
                 case Operator::Less:
-                    selector = [r](const float v) { return (v < r); };
+                    predicate.Add(c, TablePredicate::Operator::LESS, r);
                     break;
 
                 case Operator::LessOrEqual:
-                    selector = [r](const float v) { return (v <= r); };
+                    predicate.Add(c, TablePredicate::Operator::LESS_OR_EQUAL, r);
                     break;
 
                 case Operator::Equal:
-                    selector = [r, e](const float v) { return (std::abs(v - r) <= e); };
+                    predicate.Add(c, TablePredicate::Operator::EQUAL, r);
                     break;
 
                 case Operator::GreaterOrEqual:
-                    selector = [r](const float v) { return (v >= r); };
+                    predicate.Add(c, TablePredicate::Operator::GREATER_OR_EQUAL, r);
                     break;
 
                 case Operator::Greater:
-                    selector = [r](const float v) { return (v > r); };
+                    predicate.Add(c, TablePredicate::Operator::GREATER, r);
                     break;
 
                 case Operator::NotEqual:
-                    selector = [r, e](const float v) { return (std::abs(v - r) > e); };
+                    predicate.Add(c, TablePredicate::Operator::NOT_EQUAL, r);
                     break;
 
                 case Operator::LowerRange:
@@ -229,13 +278,23 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
         }
         assert(((column >= 0) && (column < this->columns.size())) || !selector);
 
-        if (selector || isSort) {
+        if (!predicate.IsEmpty() || selector || isSort) {
             // Copy selection.
             std::vector<std::size_t> selection;
-            selection.reserve(src.GetRowsCount());
 
-            if (selector) {
+            if (!predicate.IsEmpty()) {
+                // Selection is based on the predicate engine, which evaluates
+                // blocks of 64 rows into a bitmap in parallel.
+                TableSelection selected;
+                if (!predicate.Evaluate(
+                        this->columns.data(), this->columns.size(), data, src.GetRowsCount(), selected)) {
+                    selected.Resize(src.GetRowsCount(), true);
+                }
+                selected.ToIndices(selection);
+
+            } else if (selector) {
                 // Selection is based on predicate.
+                selection.reserve(src.GetRowsCount());
                 for (auto r = 0; r < src.GetRowsCount(); ++r) {
                     if (selector(data[r * this->columns.size() + column])) {
                         selection.push_back(r);
@@ -301,11 +360,13 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
             }
 
             /* Copy the data. */
-            this->values.resize(selection.size() * this->columns.size());
-            auto d = this->values.data();
-            for (auto r : selection) {
-                std::copy(data + r * this->columns.size(), data + (r + 1) * this->columns.size(), d);
-                d += this->columns.size();
+            const auto colCnt = this->columns.size();
+            const auto selCnt = static_cast<int64_t>(selection.size());
+            this->values.resize(selection.size() * colCnt);
+#pragma omp parallel for
+            for (int64_t i = 0; i < selCnt; ++i) {
+                const auto r = selection[i];
+                std::copy(data + r * colCnt, data + (r + 1) * colCnt, this->values.data() + i * colCnt);
             }
 
             /* Update the min/max range if requested. */
@@ -337,13 +398,18 @@ bool megamol::datatools::table::TableWhere::prepareData(TableDataCall& src, cons
             std::copy(src.GetData(), src.GetData() + this->values.size(), this->values.begin());
         } /* end if (selector || isSort) */
 
+        this->storeCached(this->resultCache, src);
+
         /* Persist the state of the data. */
         this->frameID = frameID;
         this->inputHash = src.DataHash();
+        // equal parameters yield an equal hash, so a cached output gets back its previous hash
+        this->localHash = static_cast<std::size_t>(this->resultCache.ParameterHash());
 
         if (isParamsChanged) {
-            ++this->localHash;
             this->paramColumn.ResetDirty();
+            this->paramEpsilon.ResetDirty();
+            this->paramExpression.ResetDirty();
             this->paramOperator.ResetDirty();
             this->paramReference.ResetDirty();
             this->paramUpdateRange.ResetDirty();
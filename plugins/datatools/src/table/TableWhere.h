@@ -67,9 +67,13 @@ protected:
 private:
     core::param::ParamSlot paramColumn;
     core::param::ParamSlot paramEpsilon;
+    core::param::ParamSlot paramExpression;
     core::param::ParamSlot paramOperator;
     core::param::ParamSlot paramReference;
     core::param::ParamSlot paramUpdateRange;
+
+    /** The selections of previous parameters and inputs. */
+    core::ResultCacheClient resultCache;
 };
 
 } /* end namespace table */
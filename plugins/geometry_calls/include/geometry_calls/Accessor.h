@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 #include <type_traits>
 
@@ -27,6 +30,31 @@ T const* access(char const* ptr, size_t idx, size_t stride) {
 }
 
 
+/**
+ * Converts 'count' elements of a strided array starting at 'first' into 'out'.
+ *
+ * Densely packed arrays are copied with plain loops the compiler can vectorize.
+ */
+template<class T, class R>
+void copy_strided(char const* ptr, size_t stride, size_t first, size_t count, R* out) {
+    char const* src = ptr + first * stride;
+    if (stride == sizeof(T)) {
+        if constexpr (std::is_same_v<T, R>) {
+            std::memcpy(out, src, count * sizeof(T));
+        } else {
+            T const* vals = reinterpret_cast<T const*>(src);
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<R>(vals[i]);
+            }
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<R>(*reinterpret_cast<T const*>(src + i * stride));
+        }
+    }
+}
+
+
 /**
  * Interface for accessor classes.
  */
@@ -43,15 +71,58 @@ public:
     virtual unsigned int Get_u32(size_t idx) const = 0;
     virtual unsigned short Get_u16(size_t idx) const = 0;
     virtual unsigned char Get_u8(size_t idx) const = 0;
+
+    /**
+     * Bulk variants of the getters: write the values of 'count' elements starting at 'first' into 'out'.
+     * This costs one indirect call per range instead of one per element.
+     */
+    virtual void Copy_f(size_t first, size_t count, float* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_f(first + i);
+        }
+    }
+
+    virtual void Copy_d(size_t first, size_t count, double* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_d(first + i);
+        }
+    }
+
+    virtual void Copy_u64(size_t first, size_t count, uint64_t* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_u64(first + i);
+        }
+    }
+
+    virtual void Copy_u32(size_t first, size_t count, unsigned int* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_u32(first + i);
+        }
+    }
+
+    virtual void Copy_u16(size_t first, size_t count, unsigned short* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_u16(first + i);
+        }
+    }
+
+    virtual void Copy_u8(size_t first, size_t count, unsigned char* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = Get_u8(first + i);
+        }
+    }
+
     virtual ~Accessor() = default;
 };
 
 
 /**
  * Implementation of an accessor into a strided array.
+ *
+ * The class is final, so calls on an object of this type, e.g. inside a ParticleStore visitor, are not virtual.
  */
 template<class T>
-class Accessor_Impl : public Accessor {
+class Accessor_Impl final : public Accessor {
 public:
     Accessor_Impl(char const* ptr, size_t stride) : ptr_{ptr}, stride_{stride} {}
 
@@ -109,6 +180,35 @@ public:
         return Get<unsigned char>(idx);
     }
 
+    template<class R>
+    void CopyTo(size_t first, size_t count, R* out) const {
+        copy_strided<T>(ptr_, stride_, first, count, out);
+    }
+
+    void Copy_f(size_t first, size_t count, float* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_d(size_t first, size_t count, double* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u64(size_t first, size_t count, uint64_t* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u32(size_t first, size_t count, unsigned int* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u16(size_t first, size_t count, unsigned short* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u8(size_t first, size_t count, unsigned char* out) const override {
+        CopyTo(first, count, out);
+    }
+
     virtual ~Accessor_Impl() = default;
 
 private:
@@ -121,7 +221,7 @@ private:
  * Accessor class reporting const values, for instance globals.
  */
 template<class T, bool Norm>
-class Accessor_Val : public Accessor {
+class Accessor_Val final : public Accessor {
 public:
     Accessor_Val(T const val) : val_(val) {}
 
@@ -167,6 +267,35 @@ public:
         return Get<unsigned char>();
     }
 
+    template<class R>
+    void CopyTo(size_t first, size_t count, R* out) const {
+        std::fill_n(out, count, Get<R>());
+    }
+
+    void Copy_f(size_t first, size_t count, float* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_d(size_t first, size_t count, double* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u64(size_t first, size_t count, uint64_t* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u32(size_t first, size_t count, unsigned int* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u16(size_t first, size_t count, unsigned short* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u8(size_t first, size_t count, unsigned char* out) const override {
+        CopyTo(first, count, out);
+    }
+
     virtual ~Accessor_Val() = default;
 
 private:
@@ -177,7 +306,7 @@ private:
 /**
  * Dummy accessor for an empty array;
  */
-class Accessor_0 : public Accessor {
+class Accessor_0 final : public Accessor {
 public:
     Accessor_0() = default;
 
@@ -213,6 +342,35 @@ public:
         return static_cast<unsigned char>(0);
     }
 
+    template<class R>
+    void CopyTo(size_t first, size_t count, R* out) const {
+        std::fill_n(out, count, static_cast<R>(0));
+    }
+
+    void Copy_f(size_t first, size_t count, float* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_d(size_t first, size_t count, double* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u64(size_t first, size_t count, uint64_t* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u32(size_t first, size_t count, unsigned int* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u16(size_t first, size_t count, unsigned short* out) const override {
+        CopyTo(first, count, out);
+    }
+
+    void Copy_u8(size_t first, size_t count, unsigned char* out) const override {
+        CopyTo(first, count, out);
+    }
+
     virtual ~Accessor_0() = default;
 
 private:
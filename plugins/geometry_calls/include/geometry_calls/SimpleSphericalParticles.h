@@ -85,124 +85,163 @@ public:
 
         void SetVertexData(SimpleSphericalParticles::VertexDataType const t, char const* p, unsigned int const s = 0,
             float const globRad = 0.5f) {
-            switch (t) {
-            case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ: {
-                this->x_acc_ = std::make_shared<Accessor_Impl<double>>(p, s);
-                this->y_acc_ = std::make_shared<Accessor_Impl<double>>(p + sizeof(double), s);
-                this->z_acc_ = std::make_shared<Accessor_Impl<double>>(p + 2 * sizeof(double), s);
-                this->r_acc_ = std::make_shared<Accessor_Val<float, false>>(globRad);
-            } break;
-            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZ: {
-                this->x_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->y_acc_ = std::make_shared<Accessor_Impl<float>>(p + sizeof(float), s);
-                this->z_acc_ = std::make_shared<Accessor_Impl<float>>(p + 2 * sizeof(float), s);
-                this->r_acc_ = std::make_shared<Accessor_Val<float, false>>(globRad);
-            } break;
-            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZR: {
-                this->x_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->y_acc_ = std::make_shared<Accessor_Impl<float>>(p + sizeof(float), s);
-                this->z_acc_ = std::make_shared<Accessor_Impl<float>>(p + 2 * sizeof(float), s);
-                this->r_acc_ = std::make_shared<Accessor_Impl<float>>(p + 3 * sizeof(float), s);
-            } break;
-            case SimpleSphericalParticles::VERTDATA_SHORT_XYZ: {
-                this->x_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p, s);
-                this->y_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p + sizeof(unsigned short), s);
-                this->z_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p + 2 * sizeof(unsigned short), s);
-                this->r_acc_ = std::make_shared<Accessor_Val<float, false>>(globRad);
-            } break;
-            case SimpleSphericalParticles::VERTDATA_NONE:
-            default: {
-                this->x_acc_ = std::make_shared<Accessor_0>();
-                this->y_acc_ = std::make_shared<Accessor_0>();
-                this->z_acc_ = std::make_shared<Accessor_0>();
-                this->r_acc_ = std::make_shared<Accessor_Val<float, false>>(globRad);
-            }
-            }
+            this->vert_type_ = t;
+            this->vert_ptr_ = p;
+            this->vert_stride_ = s;
+            this->glob_rad_ = globRad;
+            this->VisitVertices([this](auto const& x, auto const& y, auto const& z, auto const& r) {
+                this->x_acc_ = share(x);
+                this->y_acc_ = share(y);
+                this->z_acc_ = share(z);
+                this->r_acc_ = share(r);
+            });
         }
 
         void SetColorData(SimpleSphericalParticles::ColourDataType const t, char const* p, unsigned int const s = 0,
             unsigned char const r = 255, unsigned char const g = 255, unsigned char const b = 255,
             unsigned char const a = 255) {
-            switch (t) {
-            case SimpleSphericalParticles::COLDATA_DOUBLE_I: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<double>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_0>();
-                this->cb_acc_ = std::make_shared<Accessor_0>();
-                this->ca_acc_ = std::make_shared<Accessor_0>();
-            } break;
-            case SimpleSphericalParticles::COLDATA_FLOAT_I: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_0>();
-                this->cb_acc_ = std::make_shared<Accessor_0>();
-                this->ca_acc_ = std::make_shared<Accessor_0>();
-            } break;
-            case SimpleSphericalParticles::COLDATA_FLOAT_RGB: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_Impl<float>>(p + sizeof(float), s);
-                this->cb_acc_ = std::make_shared<Accessor_Impl<float>>(p + 2 * sizeof(float), s);
-                this->ca_acc_ = std::make_shared<Accessor_Val<float, false>>(1.0f);
-            } break;
-            case SimpleSphericalParticles::COLDATA_FLOAT_RGBA: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_Impl<float>>(p + sizeof(float), s);
-                this->cb_acc_ = std::make_shared<Accessor_Impl<float>>(p + 2 * sizeof(float), s);
-                this->ca_acc_ = std::make_shared<Accessor_Impl<float>>(p + 3 * sizeof(float), s);
-            } break;
-            case SimpleSphericalParticles::COLDATA_UINT8_RGB: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p + sizeof(unsigned char), s);
-                this->cb_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p + 2 * sizeof(unsigned char), s);
-                this->ca_acc_ = std::make_shared<Accessor_Val<unsigned char, false>>(255);
-            } break;
-            case SimpleSphericalParticles::COLDATA_UINT8_RGBA: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p + sizeof(unsigned char), s);
-                this->cb_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p + 2 * sizeof(unsigned char), s);
-                this->ca_acc_ = std::make_shared<Accessor_Impl<unsigned char>>(p + 3 * sizeof(unsigned char), s);
-            } break;
-            case SimpleSphericalParticles::COLDATA_USHORT_RGBA: {
-                this->cr_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p, s);
-                this->cg_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p + sizeof(unsigned short), s);
-                this->cb_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p + 2 * sizeof(unsigned short), s);
-                this->ca_acc_ = std::make_shared<Accessor_Impl<unsigned short>>(p + 3 * sizeof(unsigned short), s);
-            } break;
-            case SimpleSphericalParticles::COLDATA_NONE:
-            default: {
-                this->cr_acc_ = std::make_shared<Accessor_Val<unsigned char, true>>(r);
-                this->cg_acc_ = std::make_shared<Accessor_Val<unsigned char, true>>(g);
-                this->cb_acc_ = std::make_shared<Accessor_Val<unsigned char, true>>(b);
-                this->ca_acc_ = std::make_shared<Accessor_Val<unsigned char, true>>(a);
-            }
-            }
+            this->col_type_ = t;
+            this->col_ptr_ = p;
+            this->col_stride_ = s;
+            this->glob_col_ = {r, g, b, a};
+            this->VisitColors([this](auto const& cr, auto const& cg, auto const& cb, auto const& ca) {
+                this->cr_acc_ = share(cr);
+                this->cg_acc_ = share(cg);
+                this->cb_acc_ = share(cb);
+                this->ca_acc_ = share(ca);
+            });
         }
 
         void SetDirData(SimpleSphericalParticles::DirDataType const t, char const* p, unsigned int const s = 0) {
-            switch (t) {
-            case DIRDATA_FLOAT_XYZ: {
-                this->dx_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
-                this->dy_acc_ = std::make_shared<Accessor_Impl<float>>(p + sizeof(float), s);
-                this->dz_acc_ = std::make_shared<Accessor_Impl<float>>(p + 2 * sizeof(float), s);
-            } break;
-            default: {
-                this->dx_acc_ = std::make_shared<Accessor_0>();
-                this->dy_acc_ = std::make_shared<Accessor_0>();
-                this->dz_acc_ = std::make_shared<Accessor_0>();
+            this->dir_type_ = t;
+            this->dir_ptr_ = p;
+            this->dir_stride_ = s;
+            this->VisitDirs([this](auto const& dx, auto const& dy, auto const& dz) {
+                this->dx_acc_ = share(dx);
+                this->dy_acc_ = share(dy);
+                this->dz_acc_ = share(dz);
+            });
+        }
+
+        void SetIDData(SimpleSphericalParticles::IDDataType const t, char const* p, unsigned int const s = 0) {
+            this->id_type_ = t;
+            this->id_ptr_ = p;
+            this->id_stride_ = s;
+            this->VisitIDs([this](auto const& id) { this->id_acc_ = share(id); });
+        }
+
+        /**
+         * Calls 'v(x, y, z, r)' once with the accessors of the current vertex layout as concrete types.
+         *
+         * Per element calls like 'x.Get_f(idx)' inside the visitor are resolved at compile time, so a whole list
+         * costs a single dispatch instead of one virtual call per component and particle.
+         */
+        template<class Visitor>
+        void VisitVertices(Visitor&& v) const {
+            auto const p = this->vert_ptr_;
+            auto const s = this->vert_stride_;
+            switch (this->vert_type_) {
+            case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ:
+                v(Accessor_Impl<double>(p, s), Accessor_Impl<double>(p + sizeof(double), s),
+                    Accessor_Impl<double>(p + 2 * sizeof(double), s), Accessor_Val<float, false>(this->glob_rad_));
+                break;
+            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZ:
+                v(Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                    Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Val<float, false>(this->glob_rad_));
+                break;
+            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZR:
+                v(Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                    Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Impl<float>(p + 3 * sizeof(float), s));
+                break;
+            case SimpleSphericalParticles::VERTDATA_SHORT_XYZ:
+                v(Accessor_Impl<unsigned short>(p, s), Accessor_Impl<unsigned short>(p + sizeof(unsigned short), s),
+                    Accessor_Impl<unsigned short>(p + 2 * sizeof(unsigned short), s),
+                    Accessor_Val<float, false>(this->glob_rad_));
+                break;
+            case SimpleSphericalParticles::VERTDATA_NONE:
+            default:
+                v(Accessor_0(), Accessor_0(), Accessor_0(), Accessor_Val<float, false>(this->glob_rad_));
             }
+        }
+
+        /**
+         * Calls 'v(cr, cg, cb, ca)' once with the accessors of the current colour layout as concrete types.
+         */
+        template<class Visitor>
+        void VisitColors(Visitor&& v) const {
+            auto const p = this->col_ptr_;
+            auto const s = this->col_stride_;
+            switch (this->col_type_) {
+            case SimpleSphericalParticles::COLDATA_DOUBLE_I:
+                v(Accessor_Impl<double>(p, s), Accessor_0(), Accessor_0(), Accessor_0());
+                break;
+            case SimpleSphericalParticles::COLDATA_FLOAT_I:
+                v(Accessor_Impl<float>(p, s), Accessor_0(), Accessor_0(), Accessor_0());
+                break;
+            case SimpleSphericalParticles::COLDATA_FLOAT_RGB:
+                v(Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                    Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Val<float, false>(1.0f));
+                break;
+            case SimpleSphericalParticles::COLDATA_FLOAT_RGBA:
+                v(Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                    Accessor_Impl<float>(p + 2 * sizeof(float), s), Accessor_Impl<float>(p + 3 * sizeof(float), s));
+                break;
+            case SimpleSphericalParticles::COLDATA_UINT8_RGB:
+                v(Accessor_Impl<unsigned char>(p, s), Accessor_Impl<unsigned char>(p + sizeof(unsigned char), s),
+                    Accessor_Impl<unsigned char>(p + 2 * sizeof(unsigned char), s),
+                    Accessor_Val<unsigned char, false>(255));
+                break;
+            case SimpleSphericalParticles::COLDATA_UINT8_RGBA:
+                v(Accessor_Impl<unsigned char>(p, s), Accessor_Impl<unsigned char>(p + sizeof(unsigned char), s),
+                    Accessor_Impl<unsigned char>(p + 2 * sizeof(unsigned char), s),
+                    Accessor_Impl<unsigned char>(p + 3 * sizeof(unsigned char), s));
+                break;
+            case SimpleSphericalParticles::COLDATA_USHORT_RGBA:
+                v(Accessor_Impl<unsigned short>(p, s), Accessor_Impl<unsigned short>(p + sizeof(unsigned short), s),
+                    Accessor_Impl<unsigned short>(p + 2 * sizeof(unsigned short), s),
+                    Accessor_Impl<unsigned short>(p + 3 * sizeof(unsigned short), s));
+                break;
+            case SimpleSphericalParticles::COLDATA_NONE:
+            default:
+                v(Accessor_Val<unsigned char, true>(this->glob_col_[0]),
+                    Accessor_Val<unsigned char, true>(this->glob_col_[1]),
+                    Accessor_Val<unsigned char, true>(this->glob_col_[2]),
+                    Accessor_Val<unsigned char, true>(this->glob_col_[3]));
             }
         }
 
-        void SetIDData(SimpleSphericalParticles::IDDataType const t, char const* p, unsigned int const s = 0) {
-            switch (t) {
-            case SimpleSphericalParticles::IDDATA_UINT32: {
-                this->id_acc_ = std::make_shared<Accessor_Impl<unsigned int>>(reinterpret_cast<char const*>(p), s);
-            } break;
-            case SimpleSphericalParticles::IDDATA_UINT64: {
-                this->id_acc_ = std::make_shared<Accessor_Impl<uint64_t>>(reinterpret_cast<char const*>(p), s);
-            } break;
-            case SimpleSphericalParticles::IDDATA_NONE:
-            default: {
-                this->id_acc_ = std ::make_shared<Accessor_0>();
+        /**
+         * Calls 'v(dx, dy, dz)' once with the accessors of the current direction layout as concrete types.
+         */
+        template<class Visitor>
+        void VisitDirs(Visitor&& v) const {
+            auto const p = this->dir_ptr_;
+            auto const s = this->dir_stride_;
+            switch (this->dir_type_) {
+            case SimpleSphericalParticles::DIRDATA_FLOAT_XYZ:
+                v(Accessor_Impl<float>(p, s), Accessor_Impl<float>(p + sizeof(float), s),
+                    Accessor_Impl<float>(p + 2 * sizeof(float), s));
+                break;
+            default:
+                v(Accessor_0(), Accessor_0(), Accessor_0());
             }
+        }
+
+        /**
+         * Calls 'v(id)' once with the accessor of the current id layout as concrete type.
+         */
+        template<class Visitor>
+        void VisitIDs(Visitor&& v) const {
+            switch (this->id_type_) {
+            case SimpleSphericalParticles::IDDATA_UINT32:
+                v(Accessor_Impl<unsigned int>(this->id_ptr_, this->id_stride_));
+                break;
+            case SimpleSphericalParticles::IDDATA_UINT64:
+                v(Accessor_Impl<uint64_t>(this->id_ptr_, this->id_stride_));
+                break;
+            case SimpleSphericalParticles::IDDATA_NONE:
+            default:
+                v(Accessor_0());
             }
         }
 
@@ -255,6 +294,27 @@ public:
         }
 
     private:
+        template<class A>
+        static std::shared_ptr<Accessor> share(A const& acc) {
+            return std::make_shared<A>(acc);
+        }
+
+        // the layouts the accessors are built from, kept for the visitors
+        SimpleSphericalParticles::VertexDataType vert_type_ = SimpleSphericalParticles::VERTDATA_NONE;
+        char const* vert_ptr_ = nullptr;
+        unsigned int vert_stride_ = 0;
+        float glob_rad_ = 0.0f;
+        SimpleSphericalParticles::ColourDataType col_type_ = SimpleSphericalParticles::COLDATA_NONE;
+        char const* col_ptr_ = nullptr;
+        unsigned int col_stride_ = 0;
+        std::array<unsigned char, 4> glob_col_ = {0, 0, 0, 0};
+        SimpleSphericalParticles::DirDataType dir_type_ = SimpleSphericalParticles::DIRDATA_NONE;
+        char const* dir_ptr_ = nullptr;
+        unsigned int dir_stride_ = 0;
+        SimpleSphericalParticles::IDDataType id_type_ = SimpleSphericalParticles::IDDATA_NONE;
+        char const* id_ptr_ = nullptr;
+        unsigned int id_stride_ = 0;
+
         std::shared_ptr<Accessor> x_acc_ = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> y_acc_ = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> z_acc_ = std::make_shared<Accessor_0>();
@@ -30,6 +30,9 @@ public:
     /** Structure containing all required metadata about a data set. */
     typedef struct VolumetricMetadata_t Metadata;
 
+    /** A block of voxels of the resolution pyramid. */
+    typedef struct VolumetricBrick_t Brick;
+
     /**
      * Answer the name of this module.
      *
@@ -95,6 +98,17 @@ public:
     /** Index of the function retrieving data that might be unavailable. */
     static const unsigned int IDX_TRY_GET_DATA;
 
+    /**
+     * Index of the function retrieving the bricks covering the requested
+     * region (see SetRegion) of the requested frame.
+     *
+     * Like all other functions, the function must be registered by every
+     * provider, as the call is not compatible with a slot lacking it.
+     * Providers that cannot answer bricks register a callback returning
+     * false, so callers fall back to GetData.
+     */
+    static const unsigned int IDX_GET_BRICKS;
+
     /**
      * Initialises a new instance.
      */
@@ -121,6 +135,24 @@ public:
         return this->FrameCount();
     }
 
+    /**
+     * Gets the bricks delivered by the last IDX_GET_BRICKS call.
+     *
+     * @return The bricks, which remain valid until the next call.
+     */
+    inline const Brick* GetBricks(void) const {
+        return this->bricks;
+    }
+
+    /**
+     * Gets the number of bricks delivered by the last IDX_GET_BRICKS call.
+     *
+     * @return The number of bricks.
+     */
+    inline size_t GetBrickCount(void) const {
+        return this->cntBricks;
+    }
+
     /**
      * Gets the number of components per grid point.
      *
@@ -184,6 +216,56 @@ public:
         return this->GetVoxelSize() * this->GetVoxelsPerFrame();
     }
 
+    /**
+     * Gets the number of levels of the resolution pyramid of the data
+     * source, which is known after the first IDX_GET_BRICKS call.
+     *
+     * @return The number of levels or 0 if unknown.
+     */
+    inline unsigned int GetLevels(void) const {
+        return this->levels;
+    }
+
+    /**
+     * Gets the first voxel of the requested region in voxels of level 0.
+     *
+     * @return The minimum corner of the region.
+     */
+    inline const size_t* GetRegionMin(void) const {
+        return this->regionMin;
+    }
+
+    /**
+     * Gets the voxel after the requested region in voxels of level 0. The
+     * data source clamps the region to the resolution of the data set.
+     *
+     * @return The maximum corner of the region (exclusive).
+     */
+    inline const size_t* GetRegionMax(void) const {
+        return this->regionMax;
+    }
+
+    /**
+     * Gets the requested level of the resolution pyramid. The data source
+     * answers with its coarsest level if the requested one does not exist.
+     *
+     * @return The requested level.
+     */
+    inline unsigned int GetRequestedLevel(void) const {
+        return this->requestedLevel;
+    }
+
+    /**
+     * Answer whether the data source may build missing bricks for a
+     * IDX_GET_BRICKS call. Otherwise, the call fails unless the bricks of
+     * the requested frame already exist.
+     *
+     * @return 'true' if bricks may be built on request.
+     */
+    inline bool IsBuildAllowed(void) const {
+        return this->isBuildAllowed;
+    }
+
     /**
      * Gets the type of the grid.
      *
@@ -299,6 +381,31 @@ public:
      */
     void SetMetadata(const Metadata* metadata);
 
+    /**
+     * Sets the bricks answering a IDX_GET_BRICKS call.
+     *
+     * The object never takes ownership of the memory designated by 'bricks'.
+     *
+     * @param bricks    The bricks covering the requested region.
+     * @param cntBricks The number of bricks.
+     * @param levels    The number of levels of the resolution pyramid.
+     */
+    void SetBricks(const Brick* bricks, const size_t cntBricks, const unsigned int levels);
+
+    /**
+     * Sets the region and level of detail for a IDX_GET_BRICKS call. The
+     * default region is the whole data set at level 0.
+     *
+     * @param min            The first voxel of the region in voxels of
+     *                       level 0.
+     * @param max            The voxel after the region in voxels of level 0.
+     * @param level          The requested level of the resolution pyramid.
+     * @param isBuildAllowed Allow the data source to build missing bricks,
+     *                       which requires reading the whole frame.
+     */
+    void SetRegion(
+        const size_t* min, const size_t* max, const unsigned int level = 0, const bool isBuildAllowed = true);
+
     /**
      * Assignment.
      *
@@ -313,7 +420,7 @@ private:
     typedef AbstractGetData3DCall Base;
 
     /** The functions that are provided by the call. */
-    static const char* FUNCTIONS[6];
+    static const char* FUNCTIONS[7];
 
     /** The pointer to the raw data. The call does not own this memory! */
     void* data;
@@ -323,6 +430,25 @@ private:
 
     /** Pointer to the metadata descriptor of the data set. */
     const Metadata* metadata;
+
+    /** The bricks of the last IDX_GET_BRICKS call. The call does not own this memory! */
+    const Brick* bricks;
+
+    /** The number of elements in 'bricks'. */
+    size_t cntBricks;
+
+    /** The number of levels of the resolution pyramid. */
+    unsigned int levels;
+
+    /** The requested region in voxels of level 0, 'regionMax' is exclusive. */
+    size_t regionMin[3];
+    size_t regionMax[3];
+
+    /** The requested level of the resolution pyramid. */
+    unsigned int requestedLevel;
+
+    /** Whether the data source may build missing bricks. */
+    bool isBuildAllowed;
 };
 
 /** Call Descriptor.  */
@@ -133,4 +133,35 @@ struct VolumetricMetadata_t {
     enum MemoryLocation MemLoc;
 };
 
+/**
+ * A block of voxels of one level of the resolution pyramid of a data set.
+ * Level 0 is the original resolution, every further level halves the
+ * resolution in each dimension (rounding up).
+ */
+struct VolumetricBrick_t {
+
+    /** The level of the pyramid the brick belongs to. */
+    unsigned int Level;
+
+    /** The position of the first voxel of the brick in voxels of its level. */
+    size_t Offset[3];
+
+    /** The number of voxels of the brick in each dimension. */
+    size_t Resolution[3];
+
+    /**
+     * The voxels of the brick, x running fastest, each voxel having the same
+     * layout as in the full frame. The data source remains owner of the
+     * memory.
+     */
+    const void* Data;
+
+    /**
+     * Minimal and maximal values per component over all voxels of the
+     * original resolution covered by the brick, or nullptr if unknown.
+     */
+    const double* MinValues;
+    const double* MaxValues;
+};
+
 } // namespace megamol::geocalls
@@ -8,6 +8,8 @@
 #include "geometry_calls/VolumetricDataCall.h"
 #include "stdafx.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 #include "vislib/OutOfRangeException.h"
@@ -111,10 +113,27 @@ const unsigned int VolumetricDataCall::IDX_STOP_ASYNC = 4;
 const unsigned int VolumetricDataCall::IDX_TRY_GET_DATA = 5;
 
 
+/*
+ * VolumetricDataCall::IDX_GET_BRICKS
+ */
+const unsigned int VolumetricDataCall::IDX_GET_BRICKS = 6;
+
+
 /*
  * VolumetricDataCall::VolumetricDataCall
  */
-VolumetricDataCall::VolumetricDataCall(void) : data(nullptr), metadata(nullptr), vram_volume_name(0) {}
+VolumetricDataCall::VolumetricDataCall(void)
+        : data(nullptr)
+        , metadata(nullptr)
+        , vram_volume_name(0)
+        , bricks(nullptr)
+        , cntBricks(0)
+        , levels(0)
+        , requestedLevel(0)
+        , isBuildAllowed(true) {
+    std::fill(this->regionMin, this->regionMin + 3, 0);
+    std::fill(this->regionMax, this->regionMax + 3, std::numeric_limits<size_t>::max());
+}
 
 
 /*
@@ -123,7 +142,12 @@ VolumetricDataCall::VolumetricDataCall(void) : data(nullptr), metadata(nullptr),
 VolumetricDataCall::VolumetricDataCall(const VolumetricDataCall& rhs)
         : data(nullptr)
         , metadata(nullptr)
-        , vram_volume_name(0) {
+        , vram_volume_name(0)
+        , bricks(nullptr)
+        , cntBricks(0)
+        , levels(0)
+        , requestedLevel(0)
+        , isBuildAllowed(true) {
     *this = rhs;
 }
 
@@ -307,6 +331,16 @@ bool VolumetricDataCall::IsUniform(const int axis) const {
 }
 
 
+/*
+ * VolumetricDataCall::SetBricks
+ */
+void VolumetricDataCall::SetBricks(const Brick* bricks, const size_t cntBricks, const unsigned int levels) {
+    this->bricks = bricks;
+    this->cntBricks = (bricks != nullptr) ? cntBricks : 0;
+    this->levels = levels;
+}
+
+
 /*
  * VolumetricDataCall::SetMetadata
  */
@@ -315,6 +349,18 @@ void VolumetricDataCall::SetMetadata(const Metadata* metadata) {
 }
 
 
+/*
+ * VolumetricDataCall::SetRegion
+ */
+void VolumetricDataCall::SetRegion(
+    const size_t* min, const size_t* max, const unsigned int level, const bool isBuildAllowed) {
+    std::copy(min, min + 3, this->regionMin);
+    std::copy(max, max + 3, this->regionMax);
+    this->requestedLevel = level;
+    this->isBuildAllowed = isBuildAllowed;
+}
+
+
 /*
  * VolumetricDataCall::operator =
  */
@@ -323,6 +369,13 @@ VolumetricDataCall& VolumetricDataCall::operator=(const VolumetricDataCall& rhs)
         Base::operator=(rhs);
         this->data = rhs.data;
         this->metadata = rhs.metadata;
+        this->bricks = rhs.bricks;
+        this->cntBricks = rhs.cntBricks;
+        this->levels = rhs.levels;
+        std::copy(rhs.regionMin, rhs.regionMin + 3, this->regionMin);
+        std::copy(rhs.regionMax, rhs.regionMax + 3, this->regionMax);
+        this->requestedLevel = rhs.requestedLevel;
+        this->isBuildAllowed = rhs.isBuildAllowed;
     }
     return *this;
 }
@@ -332,5 +385,5 @@ VolumetricDataCall& VolumetricDataCall::operator=(const VolumetricDataCall& rhs)
  * VolumetricDataCall::FUNCTIONS
  */
 const char* VolumetricDataCall::FUNCTIONS[] = {
-    "GetExtents", "GetData", "GetMetadata", "StartAsync", "StopAsync", "TryGetData"};
+    "GetExtents", "GetData", "GetMetadata", "StartAsync", "StopAsync", "TryGetData", "GetBricks"};
 } // namespace megamol::geocalls
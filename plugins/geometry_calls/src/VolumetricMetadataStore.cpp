@@ -79,16 +79,15 @@ VolumetricMetadataStore& VolumetricMetadataStore::operator=(const VolumetricMeta
     if (this != std::addressof(rhs)) {
         ::memcpy(this, std::addressof(rhs), sizeof(VolumetricMetadata_t));
 
+        // sources that only deliver bricks may not know the range yet
         this->maxValues.clear();
-        this->maxValues.resize(this->Components);
-        for (std::size_t i = 0; i < this->maxValues.size(); ++i) {
-            this->maxValues[i] = rhs.MaxValues[i];
+        if (rhs.MaxValues != nullptr) {
+            this->maxValues.assign(rhs.MaxValues, rhs.MaxValues + this->Components);
         }
 
         this->minValues.clear();
-        this->minValues.resize(this->Components);
-        for (std::size_t i = 0; i < this->minValues.size(); ++i) {
-            this->minValues[i] = rhs.MinValues[i];
+        if (rhs.MinValues != nullptr) {
+            this->minValues.assign(rhs.MinValues, rhs.MinValues + this->Components);
         }
 
         switch (this->GridType) {
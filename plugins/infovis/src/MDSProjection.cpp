@@ -2,11 +2,14 @@
 
 #include "datatools/table/TableDataCall.h"
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/IntParam.h"
 
 #include "MDSProjection.h"
 #include <Eigen/Dense>
 #include <Eigen/SVD>
+#include <algorithm>
+#include <limits>
 #include <set>
 #include <sstream>
 
@@ -21,6 +24,9 @@ MDSProjection::MDSProjection(void)
         , dataOutSlot("dataOut", "Ouput")
         , dataInSlot("dataIn", "Input")
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
+        , methodSlot("method", "Classic MDS of all rows (quadratic memory) or landmark MDS, which embeds the landmarks "
+                               "and places the other rows relative to them")
+        , landmarkCountSlot("landmarks", "Number of landmark rows for landmark MDS")
         , datahash(0)
         , dataInHash(0)
         , columnInfos() {
@@ -36,6 +42,15 @@ MDSProjection::MDSProjection(void)
 
     reduceToNSlot << new ::megamol::core::param::IntParam(2);
     this->MakeSlotAvailable(&reduceToNSlot);
+
+    auto* methods = new ::megamol::core::param::EnumParam(0);
+    methods->SetTypePair(0, "Classic");
+    methods->SetTypePair(1, "Landmark");
+    methodSlot << methods;
+    this->MakeSlotAvailable(&methodSlot);
+
+    landmarkCountSlot << new ::megamol::core::param::IntParam(256, 2);
+    this->MakeSlotAvailable(&landmarkCountSlot);
 }
 
 MDSProjection::~MDSProjection(void) {
@@ -116,7 +131,7 @@ bool MDSProjection::getHashCallback(core::Call& c) {
 bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::TableDataCall* inCall) {
     // Test if inData has changed and if slots have changed
     if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty()) {
+        if (!reduceToNSlot.IsDirty() && !methodSlot.IsDirty() && !landmarkCountSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
@@ -133,18 +148,32 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::
         return false;
     }
 
-    // Load data in a Matrix
-    Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
-    for (int row = 0; row < rowsCount; row++) {
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat(row, col) = inData[row * columnCount + col];
+    Eigen::MatrixXd result;
+    if (this->methodSlot.Param<core::param::EnumParam>()->Value() == 1) {
+        size_t landmarkCount = std::min<size_t>(
+            this->landmarkCountSlot.Param<core::param::IntParam>()->Value(), static_cast<size_t>(rowsCount));
+        if (landmarkCount <= static_cast<size_t>(outputDimCount)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                _T("%hs: Landmark MDS needs more landmarks than dimensions\n"), ClassName());
+            return false;
+        }
+
+        auto landmarks = maxMinLandmarks(inData, rowsCount, columnCount, landmarkCount);
+        result = landmarkMds(inData, rowsCount, columnCount, landmarks, outputDimCount);
+    } else {
+        // Load data in a Matrix
+        Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
+        for (int row = 0; row < rowsCount; row++) {
+            for (int col = 0; col < columnCount; col++) {
+                inDataMat(row, col) = inData[row * columnCount + col];
+            }
         }
-    }
 
-    // generate dissimilarity Matrix( squared euclidean Distance matrix)
-    Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
-    // compute MDS
-    Eigen::MatrixXd result = classicMds(delta2, outputDimCount);
+        // generate dissimilarity Matrix( squared euclidean Distance matrix)
+        Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
+        // compute MDS
+        result = classicMds(delta2, outputDimCount);
+    }
 
     // generate new columns
     this->columnInfos.clear();
@@ -170,6 +199,8 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::datatools::table::
     this->dataInHash = inCall->DataHash();
     this->datahash++;
     reduceToNSlot.ResetDirty();
+    methodSlot.ResetDirty();
+    landmarkCountSlot.ResetDirty();
 
     return true;
 }
@@ -178,6 +209,7 @@ Eigen::MatrixXd megamol::infovis::MDSProjection::euclideanDissimilarityMatrix(Ei
     // generate euclidean Distance matrix
     int rowsCount = dataMatrix.rows();
     Eigen::MatrixXd distanceMatrix = Eigen::MatrixXd::Zero(rowsCount, rowsCount);
+#pragma omp parallel for schedule(dynamic, 16)
     for (int row = 1; row < rowsCount; row++) {
         for (int col = 0; col < row; col++) {
             double distance = (dataMatrix.row(row) - dataMatrix.row(col)).norm();
@@ -228,6 +260,122 @@ Eigen::MatrixXd megamol::infovis::MDSProjection::classicMds(
     return result;
 }
 
+std::vector<size_t> megamol::infovis::MDSProjection::maxMinLandmarks(
+    float const* data, size_t rowsCount, size_t columnCount, size_t landmarkCount) {
+    landmarkCount = std::min(landmarkCount, rowsCount);
+    std::vector<size_t> landmarks;
+    landmarks.reserve(landmarkCount);
+    if (landmarkCount == 0) {
+        return landmarks;
+    }
+
+    // squared distance of each row to the nearest landmark so far
+    std::vector<double> minDist(rowsCount, std::numeric_limits<double>::max());
+    landmarks.push_back(0);
+    while (landmarks.size() < landmarkCount) {
+        float const* landmark = data + landmarks.back() * columnCount;
+        double farthestDist = -1.0;
+        size_t farthest = 0;
+#pragma omp parallel
+        {
+            double localDist = -1.0;
+            size_t local = 0;
+#pragma omp for
+            for (int64_t row = 0; row < static_cast<int64_t>(rowsCount); row++) {
+                float const* values = data + row * columnCount;
+                double dist = 0.0;
+                for (size_t col = 0; col < columnCount; col++) {
+                    double const diff = values[col] - landmark[col];
+                    dist += diff * diff;
+                }
+                if (dist < minDist[row]) {
+                    minDist[row] = dist;
+                }
+                if (minDist[row] > localDist) {
+                    localDist = minDist[row];
+                    local = row;
+                }
+            }
+#pragma omp critical
+            {
+                if (localDist > farthestDist || (localDist == farthestDist && local < farthest)) {
+                    farthestDist = localDist;
+                    farthest = local;
+                }
+            }
+        }
+        if (farthestDist <= 0.0) {
+            // all remaining rows coincide with a landmark
+            break;
+        }
+        landmarks.push_back(farthest);
+    }
+
+    return landmarks;
+}
+
+Eigen::MatrixXd megamol::infovis::MDSProjection::landmarkMds(float const* data, size_t rowsCount, size_t columnCount,
+    std::vector<size_t> const& landmarks, int outputDimension) {
+    int const landmarkCount = static_cast<int>(landmarks.size());
+
+    // landmark values in one block, they are compared against every row
+    std::vector<float> landmarkData(landmarkCount * columnCount);
+    for (int l = 0; l < landmarkCount; l++) {
+        std::copy_n(data + landmarks[l] * columnCount, columnCount, landmarkData.begin() + l * columnCount);
+    }
+    auto squaredDistances = [&landmarkData, columnCount, landmarkCount](float const* values, Eigen::VectorXd& dist) {
+        for (int l = 0; l < landmarkCount; l++) {
+            float const* landmark = landmarkData.data() + l * columnCount;
+            double d = 0.0;
+            for (size_t col = 0; col < columnCount; col++) {
+                double const diff = values[col] - landmark[col];
+                d += diff * diff;
+            }
+            dist(l) = d;
+        }
+    };
+
+    // classic MDS of the landmarks
+    Eigen::MatrixXd delta2(landmarkCount, landmarkCount);
+    for (int l = 0; l < landmarkCount; l++) {
+        Eigen::VectorXd dist(landmarkCount);
+        squaredDistances(landmarkData.data() + l * columnCount, dist);
+        delta2.col(l) = dist;
+    }
+    Eigen::VectorXd meanDelta2 = delta2.rowwise().mean();
+    Eigen::MatrixXd J = Eigen::MatrixXd::Identity(landmarkCount, landmarkCount) -
+                        (1.0 / (double)landmarkCount) * Eigen::MatrixXd::Ones(landmarkCount, landmarkCount);
+    Eigen::MatrixXd B = -0.5 * J * delta2 * J;
+
+    // B is symmetric, eigenvalues are ascending
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(B);
+    VectorXd eigVal = eigSolver.eigenvalues();
+    MatrixXd eigVec = eigSolver.eigenvectors();
+
+    // pseudo-inverse transpose of the landmark coordinates, axes without variance are dropped
+    MatrixXd pseudoInv = MatrixXd::Zero(outputDimension, landmarkCount);
+    for (int i = 0; i < outputDimension; i++) {
+        int const idx = landmarkCount - 1 - i;
+        if (idx >= 0 && eigVal(idx) > 0.0) {
+            pseudoInv.row(i) = eigVec.col(idx).transpose() / std::sqrt(eigVal(idx));
+        }
+    }
+
+    // triangulate all rows from their distances to the landmarks
+    MatrixXd result(rowsCount, outputDimension);
+#pragma omp parallel
+    {
+        Eigen::VectorXd dist(landmarkCount);
+#pragma omp for
+        for (int64_t row = 0; row < static_cast<int64_t>(rowsCount); row++) {
+            squaredDistances(data + row * columnCount, dist);
+            result.row(row) = (-0.5 * pseudoInv * (dist - meanDelta2)).transpose();
+        }
+    }
+
+    return result;
+}
+
 Eigen::MatrixXd megamol::infovis::MDSProjection::bMatrix(
     Eigen::MatrixXd X, Eigen::MatrixXd W, Eigen::MatrixXd dissimilarityMatrix) {
     assert(X.rows() == W.rows());
@@ -8,6 +8,7 @@
 #include "mmcore/param/ParamSlot.h"
 #include <Eigen/Dense>
 #include <Eigen/SVD>
+#include <vector>
 
 
 namespace megamol {
@@ -43,6 +44,21 @@ public:
 
     static Eigen::MatrixXd classicMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension);
 
+    /**
+     * Selects landmark rows of a row-major table by max-min picking: starting with the first row, the next landmark is
+     * always the row farthest from all landmarks selected so far.
+     */
+    static std::vector<size_t> maxMinLandmarks(
+        float const* data, size_t rowsCount, size_t columnCount, size_t landmarkCount);
+
+    /**
+     * Landmark MDS (de Silva and Tenenbaum): classic MDS of the landmarks only, all other rows are placed by
+     * triangulation from their squared distances to the landmarks. Needs O(rows * landmarks) time and
+     * O(landmarks^2) memory.
+     */
+    static Eigen::MatrixXd landmarkMds(float const* data, size_t rowsCount, size_t columnCount,
+        std::vector<size_t> const& landmarks, int outputDimension);
+
     static Eigen::MatrixXd smacofMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension = 2,
         int countSteps = 100, Eigen::MatrixXd weightsMatrix = Eigen::MatrixXd::Ones(1, 1), double tolerance = 1e-3);
 
@@ -80,6 +96,12 @@ private:
     /** Parameter slot for target number of dimensions */
     ::megamol::core::param::ParamSlot reduceToNSlot;
 
+    /** Parameter slot for classic or landmark MDS */
+    ::megamol::core::param::ParamSlot methodSlot;
+
+    /** Parameter slot for the number of landmarks */
+    ::megamol::core::param::ParamSlot landmarkCountSlot;
+
     /** ID of the current frame */
     // int frameID; //TODO: unknown
 
@@ -2,11 +2,13 @@
 
 #include "datatools/table/TableDataCall.h"
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/IntParam.h"
 
 #include <Eigen/Dense>
 #include <Eigen/SVD>
-#include <sstream>
+#include <algorithm>
+#include <random>
 
 
 using namespace megamol;
@@ -21,9 +23,12 @@ PCAProjection::PCAProjection(void)
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
         , scaleSlot("scale", "Set to scale each column to unit variance")
         , centerSlot("center", "Set to shift the mean centroid to the origin")
+        , solverSlot("solver", "Full eigen decomposition of the covariance matrix or randomized computation of the "
+                               "requested components only")
         , datahash(0)
         , dataInHash(0)
-        , columnInfos() {
+        , columnInfos()
+        , basisInHash(0) {
 
     this->dataInSlot.SetCompatibleCall<megamol::datatools::table::TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
@@ -42,6 +47,12 @@ PCAProjection::PCAProjection(void)
 
     scaleSlot << new ::megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&scaleSlot);
+
+    auto* solvers = new ::megamol::core::param::EnumParam(0);
+    solvers->SetTypePair(0, "Full");
+    solvers->SetTypePair(1, "Randomized");
+    solverSlot << solvers;
+    this->MakeSlotAvailable(&solverSlot);
 }
 
 
@@ -53,7 +64,12 @@ bool PCAProjection::create(void) {
     return true;
 }
 
-void PCAProjection::release(void) {}
+void PCAProjection::release(void) {
+    this->basisInHash = 0;
+    this->basisMean.resize(0);
+    this->basisScale.resize(0);
+    this->basis.resize(0, 0);
+}
 
 bool PCAProjection::getDataCallback(core::Call& c) {
 
@@ -125,7 +141,7 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
 
     // check if inData has changed and if Slots have changed
     if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty()) {
+        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty() && !solverSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
@@ -137,8 +153,6 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
     auto inData = inCall->GetData();
 
     unsigned int outputDimCount = this->reduceToNSlot.Param<core::param::IntParam>()->Value();
-    bool center = this->centerSlot.Param<core::param::BoolParam>()->Value();
-    bool scale = this->scaleSlot.Param<core::param::BoolParam>()->Value();
 
 
     if (outputDimCount <= 0 || outputDimCount > columnCount) {
@@ -147,92 +161,34 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
         return false;
     }
 
-    // Load data in a Matrix
-    Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
-    for (int row = 0; row < rowsCount; row++) {
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat(row, col) = inData[row * columnCount + col];
-        }
+    // the decomposition only depends on the input and on the preparation of the data, so a change of the number of
+    // components reuses it if it holds enough of them
+    if (scaleSlot.IsDirty() || centerSlot.IsDirty() || solverSlot.IsDirty()) {
+        this->basisInHash = 0;
     }
-
-    // calculate mean for each column
-    Eigen::VectorXd mean_vector(columnCount);
-    mean_vector = inDataMat.colwise().mean();
-
-
-    // prepare data
-    if (center) {
-        // substract mean columnwise
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
+    if (this->basisInHash == 0 || this->basisInHash != inCall->DataHash() ||
+        this->basis.cols() < static_cast<Index>(outputDimCount)) {
+        if (!computeBasis(inCall, outputDimCount)) {
+            return false;
         }
     }
 
-
-    if (scale) {
-        // scale data to unit variance by dividing by standard deviation
-        Eigen::VectorXd stdDev(columnCount);
-        for (int col = 0; col < columnCount; col++) {
-            stdDev(col) = sqrt(inDataMat.col(col).cwiseProduct(inDataMat.col(col)).sum() / (rowsCount - 1));
-            inDataMat.col(col) /= stdDev(col);
+    // calculate PCA
+    MatrixXd eigVecBasis = this->basis.leftCols(outputDimCount);
+    MatrixXd result(rowsCount, outputDimCount);
+#pragma omp parallel
+    {
+        VectorXd row(columnCount);
+#pragma omp for
+        for (int64_t r = 0; r < static_cast<int64_t>(rowsCount); r++) {
+            for (size_t col = 0; col < columnCount; col++) {
+                row(col) = (inData[r * columnCount + col] - this->basisMean(col)) * this->basisScale(col);
+            }
+            result.row(r) = row.transpose() * eigVecBasis;
         }
     }
 
 
-    // calculate CovarianceMatrix
-    MatrixXd covarianceMatrix = inDataMat;
-
-    /** if center is off: "R ggfortify" doesn't substract mean for the covariance matrix
-    //substract mean for cov Matrix
-    mean_vector = inDataMat.colwise().mean();
-    for (int col = 0; col < columnCount; col++) {
-        covarianceMatrix.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
-    }*/
-
-
-    covarianceMatrix = covarianceMatrix.transpose() * covarianceMatrix;
-    covarianceMatrix = covarianceMatrix / (float)(rowsCount - 1);
-
-
-    // calculate Eigenvalues and Eigenvectors
-    EigenSolver<MatrixXd> eigSolver(covarianceMatrix);
-
-    VectorXd eigVal = eigSolver.eigenvalues().real();
-    MatrixXd eigVec = eigSolver.eigenvectors().real();
-
-    // sort eigenvalues (with index): descending
-    // each eigenvalue represents the variance
-    typedef std::pair<float, int> eigenPair;
-    std::vector<eigenPair> sorted;
-    for (unsigned int i = 0; i < columnCount; ++i) {
-        sorted.push_back(std::make_pair(eigVal(i), i));
-    }
-    std::sort(sorted.begin(), sorted.end(), [&sorted](eigenPair& a, eigenPair& b) { return a.first > b.first; });
-
-    // create Matrix out of sorted (and selected) eigenvectors
-    MatrixXd eigVecBasis = MatrixXd(columnCount, outputDimCount);
-    for (unsigned int i = 0; i < outputDimCount; ++i) {
-        eigVecBasis.col(i) = eigVec.col(sorted[i].second);
-    }
-
-
-    // calculate PCA
-    MatrixXd result = inDataMat * eigVecBasis;
-
-
-    //// center
-    // mean_vector = result.colwise().mean();
-    //// substract mean adjusted Matrix (shift to mean to zero)
-    // for (int col = 0; col < result.cols(); col++) {
-    //    result.col(col) -= Eigen::VectorXd::Constant(rowsCount, mean_vector(col));
-    //}
-
-
-    std::stringstream debug;
-    debug << std::endl << result << std::endl;
-
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo(debug.str().c_str());
-
     // generate new columns
     this->columnInfos.clear();
     this->columnInfos.resize(outputDimCount);
@@ -246,12 +202,11 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
     }
 
     // Result Matrix into Output
-    this->data.clear();
-    this->data.reserve(rowsCount * outputDimCount);
-
-    for (size_t row = 0; row < rowsCount; row++) {
+    this->data.resize(rowsCount * outputDimCount);
+#pragma omp parallel for
+    for (int64_t row = 0; row < static_cast<int64_t>(rowsCount); row++) {
         for (size_t col = 0; col < outputDimCount; col++)
-            this->data.push_back(result(row, col));
+            this->data[row * outputDimCount + col] = result(row, col);
     }
 
 
@@ -260,6 +215,125 @@ bool megamol::infovis::PCAProjection::project(megamol::datatools::table::TableDa
     reduceToNSlot.ResetDirty();
     scaleSlot.ResetDirty();
     centerSlot.ResetDirty();
+    solverSlot.ResetDirty();
 
     return true;
 }
+
+bool megamol::infovis::PCAProjection::computeBasis(
+    megamol::datatools::table::TableDataCall* inCall, unsigned int componentCount) {
+    static const int64_t chunkRows = 256;
+
+    auto columnCount = inCall->GetColumnsCount();
+    auto rowsCount = inCall->GetRowsCount();
+    auto inData = inCall->GetData();
+
+    bool center = this->centerSlot.Param<core::param::BoolParam>()->Value();
+    bool scale = this->scaleSlot.Param<core::param::BoolParam>()->Value();
+    bool randomized = this->solverSlot.Param<core::param::EnumParam>()->Value() == 1;
+
+    if (rowsCount < 2) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("%hs: At least two rows are needed\n"), ClassName());
+        return false;
+    }
+    int64_t const chunkCount = (static_cast<int64_t>(rowsCount) + chunkRows - 1) / chunkRows;
+
+    // calculate mean for each column
+    VectorXd mean = VectorXd::Zero(columnCount);
+    if (center) {
+#pragma omp parallel
+        {
+            VectorXd localSum = VectorXd::Zero(columnCount);
+#pragma omp for
+            for (int64_t row = 0; row < static_cast<int64_t>(rowsCount); row++) {
+                localSum += Map<const VectorXf>(inData + row * columnCount, columnCount).cast<double>();
+            }
+#pragma omp critical
+            mean += localSum;
+        }
+        mean /= static_cast<double>(rowsCount);
+    }
+
+    // calculate CovarianceMatrix of the centered data
+    // if center is off: "R ggfortify" doesn't substract mean for the covariance matrix
+    MatrixXd covarianceMatrix = MatrixXd::Zero(columnCount, columnCount);
+#pragma omp parallel
+    {
+        MatrixXd chunk(chunkRows, columnCount);
+        MatrixXd localCov = MatrixXd::Zero(columnCount, columnCount);
+#pragma omp for schedule(dynamic)
+        for (int64_t c = 0; c < chunkCount; c++) {
+            int64_t const begin = c * chunkRows;
+            int64_t const count = std::min(chunkRows, static_cast<int64_t>(rowsCount) - begin);
+            for (int64_t row = 0; row < count; row++) {
+                chunk.row(row) =
+                    Map<const RowVectorXf>(inData + (begin + row) * columnCount, columnCount).cast<double>() -
+                    mean.transpose();
+            }
+            localCov.selfadjointView<Lower>().rankUpdate(chunk.topRows(count).transpose());
+        }
+#pragma omp critical
+        covarianceMatrix += localCov;
+    }
+    covarianceMatrix = covarianceMatrix.selfadjointView<Lower>();
+    covarianceMatrix /= static_cast<double>(rowsCount - 1);
+
+    // scale data to unit variance by dividing by standard deviation
+    VectorXd scaleFactors = VectorXd::Ones(columnCount);
+    if (scale) {
+        scaleFactors = covarianceMatrix.diagonal().cwiseSqrt().cwiseInverse();
+        covarianceMatrix = scaleFactors.asDiagonal() * covarianceMatrix * scaleFactors.asDiagonal();
+    }
+
+    // calculate Eigenvectors, each eigenvalue represents the variance
+    if (randomized && componentCount < columnCount) {
+        this->basis = randomizedEigenvectors(covarianceMatrix, componentCount);
+    } else {
+        // eigenvalues are ascending
+        SelfAdjointEigenSolver<MatrixXd> eigSolver(covarianceMatrix);
+        this->basis = eigSolver.eigenvectors().rowwise().reverse();
+    }
+
+    this->basisMean = mean;
+    this->basisScale = scaleFactors;
+    this->basisInHash = inCall->DataHash();
+
+    return true;
+}
+
+Eigen::MatrixXd megamol::infovis::PCAProjection::randomizedEigenvectors(
+    Eigen::MatrixXd const& symMatrix, unsigned int componentCount) {
+    static const int oversampling = 10;
+    static const int powerIterations = 2;
+
+    auto const n = symMatrix.rows();
+    auto const sampleCount = std::min<Index>(componentCount + oversampling, n);
+
+    // fixed seed, so the result is reproducible
+    std::mt19937 rng(42);
+    std::normal_distribution<double> normal;
+    MatrixXd omega(n, sampleCount);
+    for (Index col = 0; col < sampleCount; col++) {
+        for (Index row = 0; row < n; row++) {
+            omega(row, col) = normal(rng);
+        }
+    }
+
+    // orthonormal basis of the range, refined by power iterations
+    auto orthonormalize = [n, sampleCount](MatrixXd const& y) -> MatrixXd {
+        HouseholderQR<MatrixXd> qr(y);
+        return qr.householderQ() * MatrixXd::Identity(n, sampleCount);
+    };
+    MatrixXd q = orthonormalize(symMatrix * omega);
+    for (int i = 0; i < powerIterations; i++) {
+        q = orthonormalize(symMatrix * q);
+    }
+
+    // Rayleigh-Ritz on the small projected matrix, eigenvalues are ascending
+    MatrixXd projected = q.transpose() * symMatrix * q;
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(projected);
+    MatrixXd ritz = q * eigSolver.eigenvectors().rowwise().reverse();
+
+    return ritz.leftCols(componentCount);
+}
@@ -6,6 +6,8 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
+#include <Eigen/Dense>
+#include <vector>
 
 
 namespace megamol {
@@ -51,6 +53,18 @@ private:
 
     bool project(megamol::datatools::table::TableDataCall* inCall);
 
+    /**
+     * Computes mean, scale and principal axes of the input into the cache. The covariance matrix is accumulated from
+     * chunks of rows in parallel, the table is never copied.
+     */
+    bool computeBasis(megamol::datatools::table::TableDataCall* inCall, unsigned int componentCount);
+
+    /**
+     * Top 'componentCount' eigenvectors of a symmetric matrix by randomized subspace iteration (Halko et al.),
+     * which is cheaper than a full decomposition if only few components are requested.
+     */
+    static Eigen::MatrixXd randomizedEigenvectors(Eigen::MatrixXd const& symMatrix, unsigned int componentCount);
+
     /** Data output slot */
     CalleeSlot dataOutSlot;
 
@@ -61,6 +75,7 @@ private:
     ::megamol::core::param::ParamSlot reduceToNSlot;
     ::megamol::core::param::ParamSlot scaleSlot;
     ::megamol::core::param::ParamSlot centerSlot;
+    ::megamol::core::param::ParamSlot solverSlot;
 
     /** ID of the current frame */
     // int frameID; //TODO: unknown
@@ -74,6 +89,18 @@ private:
 
     /** Vector stroing the actual float data */
     std::vector<float> data;
+
+    /** Decomposition of the input with hash 'basisInHash', valid for 'basisInHash' != 0 */
+    size_t basisInHash;
+
+    /** Mean subtracted from each column, zero if centering is off */
+    Eigen::VectorXd basisMean;
+
+    /** Factor applied to each column after centering */
+    Eigen::VectorXd basisScale;
+
+    /** Principal axes as columns, ordered by descending variance */
+    Eigen::MatrixXd basis;
 };
 
 } // namespace infovis
@@ -0,0 +1,655 @@
+/**
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#include "TSNEOptimizer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include <nanoflann.hpp>
+
+
+using namespace megamol;
+using namespace megamol::infovis;
+
+
+namespace {
+
+const double learningRate = 200.0;
+const double earlyExaggeration = 12.0;
+const double initialMomentum = 0.5;
+const double finalMomentum = 0.8;
+
+/** nanoflann adaptor for a row-major float table */
+struct TableAdaptor {
+    float const* data;
+    size_t rowsCount;
+    size_t columnCount;
+
+    inline size_t kdtree_get_point_count() const {
+        return rowsCount;
+    }
+
+    inline float kdtree_get_pt(const size_t idx, const size_t dim) const {
+        return data[idx * columnCount + dim];
+    }
+
+    template<class BBOX>
+    bool kdtree_get_bbox(BBOX& bb) const {
+        return false;
+    }
+};
+
+typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Adaptor<float, TableAdaptor, float>, TableAdaptor, -1,
+    size_t>
+    TableTree;
+
+/**
+ * Space-partitioning tree over the embedding with 2^dims children per node, the center of mass of each node
+ * approximates its points in the Barnes-Hut repulsion.
+ */
+class SpaceTree {
+public:
+    SpaceTree(double const* points, size_t count, int dims) : points(points), dims(dims) {
+        std::vector<double> minPos(dims, std::numeric_limits<double>::max());
+        std::vector<double> maxPos(dims, std::numeric_limits<double>::lowest());
+        for (size_t i = 0; i < count; i++) {
+            for (int d = 0; d < dims; d++) {
+                minPos[d] = std::min(minPos[d], points[i * dims + d]);
+                maxPos[d] = std::max(maxPos[d], points[i * dims + d]);
+            }
+        }
+        this->addNode();
+        for (int d = 0; d < dims; d++) {
+            this->centers[d] = 0.5 * (minPos[d] + maxPos[d]);
+            this->halfWidths[d] = 0.5 * (maxPos[d] - minPos[d]) + 1e-5;
+        }
+        for (size_t i = 0; i < count; i++) {
+            this->insert(static_cast<uint32_t>(i));
+        }
+    }
+
+    /**
+     * Accumulates sum_j q_ij^2 (y_i - y_j) of point 'i' into 'force'.
+     *
+     * @return sum_{j != i} q_ij.
+     */
+    double repulsion(uint32_t i, double theta, double* force, std::vector<uint32_t>& stack) const {
+        double const* pos = this->points + static_cast<size_t>(i) * dims;
+        double sumQ = 0.0;
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            auto const node = stack.back();
+            stack.pop_back();
+            auto const count = this->counts[node];
+            if (count == 0) {
+                continue;
+            }
+            double dist2 = 0.0;
+            double maxWidth = 0.0;
+            for (int d = 0; d < dims; d++) {
+                double const diff = pos[d] - this->masses[node * dims + d] / count;
+                dist2 += diff * diff;
+                maxWidth = std::max(maxWidth, 2.0 * this->halfWidths[node * dims + d]);
+            }
+            bool const leaf = this->firstChild[node] == noChild;
+            double const* leafPos = this->points + static_cast<size_t>(this->leafPoint[node]) * dims;
+            if (leaf && std::equal(pos, pos + dims, leafPos)) {
+                // the leaf holding 'i' and its duplicates
+                sumQ += count - 1;
+            } else if (leaf || maxWidth * maxWidth < theta * theta * dist2) {
+                double const q = 1.0 / (1.0 + dist2);
+                double const mult = count * q;
+                sumQ += mult;
+                for (int d = 0; d < dims; d++) {
+                    force[d] += mult * q * (pos[d] - this->masses[node * dims + d] / count);
+                }
+            } else {
+                auto const first = this->firstChild[node];
+                for (uint32_t c = 0; c < this->childCount(); c++) {
+                    stack.push_back(first + c);
+                }
+            }
+        }
+        return sumQ;
+    }
+
+private:
+    static const uint32_t noChild = std::numeric_limits<uint32_t>::max();
+
+    uint32_t childCount() const {
+        return 1u << dims;
+    }
+
+    uint32_t addNode() {
+        auto const node = static_cast<uint32_t>(this->counts.size());
+        this->counts.push_back(0);
+        this->firstChild.push_back(noChild);
+        this->leafPoint.push_back(0);
+        this->centers.resize(this->centers.size() + dims);
+        this->halfWidths.resize(this->halfWidths.size() + dims);
+        this->masses.resize(this->masses.size() + dims, 0.0);
+        return node;
+    }
+
+    uint32_t childFor(uint32_t node, double const* pos) const {
+        uint32_t child = 0;
+        for (int d = 0; d < dims; d++) {
+            if (pos[d] > this->centers[node * dims + d]) {
+                child |= 1u << d;
+            }
+        }
+        return this->firstChild[node] + child;
+    }
+
+    void subdivide(uint32_t node) {
+        auto const first = static_cast<uint32_t>(this->counts.size());
+        for (uint32_t c = 0; c < this->childCount(); c++) {
+            auto const child = this->addNode();
+            for (int d = 0; d < dims; d++) {
+                auto const hw = 0.5 * this->halfWidths[node * dims + d];
+                this->halfWidths[child * dims + d] = hw;
+                this->centers[child * dims + d] = this->centers[node * dims + d] + ((c >> d) & 1u ? hw : -hw);
+            }
+        }
+        this->firstChild[node] = first;
+    }
+
+    void insert(uint32_t i) {
+        double const* pos = this->points + static_cast<size_t>(i) * dims;
+        uint32_t node = 0;
+        for (int depth = 0;; depth++) {
+            this->counts[node]++;
+            for (int d = 0; d < dims; d++) {
+                this->masses[node * dims + d] += pos[d];
+            }
+            if (this->firstChild[node] != noChild) {
+                node = this->childFor(node, pos);
+                continue;
+            }
+            if (this->counts[node] == 1) {
+                this->leafPoint[node] = i;
+                return;
+            }
+            // duplicates share their leaf, the depth limit catches points closer than the precision of the widths
+            double const* other = this->points + static_cast<size_t>(this->leafPoint[node]) * dims;
+            if (std::equal(pos, pos + dims, other) || depth >= maxDepth) {
+                return;
+            }
+            // move the points already in the leaf, which all share one position, down one level
+            auto const previous = this->counts[node] - 1;
+            this->subdivide(node);
+            auto const child = this->childFor(node, other);
+            this->counts[child] = previous;
+            this->leafPoint[child] = this->leafPoint[node];
+            for (int d = 0; d < dims; d++) {
+                this->masses[child * dims + d] = previous * other[d];
+            }
+            node = this->childFor(node, pos);
+        }
+    }
+
+    static const int maxDepth = 64;
+
+    double const* points;
+    int dims;
+
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> firstChild;
+    std::vector<uint32_t> leafPoint;
+    std::vector<double> centers;
+    std::vector<double> halfWidths;
+    /** sum of the positions of the points in each node */
+    std::vector<double> masses;
+};
+
+/** In-place radix-2 FFT of 'n' values, 'n' has to be a power of two */
+void fft(std::complex<double>* data, size_t n, bool inverse) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    double const pi = 3.14159265358979323846;
+    for (size_t len = 2; len <= n; len <<= 1) {
+        double const angle = 2.0 * pi / len * (inverse ? 1.0 : -1.0);
+        std::complex<double> const wlen(std::cos(angle), std::sin(angle));
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> w(1.0);
+            for (size_t k = 0; k < len / 2; k++) {
+                auto const u = data[i + k];
+                auto const v = data[i + k + len / 2] * w;
+                data[i + k] = u + v;
+                data[i + k + len / 2] = u - v;
+                w *= wlen;
+            }
+        }
+    }
+}
+
+/**
+ * Unnormalized 2D FFT of a row-major n x n grid. Only the first 'usedRows' rows are transformed along the rows: for
+ * the forward transform the other rows have to be zero, for the inverse transform they are not needed.
+ */
+void fft2(std::vector<std::complex<double>>& grid, size_t n, bool inverse, size_t usedRows) {
+#pragma omp parallel
+    {
+        std::vector<std::complex<double>> column(n);
+        for (int pass = 0; pass < 2; pass++) {
+            if ((pass == 0) != inverse) {
+#pragma omp for
+                for (int64_t row = 0; row < static_cast<int64_t>(usedRows); row++) {
+                    fft(grid.data() + row * n, n, inverse);
+                }
+            } else {
+#pragma omp for
+                for (int64_t col = 0; col < static_cast<int64_t>(n); col++) {
+                    for (size_t row = 0; row < n; row++) {
+                        column[row] = grid[row * n + col];
+                    }
+                    fft(column.data(), n, inverse);
+                    for (size_t row = 0; row < n; row++) {
+                        grid[row * n + col] = column[row];
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+TSNEOptimizer::TSNEOptimizer(
+    float const* data, size_t rowsCount, size_t columnCount, int outputDimension, double perplexity)
+        : rows(rowsCount)
+        , dims(outputDimension)
+        , iter(0)
+        , exaggerationEnd(0) {
+    if (rowsCount < 2 || outputDimension < 1) {
+        throw std::invalid_argument("t-SNE needs at least two rows and one output dimension");
+    }
+    this->computeAffinities(data, columnCount, perplexity);
+}
+
+
+void TSNEOptimizer::computeAffinities(float const* data, size_t columnCount, double perplexity) {
+    size_t const k = std::min(this->rows - 1, static_cast<size_t>(std::max(3.0 * perplexity, 1.0)));
+
+    TableAdaptor adaptor{data, this->rows, columnCount};
+    TableTree tree(static_cast<int>(columnCount), adaptor, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+    tree.buildIndex();
+
+    // conditional probabilities of the k nearest neighbors, with a Gaussian fitted to the perplexity
+    std::vector<uint32_t> neighbors(this->rows * k);
+    std::vector<double> conditional(this->rows * k);
+#pragma omp parallel
+    {
+        std::vector<size_t> indices(k + 1);
+        std::vector<float> dists(k + 1);
+        std::vector<double> p(k);
+#pragma omp for schedule(dynamic, 64)
+        for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+            nanoflann::KNNResultSet<float> resultSet(k + 1);
+            resultSet.init(indices.data(), dists.data());
+            tree.findNeighbors(resultSet, data + i * columnCount, nanoflann::SearchParams(10));
+
+            // skip the row itself, which is not necessarily the first one if there are duplicates
+            size_t found = 0;
+            for (size_t n = 0; n <= k && found < k; n++) {
+                if (indices[n] == static_cast<size_t>(i)) {
+                    continue;
+                }
+                neighbors[i * k + found] = static_cast<uint32_t>(indices[n]);
+                dists[found] = dists[n];
+                found++;
+            }
+
+            double beta = 1.0;
+            double minBeta = -std::numeric_limits<double>::max();
+            double maxBeta = std::numeric_limits<double>::max();
+            double const targetEntropy = std::log(perplexity);
+            double sumP = 0.0;
+            for (int bs = 0; bs < 200; bs++) {
+                sumP = std::numeric_limits<double>::min();
+                double weightedDist = 0.0;
+                for (size_t n = 0; n < k; n++) {
+                    p[n] = std::exp(-beta * dists[n]);
+                    sumP += p[n];
+                    weightedDist += beta * dists[n] * p[n];
+                }
+                double const entropy = std::log(sumP) + weightedDist / sumP;
+                double const diff = entropy - targetEntropy;
+                if (std::abs(diff) < 1e-5) {
+                    break;
+                }
+                if (diff > 0.0) {
+                    minBeta = beta;
+                    beta = maxBeta == std::numeric_limits<double>::max() ? beta * 2.0 : 0.5 * (beta + maxBeta);
+                } else {
+                    maxBeta = beta;
+                    beta = minBeta == -std::numeric_limits<double>::max() ? beta * 0.5 : 0.5 * (beta + minBeta);
+                }
+            }
+            for (size_t n = 0; n < k; n++) {
+                conditional[i * k + n] = p[n] / sumP;
+            }
+        }
+    }
+
+    // symmetrize: every entry (i, j) also contributes to (j, i)
+    std::vector<size_t> offsets(this->rows + 1, 0);
+    for (size_t i = 0; i < this->rows; i++) {
+        offsets[i + 1] += k;
+        for (size_t n = 0; n < k; n++) {
+            offsets[neighbors[i * k + n] + 1]++;
+        }
+    }
+    for (size_t i = 0; i < this->rows; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<std::pair<uint32_t, double>> entries(offsets.back());
+    std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < this->rows; i++) {
+        for (size_t n = 0; n < k; n++) {
+            auto const j = neighbors[i * k + n];
+            auto const value = conditional[i * k + n];
+            entries[fill[i]++] = std::make_pair(j, value);
+            entries[fill[j]++] = std::make_pair(static_cast<uint32_t>(i), value);
+        }
+    }
+
+    // merge the entries of each row by column
+    std::vector<size_t> rowSizes(this->rows);
+    double sum = 0.0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : sum)
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        auto const begin = entries.begin() + offsets[i];
+        auto const end = entries.begin() + offsets[i + 1];
+        std::sort(begin, end, [](auto const& a, auto const& b) { return a.first < b.first; });
+        auto out = begin;
+        for (auto it = begin; it != end; ++it) {
+            if (out != begin && (out - 1)->first == it->first) {
+                (out - 1)->second += it->second;
+            } else {
+                *out++ = *it;
+            }
+            sum += it->second;
+        }
+        rowSizes[i] = out - begin;
+    }
+
+    this->rowP.assign(this->rows + 1, 0);
+    for (size_t i = 0; i < this->rows; i++) {
+        this->rowP[i + 1] = this->rowP[i] + rowSizes[i];
+    }
+    this->colP.resize(this->rowP.back());
+    this->valP.resize(this->rowP.back());
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        for (size_t n = 0; n < rowSizes[i]; n++) {
+            auto const& entry = entries[offsets[i] + n];
+            this->colP[this->rowP[i] + n] = entry.first;
+            this->valP[this->rowP[i] + n] = entry.second / sum;
+        }
+    }
+}
+
+
+void TSNEOptimizer::initialize(int randomSeed, std::vector<double> const* warmStart) {
+    auto const count = this->rows * this->dims;
+    this->update.assign(count, 0.0);
+    this->gains.assign(count, 1.0);
+    this->iter = 0;
+
+    if (warmStart != nullptr && warmStart->size() == count) {
+        this->y = *warmStart;
+        this->exaggerationEnd = 0;
+    } else {
+        std::mt19937 rng(randomSeed >= 0 ? static_cast<unsigned int>(randomSeed)
+                                         : static_cast<unsigned int>(
+                                               std::chrono::system_clock::now().time_since_epoch().count()));
+        std::normal_distribution<double> normal(0.0, 1e-4);
+        this->y.resize(count);
+        for (auto& v : this->y) {
+            v = normal(rng);
+        }
+        this->exaggerationEnd = exaggerationIterations;
+    }
+}
+
+
+void TSNEOptimizer::step(Gradient gradient, double theta) {
+    auto const count = this->rows * this->dims;
+    bool const exaggerated = this->iter < this->exaggerationEnd;
+
+    std::vector<double> repulsive(count, 0.0);
+    double sumQ = 0.0;
+    if (gradient == Gradient::Interpolated && this->dims == 2) {
+        sumQ = this->interpolatedRepulsion(repulsive);
+    } else if (theta > 0.0) {
+        sumQ = this->barnesHutRepulsion(theta, repulsive);
+    } else {
+        sumQ = this->exactRepulsion(repulsive);
+    }
+
+    std::vector<double> grad(count, 0.0);
+    this->attractiveForces(exaggerated ? earlyExaggeration : 1.0, grad);
+
+    double const momentum = exaggerated ? initialMomentum : finalMomentum;
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(count); i++) {
+        double const g = grad[i] - repulsive[i] / sumQ;
+        this->gains[i] = (g > 0.0) != (this->update[i] > 0.0) ? this->gains[i] + 0.2 : this->gains[i] * 0.8;
+        this->gains[i] = std::max(this->gains[i], 0.01);
+        this->update[i] = momentum * this->update[i] - learningRate * this->gains[i] * g;
+        this->y[i] += this->update[i];
+    }
+
+    // keep the embedding centered
+    std::vector<double> mean(this->dims, 0.0);
+    for (size_t i = 0; i < this->rows; i++) {
+        for (int d = 0; d < this->dims; d++) {
+            mean[d] += this->y[i * this->dims + d];
+        }
+    }
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        for (int d = 0; d < this->dims; d++) {
+            this->y[i * this->dims + d] -= mean[d] / this->rows;
+        }
+    }
+
+    this->iter++;
+}
+
+
+void TSNEOptimizer::attractiveForces(double exaggeration, std::vector<double>& forces) const {
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        double const* yi = this->y.data() + i * this->dims;
+        double* fi = forces.data() + i * this->dims;
+        for (size_t n = this->rowP[i]; n < this->rowP[i + 1]; n++) {
+            double const* yj = this->y.data() + static_cast<size_t>(this->colP[n]) * this->dims;
+            double dist2 = 0.0;
+            for (int d = 0; d < this->dims; d++) {
+                double const diff = yi[d] - yj[d];
+                dist2 += diff * diff;
+            }
+            double const mult = exaggeration * this->valP[n] / (1.0 + dist2);
+            for (int d = 0; d < this->dims; d++) {
+                fi[d] += mult * (yi[d] - yj[d]);
+            }
+        }
+    }
+}
+
+
+double TSNEOptimizer::exactRepulsion(std::vector<double>& forces) const {
+    double sumQ = 0.0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : sumQ)
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        double const* yi = this->y.data() + i * this->dims;
+        double* fi = forces.data() + i * this->dims;
+        for (size_t j = 0; j < this->rows; j++) {
+            if (j == static_cast<size_t>(i)) {
+                continue;
+            }
+            double const* yj = this->y.data() + j * this->dims;
+            double dist2 = 0.0;
+            for (int d = 0; d < this->dims; d++) {
+                double const diff = yi[d] - yj[d];
+                dist2 += diff * diff;
+            }
+            double const q = 1.0 / (1.0 + dist2);
+            sumQ += q;
+            for (int d = 0; d < this->dims; d++) {
+                fi[d] += q * q * (yi[d] - yj[d]);
+            }
+        }
+    }
+    return sumQ;
+}
+
+
+double TSNEOptimizer::barnesHutRepulsion(double theta, std::vector<double>& forces) const {
+    SpaceTree tree(this->y.data(), this->rows, this->dims);
+
+    double sumQ = 0.0;
+#pragma omp parallel reduction(+ : sumQ)
+    {
+        std::vector<uint32_t> stack;
+#pragma omp for schedule(dynamic, 256)
+        for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+            sumQ += tree.repulsion(static_cast<uint32_t>(i), theta, forces.data() + i * this->dims, stack);
+        }
+    }
+    return sumQ;
+}
+
+
+double TSNEOptimizer::interpolatedRepulsion(std::vector<double>& forces) const {
+    // equispaced interpolation nodes in boxes of at most unit width, as in FIt-SNE
+    static const int nodesPerBox = 3;
+    static const int minBoxes = 50;
+    static const size_t maxFftSize = 1024;
+    static const int channels = 4;
+
+    double minPos = std::numeric_limits<double>::max();
+    double maxPos = std::numeric_limits<double>::lowest();
+    for (auto const v : this->y) {
+        minPos = std::min(minPos, v);
+        maxPos = std::max(maxPos, v);
+    }
+    // the convolution of n nodes needs 2n - 1 values without wrap-around, so the boxes fill the next power of two
+    auto const minNodes =
+        static_cast<size_t>(std::max(minBoxes, static_cast<int>(std::ceil(maxPos - minPos))) * nodesPerBox);
+    size_t fftSize = 2;
+    while (fftSize < maxFftSize && fftSize + 1 < 2 * minNodes) {
+        fftSize <<= 1;
+    }
+    auto const boxes = static_cast<int>((fftSize + 1) / 2 / nodesPerBox);
+    double const boxWidth = std::max(maxPos - minPos, 1e-5) / boxes;
+    double const spacing = boxWidth / nodesPerBox;
+    size_t const nodes = static_cast<size_t>(boxes) * nodesPerBox;
+
+    // Lagrange weights of the nodes of the box of each point
+    std::vector<double> weights(this->rows * 2 * nodesPerBox);
+    std::vector<uint32_t> firstNode(this->rows * 2);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        for (int d = 0; d < 2; d++) {
+            double const rel = (this->y[i * 2 + d] - minPos) / boxWidth;
+            auto const box = std::min(static_cast<int>(rel), boxes - 1);
+            double const t = (rel - box) * nodesPerBox - 0.5;
+            firstNode[i * 2 + d] = box * nodesPerBox;
+            for (int j = 0; j < nodesPerBox; j++) {
+                double w = 1.0;
+                for (int l = 0; l < nodesPerBox; l++) {
+                    if (l != j) {
+                        w *= (t - l) / (j - l);
+                    }
+                }
+                weights[(i * 2 + d) * nodesPerBox + j] = w;
+            }
+        }
+    }
+
+    // spread the charges 1, y and |y|^2 onto the nodes, two real channels share one complex grid
+    std::vector<std::vector<std::complex<double>>> grids(
+        channels / 2, std::vector<std::complex<double>>(fftSize * fftSize, 0.0));
+    for (size_t i = 0; i < this->rows; i++) {
+        double const y0 = this->y[i * 2];
+        double const y1 = this->y[i * 2 + 1];
+        double const charges[channels] = {1.0, y0, y1, y0 * y0 + y1 * y1};
+        for (int jy = 0; jy < nodesPerBox; jy++) {
+            for (int jx = 0; jx < nodesPerBox; jx++) {
+                double const w = weights[(i * 2) * nodesPerBox + jx] * weights[(i * 2 + 1) * nodesPerBox + jy];
+                size_t const node = (firstNode[i * 2 + 1] + jy) * fftSize + firstNode[i * 2] + jx;
+                for (int c = 0; c < channels / 2; c++) {
+                    grids[c][node] += w * std::complex<double>(charges[2 * c], charges[2 * c + 1]);
+                }
+            }
+        }
+    }
+
+    // circular convolution with the squared Cauchy kernel, the padding avoids wrap-around
+    std::vector<std::complex<double>> kernel(fftSize * fftSize, 0.0);
+    for (int64_t oy = -static_cast<int64_t>(nodes) + 1; oy < static_cast<int64_t>(nodes); oy++) {
+        for (int64_t ox = -static_cast<int64_t>(nodes) + 1; ox < static_cast<int64_t>(nodes); ox++) {
+            double const dist2 = (ox * ox + oy * oy) * spacing * spacing;
+            double const q = 1.0 / (1.0 + dist2);
+            kernel[((oy + fftSize) % fftSize) * fftSize + (ox + fftSize) % fftSize] = q * q;
+        }
+    }
+    fft2(kernel, fftSize, false, fftSize);
+    double const norm = 1.0 / (static_cast<double>(fftSize) * fftSize);
+    for (auto& grid : grids) {
+        fft2(grid, fftSize, false, nodes);
+        // the kernel is real and even, so is its transform, which keeps the packed channels apart
+        for (size_t n = 0; n < grid.size(); n++) {
+            grid[n] *= kernel[n].real() * norm;
+        }
+        fft2(grid, fftSize, true, nodes);
+    }
+
+    // interpolate the potentials back to the points
+    double sumQ = 0.0;
+#pragma omp parallel for reduction(+ : sumQ)
+    for (int64_t i = 0; i < static_cast<int64_t>(this->rows); i++) {
+        double phi[channels] = {0.0, 0.0, 0.0, 0.0};
+        for (int jy = 0; jy < nodesPerBox; jy++) {
+            for (int jx = 0; jx < nodesPerBox; jx++) {
+                double const w = weights[(i * 2) * nodesPerBox + jx] * weights[(i * 2 + 1) * nodesPerBox + jy];
+                size_t const node = (firstNode[i * 2 + 1] + jy) * fftSize + firstNode[i * 2] + jx;
+                for (int c = 0; c < channels / 2; c++) {
+                    phi[2 * c] += w * grids[c][node].real();
+                    phi[2 * c + 1] += w * grids[c][node].imag();
+                }
+            }
+        }
+        double const y0 = this->y[i * 2];
+        double const y1 = this->y[i * 2 + 1];
+        // q = q^2 (1 + |y_i - y_j|^2), the point itself contributes q = 1
+        sumQ += (1.0 + y0 * y0 + y1 * y1) * phi[0] - 2.0 * (y0 * phi[1] + y1 * phi[2]) + phi[3] - 1.0;
+        forces[i * 2] = y0 * phi[0] - phi[1];
+        forces[i * 2 + 1] = y1 * phi[0] - phi[2];
+    }
+    return sumQ;
+}
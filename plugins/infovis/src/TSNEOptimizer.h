@@ -0,0 +1,109 @@
+/**
+ * MegaMol
+ * Copyright (c) 2021, MegaMol Dev Team
+ * All rights reserved.
+ */
+
+#ifndef MEGAMOL_INFOVIS_TSNEOPTIMIZER_H_INCLUDED
+#define MEGAMOL_INFOVIS_TSNEOPTIMIZER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace megamol {
+namespace infovis {
+
+/**
+ * t-SNE that is advanced iteration by iteration, so the embedding can be inspected in between.
+ *
+ * The input similarities are computed from the exact k nearest neighbors (k = 3 * perplexity) as in Barnes-Hut-SNE.
+ * The optimization follows bhtsne: gradient descent with momentum and gains, and early exaggeration during the first
+ * iterations. The repulsive forces are computed in parallel, either exactly (theta = 0), with a Barnes-Hut tree, or,
+ * for two output dimensions, by interpolation onto a regular grid where the kernel is applied by FFT (FIt-SNE).
+ */
+class TSNEOptimizer {
+public:
+    enum class Gradient { BarnesHut, Interpolated };
+
+    /** Number of iterations with early exaggeration and low momentum after a random initialization */
+    static const int exaggerationIterations = 250;
+
+    /**
+     * Computes the input similarities of the row-major table 'data', which is not referenced afterwards.
+     */
+    TSNEOptimizer(float const* data, size_t rowsCount, size_t columnCount, int outputDimension, double perplexity);
+
+    /**
+     * Starts a new optimization from a random embedding, or from 'warmStart' (rowsCount * outputDimension values) if
+     * given. A warm start skips the early exaggeration, as the embedding is expected to be roughly clustered already.
+     *
+     * @param randomSeed Seed of the random initialization, a negative value uses the current time.
+     */
+    void initialize(int randomSeed, std::vector<double> const* warmStart = nullptr);
+
+    /**
+     * Performs one gradient descent iteration.
+     *
+     * @param theta Accuracy of the Barnes-Hut approximation, 0 computes the exact gradient.
+     */
+    void step(Gradient gradient, double theta);
+
+    int iteration(void) const {
+        return this->iter;
+    }
+
+    size_t rowsCount(void) const {
+        return this->rows;
+    }
+
+    int outputDimension(void) const {
+        return this->dims;
+    }
+
+    /** Row-major embedding of rowsCount() x outputDimension() values */
+    std::vector<double> const& embedding(void) const {
+        return this->y;
+    }
+
+private:
+    void computeAffinities(float const* data, size_t columnCount, double perplexity);
+
+    /** Adds the attractive forces to 'forces' */
+    void attractiveForces(double exaggeration, std::vector<double>& forces) const;
+
+    /**
+     * Computes the unnormalized repulsive forces sum_j q_ij^2 (y_i - y_j) with q_ij = 1 / (1 + |y_i - y_j|^2).
+     *
+     * @return The normalization sum_{i != j} q_ij.
+     */
+    double exactRepulsion(std::vector<double>& forces) const;
+
+    double barnesHutRepulsion(double theta, std::vector<double>& forces) const;
+
+    double interpolatedRepulsion(std::vector<double>& forces) const;
+
+    size_t rows;
+
+    int dims;
+
+    /** Symmetric joint probabilities of the input in CSR layout */
+    std::vector<size_t> rowP;
+    std::vector<uint32_t> colP;
+    std::vector<double> valP;
+
+    std::vector<double> y;
+    std::vector<double> update;
+    std::vector<double> gains;
+
+    int iter;
+
+    /** Iteration at which early exaggeration ends and the momentum increases */
+    int exaggerationEnd;
+};
+
+} // namespace infovis
+} // namespace megamol
+
+#endif
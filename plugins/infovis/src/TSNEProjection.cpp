@@ -2,11 +2,12 @@
 
 #include "datatools/table/TableDataCall.h"
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 
-#include <sstream>
-#include <tsne.h>
+#include <algorithm>
+#include <exception>
 
 using namespace megamol;
 using namespace megamol::infovis;
@@ -21,11 +22,23 @@ TSNEProjection::TSNEProjection(void)
               "theta = 0 corresponds to standard, slow t-SNE, while theta = 1 corresponds to very crude approximations")
         , maxIterSlot("maxIter", "Set the maximum Iterations")
         , perplexitySlot("perplexity", "Set the Perplexity")
+        , gradientSlot("gradient", "Barnes-Hut approximation of the gradient (exact for theta = 0) or interpolation on a "
+                                   "grid with FFT, which is faster for many rows and two dimensions")
+        , publishIntervalSlot("publishInterval", "Number of iterations after which the intermediate embedding is output")
+        , warmStartSlot("warmStart", "Start from the previous embedding of the same input if the dimensions match")
         , datahash(0)
         , dataInHash(0)
-        , columnInfos() {
-
-    TSNE* tsne = new TSNE(); // lib load test
+        , columnInfos()
+        , cancelOptimization(false)
+        , gradient(TSNEOptimizer::Gradient::BarnesHut)
+        , theta(0.5)
+        , perplexity(30.0)
+        , maxIter(1000)
+        , randomSeed(42)
+        , publishInterval(50)
+        , publishedColumnCount(0)
+        , publishedCount(0)
+        , fetchedCount(0) {
 
     this->dataInSlot.SetCompatibleCall<megamol::datatools::table::TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
@@ -50,6 +63,18 @@ TSNEProjection::TSNEProjection(void)
 
     thetaSlot << new ::megamol::core::param::FloatParam(0.5);
     this->MakeSlotAvailable(&thetaSlot);
+
+    auto* gradients = new ::megamol::core::param::EnumParam(static_cast<int>(TSNEOptimizer::Gradient::BarnesHut));
+    gradients->SetTypePair(static_cast<int>(TSNEOptimizer::Gradient::BarnesHut), "BarnesHut");
+    gradients->SetTypePair(static_cast<int>(TSNEOptimizer::Gradient::Interpolated), "Interpolated");
+    gradientSlot << gradients;
+    this->MakeSlotAvailable(&gradientSlot);
+
+    publishIntervalSlot << new ::megamol::core::param::IntParam(50, 1);
+    this->MakeSlotAvailable(&publishIntervalSlot);
+
+    warmStartSlot << new ::megamol::core::param::BoolParam(true);
+    this->MakeSlotAvailable(&warmStartSlot);
 }
 
 TSNEProjection::~TSNEProjection(void) {
@@ -60,7 +85,10 @@ bool TSNEProjection::create(void) {
     return true;
 }
 
-void TSNEProjection::release(void) {}
+void TSNEProjection::release(void) {
+    this->stopOptimization();
+    this->optimizer.reset();
+}
 
 bool TSNEProjection::getDataCallback(core::Call& c) {
     try {
@@ -116,6 +144,8 @@ bool TSNEProjection::getHashCallback(core::Call& c) {
         if (!(*inCall)(1))
             return false;
 
+        this->fetchEmbedding();
+
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetDataHash(this->datahash);
     } catch (...) {
@@ -128,25 +158,26 @@ bool TSNEProjection::getHashCallback(core::Call& c) {
 }
 
 bool megamol::infovis::TSNEProjection::project(megamol::datatools::table::TableDataCall* inCall) {
+    if (publishIntervalSlot.IsDirty()) {
+        this->publishInterval = this->publishIntervalSlot.Param<core::param::IntParam>()->Value();
+        publishIntervalSlot.ResetDirty();
+    }
+
     // check if inData has changed and if Slots have changed
-    if (this->dataInHash == inCall->DataHash()) {
+    bool const inputChanged = this->dataInHash != inCall->DataHash();
+    if (!inputChanged) {
         if (!reduceToNSlot.IsDirty() && !maxIterSlot.IsDirty() && !thetaSlot.IsDirty() && !perplexitySlot.IsDirty() &&
-            !randomSeedSlot.IsDirty()) {
+            !randomSeedSlot.IsDirty() && !gradientSlot.IsDirty()) {
+            this->fetchEmbedding();
             return true; // Nothing to do
         }
     }
 
     auto columnCount = inCall->GetColumnsCount();
-    auto column_infos = inCall->GetColumnsInfos();
     auto rowsCount = inCall->GetRowsCount();
     auto inData = inCall->GetData();
 
     unsigned int outputColumnCount = this->reduceToNSlot.Param<core::param::IntParam>()->Value();
-    int maxIter = this->maxIterSlot.Param<core::param::IntParam>()->Value();
-    int randomSeed = this->randomSeedSlot.Param<core::param::IntParam>()->Value();
-    double theta = this->thetaSlot.Param<core::param::FloatParam>()->Value();
-    double perplexity = this->perplexitySlot.Param<core::param::FloatParam>()->Value();
-
 
     if (outputColumnCount <= 0 || outputColumnCount > columnCount) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(
@@ -154,85 +185,135 @@ bool megamol::infovis::TSNEProjection::project(megamol::datatools::table::TableD
         return false;
     }
 
-    // Load data in a double Array
-    double* inputData = (double*)malloc(columnCount * rowsCount * sizeof(double));
-    for (int col = 0; col < columnCount; col++) {
-        for (int row = 0; row < rowsCount; row++) {
-            inputData[row * columnCount + col] = inData[row * columnCount + col];
-            // inputData[col*rowsCount + row] = inData[row * columnCount + col];
+    this->stopOptimization();
+
+    // the input similarities only depend on the input and the perplexity
+    std::vector<float> input;
+    if (inputChanged || !this->optimizer || reduceToNSlot.IsDirty() || perplexitySlot.IsDirty()) {
+        input.assign(inData, inData + rowsCount * columnCount);
+        this->optimizer.reset();
+    }
+
+    std::vector<double> warmStart;
+    {
+        std::lock_guard<std::mutex> lock(this->publishedMutex);
+        bool const fits = this->publishedColumnCount == static_cast<int>(outputColumnCount) &&
+                          this->publishedEmbedding.size() == rowsCount * outputColumnCount;
+        // rows of other input data do not correspond to the previous points, even if the shape matches
+        if (fits && !inputChanged && this->warmStartSlot.Param<core::param::BoolParam>()->Value() &&
+            !randomSeedSlot.IsDirty()) {
+            warmStart = this->publishedEmbedding;
+        }
+        if (!fits) {
+            // the previous embedding does not match the input anymore
+            this->publishedEmbedding.clear();
+            this->publishedColumnCount = 0;
+            this->publishedCount++;
         }
     }
 
+    this->gradient = static_cast<TSNEOptimizer::Gradient>(this->gradientSlot.Param<core::param::EnumParam>()->Value());
+    this->theta = this->thetaSlot.Param<core::param::FloatParam>()->Value();
+    this->perplexity = this->perplexitySlot.Param<core::param::FloatParam>()->Value();
+    this->maxIter = this->maxIterSlot.Param<core::param::IntParam>()->Value();
+    this->randomSeed = this->randomSeedSlot.Param<core::param::IntParam>()->Value();
+    this->cancelOptimization = false;
+    this->optimizeThread = std::thread(&TSNEProjection::optimize, this, std::move(input), rowsCount, columnCount,
+        static_cast<int>(outputColumnCount), std::move(warmStart));
 
-    TSNE* tsne = new TSNE();
+    this->dataInHash = inCall->DataHash();
+    reduceToNSlot.ResetDirty();
+    maxIterSlot.ResetDirty();
+    randomSeedSlot.ResetDirty();
+    thetaSlot.ResetDirty();
+    perplexitySlot.ResetDirty();
+    gradientSlot.ResetDirty();
 
-    double* result = (double*)malloc(rowsCount * outputColumnCount * sizeof(double));
-    // void run(double* X, int N, int D, double* Y, int no_dims, double perplexity, double theta, int rand_seed,
-    // bool skip_random_init, int max_iter = 1000, int stop_lying_iter = 250, int mom_switch_iter = 250);
-    tsne->run(
-        inputData, rowsCount, columnCount, result, outputColumnCount, perplexity, theta, randomSeed, false, maxIter);
+    this->fetchEmbedding();
 
-    double* maximas = new double[outputColumnCount];
-    double* minimas = new double[outputColumnCount];
+    return true;
+}
 
-    for (int col = 0; col < outputColumnCount; col++) {
-        maximas[col] = result[col];
-        minimas[col] = result[col];
-    }
+void megamol::infovis::TSNEProjection::optimize(std::vector<float> input, size_t rowsCount, size_t columnCount,
+    int outputColumnCount, std::vector<double> warmStart) {
+    try {
+        if (!input.empty()) {
+            this->optimizer = std::make_unique<TSNEOptimizer>(
+                input.data(), rowsCount, columnCount, outputColumnCount, this->perplexity);
+            input = std::vector<float>();
+        }
+
+        this->optimizer->initialize(this->randomSeed, warmStart.empty() ? nullptr : &warmStart);
+        this->publish();
 
-    for (int col = 0; col < outputColumnCount; col++) {
-        for (int row = 1; row < rowsCount; row++) {
-            double value = result[row * outputColumnCount + col];
-            if (maximas[col] < value)
-                maximas[col] = value;
-            if (minimas[col] > value)
-                minimas[col] = value;
+        while (this->optimizer->iteration() < this->maxIter && !this->cancelOptimization) {
+            this->optimizer->step(this->gradient, this->theta);
+            auto const iter = this->optimizer->iteration();
+            if (iter % std::max(1, this->publishInterval.load()) == 0 || iter == this->maxIter) {
+                this->publish();
+            }
         }
+    } catch (std::exception const& e) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: %hs\n"), ClassName(), e.what());
+        this->optimizer.reset();
+    }
+}
+
+void megamol::infovis::TSNEProjection::publish(void) {
+    std::lock_guard<std::mutex> lock(this->publishedMutex);
+    this->publishedEmbedding = this->optimizer->embedding();
+    this->publishedColumnCount = this->optimizer->outputDimension();
+    this->publishedCount++;
+}
+
+void megamol::infovis::TSNEProjection::stopOptimization(void) {
+    this->cancelOptimization = true;
+    if (this->optimizeThread.joinable()) {
+        this->optimizeThread.join();
+    }
+}
+
+bool megamol::infovis::TSNEProjection::fetchEmbedding(void) {
+    std::lock_guard<std::mutex> lock(this->publishedMutex);
+    if (this->publishedCount == this->fetchedCount) {
+        return false;
     }
+    this->fetchedCount = this->publishedCount;
 
+    int const outputColumnCount = this->publishedColumnCount;
+    size_t const rowsCount = outputColumnCount > 0 ? this->publishedEmbedding.size() / outputColumnCount : 0;
 
-    // std::stringstream debug;
-    // debug << std::endl << result << std::endl;
-    // megamol::core::utility::log::Log::DefaultLog.WriteInfo(debug.str().c_str());
+    // the ranges of the columns are undefined without rows
+    if (rowsCount == 0) {
+        this->columnInfos.clear();
+        this->data.clear();
+        this->datahash++;
+        return true;
+    }
 
     // generate new columns
     this->columnInfos.clear();
     this->columnInfos.resize(outputColumnCount);
 
     for (int indexX = 0; indexX < outputColumnCount; indexX++) {
+        double minimum = this->publishedEmbedding[indexX];
+        double maximum = this->publishedEmbedding[indexX];
+        for (size_t row = 1; row < rowsCount; row++) {
+            double value = this->publishedEmbedding[row * outputColumnCount + indexX];
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+        }
         this->columnInfos[indexX]
             .SetName("TSNE" + std::to_string(indexX))
             .SetType(megamol::datatools::table::TableDataCall::ColumnType::QUANTITATIVE)
-            .SetMinimumValue(minimas[indexX])
-            .SetMaximumValue(maximas[indexX]);
+            .SetMinimumValue(minimum)
+            .SetMaximumValue(maximum);
     }
 
     // Result Matrix into Output
-    this->data.clear();
-    this->data.reserve(rowsCount * outputColumnCount);
-
-
-    for (size_t row = 0; row < rowsCount; row++) {
-        for (size_t col = 0; col < outputColumnCount; col++)
-            this->data.push_back(result[row * outputColumnCount + col]);
-    }
-
+    this->data.assign(this->publishedEmbedding.begin(), this->publishedEmbedding.end());
 
-    this->dataInHash = inCall->DataHash();
     this->datahash++;
-    reduceToNSlot.ResetDirty();
-    maxIterSlot.ResetDirty();
-    randomSeedSlot.ResetDirty();
-    thetaSlot.ResetDirty();
-    perplexitySlot.ResetDirty();
-
-    free(result);
-    result = NULL;
-    free(inputData);
-    inputData = NULL;
-    delete (tsne);
-    delete[] maximas;
-    delete[] minimas;
 
     return true;
 }
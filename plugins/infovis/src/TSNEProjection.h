@@ -7,6 +7,13 @@
 #include "mmcore/Module.h"
 #include "mmcore/param/ParamSlot.h"
 
+#include "TSNEOptimizer.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 
 namespace megamol {
 namespace infovis {
@@ -52,6 +59,21 @@ private:
 
     bool project(megamol::datatools::table::TableDataCall* inCall);
 
+    /**
+     * Runs the optimization in the background thread, publishing the embedding every 'publishInterval' iterations.
+     * An empty 'input' reuses the input similarities of the previous optimizer.
+     */
+    void optimize(std::vector<float> input, size_t rowsCount, size_t columnCount, int outputColumnCount,
+        std::vector<double> warmStart);
+
+    void publish(void);
+
+    /** Stops and joins the background thread */
+    void stopOptimization(void);
+
+    /** Takes the latest published embedding as output data, answers whether there was a new one */
+    bool fetchEmbedding(void);
+
     /** Data output slot */
     CalleeSlot dataOutSlot;
 
@@ -64,6 +86,9 @@ private:
     ::megamol::core::param::ParamSlot thetaSlot;
     ::megamol::core::param::ParamSlot perplexitySlot;
     ::megamol::core::param::ParamSlot maxIterSlot;
+    ::megamol::core::param::ParamSlot gradientSlot;
+    ::megamol::core::param::ParamSlot publishIntervalSlot;
+    ::megamol::core::param::ParamSlot warmStartSlot;
 
     /** ID of the current frame */
     // int frameID; //TODO: unknown
@@ -77,6 +102,28 @@ private:
 
     /** Vector stroing the actual float data */
     std::vector<float> data;
+
+    /** Optimizer of the background thread, only accessed by this thread while the background thread is stopped */
+    std::unique_ptr<TSNEOptimizer> optimizer;
+
+    std::thread optimizeThread;
+
+    std::atomic<bool> cancelOptimization;
+
+    /** Parameters of the running optimization */
+    TSNEOptimizer::Gradient gradient;
+    double theta;
+    double perplexity;
+    int maxIter;
+    int randomSeed;
+    std::atomic<int> publishInterval;
+
+    /** Latest embedding of the background thread and its running number, guarded by 'publishedMutex' */
+    std::mutex publishedMutex;
+    std::vector<double> publishedEmbedding;
+    int publishedColumnCount;
+    size_t publishedCount;
+    size_t fetchedCount;
 };
 
 } // namespace infovis
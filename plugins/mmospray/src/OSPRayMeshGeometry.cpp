@@ -119,6 +119,7 @@ bool OSPRayMeshGeometry::readData(megamol::core::Call& call) {
                                 ? core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::ENABLED |
                                                                       core::FlagStorageTypes::flag_bits::SELECTED)
                                 : core::FlagStorageTypes::to_integral(core::FlagStorageTypes::flag_bits::ENABLED);
+                        data->markChanged(a_idx, a_idx);
                         fcw->setData(data, version + 1);
                         (*fcw)(core::FlagCallWrite_CPU::CallGetData);
                         os->setPickResult(-1, -1);
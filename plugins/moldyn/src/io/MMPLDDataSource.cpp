@@ -6,19 +6,45 @@
  */
 
 #include "MMPLDDataSource.h"
+
+#include <algorithm>
+#include <omp.h>
+
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CoreInstance.h"
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/utility/sys/SystemInformation.h"
 #include "stdafx.h"
+#include "vislib/Exception.h"
 #include "vislib/String.h"
 #include "vislib/sys/FastFile.h"
 
 namespace megamol::moldyn::io {
 
+namespace {
+
+/**
+ * Converts 'cnt' records of 'C' values of type 'T' at 'src', which are 'stride'
+ * bytes apart, into tightly packed floats at 'dst'. The loop body has no
+ * dependencies between iterations, such that the compiler can vectorise it.
+ */
+template<class T, int C>
+void convertToFloat(const UINT8* src, unsigned int stride, float* dst, INT64 cnt) {
+    for (INT64 i = 0; i < cnt; ++i) {
+        T v[C];
+        memcpy(v, src + i * stride, sizeof(v));
+        for (int c = 0; c < C; ++c) {
+            dst[C * i + c] = static_cast<float>(v[c]);
+        }
+    }
+}
+
+} // namespace
+
 
 /* defines for the frame cache size */
 // minimum number of frames in the cache (2 for interpolation; 1 for loading)
@@ -33,7 +59,13 @@ namespace megamol::moldyn::io {
 /*
  * MMPLDDataSource::Frame::Frame
  */
-MMPLDDataSource::Frame::Frame(AnimDataModule& owner) : AnimDataModule::Frame(owner), dat() {
+MMPLDDataSource::Frame::Frame(AnimDataModule& owner)
+        : AnimDataModule::Frame(owner)
+        , dat()
+        , mapped(NULL)
+        , mappedSize(0)
+        , lists()
+        , fileVersion(0) {
     // intentionally empty
 }
 
@@ -52,8 +84,73 @@ MMPLDDataSource::Frame::~Frame() {
 bool MMPLDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version) {
     this->frame = idx;
     this->fileVersion = version;
+    this->mapped = NULL;
+    this->mappedSize = 0;
     this->dat.EnforceSize(static_cast<SIZE_T>(size));
-    return (file->Read(this->dat, size) == size);
+    if (file->Read(this->dat, size) != size) {
+        this->dat.EnforceSize(0);
+        this->lists.clear();
+        return false;
+    }
+    this->parseLists();
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::Frame::MapFrame
+ */
+void MMPLDDataSource::Frame::MapFrame(const char* data, unsigned int idx, UINT64 size, unsigned int version) {
+    this->frame = idx;
+    this->fileVersion = version;
+    this->dat.EnforceSize(0);
+    this->mapped = (size > 0) ? data : NULL;
+    this->mappedSize = static_cast<SIZE_T>(size);
+    this->parseLists();
+}
+
+
+/*
+ * MMPLDDataSource::Frame::Canonicalize
+ */
+void MMPLDDataSource::Frame::Canonicalize(int threadCnt) {
+    // split the conversion into chunks of all lists to keep all threads busy
+    // for few large as well as for many small lists.
+    const INT64 chunkSize = 64 * 1024;
+    std::vector<std::pair<size_t, INT64>> chunks;
+    for (size_t i = 0; i < this->lists.size(); i++) {
+        ListLayout& l = this->lists[i];
+        bool convVrt = (l.vrtDatType == geocalls::MultiParticleDataCall::Particles::VERTDATA_SHORT_XYZ) ||
+                       (l.vrtDatType == geocalls::MultiParticleDataCall::Particles::VERTDATA_DOUBLE_XYZ);
+        bool convCol = (l.colDatType == geocalls::MultiParticleDataCall::Particles::COLDATA_DOUBLE_I);
+        l.vertices.resize(convVrt ? static_cast<size_t>(3 * l.count) : 0);
+        l.intensities.resize(convCol ? static_cast<size_t>(l.count) : 0);
+        if (convVrt || convCol) {
+            for (INT64 c = 0; c < static_cast<INT64>(l.count); c += chunkSize) {
+                chunks.emplace_back(i, c);
+            }
+        }
+    }
+
+    const INT64 chunkCnt = static_cast<INT64>(chunks.size());
+#pragma omp parallel for schedule(dynamic) num_threads(threadCnt)
+    for (INT64 c = 0; c < chunkCnt; ++c) {
+        ListLayout& l = this->lists[chunks[c].first];
+        const INT64 first = chunks[c].second;
+        const INT64 cnt = std::min(chunkSize, static_cast<INT64>(l.count) - first);
+        const UINT8* data = this->dataAt<UINT8>(l.dataOffset + static_cast<SIZE_T>(first) * l.stride);
+
+        if (!l.vertices.empty()) {
+            if (l.vrtDatType == geocalls::MultiParticleDataCall::Particles::VERTDATA_SHORT_XYZ) {
+                convertToFloat<unsigned short, 3>(data, l.stride, l.vertices.data() + 3 * first, cnt);
+            } else {
+                convertToFloat<double, 3>(data, l.stride, l.vertices.data() + 3 * first, cnt);
+            }
+        }
+        if (!l.intensities.empty()) {
+            convertToFloat<double, 1>(data + l.vrtSize, l.stride, l.intensities.data() + first, cnt);
+        }
+    }
 }
 
 
@@ -62,158 +159,207 @@ bool MMPLDDataSource::Frame::LoadFrame(vislib::sys::File* file, unsigned int idx
  */
 void MMPLDDataSource::Frame::SetData(
     geocalls::MultiParticleDataCall& call, vislib::math::Cuboid<float> const& bbox, bool overrideBBox) {
-    if (this->dat.IsEmpty()) {
+    if ((this->mapped == NULL) && this->dat.IsEmpty()) {
         call.SetParticleListCount(0);
         return;
     }
 
+    call.SetParticleListCount(static_cast<unsigned int>(this->lists.size()));
+    for (UINT32 i = 0; i < this->lists.size(); i++) {
+        geocalls::MultiParticleDataCall::Particles& pts = call.AccessParticles(i);
+        ListLayout const& l = this->lists[i];
+
+        pts.SetGlobalRadius(l.globalRadius);
+        pts.SetGlobalColour(l.globalColour[0], l.globalColour[1], l.globalColour[2]);
+        if (l.hasColourMapRange) {
+            pts.SetColourMapIndexValues(l.colourMapRange[0], l.colourMapRange[1]);
+        }
+        pts.SetCount(l.count);
+
+        if (l.bboxOffset != 0) {
+            auto const box = this->dataAt<float>(l.bboxOffset);
+            vislib::math::Cuboid<float> bbox;
+            bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
+            pts.SetBBox(bbox);
+        }
+        if (overrideBBox) {
+            pts.SetBBox(bbox);
+        }
+
+        if (!l.vertices.empty()) {
+            pts.SetVertexData(geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ, l.vertices.data());
+        } else {
+            pts.SetVertexData(l.vrtDatType, this->dataAt<UINT8>(l.dataOffset), l.stride);
+        }
+        if (!l.intensities.empty()) {
+            pts.SetColourData(geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_I, l.intensities.data());
+        } else {
+            pts.SetColourData(l.colDatType, this->dataAt<UINT8>(l.dataOffset + l.vrtSize), l.stride);
+        }
+
+        if (l.clusterInfoOffset != 0) {
+            SIZE_T p = l.clusterInfoOffset;
+            // TODO: who deletes this?
+            geocalls::SimpleSphericalParticles::ClusterInfos* ci =
+                new geocalls::SimpleSphericalParticles::ClusterInfos();
+            ci->numClusters = *this->dataAt<unsigned int>(p);
+            p += sizeof(unsigned int);
+            ci->sizeofPlainData = *this->dataAt<size_t>(p);
+            p += sizeof(size_t);
+            ci->plainData = (unsigned int*)malloc(ci->sizeofPlainData);
+            memcpy(ci->plainData, this->dataAt<UINT8>(p), ci->sizeofPlainData);
+            pts.SetClusterInfos(ci);
+        }
+    }
+}
+
+
+/*
+ * MMPLDDataSource::Frame::parseLists
+ */
+void MMPLDDataSource::Frame::parseLists(void) {
     SIZE_T p = 0;
-    float timestamp = static_cast<float>(call.FrameID());
+    if ((this->mapped == NULL) && this->dat.IsEmpty()) {
+        this->lists.clear();
+        return;
+    }
+
     // HAZARD for megamol up to fc4e784dae531953ad4cd3180f424605474dd18b this reads == 102
     // which means that many MMPLDs out there with version 103 are written wrongly (no timestamp)!
     if (this->fileVersion >= 102) {
-        timestamp = *this->dat.AsAt<float>(p);
-        p += sizeof(float);
+        p += sizeof(float); // timestamp
     }
-    UINT32 plc = *this->dat.AsAt<UINT32>(p);
+    UINT32 plc = *this->dataAt<UINT32>(p);
     p += sizeof(UINT32);
-    call.SetParticleListCount(plc);
+    // Note: resizing keeps the conversion buffers of the previous frame for reuse
+    this->lists.resize(plc);
     for (UINT32 i = 0; i < plc; i++) {
-        geocalls::MultiParticleDataCall::Particles& pts = call.AccessParticles(i);
+        ListLayout& l = this->lists[i];
 
-        UINT8 vrtType = *this->dat.AsAt<UINT8>(p);
+        UINT8 vrtType = *this->dataAt<UINT8>(p);
         p += 1;
-        UINT8 colType = *this->dat.AsAt<UINT8>(p);
+        UINT8 colType = *this->dataAt<UINT8>(p);
         p += 1;
-        geocalls::MultiParticleDataCall::Particles::VertexDataType vrtDatType;
-        geocalls::MultiParticleDataCall::Particles::ColourDataType colDatType;
-        SIZE_T vrtSize = 0;
         SIZE_T colSize = 0;
 
         switch (vrtType) {
         case 0:
-            vrtSize = 0;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE;
+            l.vrtSize = 0;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE;
             break;
         case 1:
-            vrtSize = 12;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ;
+            l.vrtSize = 12;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZ;
             break;
         case 2:
-            vrtSize = 16;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZR;
+            l.vrtSize = 16;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_FLOAT_XYZR;
             break;
         case 3:
-            vrtSize = 6;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_SHORT_XYZ;
+            l.vrtSize = 6;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_SHORT_XYZ;
             break;
         case 4:
-            vrtSize = 24;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_DOUBLE_XYZ;
+            l.vrtSize = 24;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_DOUBLE_XYZ;
             break;
         default:
-            vrtSize = 0;
-            vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE;
+            l.vrtSize = 0;
+            l.vrtDatType = geocalls::MultiParticleDataCall::Particles::VERTDATA_NONE;
             break;
         }
         if (vrtType != 0) {
             switch (colType) {
             case 0:
                 colSize = 0;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
                 break;
             case 1:
                 colSize = 3;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGB;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGB;
                 break;
             case 2:
                 colSize = 4;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGBA;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_UINT8_RGBA;
                 break;
             case 3:
                 colSize = 4;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_I;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_I;
                 break;
             case 4:
                 colSize = 12;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGB;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGB;
                 break;
             case 5:
                 colSize = 16;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGBA;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_FLOAT_RGBA;
                 break;
             case 6:
                 colSize = 8;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_USHORT_RGBA;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_USHORT_RGBA;
                 break;
             case 7:
                 colSize = 8;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_DOUBLE_I;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_DOUBLE_I;
                 break;
             default:
                 colSize = 0;
-                colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
+                l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
                 break;
             }
         } else {
-            colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
+            l.colDatType = geocalls::MultiParticleDataCall::Particles::COLDATA_NONE;
             colSize = 0;
         }
-        unsigned int stride = static_cast<unsigned int>(vrtSize + colSize);
+        l.stride = static_cast<unsigned int>(l.vrtSize + colSize);
 
         if ((vrtType == 1) || (vrtType == 3) || (vrtType == 4)) {
-            pts.SetGlobalRadius(*this->dat.AsAt<float>(p));
+            l.globalRadius = *this->dataAt<float>(p);
             p += 4;
         } else {
-            pts.SetGlobalRadius(0.05f);
+            l.globalRadius = 0.05f;
         }
 
+        l.hasColourMapRange = false;
         if (colType == 0) {
-            pts.SetGlobalColour(
-                *this->dat.AsAt<UINT8>(p), *this->dat.AsAt<UINT8>(p + 1), *this->dat.AsAt<UINT8>(p + 2));
+            l.globalColour[0] = *this->dataAt<UINT8>(p);
+            l.globalColour[1] = *this->dataAt<UINT8>(p + 1);
+            l.globalColour[2] = *this->dataAt<UINT8>(p + 2);
             p += 4;
         } else {
-            pts.SetGlobalColour(192, 192, 192);
+            l.globalColour[0] = l.globalColour[1] = l.globalColour[2] = 192;
+            l.hasColourMapRange = true;
             if (colType == 3 || colType == 7) {
-                pts.SetColourMapIndexValues(*this->dat.AsAt<float>(p), *this->dat.AsAt<float>(p + 4));
+                l.colourMapRange[0] = *this->dataAt<float>(p);
+                l.colourMapRange[1] = *this->dataAt<float>(p + 4);
                 p += 8;
             } else {
-                pts.SetColourMapIndexValues(0.0f, 1.0f);
+                l.colourMapRange[0] = 0.0f;
+                l.colourMapRange[1] = 1.0f;
             }
         }
 
-        pts.SetCount(*this->dat.AsAt<UINT64>(p));
+        l.count = *this->dataAt<UINT64>(p);
         p += 8;
 
+        l.bboxOffset = 0;
         if (this->fileVersion >= 103) {
-            auto const box = this->dat.AsAt<float>(p);
-            vislib::math::Cuboid<float> bbox;
-            bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
-            pts.SetBBox(bbox);
+            l.bboxOffset = p;
             p += 24;
         }
-        if (overrideBBox) {
-            pts.SetBBox(bbox);
-        }
-
-        pts.SetVertexData(vrtDatType, this->dat.At(p), stride);
-        pts.SetColourData(colDatType, this->dat.At(p + vrtSize), stride);
 
-        p += static_cast<SIZE_T>(stride * pts.GetCount());
+        l.dataOffset = p;
+        p += static_cast<SIZE_T>(l.stride * l.count);
 
+        l.clusterInfoOffset = 0;
         if (this->fileVersion == 101) {
-            // TODO: who deletes this?
-            geocalls::SimpleSphericalParticles::ClusterInfos* ci =
-                new geocalls::SimpleSphericalParticles::ClusterInfos();
-            ci->numClusters = *this->dat.AsAt<unsigned int>(p);
+            l.clusterInfoOffset = p;
             p += sizeof(unsigned int);
-            ci->sizeofPlainData = *this->dat.AsAt<size_t>(p);
-            p += sizeof(size_t);
-            ci->plainData = (unsigned int*)malloc(ci->sizeofPlainData);
-            memcpy(ci->plainData, this->dat.At(p), ci->sizeofPlainData);
-            p += ci->sizeofPlainData;
-            pts.SetClusterInfos(ci);
+            p += sizeof(size_t) + *this->dataAt<size_t>(p);
         }
+
+        l.vertices.clear();
+        l.intensities.clear();
     }
 }
 
@@ -229,8 +375,16 @@ MMPLDDataSource::MMPLDDataSource(void)
         , limitMemorySlot("limitMemory", "Limits the memory cache size")
         , limitMemorySizeSlot("limitMemorySize", "Specifies the size limit (in MegaBytes) of the memory cache")
         , overrideBBoxSlot("overrideLocalBBox", "Override local bbox")
+        , useMemoryMappingSlot("useMemoryMapping", "Access the frames directly inside the memory-mapped file")
+        , readAheadSlot("readAhead", "Number of frames to read ahead when memory mapping is used")
+        , canonicalizeSlot(
+              "canonicalize", "Converts short and double positions and double intensities to float on load")
+        , loaderThreadsSlot("loaderThreads", "Number of threads loading frames in parallel")
+        , prefetchPolicySlot("prefetchPolicy", "Policy selecting the frames to be loaded into the cache")
         , getData("getdata", "Slot to request data from this data source.")
         , file(NULL)
+        , mappedFile(NULL)
+        , mappedData(NULL)
         , frameIdx(NULL)
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
@@ -256,6 +410,28 @@ MMPLDDataSource::MMPLDDataSource(void)
     this->overrideBBoxSlot << new core::param::BoolParam(false);
     this->MakeSlotAvailable(&this->overrideBBoxSlot);
 
+    this->useMemoryMappingSlot << new core::param::BoolParam(false);
+    this->useMemoryMappingSlot.SetUpdateCallback(&MMPLDDataSource::loadingParamChanged);
+    this->MakeSlotAvailable(&this->useMemoryMappingSlot);
+
+    this->readAheadSlot << new core::param::IntParam(2, 0);
+    this->MakeSlotAvailable(&this->readAheadSlot);
+
+    this->canonicalizeSlot << new core::param::BoolParam(false);
+    this->canonicalizeSlot.SetUpdateCallback(&MMPLDDataSource::loadingParamChanged);
+    this->MakeSlotAvailable(&this->canonicalizeSlot);
+
+    this->loaderThreadsSlot << new core::param::IntParam(1, 1);
+    this->loaderThreadsSlot.SetUpdateCallback(&MMPLDDataSource::loadingParamChanged);
+    this->MakeSlotAvailable(&this->loaderThreadsSlot);
+
+    auto policyParam = new core::param::EnumParam(1);
+    policyParam->SetTypePair(0, "Linear");
+    policyParam->SetTypePair(1, "Adaptive");
+    this->prefetchPolicySlot << policyParam;
+    this->prefetchPolicySlot.SetUpdateCallback(&MMPLDDataSource::loadingParamChanged);
+    this->MakeSlotAvailable(&this->prefetchPolicySlot);
+
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
         geocalls::MultiParticleDataCall::FunctionName(0), &MMPLDDataSource::getDataCallback);
     this->getData.SetCallback(geocalls::MultiParticleDataCall::ClassName(),
@@ -308,10 +484,28 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
     //printf("Requesting frame %u of %u frames\n", idx, this->FrameCount());
     //Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Requesting frame %u of %u frames\n", idx, this->FrameCount());
     ASSERT(idx < this->FrameCount());
-    this->file->Seek(this->frameIdx[idx]);
-    if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
-        // failed
-        Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame %d from MMPLD file\n", idx);
+    if (this->mappedData != NULL) {
+        f->MapFrame(this->mappedData + this->frameIdx[idx], idx, this->frameIdx[idx + 1] - this->frameIdx[idx],
+            this->fileVersion);
+        // let the OS page in this frame and the following ones asynchronously
+        unsigned int readAhead =
+            static_cast<unsigned int>(this->readAheadSlot.Param<core::param::IntParam>()->Value());
+        unsigned int last = vislib::math::Min(idx + 1 + readAhead, this->FrameCount());
+        this->mappedFile->AdviseWillNeed(this->frameIdx[idx], this->frameIdx[last] - this->frameIdx[idx]);
+    } else {
+        std::lock_guard<std::mutex> guard(this->fileLock);
+        this->file->Seek(this->frameIdx[idx]);
+        if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
+            // failed
+            Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Unable to read frame %d from MMPLD file\n", idx);
+            return;
+        }
+    }
+    if (this->canonicalizeSlot.Param<core::param::BoolParam>()->Value()) {
+        // every loader thread converts its frame concurrently, so share the
+        // OpenMP threads among them instead of starting a full team each.
+        const int loaderCnt = std::max(1, this->loaderThreadsSlot.Param<core::param::IntParam>()->Value());
+        f->Canonicalize(std::max(1, omp_get_max_threads() / loaderCnt));
     }
 }
 
@@ -321,6 +515,7 @@ void MMPLDDataSource::loadFrame(AnimDataModule::Frame* frame, unsigned int idx)
  */
 void MMPLDDataSource::release(void) {
     this->resetFrameCache();
+    this->unmapFile();
     if (this->file != NULL) {
         vislib::sys::File* f = this->file;
         this->file = NULL;
@@ -338,6 +533,7 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     using megamol::core::utility::log::Log;
     using vislib::sys::File;
     this->resetFrameCache();
+    this->unmapFile();
     this->bbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     this->clipbox = this->bbox;
     this->data_hash++;
@@ -408,28 +604,49 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
     size /= static_cast<double>(frmCnt);
     size *= CACHE_FRAME_FACTOR;
 
-    UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
-    if (this->limitMemorySlot.Param<core::param::BoolParam>()->Value()) {
-        mem = vislib::math::Min(
-            mem, (UINT64)(this->limitMemorySizeSlot.Param<core::param::IntParam>()->Value()) * (UINT64)(1024u * 1024u));
-    }
-    unsigned int cacheSize = static_cast<unsigned int>(mem / size);
+    this->mapFile();
 
-    if (cacheSize > CACHE_SIZE_MAX) {
-        cacheSize = CACHE_SIZE_MAX;
-    }
-    if (cacheSize < CACHE_SIZE_MIN) {
-        vislib::StringA msg;
-        msg.Format("Frame cache size forced to %i. Calculated size was %u.\n", CACHE_SIZE_MIN, cacheSize);
-        megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_WARN, msg);
-        cacheSize = CACHE_SIZE_MIN;
-    } else {
+    const auto loaderCnt = static_cast<unsigned int>(this->loaderThreadsSlot.Param<core::param::IntParam>()->Value());
+    unsigned int cacheSize;
+    if ((this->mappedData != NULL) && !this->canonicalizeSlot.Param<core::param::BoolParam>()->Value()) {
+        // mapped frames are views into the file and do not occupy memory of
+        // their own, so the cache only needs slots for the frames in use and
+        // the frames being mapped by the loader threads.
+        cacheSize = CACHE_SIZE_MIN + loaderCnt;
         vislib::StringA msg;
-        msg.Format("Frame cache size set to %i.\n", cacheSize);
+        msg.Format("Frame cache size set to %u mapped frames.\n", cacheSize);
         megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO, msg);
+
+    } else {
+        UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
+        if (this->limitMemorySlot.Param<core::param::BoolParam>()->Value()) {
+            mem = vislib::math::Min(mem,
+                (UINT64)(this->limitMemorySizeSlot.Param<core::param::IntParam>()->Value()) * (UINT64)(1024u * 1024u));
+        }
+        cacheSize = static_cast<unsigned int>(mem / size);
+
+        if (cacheSize > CACHE_SIZE_MAX) {
+            cacheSize = CACHE_SIZE_MAX;
+        }
+        if (cacheSize < CACHE_SIZE_MIN) {
+            vislib::StringA msg;
+            msg.Format("Frame cache size forced to %i. Calculated size was %u.\n", CACHE_SIZE_MIN, cacheSize);
+            megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_WARN, msg);
+            cacheSize = CACHE_SIZE_MIN;
+        } else {
+            vislib::StringA msg;
+            msg.Format("Frame cache size set to %i.\n", cacheSize);
+            megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO, msg);
+        }
     }
 
     this->setFrameCount(frmCnt);
+    this->setLoaderThreadCount(loaderCnt);
+    if (this->prefetchPolicySlot.Param<core::param::EnumParam>()->Value() == 0) {
+        this->setPrefetchPolicy(std::make_shared<core::view::LinearPrefetchPolicy>());
+    } else {
+        this->setPrefetchPolicy(std::make_shared<core::view::AdaptivePrefetchPolicy>());
+    }
     this->initFrameCache(cacheSize);
 
 #undef _ASSERT_READFILE
@@ -439,6 +656,62 @@ bool MMPLDDataSource::filenameChanged(core::param::ParamSlot& slot) {
 }
 
 
+/*
+ * MMPLDDataSource::loadingParamChanged
+ */
+bool MMPLDDataSource::loadingParamChanged(core::param::ParamSlot& slot) {
+    if (this->file != NULL) {
+        // reload to apply the new loading settings
+        this->filenameChanged(this->filename);
+    }
+    return true;
+}
+
+
+/*
+ * MMPLDDataSource::mapFile
+ */
+void MMPLDDataSource::mapFile(void) {
+    using megamol::core::utility::log::Log;
+    ASSERT(this->mappedFile == NULL);
+    if (!this->useMemoryMappingSlot.Param<core::param::BoolParam>()->Value()) {
+        return;
+    }
+
+    auto const& path = this->filename.Param<core::param::FilePathParam>()->Value();
+    this->mappedFile = new vislib::sys::MemmappedFile();
+    try {
+        if (this->mappedFile->Open(path.native().c_str(), vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ,
+                vislib::sys::File::OPEN_ONLY)) {
+            this->mappedData = this->mappedFile->MapFile();
+        }
+    } catch (vislib::Exception& ex) {
+        Log::DefaultLog.WriteMsg(Log::LEVEL_WARN, "Unable to memory-map MMPLD-File \"%s\": %s",
+            path.generic_u8string().c_str(), ex.GetMsgA());
+        this->mappedData = NULL;
+    }
+
+    if (this->mappedData == NULL) {
+        Log::DefaultLog.WriteMsg(Log::LEVEL_WARN, "Falling back to reading frames into memory.");
+        this->unmapFile();
+    }
+}
+
+
+/*
+ * MMPLDDataSource::unmapFile
+ */
+void MMPLDDataSource::unmapFile(void) {
+    this->mappedData = NULL;
+    if (this->mappedFile != NULL) {
+        vislib::sys::MemmappedFile* f = this->mappedFile;
+        this->mappedFile = NULL;
+        f->Close();
+        delete f;
+    }
+}
+
+
 /*
  * MMPLDDataSource::getDataCallback
  */
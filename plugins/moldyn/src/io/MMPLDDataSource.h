@@ -7,9 +7,13 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "geometry_calls/MultiParticleDataCall.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/param/ParamSlot.h"
+#include "mmcore/utility/sys/MemmappedFile.h"
 #include "mmcore/view/AnimDataModule.h"
 #include "vislib/RawStorage.h"
 #include "vislib/math/Cuboid.h"
@@ -108,8 +112,22 @@ protected:
          */
         inline void Clear(void) {
             this->dat.EnforceSize(0);
+            this->mapped = NULL;
+            this->mappedSize = 0;
+            this->lists.clear();
         }
 
+        /**
+         * Converts all lists with short or double positions to float
+         * positions and all lists with double intensities to float
+         * intensities. The lists are converted in parallel. Must be called
+         * after the frame has been loaded.
+         *
+         * @param threadCnt The number of OpenMP threads to convert with,
+         *                  which must account for concurrent loader threads.
+         */
+        void Canonicalize(int threadCnt);
+
         /**
          * Loads a frame from 'file' into this object
          *
@@ -123,6 +141,18 @@ protected:
          */
         bool LoadFrame(vislib::sys::File* file, unsigned int idx, UINT64 size, unsigned int version);
 
+        /**
+         * Points this object to the frame data inside a memory-mapped file
+         * instead of copying it. The mapping must stay valid as long as this
+         * frame references it.
+         *
+         * @param data Pointer to the first byte of the frame data
+         * @param idx The zero-based index of the frame
+         * @param size The size of the frame data in bytes
+         * @param version File version (100 = standard, 101 with clusterInfos)
+         */
+        void MapFrame(const char* data, unsigned int idx, UINT64 size, unsigned int version);
+
         /**
          * Sets the data into the call
          *
@@ -131,9 +161,84 @@ protected:
         void SetData(geocalls::MultiParticleDataCall& call, vislib::math::Cuboid<float> const& bbox, bool overrideBBox);
 
     private:
+        /** Layout of one particle list inside the frame data */
+        struct ListLayout {
+            /** The type of the vertex data */
+            geocalls::MultiParticleDataCall::Particles::VertexDataType vrtDatType;
+
+            /** The type of the colour data */
+            geocalls::MultiParticleDataCall::Particles::ColourDataType colDatType;
+
+            /** The size of the vertex data of one particle in bytes */
+            SIZE_T vrtSize;
+
+            /** The size of the data of one particle in bytes */
+            unsigned int stride;
+
+            /** The global radius */
+            float globalRadius;
+
+            /** The global colour */
+            UINT8 globalColour[3];
+
+            /** Flag whether the list specifies a colour map range */
+            bool hasColourMapRange;
+
+            /** The colour map range */
+            float colourMapRange[2];
+
+            /** The number of particles */
+            UINT64 count;
+
+            /** The offset of the local bounding box or zero if not present */
+            SIZE_T bboxOffset;
+
+            /** The offset of the particle data */
+            SIZE_T dataOffset;
+
+            /** The offset of the cluster infos or zero if not present */
+            SIZE_T clusterInfoOffset;
+
+            /** Positions converted to float XYZ (empty if not converted) */
+            std::vector<float> vertices;
+
+            /** Intensities converted to float (empty if not converted) */
+            std::vector<float> intensities;
+        };
+
+        /**
+         * Parses the list headers of the loaded frame data into 'lists'.
+         */
+        void parseLists(void);
+
+        /**
+         * Answers a pointer to the frame data at the given offset, either
+         * inside the memory-mapped file or inside the local copy.
+         *
+         * @param offset The offset in bytes from the start of the frame data
+         *
+         * @return Pointer to the frame data at 'offset'
+         */
+        template<class T>
+        inline const T* dataAt(SIZE_T offset) const {
+            if (this->mapped != NULL) {
+                return reinterpret_cast<const T*>(this->mapped + offset);
+            }
+            return reinterpret_cast<const T*>(this->dat.At(offset));
+        }
+
         /** position data per type */
         vislib::RawStorage dat;
 
+        /** frame data inside the memory-mapped file (NULL if 'dat' is used) */
+        const char* mapped;
+
+        /** size of the frame data inside the memory-mapped file */
+        SIZE_T mappedSize;
+
+        /** the layouts of the particle lists of the loaded frame */
+        std::vector<ListLayout> lists;
+
         /** file version */
         unsigned int fileVersion;
     };
@@ -181,6 +286,27 @@ protected:
      */
     bool filenameChanged(core::param::ParamSlot& slot);
 
+    /**
+     * Callback receiving the update of the parameters controlling how the
+     * frames are loaded.
+     *
+     * @param slot The updated ParamSlot.
+     *
+     * @return Always 'true' to reset the dirty flag.
+     */
+    bool loadingParamChanged(core::param::ParamSlot& slot);
+
+    /**
+     * Maps the opened data file into memory, if requested. Falls back to
+     * reading frames into memory if mapping is not possible.
+     */
+    void mapFile(void);
+
+    /**
+     * Unmaps the data file. The frame cache must have been reset before.
+     */
+    void unmapFile(void);
+
     /**
      * Gets the data from the source.
      *
@@ -211,12 +337,36 @@ protected:
     /** Override local bbox */
     core::param::ParamSlot overrideBBoxSlot;
 
+    /** Access the frames directly inside the memory-mapped file */
+    core::param::ParamSlot useMemoryMappingSlot;
+
+    /** Number of frames to read ahead when memory mapping is used */
+    core::param::ParamSlot readAheadSlot;
+
+    /** Converts short and double data to float when loading frames */
+    core::param::ParamSlot canonicalizeSlot;
+
+    /** Number of threads loading frames in parallel */
+    core::param::ParamSlot loaderThreadsSlot;
+
+    /** Policy selecting the frames to be loaded into the cache */
+    core::param::ParamSlot prefetchPolicySlot;
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
     /** The opened data file */
     vislib::sys::File* file;
 
+    /** Serialises seeking and reading of 'file' by the loader threads */
+    std::mutex fileLock;
+
+    /** The memory-mapped data file (NULL if frames are read into memory) */
+    vislib::sys::MemmappedFile* mappedFile;
+
+    /** The content of the memory-mapped data file */
+    const char* mappedData;
+
     /** The frame index table */
     UINT64* frameIdx;
 
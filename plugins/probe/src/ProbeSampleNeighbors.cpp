@@ -0,0 +1,102 @@
+/*
+ * ProbeSampleNeighbors.cpp
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "ProbeSampleNeighbors.h"
+#include <algorithm>
+#include <cmath>
+
+
+namespace megamol {
+namespace probe {
+
+void ProbeSampleNeighbors::setProbe(tree_type const& tree, std::array<float, 3> const& position,
+    std::array<float, 3> const& direction, float sample_step, double radius, int num_samples) {
+    _tree = &tree;
+    _position = position;
+    _direction = direction;
+    _sample_step = sample_step;
+    _radius = radius;
+    _num_samples = num_samples;
+    _batch_begin = _batch_end = 0;
+
+    // the tree compares squared distances against the radius, so the actual search radius is its square root.
+    // batches spanning up to one search radius keep the candidate volume small compared to the saved searches
+    auto const step_length = std::abs(sample_step) * std::sqrt(direction[0] * direction[0] +
+                                                               direction[1] * direction[1] +
+                                                               direction[2] * direction[2]);
+    auto const search_radius = std::sqrt(std::max(radius, 0.0));
+    if (step_length > 0.0f) {
+        _batch_size = 1 + static_cast<int>(std::min(search_radius / step_length, static_cast<double>(max_batch_size)));
+    } else {
+        _batch_size = max_batch_size;
+    }
+    _batch_size = std::min(_batch_size, max_batch_size);
+}
+
+int ProbeSampleNeighbors::query(int j) {
+    if (j < _batch_begin || j >= _batch_end) {
+        queryBatch(j);
+    }
+
+    auto const sample = samplePoint(j);
+
+    _indices.clear();
+    _distances.clear();
+    for (size_t c = 0; c < _candidates.size(); ++c) {
+        // same metric as the tree, which takes the difference in float and accumulates in double
+        auto const& p = _candidate_points[c];
+        double const dx = sample.x - p[0];
+        double const dy = sample.y - p[1];
+        double const dz = sample.z - p[2];
+        double dist = 0.0;
+        dist += dx * dx;
+        dist += dy * dy;
+        dist += dz * dz;
+        if (dist < _radius) {
+            _indices.push_back(_candidates[c]);
+            _distances.push_back(static_cast<float>(dist));
+        }
+    }
+
+    if (_indices.empty()) {
+        return _tree->nearestKSearch(sample, 1, _indices, _distances);
+    }
+    return static_cast<int>(_indices.size());
+}
+
+void ProbeSampleNeighbors::queryBatch(int begin) {
+    _batch_begin = begin;
+    _batch_end = std::min(begin + _batch_size, _num_samples);
+
+    auto const first = samplePoint(_batch_begin);
+    auto const last = samplePoint(std::max(_batch_end - 1, _batch_begin));
+    pcl::PointXYZ const center(0.5f * (first.x + last.x), 0.5f * (first.y + last.y), 0.5f * (first.z + last.z));
+
+    // every neighbor of a sample is within the search radius plus the distance of the sample to the center
+    double max_offset = 0.0;
+    for (int j = _batch_begin; j < _batch_end; ++j) {
+        auto const s = samplePoint(j);
+        double const dx = s.x - center.x;
+        double const dy = s.y - center.y;
+        double const dz = s.z - center.z;
+        max_offset = std::max(max_offset, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+    auto const batch_radius = std::sqrt(std::max(_radius, 0.0)) + max_offset;
+    // small safety margin against rounding, surplus candidates are removed per sample anyway
+    auto const batch_radius_sq = batch_radius * batch_radius * (1.0 + 1e-4);
+
+    _tree->radiusSearch(center, batch_radius_sq, _candidates, _candidate_distances);
+
+    auto const& cloud = _tree->getInputCloud()->points;
+    _candidate_points.resize(_candidates.size());
+    for (size_t c = 0; c < _candidates.size(); ++c) {
+        auto const& p = cloud[_candidates[c]];
+        _candidate_points[c] = {p.x, p.y, p.z};
+    }
+}
+
+} // namespace probe
+} // namespace megamol
@@ -0,0 +1,88 @@
+/*
+ * ProbeSampleNeighbors.h
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "kdtree.h"
+
+namespace megamol {
+namespace probe {
+
+/**
+ * Neighbor queries for the equidistant samples along a probe.
+ *
+ * Instead of one radius search per sample, a single search around a batch of consecutive samples collects the
+ * candidates of the whole batch, which are then filtered per sample. Samples closer together than the search radius
+ * share most of their neighbors, so this saves most of the tree traversals. The neighbors of a sample are the same as
+ * the ones returned by pcl::KdTreeFLANN::radiusSearch, including its squared radius, with a nearest neighbor fallback
+ * for samples without neighbors.
+ *
+ * Keeps its buffers between probes, so use one instance per thread.
+ */
+class ProbeSampleNeighbors {
+public:
+    using tree_type = pcl::KdTreeFLANN<pcl::PointXYZ>;
+
+    /** The maximum number of samples sharing one radius search */
+    static constexpr int max_batch_size = 16;
+
+    /**
+     * Starts a new probe.
+     *
+     * @param radius The radius as passed to the radius search of the tree.
+     */
+    void setProbe(tree_type const& tree, std::array<float, 3> const& position, std::array<float, 3> const& direction,
+        float sample_step, double radius, int num_samples);
+
+    /**
+     * Collects the neighbors of sample 'j' of the current probe.
+     *
+     * @return The number of neighbors, their indices and squared distances are valid until the next query.
+     */
+    int query(int j);
+
+    pcl::PointXYZ samplePoint(int j) const {
+        return pcl::PointXYZ(_position[0] + j * _sample_step * _direction[0],
+            _position[1] + j * _sample_step * _direction[1], _position[2] + j * _sample_step * _direction[2]);
+    }
+
+    std::vector<uint32_t> const& indices() const {
+        return _indices;
+    }
+
+    std::vector<float> const& distances() const {
+        return _distances;
+    }
+
+private:
+    void queryBatch(int begin);
+
+    tree_type const* _tree = nullptr;
+
+    std::array<float, 3> _position;
+    std::array<float, 3> _direction;
+    float _sample_step = 0.0f;
+    double _radius = 0.0;
+    int _num_samples = 0;
+    int _batch_size = 1;
+
+    /** samples [_batch_begin, _batch_end) are covered by the candidates */
+    int _batch_begin = 0;
+    int _batch_end = 0;
+
+    std::vector<uint32_t> _candidates;
+    std::vector<float> _candidate_distances;
+    std::vector<std::array<float, 3>> _candidate_points;
+
+    std::vector<uint32_t> _indices;
+    std::vector<float> _distances;
+};
+
+} // namespace probe
+} // namespace megamol
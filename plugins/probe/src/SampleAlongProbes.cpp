@@ -6,11 +6,13 @@
 
 #include "SampleAlongProbes.h"
 #include "mmadios/CallADIOSData.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FlexEnumParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "probe/CallKDTree.h"
 #include "probe/ProbeCalls.h"
+#include <cstring>
 
 
 namespace megamol {
@@ -34,7 +36,12 @@ SampleAlongPobes::SampleAlongPobes()
         , _vec_param_to_samplex_y("ParameterToSampleY", "")
         , _vec_param_to_samplex_z("ParameterToSampleZ", "")
         , _vec_param_to_samplex_w("ParameterToSampleW", "")
-        , _volume_rhs_slot("getVolumeData", "") {
+        , _volume_rhs_slot("getVolumeData", "")
+        , _incremental_slot("IncrementalSampling",
+              "Only resamples probes whose position, direction or length changed if the data did not change. Keeps a "
+              "copy of the samples. Not available for the tetrahedral modes.")
+        , _cached_frame_id(0)
+        , _num_reused(0) {
 
     this->_probe_lhs_slot.SetCallback(CallProbes::ClassName(), CallProbes::FunctionName(0), &SampleAlongPobes::getData);
     this->_probe_lhs_slot.SetCallback(
@@ -103,6 +110,10 @@ SampleAlongPobes::SampleAlongPobes()
     this->_vec_param_to_samplex_w << paramEnum_4;
     this->_vec_param_to_samplex_w.SetUpdateCallback(&SampleAlongPobes::paramChanged);
     this->MakeSlotAvailable(&this->_vec_param_to_samplex_w);
+
+    this->_incremental_slot << new core::param::BoolParam(true);
+    this->_incremental_slot.SetUpdateCallback(&SampleAlongPobes::paramChanged);
+    this->MakeSlotAvailable(&this->_incremental_slot);
 }
 
 SampleAlongPobes::~SampleAlongPobes() {
@@ -113,11 +124,14 @@ bool SampleAlongPobes::create() {
     return true;
 }
 
-void SampleAlongPobes::release() {}
+void SampleAlongPobes::release() {
+    clearCache();
+}
 
 bool SampleAlongPobes::getData(core::Call& call) {
 
     bool something_has_changed = false;
+    bool data_has_changed = false;
     auto cp = dynamic_cast<CallProbes*>(&call);
     if (cp == nullptr)
         return false;
@@ -185,7 +199,8 @@ bool SampleAlongPobes::getData(core::Call& call) {
 
         tree_meta_data = ct->getMetaData();
 
-        something_has_changed = something_has_changed || (cd->getDataHash() != _old_datahash) || ct->hasUpdate();
+        data_has_changed = (cd->getDataHash() != _old_datahash) || ct->hasUpdate();
+        something_has_changed = something_has_changed || data_has_changed;
     } else if (cv != nullptr) {
 
         // get volume data
@@ -201,7 +216,8 @@ bool SampleAlongPobes::getData(core::Call& call) {
             return false;
         }
 
-        something_has_changed = something_has_changed || (cv->DataHash() != _old_volume_datahash);
+        data_has_changed = (cv->DataHash() != _old_volume_datahash);
+        something_has_changed = something_has_changed || data_has_changed;
     } else {
         return false;
     }
@@ -220,6 +236,15 @@ bool SampleAlongPobes::getData(core::Call& call) {
     if (something_has_changed) {
         ++_version;
 
+        // samples of unchanged probes stay valid as long as the data and the sampling parameters do not change
+        auto const mode = _sampling_mode.Param<core::param::EnumParam>()->Value();
+        bool const incremental = _incremental_slot.Param<core::param::BoolParam>()->Value() && mode != 3 && mode != 5;
+        if (!incremental || data_has_changed || _trigger_recalc || meta_data.m_frame_ID != _cached_frame_id) {
+            clearCache();
+        }
+        bool const use_cache = !_cache_lookup.empty();
+        _num_reused = 0;
+
         if (_sampling_mode.Param<core::param::EnumParam>()->Value() == 0 ||
             _sampling_mode.Param<core::param::EnumParam>()->Value() == 3 ||
             _sampling_mode.Param<core::param::EnumParam>()->Value() == 4 ||
@@ -353,6 +378,17 @@ bool SampleAlongPobes::getData(core::Call& call) {
                 return false;
             }
         }
+
+        if (use_cache) {
+            core::utility::log::Log::DefaultLog.WriteInfo("[SampleAlongProbes] Resampled %d of %d probes.",
+                static_cast<int>(_probes->getProbeCount()) - _num_reused, static_cast<int>(_probes->getProbeCount()));
+        }
+        if (incremental) {
+            updateCache();
+            _cached_frame_id = meta_data.m_frame_ID;
+        } else {
+            clearCache();
+        }
     }
 
     // put data into probes
@@ -432,6 +468,63 @@ bool SampleAlongPobes::getMetaData(core::Call& call) {
     return true;
 }
 
+size_t SampleAlongPobes::ProbeGeometryHash::operator()(ProbeGeometry const& geometry) const {
+    size_t hash = 0;
+    for (auto const el : geometry) {
+        hash ^= std::hash<uint32_t>()(el) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+SampleAlongPobes::ProbeGeometry SampleAlongPobes::probeGeometry(BaseProbe const& probe) {
+    std::array<float, 8> const values = {probe.m_position[0], probe.m_position[1], probe.m_position[2],
+        probe.m_direction[0], probe.m_direction[1], probe.m_direction[2], probe.m_begin, probe.m_end};
+    ProbeGeometry geometry;
+    std::memcpy(geometry.data(), values.data(), sizeof(values));
+    return geometry;
+}
+
+void SampleAlongPobes::clearCache() {
+    _cached_probes.clear();
+    _cache_lookup.clear();
+}
+
+void SampleAlongPobes::updateCache() {
+    clearCache();
+    if (_probes == nullptr) {
+        return;
+    }
+
+    // the samples are copied, the probes handed out might be modified downstream
+    auto const num_probes = _probes->getProbeCount();
+    _cached_probes.resize(num_probes);
+    _cache_lookup.reserve(num_probes);
+    for (uint32_t i = 0; i < num_probes; ++i) {
+        auto visitor = [this, i](auto&& arg) {
+            using T = std::decay_t<decltype(arg)>;
+            if constexpr (std::is_same_v<T, probe::FloatProbe> || std::is_same_v<T, probe::Vec4Probe> ||
+                          std::is_same_v<T, probe::FloatDistributionProbe>) {
+                T copy;
+                static_cast<BaseProbe&>(copy) = arg;
+                *copy.getSamplingResult() = *arg.getSamplingResult();
+                _cached_probes[i] = std::move(copy);
+                _cache_lookup.emplace(probeGeometry(arg), i);
+            }
+        };
+        std::visit(visitor, _probes->getGenericProbe(i));
+    }
+}
+
+void SampleAlongPobes::setGlobalMinMax(std::vector<float> const& probe_min, std::vector<float> const& probe_max) {
+    float global_min = std::numeric_limits<float>::max();
+    float global_max = -std::numeric_limits<float>::max();
+    for (size_t i = 0; i < probe_min.size(); ++i) {
+        global_min = std::min(global_min, probe_min[i]);
+        global_max = std::max(global_max, probe_max[i]);
+    }
+    _probes->setGlobalMinMax(global_min, global_max);
+}
+
 bool SampleAlongPobes::paramChanged(core::param::ParamSlot& p) {
 
     _trigger_recalc = true;
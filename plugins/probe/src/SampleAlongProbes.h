@@ -11,9 +11,11 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 
+#include "ProbeSampleNeighbors.h"
 #include "geometry_calls/VolumetricDataCall.h"
 #include "kdtree.h"
 #include "mmadios/CallADIOSData.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
@@ -28,6 +30,8 @@
 
 #include <glm/glm.hpp>
 
+#include <unordered_map>
+
 namespace megamol {
 namespace probe {
 
@@ -93,8 +97,30 @@ protected:
     core::param::ParamSlot _vec_param_to_samplex_y;
     core::param::ParamSlot _vec_param_to_samplex_z;
     core::param::ParamSlot _vec_param_to_samplex_w;
+    core::param::ParamSlot _incremental_slot;
 
 private:
+    /** bit patterns of position, direction, begin and end, probes with equal geometry get equal samples */
+    using ProbeGeometry = std::array<uint32_t, 8>;
+
+    struct ProbeGeometryHash {
+        size_t operator()(ProbeGeometry const& geometry) const;
+    };
+
+    static ProbeGeometry probeGeometry(BaseProbe const& probe);
+
+    /** Answers the probe of the previous sampling with the same geometry, nullptr if there is none */
+    template<typename ProbeType>
+    ProbeType const* findCachedProbe(BaseProbe const& probe) const;
+
+    void clearCache();
+
+    /** Keeps a copy of the samples of all probes for the next sampling */
+    void updateCache();
+
+    /** Sets the global min max of the probes to the extremes of the given per probe min max */
+    void setGlobalMinMax(std::vector<float> const& probe_min, std::vector<float> const& probe_max);
+
     template<typename T>
     void doScalarSampling(const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data);
 
@@ -135,112 +161,143 @@ private:
     size_t _old_volume_datahash;
     bool _trigger_recalc;
     bool paramChanged(core::param::ParamSlot& p);
+
+    /** sampled probes of the previous sampling for the incremental mode */
+    std::vector<GenericProbe> _cached_probes;
+    std::unordered_map<ProbeGeometry, size_t, ProbeGeometryHash> _cache_lookup;
+    unsigned int _cached_frame_id;
+    /** number of probes of the last sampling taken from the cache */
+    int32_t _num_reused;
 };
 
 
+template<typename ProbeType>
+ProbeType const* SampleAlongPobes::findCachedProbe(BaseProbe const& probe) const {
+    if (_cache_lookup.empty()) {
+        return nullptr;
+    }
+    auto const it = _cache_lookup.find(probeGeometry(probe));
+    if (it == _cache_lookup.end()) {
+        return nullptr;
+    }
+    return std::get_if<ProbeType>(&_cached_probes[it->second]);
+}
+
+
 template<typename T>
 void SampleAlongPobes::doScalarSampling(
     const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data) {
 
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
+    const auto weighting = this->_weighting.Param<megamol::core::param::EnumParam>()->Value();
 
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    const auto num_probes = static_cast<int32_t>(_probes->getProbeCount());
+    std::vector<float> probe_min(num_probes);
+    std::vector<float> probe_max(num_probes);
+    int32_t num_reused = 0;
 
-        FloatProbe probe;
+#pragma omp parallel
+    {
+        ProbeSampleNeighbors neighbors;
 
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
+#pragma omp for schedule(dynamic, 64) reduction(+ : num_reused)
+        for (int32_t i = 0; i < num_probes; i++) {
 
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
+            FloatProbe probe;
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+            auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe> ||
+                              std::is_same_v<T, probe::FloatDistributionProbe>) {
 
-                _probes->setProbe(i, probe);
+                    probe.m_timestamp = arg.m_timestamp;
+                    probe.m_value_name = arg.m_value_name;
+                    probe.m_position = arg.m_position;
+                    probe.m_direction = arg.m_direction;
+                    probe.m_begin = arg.m_begin;
+                    probe.m_end = arg.m_end;
+                    probe.m_cluster_id = arg.m_cluster_id;
 
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
+                    auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+                    auto radius = 0.5 * sample_step * sample_radius_factor;
+                    probe.m_sample_radius = radius;
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
+                    _probes->setProbe(i, probe);
 
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
+                } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
+                    probe = arg;
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
+                } else {
+                    // unknown/incompatible probe type, throw error? do nothing?
+                }
+            };
 
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+            auto generic_probe = _probes->getGenericProbe(i);
+            std::visit(visitor, generic_probe);
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float min_data = std::numeric_limits<float>::max();
-        float max_data = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+            auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+            auto radius = 0.5 * sample_step * sample_radius_factor;
 
-        for (int j = 0; j < samples_per_probe; j++) {
+            std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
 
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
-
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
+            if (auto cached = findCachedProbe<FloatProbe>(probe)) {
+                *samples = *cached->getSamplingResult();
+                probe_min[i] = samples->min_value;
+                probe_max[i] = samples->max_value;
+                ++num_reused;
+                continue;
             }
 
-            // accumulate values
-            float value = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                auto distance_weight = k_distances[n] / radius;
-                value += data[k_indices[n]] * distance_weight;
-                min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
-                max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
-            } // end num_neighbors
-            value /= num_neighbors;
-            if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-                samples->samples[j] = value;
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = -std::numeric_limits<float>::max();
+            float min_data = std::numeric_limits<float>::max();
+            float max_data = -std::numeric_limits<float>::max();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
+
+            neighbors.setProbe(*tree, probe.m_position, probe.m_direction, sample_step, radius, samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; j++) {
+
+                auto num_neighbors = neighbors.query(j);
+                auto const& k_indices = neighbors.indices();
+                auto const& k_distances = neighbors.distances();
+
+                // accumulate values
+                float value = 0;
+                for (int n = 0; n < num_neighbors; n++) {
+                    auto distance_weight = k_distances[n] / radius;
+                    value += data[k_indices[n]] * distance_weight;
+                    min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
+                    max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
+                } // end num_neighbors
+                value /= num_neighbors;
+                if (weighting == 0) {
+                    samples->samples[j] = value;
+                } else {
+                    samples->samples[j] = max_data;
+                }
+                min_value = std::min(min_value, value);
+                max_value = std::max(max_value, value);
+                avg_value += value;
+            } // end num samples per probe
+            avg_value /= samples_per_probe;
+            if (weighting == 0) {
+                samples->average_value = avg_value;
+                samples->max_value = max_value;
+                samples->min_value = min_value;
             } else {
-                samples->samples[j] = max_data;
+                samples->average_value = max_data;
+                samples->max_value = max_data;
+                samples->min_value = max_data;
             }
-            min_value = std::min(min_value, value);
-            max_value = std::max(max_value, value);
-            avg_value += value;
-        } // end num samples per probe
-        avg_value /= samples_per_probe;
-        if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-            samples->average_value = avg_value;
-            samples->max_value = max_value;
-            samples->min_value = min_value;
-        } else {
-            samples->average_value = max_data;
-            samples->max_value = max_data;
-            samples->min_value = max_data;
-        }
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
-    } // end for probes
-    _probes->setGlobalMinMax(global_min, global_max);
+            probe_min[i] = samples->min_value;
+            probe_max[i] = samples->max_value;
+        } // end for probes
+    }
+    setGlobalMinMax(probe_min, probe_max);
+    _num_reused = num_reused;
 }
 
 template<typename T>
@@ -250,92 +307,104 @@ inline void SampleAlongPobes::doScalarDistributionSampling(
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    const auto num_probes = static_cast<int32_t>(_probes->getProbeCount());
+    std::vector<float> probe_min(num_probes);
+    std::vector<float> probe_max(num_probes);
+    int32_t num_reused = 0;
 
-        FloatDistributionProbe probe;
+#pragma omp parallel
+    {
+        ProbeSampleNeighbors neighbors;
 
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
-                          std::is_same_v<T, probe::Vec4Probe>) {
+#pragma omp for schedule(dynamic, 64) reduction(+ : num_reused)
+        for (int32_t i = 0; i < num_probes; i++) {
 
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
+            FloatDistributionProbe probe;
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = 0.5 * sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+            auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
+                              std::is_same_v<T, probe::Vec4Probe>) {
 
-                _probes->setProbe(i, probe);
+                    probe.m_timestamp = arg.m_timestamp;
+                    probe.m_value_name = arg.m_value_name;
+                    probe.m_position = arg.m_position;
+                    probe.m_direction = arg.m_direction;
+                    probe.m_begin = arg.m_begin;
+                    probe.m_end = arg.m_end;
+                    probe.m_cluster_id = arg.m_cluster_id;
 
-            } else if constexpr (std::is_same_v<T, probe::FloatDistributionProbe>) {
-                probe = arg;
+                    auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+                    auto radius = 0.5 * sample_step * sample_radius_factor;
+                    probe.m_sample_radius = radius;
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
+                    _probes->setProbe(i, probe);
 
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
+                } else if constexpr (std::is_same_v<T, probe::FloatDistributionProbe>) {
+                    probe = arg;
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = 0.5 * sample_step * sample_radius_factor;
+                } else {
+                    // unknown/incompatible probe type, throw error? do nothing?
+                }
+            };
 
-        std::shared_ptr<FloatDistributionProbe::SamplingResult> samples = probe.getSamplingResult();
+            auto generic_probe = _probes->getGenericProbe(i);
+            std::visit(visitor, generic_probe);
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = std::numeric_limits<float>::min();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+            auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+            auto radius = 0.5 * sample_step * sample_radius_factor;
 
-        for (int j = 0; j < samples_per_probe; j++) {
+            std::shared_ptr<FloatDistributionProbe::SamplingResult> samples = probe.getSamplingResult();
 
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
+            if (auto cached = findCachedProbe<FloatDistributionProbe>(probe)) {
+                *samples = *cached->getSamplingResult();
+                probe_min[i] = samples->min_value;
+                probe_max[i] = samples->max_value;
+                ++num_reused;
+                continue;
+            }
 
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
+            float min_value = std::numeric_limits<float>::max();
+            float max_value = std::numeric_limits<float>::min();
+            float avg_value = 0.0f;
+            samples->samples.resize(samples_per_probe);
 
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
+            neighbors.setProbe(*tree, probe.m_position, probe.m_direction, sample_step, radius, samples_per_probe);
 
-            // accumulate values
-            float value = 0.0f;
-            float min_data = std::numeric_limits<float>::max();
-            float max_data = std::numeric_limits<float>::min();
-            for (int n = 0; n < num_neighbors; n++) {
-                value += data[k_indices[n]];
-                min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
-                max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
-            } // end num_neighbors
-            value /= num_neighbors;
-
-            samples->samples[j].mean = value;
-            samples->samples[j].lower_bound = min_data;
-            samples->samples[j].upper_bound = max_data;
-
-            min_value = std::min(min_value, min_data);
-            max_value = std::max(max_value, max_data);
-            avg_value += value;
-        } // end num samples per probe
+            for (int j = 0; j < samples_per_probe; j++) {
 
-        global_min = std::min(global_min, min_value);
-        global_max = std::max(global_max, max_value);
-    } // end for probes
-    _probes->setGlobalMinMax(global_min, global_max);
+                auto num_neighbors = neighbors.query(j);
+                auto const& k_indices = neighbors.indices();
+
+                // accumulate values
+                float value = 0.0f;
+                float min_data = std::numeric_limits<float>::max();
+                float max_data = std::numeric_limits<float>::min();
+                for (int n = 0; n < num_neighbors; n++) {
+                    value += data[k_indices[n]];
+                    min_data = std::min(min_data, static_cast<float>(data[k_indices[n]]));
+                    max_data = std::max(max_data, static_cast<float>(data[k_indices[n]]));
+                } // end num_neighbors
+                value /= num_neighbors;
+
+                samples->samples[j].mean = value;
+                samples->samples[j].lower_bound = min_data;
+                samples->samples[j].upper_bound = max_data;
+
+                min_value = std::min(min_value, min_data);
+                max_value = std::max(max_value, max_data);
+                avg_value += value;
+            } // end num samples per probe
+
+            samples->average_value = avg_value / samples_per_probe;
+            samples->min_value = min_value;
+            samples->max_value = max_value;
+            probe_min[i] = min_value;
+            probe_max[i] = max_value;
+        } // end for probes
+    }
+    setGlobalMinMax(probe_min, probe_max);
+    _num_reused = num_reused;
 }
 
 template<typename T>
@@ -346,98 +415,90 @@ inline void SampleAlongPobes::doVectorSamling(const std::shared_ptr<pcl::KdTreeF
     const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
     const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
 
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    const auto num_probes = static_cast<int32_t>(_probes->getProbeCount());
+    int32_t num_reused = 0;
 
-        Vec4Probe probe;
+#pragma omp parallel
+    {
+        ProbeSampleNeighbors neighbors;
 
-        auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
-                          std::is_same_v<T, probe::FloatDistributionProbe>) {
+#pragma omp for schedule(dynamic, 64) reduction(+ : num_reused)
+        for (int32_t i = 0; i < num_probes; i++) {
 
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-                probe.m_cluster_id = arg.m_cluster_id;
+            Vec4Probe probe;
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+            auto visitor = [&probe, i, samples_per_probe, sample_radius_factor, this](auto&& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe> ||
+                              std::is_same_v<T, probe::FloatDistributionProbe>) {
 
-                _probes->setProbe(i, probe);
+                    probe.m_timestamp = arg.m_timestamp;
+                    probe.m_value_name = arg.m_value_name;
+                    probe.m_position = arg.m_position;
+                    probe.m_direction = arg.m_direction;
+                    probe.m_begin = arg.m_begin;
+                    probe.m_end = arg.m_end;
+                    probe.m_cluster_id = arg.m_cluster_id;
 
-            } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
-                probe = arg;
+                    auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+                    auto radius = sample_step * sample_radius_factor;
+                    probe.m_sample_radius = radius;
 
-                auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-                auto radius = sample_step * sample_radius_factor;
-                probe.m_sample_radius = radius;
+                    _probes->setProbe(i, probe);
 
-                _probes->setProbe(i, probe);
+                } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
+                    probe = arg;
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
+                    auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+                    auto radius = sample_step * sample_radius_factor;
+                    probe.m_sample_radius = radius;
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = sample_step * sample_radius_factor;
-
-        std::shared_ptr<Vec4Probe::SamplingResult> samples = probe.getSamplingResult();
+                    _probes->setProbe(i, probe);
 
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
+                } else {
+                    // unknown/incompatible probe type, throw error? do nothing?
+                }
+            };
 
-        for (int j = 0; j < samples_per_probe; j++) {
+            auto generic_probe = _probes->getGenericProbe(i);
+            std::visit(visitor, generic_probe);
 
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
+            auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
+            auto radius = sample_step * sample_radius_factor;
 
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
+            std::shared_ptr<Vec4Probe::SamplingResult> samples = probe.getSamplingResult();
 
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
+            if (auto cached = findCachedProbe<Vec4Probe>(probe)) {
+                *samples = *cached->getSamplingResult();
+                ++num_reused;
+                continue;
             }
 
-
-            // accumulate values
-            float value_x = 0, value_y = 0, value_z = 0, value_w = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                value_x += data_x[k_indices[n]];
-                value_y += data_y[k_indices[n]];
-                value_z += data_z[k_indices[n]];
-                value_w += data_w[k_indices[n]];
-            } // end num_neighbors
-            samples->samples[j][0] = value_x / num_neighbors;
-            ;
-            samples->samples[j][1] = value_y / num_neighbors;
-            ;
-            samples->samples[j][2] = value_z / num_neighbors;
-            ;
-            samples->samples[j][3] = value_w / num_neighbors;
-            ;
-            //min_value = std::min(min_value, value);
-            //max_value = std::max(max_value, value);
-            //avg_value += value;
-        } // end num samples per probe
-        //avg_value /= samples_per_probe;
-        //samples->average_value = avg_value;
-        //samples->max_value = max_value;
-        //samples->min_value = min_value;
-    } // end for probes
+            samples->samples.resize(samples_per_probe);
+
+            neighbors.setProbe(*tree, probe.m_position, probe.m_direction, sample_step, radius, samples_per_probe);
+
+            for (int j = 0; j < samples_per_probe; j++) {
+
+                auto num_neighbors = neighbors.query(j);
+                auto const& k_indices = neighbors.indices();
+
+                // accumulate values
+                float value_x = 0, value_y = 0, value_z = 0, value_w = 0;
+                for (int n = 0; n < num_neighbors; n++) {
+                    value_x += data_x[k_indices[n]];
+                    value_y += data_y[k_indices[n]];
+                    value_z += data_z[k_indices[n]];
+                    value_w += data_w[k_indices[n]];
+                } // end num_neighbors
+                samples->samples[j][0] = value_x / num_neighbors;
+                samples->samples[j][1] = value_y / num_neighbors;
+                samples->samples[j][2] = value_z / num_neighbors;
+                samples->samples[j][3] = value_w / num_neighbors;
+            } // end num samples per probe
+        } // end for probes
+    }
+    _num_reused = num_reused;
 }
 
 
@@ -766,7 +827,8 @@ void SampleAlongPobes::doNearestNeighborSampling(
 
     float global_min = std::numeric_limits<float>::max();
     float global_max = std::numeric_limits<float>::lowest();
-    //#pragma omp parallel for
+    int32_t num_reused = 0;
+    // point location in the triangulation is not thread safe
     for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); ++i) {
 
         FloatProbe probe;
@@ -806,6 +868,14 @@ void SampleAlongPobes::doNearestNeighborSampling(
 
         std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
 
+        if (auto cached = findCachedProbe<FloatProbe>(probe)) {
+            *samples = *cached->getSamplingResult();
+            global_min = std::min(global_min, samples->min_value);
+            global_max = std::max(global_max, samples->max_value);
+            ++num_reused;
+            continue;
+        }
+
         float min_value = std::numeric_limits<float>::max();
         float max_value = std::numeric_limits<float>::lowest();
         /*float min_data = std::numeric_limits<float>::max();
@@ -836,19 +906,14 @@ void SampleAlongPobes::doNearestNeighborSampling(
         } // end num samples per probe
 
         avg_value /= samples_per_probe;
-        /*if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
-            samples->average_value = avg_value;
-            samples->max_value = max_value;
-            samples->min_value = min_value;
-        } else {
-            samples->average_value = max_data;
-            samples->max_value = max_data;
-            samples->min_value = max_data;
-        }*/
+        samples->average_value = avg_value;
+        samples->max_value = max_value;
+        samples->min_value = min_value;
         global_min = std::min(global_min, samples->min_value);
         global_max = std::max(global_max, samples->max_value);
     } // end for probes
     _probes->setGlobalMinMax(global_min, global_max);
+    _num_reused = num_reused;
 }
 
 template<typename T>
@@ -860,10 +925,15 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
     glm::vec3 spacing = {*_vol_metadata->SliceDists[0], *_vol_metadata->SliceDists[1], *_vol_metadata->SliceDists[2]};
     float min_spacing = std::min(std::min(spacing.x, spacing.y), spacing.z);
 
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    const auto weighting = this->_weighting.Param<megamol::core::param::EnumParam>()->Value();
+
+    const auto num_probes = static_cast<int32_t>(_probes->getProbeCount());
+    std::vector<float> probe_min(num_probes);
+    std::vector<float> probe_max(num_probes);
+    int32_t num_reused = 0;
+    int32_t num_non_finite = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : num_reused, num_non_finite)
+    for (int32_t i = 0; i < num_probes; i++) {
 
         FloatProbe probe;
 
@@ -910,6 +980,15 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
         }
 
         std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+
+        if (auto cached = findCachedProbe<FloatProbe>(probe)) {
+            *samples = *cached->getSamplingResult();
+            probe_min[i] = samples->min_value;
+            probe_max[i] = samples->max_value;
+            ++num_reused;
+            continue;
+        }
+
         float min_value = std::numeric_limits<float>::max();
         float max_value = -std::numeric_limits<float>::max();
         float min_data = std::numeric_limits<float>::max();
@@ -959,7 +1038,7 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
             }
             if (value != 0)
                 value /= num_samples;
-            if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
+            if (weighting == 0) {
                 samples->samples[j] = value;
             } else {
                 samples->samples[j] = max_data;
@@ -971,9 +1050,9 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
         if (avg_value != 0)
             avg_value /= samples_per_probe;
         if (!std::isfinite(avg_value)) {
-            core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
+            ++num_non_finite;
         }
-        if (this->_weighting.Param<megamol::core::param::EnumParam>()->Value() == 0) {
+        if (weighting == 0) {
             samples->average_value = avg_value;
             samples->max_value = max_value;
             samples->min_value = min_value;
@@ -982,10 +1061,15 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeRadiusSampling(T* data) {
             samples->max_value = max_data;
             samples->min_value = max_data;
         }
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
+        probe_min[i] = samples->min_value;
+        probe_max[i] = samples->max_value;
     } // end for probes
-    _probes->setGlobalMinMax(global_min, global_max);
+    if (num_non_finite > 0) {
+        core::utility::log::Log::DefaultLog.WriteError(
+            "[SampleAlongProbes] Non-finite value in %d sampled probes.", num_non_finite);
+    }
+    setGlobalMinMax(probe_min, probe_max);
+    _num_reused = num_reused;
 }
 
 template<typename T>
@@ -997,10 +1081,13 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeTrilinSampling(T* data) {
     glm::vec3 spacing = {*_vol_metadata->SliceDists[0], *_vol_metadata->SliceDists[1], *_vol_metadata->SliceDists[2]};
     float min_spacing = std::min(std::min(spacing.x, spacing.y), spacing.z);
 
-    float global_min = std::numeric_limits<float>::max();
-    float global_max = -std::numeric_limits<float>::max();
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
+    const auto num_probes = static_cast<int32_t>(_probes->getProbeCount());
+    std::vector<float> probe_min(num_probes);
+    std::vector<float> probe_max(num_probes);
+    int32_t num_reused = 0;
+    int32_t num_non_finite = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+ : num_reused, num_non_finite)
+    for (int32_t i = 0; i < num_probes; i++) {
 
         FloatProbe probe;
 
@@ -1036,6 +1123,15 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeTrilinSampling(T* data) {
         auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
 
         std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+
+        if (auto cached = findCachedProbe<FloatProbe>(probe)) {
+            *samples = *cached->getSamplingResult();
+            probe_min[i] = samples->min_value;
+            probe_max[i] = samples->max_value;
+            ++num_reused;
+            continue;
+        }
+
         float min_value = std::numeric_limits<float>::max();
         float max_value = -std::numeric_limits<float>::max();
         float avg_value = 0.0f;
@@ -1107,17 +1203,22 @@ void SampleAlongPobes::SampleAlongPobes::doVolumeTrilinSampling(T* data) {
         if (avg_value != 0)
             avg_value /= samples_per_probe;
         if (!std::isfinite(avg_value)) {
-            core::utility::log::Log::DefaultLog.WriteError("[SampleAlongProbes] Non-finite value in sampled.");
+            ++num_non_finite;
         }
 
         samples->average_value = avg_value;
         samples->max_value = max_value;
         samples->min_value = min_value;
 
-        global_min = std::min(global_min, samples->min_value);
-        global_max = std::max(global_max, samples->max_value);
+        probe_min[i] = samples->min_value;
+        probe_max[i] = samples->max_value;
     } // end for probes
-    _probes->setGlobalMinMax(global_min, global_max);
+    if (num_non_finite > 0) {
+        core::utility::log::Log::DefaultLog.WriteError(
+            "[SampleAlongProbes] Non-finite value in %d sampled probes.", num_non_finite);
+    }
+    setGlobalMinMax(probe_min, probe_max);
+    _num_reused = num_reused;
 }
 
 
@@ -22,10 +22,13 @@
 #include "vislib/math/mathfunctions.h"
 #include "vislib/sys/sysfunctions.h"
 #include "vislib/types.h"
+#include <algorithm>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #define SFB716DEMO
 #define DARKER_COLORS
@@ -421,7 +424,6 @@ void PDBLoader::Frame::encodebits(char* outbuff, int bitsize, int bitoffset, uns
  */
 void PDBLoader::Frame::readFrame(std::fstream* file) {
 
-    int* buffer;
     char* buffPt;
     int thiscoord[3], prevcoord[3], tempCoord;
     int run = 0;
@@ -548,12 +550,14 @@ void PDBLoader::Frame::readFrame(std::fstream* file) {
     file->read((char*)&size, 4);
     changeByteOrder((char*)&size);
 
-    buffer = new int[(int)(atomCount * 3 * 1.2)];
+    // the decoder may look at a few bytes past the end of the block, several loader threads decode concurrently,
+    // so every call has its own buffer
+    std::vector<int> buffer(std::max<size_t>(static_cast<size_t>(atomCount * 3 * 1.2), (size + 3) / 4) + 4, 0);
 
     // get the compressed data-block
-    file->read((char*)&buffer[0], size);
+    file->read((char*)buffer.data(), size);
 
-    buffPt = (char*)buffer;
+    buffPt = (char*)buffer.data();
     bit_offset = 0;
 
 
@@ -673,8 +677,6 @@ void PDBLoader::Frame::readFrame(std::fstream* file) {
         sizesmall[0] = sizesmall[1] = sizesmall[2] = magicints[smallidx];
     }
 
-    delete[] buffer;
-
     // set file pointer to the beginning of the next frame
     file->seekg((4 - size % 4) % 4, std::ios_base::cur);
 }
@@ -740,12 +742,15 @@ PDBLoader::PDBLoader(void)
         , calcBondsSlot("calculateBonds", "Calculate covalent bonds when loading the file")
         , recomputeStridePerFrameSlot(
               "recomputeSTRIDEeachFrame", "If STRIDE is used, should it be recomputed each frame?")
+        , loaderThreadsSlot("loaderThreads", "Number of threads decoding XTC frames in parallel")
+        , xtcIndexSlot("useXTCIndex", "Store the XTC frame index next to the trajectory and reuse it")
         , bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)
         , datahash(0)
         , stride(0)
         , secStructAvailable(false)
         , numXTCFrames(0)
-        , XTCFrameOffset(0)
+        , xtcIndex()
+        , xtcPath()
         , xtcFileValid(false) {
 
     this->pdbFilenameSlot << new param::FilePathParam("");
@@ -784,6 +789,13 @@ PDBLoader::PDBLoader(void)
     this->recomputeStridePerFrameSlot << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->recomputeStridePerFrameSlot);
 
+    this->loaderThreadsSlot << new param::IntParam(
+        static_cast<int>(vislib::math::Clamp(std::thread::hardware_concurrency(), 1U, 4U)), 1);
+    this->MakeSlotAvailable(&this->loaderThreadsSlot);
+
+    this->xtcIndexSlot << new param::BoolParam(true);
+    this->MakeSlotAvailable(&this->xtcIndexSlot);
+
     mdd = NULL; // no mdd object
 }
 
@@ -827,9 +839,12 @@ bool PDBLoader::getData(core::Call& call) {
             this->capFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str());
     }
 
-    if (this->pdbFilenameSlot.IsDirty() || this->solventResidues.IsDirty()) {
+    if (this->pdbFilenameSlot.IsDirty() || this->solventResidues.IsDirty() || this->loaderThreadsSlot.IsDirty() ||
+        this->xtcIndexSlot.IsDirty()) {
         this->pdbFilenameSlot.ResetDirty();
         this->solventResidues.ResetDirty();
+        this->loaderThreadsSlot.ResetDirty();
+        this->xtcIndexSlot.ResetDirty();
         this->loadFile(this->pdbFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str());
         this->pdbfilename =
             this->pdbFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str();
@@ -969,9 +984,12 @@ bool PDBLoader::getExtent(core::Call& call) {
             this->capFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str());
     }
 
-    if (this->pdbFilenameSlot.IsDirty() || this->solventResidues.IsDirty()) {
+    if (this->pdbFilenameSlot.IsDirty() || this->solventResidues.IsDirty() || this->loaderThreadsSlot.IsDirty() ||
+        this->xtcIndexSlot.IsDirty()) {
         this->pdbFilenameSlot.ResetDirty();
         this->solventResidues.ResetDirty();
+        this->loaderThreadsSlot.ResetDirty();
+        this->xtcIndexSlot.ResetDirty();
         this->loadFile(this->pdbFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str());
         this->pdbfilename =
             this->pdbFilenameSlot.Param<core::param::FilePathParam>()->Value().generic_u8string().c_str();
@@ -1054,11 +1072,12 @@ void PDBLoader::loadFrame(view::AnimDataModule::Frame* frame, unsigned int idx)
                                 data[0]->AtomPositions()[i+2]);
         }
     } else {*/
+    // called by several loader threads at once, each one reads through its own stream
     std::fstream xtcFile;
 
-    xtcFile.open(this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
+    xtcFile.open(this->xtcPath, std::ios::in | std::ios::binary);
 
-    xtcFile.seekg(this->XTCFrameOffset[idx]);
+    xtcFile.seekg(static_cast<std::streamoff>(this->xtcIndex[idx].offset));
 
     fr->readFrame(&xtcFile);
 
@@ -1384,51 +1403,24 @@ void PDBLoader::loadFile(const vislib::TString& filename) {
     } else {
         // try to get the total number of frames and calculate the
         // bounding box
-        this->readNumXTCFrames();
-
-        Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Number of XTC-frames: %u", this->numXTCFrames); // DEBUG
-
-        //float box[3][3];
-        char tmpByte;
-        std::fstream xtcFile;
-        char* num;
-        unsigned int nAtoms;
-
-        // try to open the xtc-file
-        xtcFile.open(
-            this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
-
-        if (!xtcFile) {
+        this->xtcPath = this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value();
+        if (!this->readNumXTCFrames()) {
             Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR,
                 "Could not load XTC-file."); // DEBUG
             xtcFileValid = false;
         } else {
-
-
-            xtcFile.seekg(4, std::ios_base::cur);
-            // read number of atoms
-            xtcFile.read((char*)&nAtoms, 4);
-            // change byte order
-            num = (char*)&nAtoms;
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
+            Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Number of XTC-frames: %u", this->numXTCFrames); // DEBUG
 
             // check whether the pdb-file and the xtc-file contain the
             // same number of atoms
+            const unsigned int nAtoms = this->xtcIndex.AtomCount();
             if (nAtoms != atomEntries.Count()) {
                 Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR,
                     "XTC-File and given PDB-file not matching (XTC-file has"
                     "%i atom entries, PDB-file has %i atom entries).",
                     nAtoms, atomEntries.Count()); // DEBUG
                 xtcFileValid = false;
-                xtcFile.close();
             } else {
-                xtcFile.close();
-
                 xtcFileValid = true;
 
                 int maxFrames = vislib::math::Min<int>(
@@ -1437,6 +1429,10 @@ void PDBLoader::loadFile(const vislib::TString& filename) {
                 // frames in xtc-file - 1 (without the last frame)
                 this->setFrameCount(this->numXTCFrames);
 
+                // decode the frames in parallel, loadFrame opens its own stream per call
+                this->setLoaderThreadCount(
+                    static_cast<unsigned int>(this->loaderThreadsSlot.Param<core::param::IntParam>()->Value()));
+
                 // start the loading thread
                 this->initFrameCache(maxFrames);
             }
@@ -2044,7 +2040,6 @@ void PDBLoader::resetAllData() {
 
 /*
  * Read the number of frames from the XTC file and update the bounding box.
- * The Last frame contains wrong byte ordering and therefore gets ignored.
  */
 bool PDBLoader::readNumXTCFrames() {
 
@@ -2052,120 +2047,33 @@ bool PDBLoader::readNumXTCFrames() {
 
     // reset values
     this->numXTCFrames = 0;
-    this->XTCFrameOffset.Clear();
-
-    // try to open xtc file
-    std::fstream xtcFile;
-    xtcFile.open(this->xtcFilenameSlot.Param<core::param::FilePathParam>()->Value(), std::ios::in | std::ios::binary);
 
-    // check if file could be opened
-    if (!xtcFile)
+    // the index comes from the sidecar file if the trajectory did not change since it was written
+    if (!this->xtcIndex.Load(this->xtcPath, this->xtcIndexSlot.Param<core::param::BoolParam>()->Value()) ||
+        this->xtcIndex.Count() == 0) {
         return false;
+    }
 
-    this->XTCFrameOffset.SetCapacityIncrement(1000);
-    int size;
-    char tmpByte;
-    char* num;
-
-    int minint[3];
-    int maxint[3];
-
-    unsigned int i;
-
-    float precision;
-
-    xtcFile.seekg(0, std::ios_base::beg);
-
-    vislib::math::Cuboid<float> tmpBBox(this->bbox);
-
-    //std::fstream::iostate st = 0;
-
-    // get length of file:
-    xtcFile.seekg(0, xtcFile.end);
-    int xtcFileLength = (int)xtcFile.tellg();
-    xtcFile.seekg(0, xtcFile.beg);
-
-    // read until eof
-    while (!xtcFile.eof() && xtcFile.tellg() < xtcFileLength) {
-        // add the offset to the offset array
-        this->XTCFrameOffset.Add((unsigned int)xtcFile.tellg());
-
-        // skip some header data
-        xtcFile.seekg(56, std::ios_base::cur);
-        // read precision
-        xtcFile.read((char*)&precision, 4);
-        // change byte-order
-        num = (char*)&precision;
-        tmpByte = num[0];
-        num[0] = num[3];
-        num[3] = tmpByte;
-        tmpByte = num[1];
-        num[1] = num[2];
-        num[2] = tmpByte;
-        precision /= 10.0f;
-
-        // get the lower bound
-        xtcFile.read((char*)&minint, 12);
-        // get the upper bound
-        xtcFile.read((char*)&maxint, 12);
-        // change byte-order
-        for (i = 0; i < 3; i++) {
-            num = (char*)&minint[i];
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
-            num = (char*)&maxint[i];
-            tmpByte = num[0];
-            num[0] = num[3];
-            num[3] = tmpByte;
-            tmpByte = num[1];
-            num[1] = num[2];
-            num[2] = tmpByte;
-        }
+    // the index already ignores a truncated last frame
+    this->numXTCFrames = static_cast<unsigned int>(this->xtcIndex.Count());
 
-        // update the bounding box by uniting it with the last frames box
-        this->bbox.Union(tmpBBox);
+    // the per frame boxes replace the ones of the PDB frames, which only hold the first frame
+    const bool perFrame = this->calcBBoxPerFrameSlot.Param<core::param::BoolParam>()->Value();
+    if (perFrame) {
+        this->bboxPerFrame.SetCount(vislib::math::Max(1U, this->numXTCFrames));
+    }
+    for (unsigned int i = 0; i < this->numXTCFrames; i++) {
+        const auto& info = this->xtcIndex[i];
         // get the current frames bounding box including the atom radius
         // note: atom radius is divided by 10
-        tmpBBox = vislib::math::Cuboid<float>((float)minint[0] / precision - 0.3f, (float)minint[1] / precision - 0.3f,
-            (float)minint[2] / precision - 0.3f,
-
-            (float)maxint[0] / precision + 0.3f, (float)maxint[1] / precision + 0.3f,
-            (float)maxint[2] / precision + 0.3f);
-
-        // skip some header data
-        xtcFile.seekg(4, std::ios_base::cur);
-
-        // read size of the compressed block of data
-        xtcFile.read((char*)&size, 4);
-        // change byte-order
-        num = (char*)&size;
-        tmpByte = num[0];
-        num[0] = num[3];
-        num[3] = tmpByte;
-        tmpByte = num[1];
-        num[1] = num[2];
-        num[2] = tmpByte;
-
-        // skip the compressed block of data except for the last byte and
-        // ignore the remaining bytes to prevent skipping over the end
-        // of the file
-        xtcFile.seekg(size - 1, std::ios_base::cur);
-        xtcFile.ignore(((4 - size % 4) % 4) + 1);
-
-        // add this frame to the frame count
-        this->numXTCFrames++;
-        //st = xtcFile.rdstate();
-        xtcFile.rdstate();
+        vislib::math::Cuboid<float> frameBBox(info.minimum[0] - 0.3f, info.minimum[1] - 0.3f, info.minimum[2] - 0.3f,
+            info.maximum[0] + 0.3f, info.maximum[1] + 0.3f, info.maximum[2] + 0.3f);
+        // update the bounding box by uniting it with the frames box
+        this->bbox.Union(frameBBox);
+        if (perFrame) {
+            this->bboxPerFrame[i] = frameBBox;
+        }
     }
-    xtcFile.close();
-
-    // remove the last frame
-    this->XTCFrameOffset.RemoveLast();
-    this->numXTCFrames--;
 
     megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO,
         "Time for parsing the XTC-file: %f",
@@ -14,6 +14,7 @@
 #include "MDDriverConnector.h"
 #include "MultiPDBLoader.h"
 #include "Stride.h"
+#include "XTCFrameIndex.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
@@ -24,6 +25,7 @@
 #include "vislib/Array.h"
 #include "vislib/math/Cuboid.h"
 #include "vislib/math/Vector.h"
+#include <filesystem>
 #include <fstream>
 
 #ifdef WITH_CURL
@@ -681,6 +683,10 @@ private:
     core::param::ParamSlot calcBondsSlot;
     /** Determine whether to recompute STRIDE each frame */
     core::param::ParamSlot recomputeStridePerFrameSlot;
+    /** The number of threads decoding XTC frames in parallel */
+    core::param::ParamSlot loaderThreadsSlot;
+    /** Determine whether to store the XTC frame index next to the trajectory */
+    core::param::ParamSlot xtcIndexSlot;
 
     /** The data */
     vislib::Array<Frame*> data;
@@ -748,8 +754,10 @@ private:
 
     /** the number of frames */
     unsigned int numXTCFrames;
-    /** the byte offset of all frames */
-    vislib::Array<unsigned int> XTCFrameOffset;
+    /** the byte offset and header data of all frames */
+    XTCFrameIndex xtcIndex;
+    /** the xtc file of 'xtcIndex', read by the loader threads instead of the parameter */
+    std::filesystem::path xtcPath;
     /** Flag whether the current xtc-filename is valid */
     bool xtcFileValid;
 
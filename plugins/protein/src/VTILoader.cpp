@@ -254,6 +254,8 @@ bool VTILoader::getExtent(core::Call& call) {
     if (fr == NULL) {
         return false;
     }
+    // The frame is not handed out to the caller, so release it right away
+    fr->Unlock();
 
     // Set frame count
     dc->SetFrameCount(
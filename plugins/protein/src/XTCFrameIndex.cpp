@@ -0,0 +1,286 @@
+/*
+ * XTCFrameIndex.cpp
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "XTCFrameIndex.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::protein;
+
+namespace {
+
+/** Magic number of every XTC frame */
+const int32_t XTC_MAGIC = 1995;
+
+/** Bytes of the frame header up to and including the second atom count */
+const size_t XTC_HEADER_SIZE = 56;
+
+/** Bytes of the header of the compressed coordinates up to and including the size of the compressed block */
+const size_t XTC_COMPRESSED_HEADER_SIZE = 36;
+
+const char SIDECAR_MAGIC[8] = {'M', 'M', 'X', 'T', 'C', 'I', 'D', 'X'};
+const uint32_t SIDECAR_VERSION = 1;
+
+/** XDR is big endian */
+inline uint32_t readBE32(const unsigned char* src) {
+    return (static_cast<uint32_t>(src[0]) << 24) | (static_cast<uint32_t>(src[1]) << 16) |
+           (static_cast<uint32_t>(src[2]) << 8) | static_cast<uint32_t>(src[3]);
+}
+
+inline int32_t readBEInt(const unsigned char* src) {
+    return static_cast<int32_t>(readBE32(src));
+}
+
+inline float readBEFloat(const unsigned char* src) {
+    const uint32_t bits = readBE32(src);
+    float f;
+    std::memcpy(&f, &bits, sizeof(float));
+    return f;
+}
+
+} // namespace
+
+
+/*
+ * XTCFrameIndex::XTCFrameIndex
+ */
+XTCFrameIndex::XTCFrameIndex(void) : atomCount(0), frames() {
+    // intentionally empty
+}
+
+
+/*
+ * XTCFrameIndex::Load
+ */
+bool XTCFrameIndex::Load(const std::filesystem::path& trajectory, bool useSidecar) {
+    using megamol::core::utility::log::Log;
+
+    this->Clear();
+
+    Stamp stamp;
+    if (!stampOf(trajectory, stamp)) {
+        return false;
+    }
+
+    const auto sidecar = SidecarPath(trajectory);
+    if (useSidecar && this->readSidecar(sidecar, stamp)) {
+        Log::DefaultLog.WriteInfo("Using the XTC frame index \"%s\" (%zu frames).", sidecar.generic_u8string().c_str(),
+            this->frames.size());
+        return true;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!this->scan(trajectory)) {
+        this->Clear();
+        return false;
+    }
+    Log::DefaultLog.WriteInfo("Indexed %zu XTC frames in %.2f s.", this->frames.size(),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    if (useSidecar && !this->writeSidecar(sidecar, stamp)) {
+        Log::DefaultLog.WriteWarn("Could not write the XTC frame index \"%s\", the trajectory will be scanned again "
+                                  "next time.",
+            sidecar.generic_u8string().c_str());
+    }
+    return true;
+}
+
+
+/*
+ * XTCFrameIndex::Clear
+ */
+void XTCFrameIndex::Clear(void) {
+    this->atomCount = 0;
+    this->frames.clear();
+}
+
+
+/*
+ * XTCFrameIndex::SidecarPath
+ */
+std::filesystem::path XTCFrameIndex::SidecarPath(const std::filesystem::path& trajectory) {
+    auto res = trajectory;
+    res += ".mmxtci";
+    return res;
+}
+
+
+/*
+ * XTCFrameIndex::stampOf
+ */
+bool XTCFrameIndex::stampOf(const std::filesystem::path& trajectory, Stamp& outStamp) {
+    std::error_code ec;
+    outStamp.size = static_cast<uint64_t>(std::filesystem::file_size(trajectory, ec));
+    if (ec) {
+        return false;
+    }
+    outStamp.modified =
+        static_cast<int64_t>(std::filesystem::last_write_time(trajectory, ec).time_since_epoch().count());
+    return !ec;
+}
+
+
+/*
+ * XTCFrameIndex::scan
+ */
+bool XTCFrameIndex::scan(const std::filesystem::path& trajectory) {
+    std::ifstream file(trajectory, std::ios::in | std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+
+    unsigned char header[XTC_HEADER_SIZE + XTC_COMPRESSED_HEADER_SIZE];
+    uint64_t offset = 0;
+    while (offset + XTC_HEADER_SIZE <= fileSize) {
+        file.seekg(static_cast<std::streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(header), XTC_HEADER_SIZE) || readBEInt(header) != XTC_MAGIC) {
+            break;
+        }
+        const uint32_t natoms = readBE32(header + 4);
+        if (this->frames.empty()) {
+            this->atomCount = natoms;
+        } else if (natoms != this->atomCount) {
+            break;
+        }
+
+        FrameInfo info{};
+        info.offset = offset;
+        info.step = readBEInt(header + 8);
+        info.time = readBEFloat(header + 12);
+        for (int i = 0; i < 9; ++i) {
+            info.box[i] = readBEFloat(header + 16 + 4 * i);
+        }
+
+        uint64_t frameSize;
+        if (natoms <= 3) {
+            // uncompressed positions in nm
+            frameSize = XTC_HEADER_SIZE + natoms * 12;
+            if (offset + frameSize > fileSize) {
+                break;
+            }
+            unsigned char pos[36];
+            if (!file.read(reinterpret_cast<char*>(pos), natoms * 12)) {
+                break;
+            }
+            for (int d = 0; d < 3; ++d) {
+                info.minimum[d] = natoms > 0 ? std::numeric_limits<float>::max() : 0.0f;
+                info.maximum[d] = natoms > 0 ? std::numeric_limits<float>::lowest() : 0.0f;
+                for (uint32_t a = 0; a < natoms; ++a) {
+                    const float v = readBEFloat(pos + 12 * a + 4 * d) * 10.0f;
+                    info.minimum[d] = std::min(info.minimum[d], v);
+                    info.maximum[d] = std::max(info.maximum[d], v);
+                }
+            }
+        } else {
+            unsigned char* comp = header + XTC_HEADER_SIZE;
+            if (!file.read(reinterpret_cast<char*>(comp), XTC_COMPRESSED_HEADER_SIZE)) {
+                break;
+            }
+            // the integer coordinates are in units of 1/precision nm
+            const float precision = readBEFloat(comp) / 10.0f;
+            for (int d = 0; d < 3; ++d) {
+                info.minimum[d] = static_cast<float>(readBEInt(comp + 4 + 4 * d)) / precision;
+                info.maximum[d] = static_cast<float>(readBEInt(comp + 16 + 4 * d)) / precision;
+            }
+            const uint64_t size = readBE32(comp + 32);
+            frameSize = XTC_HEADER_SIZE + XTC_COMPRESSED_HEADER_SIZE + ((size + 3) / 4) * 4;
+            if (offset + frameSize > fileSize) {
+                // the trajectory is still being written
+                break;
+            }
+        }
+
+        this->frames.push_back(info);
+        offset += frameSize;
+    }
+
+    return !this->frames.empty() || fileSize == 0;
+}
+
+
+/*
+ * XTCFrameIndex::readSidecar
+ */
+bool XTCFrameIndex::readSidecar(const std::filesystem::path& path, const Stamp& stamp) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version;
+    Stamp stored;
+    uint64_t frameCnt;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&stored.size), sizeof(stored.size));
+    file.read(reinterpret_cast<char*>(&stored.modified), sizeof(stored.modified));
+    file.read(reinterpret_cast<char*>(&this->atomCount), sizeof(this->atomCount));
+    file.read(reinterpret_cast<char*>(&frameCnt), sizeof(frameCnt));
+    if (!file || std::memcmp(magic, SIDECAR_MAGIC, sizeof(magic)) != 0 || version != SIDECAR_VERSION ||
+        stored.size != stamp.size || stored.modified != stamp.modified ||
+        frameCnt > stamp.size / XTC_HEADER_SIZE) {
+        this->Clear();
+        return false;
+    }
+
+    this->frames.resize(static_cast<size_t>(frameCnt));
+    file.read(reinterpret_cast<char*>(this->frames.data()), frameCnt * sizeof(FrameInfo));
+    if (!file) {
+        this->Clear();
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * XTCFrameIndex::writeSidecar
+ */
+bool XTCFrameIndex::writeSidecar(const std::filesystem::path& path, const Stamp& stamp) const {
+    // write to a temporary file first, so a concurrent reader never sees half an index
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        const uint64_t frameCnt = this->frames.size();
+        file.write(SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+        file.write(reinterpret_cast<const char*>(&SIDECAR_VERSION), sizeof(SIDECAR_VERSION));
+        file.write(reinterpret_cast<const char*>(&stamp.size), sizeof(stamp.size));
+        file.write(reinterpret_cast<const char*>(&stamp.modified), sizeof(stamp.modified));
+        file.write(reinterpret_cast<const char*>(&this->atomCount), sizeof(this->atomCount));
+        file.write(reinterpret_cast<const char*>(&frameCnt), sizeof(frameCnt));
+        file.write(reinterpret_cast<const char*>(this->frames.data()), frameCnt * sizeof(FrameInfo));
+        if (!file) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,103 @@
+/*
+ * XTCFrameIndex.h
+ *
+ * Copyright (C) 2021 by University of Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#ifndef MMPROTEINPLUGIN_XTCFRAMEINDEX_H_INCLUDED
+#define MMPROTEINPLUGIN_XTCFRAMEINDEX_H_INCLUDED
+#if (defined(_MSC_VER) && (_MSC_VER > 1000))
+#pragma once
+#endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace megamol {
+namespace protein {
+
+/**
+ * Index of the frames of a GROMACS XTC trajectory.
+ *
+ * Building the index requires reading the header of every frame, which takes minutes for trajectories of hundreds of
+ * gigabytes. The index is therefore stored in a sidecar file next to the trajectory ('<trajectory>.mmxtci') and
+ * reused as long as size and modification time of the trajectory match.
+ */
+class XTCFrameIndex {
+public:
+    /** The header data of one frame */
+    struct FrameInfo {
+        /** Byte offset of the frame in the trajectory */
+        uint64_t offset;
+        int32_t step;
+        /** Simulation time in ps */
+        float time;
+        /** Simulation box, row-major 3x3 in nm */
+        float box[9];
+        /** Bounds of the atom positions in Angstrom */
+        float minimum[3];
+        float maximum[3];
+    };
+
+    /** Ctor. */
+    XTCFrameIndex(void);
+
+    /**
+     * Loads the index of a trajectory from its sidecar file if it is up to date, otherwise scans the trajectory and
+     * tries to write the sidecar file.
+     *
+     * @param trajectory The XTC file.
+     * @param useSidecar Whether to read and write the sidecar file.
+     *
+     * @return 'true' on success, 'false' if the trajectory cannot be read.
+     */
+    bool Load(const std::filesystem::path& trajectory, bool useSidecar = true);
+
+    /** Removes all frames */
+    void Clear(void);
+
+    /** Answer the number of atoms of all frames */
+    inline uint32_t AtomCount(void) const {
+        return this->atomCount;
+    }
+
+    /** Answer the number of complete frames */
+    inline size_t Count(void) const {
+        return this->frames.size();
+    }
+
+    /** Answer the header data of a frame */
+    inline const FrameInfo& operator[](size_t idx) const {
+        return this->frames[idx];
+    }
+
+    /** Answer the path of the sidecar file of a trajectory */
+    static std::filesystem::path SidecarPath(const std::filesystem::path& trajectory);
+
+private:
+    /** Identifies the trajectory an index belongs to */
+    struct Stamp {
+        uint64_t size;
+        int64_t modified;
+    };
+
+    static bool stampOf(const std::filesystem::path& trajectory, Stamp& outStamp);
+
+    /** Reads the header of every frame, a truncated last frame is ignored */
+    bool scan(const std::filesystem::path& trajectory);
+
+    bool readSidecar(const std::filesystem::path& path, const Stamp& stamp);
+
+    bool writeSidecar(const std::filesystem::path& path, const Stamp& stamp) const;
+
+    uint32_t atomCount;
+
+    std::vector<FrameInfo> frames;
+};
+
+} /* end namespace protein */
+} /* end namespace megamol */
+
+#endif // MMPROTEINPLUGIN_XTCFRAMEINDEX_H_INCLUDED
@@ -15,8 +15,6 @@
 #include "mmcore/view/CallRender3DGL.h"
 #include "mmcore/view/Camera_2.h"
 
-#include "snappy.h"
-
 #include "vislib/Exception.h"
 #include <exception>
 
@@ -36,6 +34,7 @@ megamol::remote::FBOCompositor2::FBOCompositor2()
               "Required to be set for cinematic rendering. If true, rendering is skipped until frame for requested "
               "camera "
               "and time is received."}
+        , transportStatsSlot_{"transportStats", "Periodically logs timings and sizes of the received frames"}
         , close_future_{close_promise_.get_future()}
         , fbo_msg_write_{new std::vector<fbo_msg_t>}
         , fbo_msg_recv_{new std::vector<fbo_msg_t>}
@@ -71,6 +70,9 @@ megamol::remote::FBOCompositor2::FBOCompositor2()
 
     renderOnlyRequestedFramesSlot_ << new megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&renderOnlyRequestedFramesSlot_);
+
+    transportStatsSlot_ << new megamol::core::param::BoolParam(false);
+    this->MakeSlotAvailable(&transportStatsSlot_);
 }
 
 
@@ -354,10 +356,11 @@ bool megamol::remote::FBOCompositor2::startCallback(megamol::core::param::ParamS
 
 
 void megamol::remote::FBOCompositor2::RGBAtoRGB(std::vector<char> const& rgba, std::vector<unsigned char>& rgb) {
-    auto const num_pixels = rgba.size() / 4;
+    auto const num_pixels = static_cast<int64_t>(rgba.size() / 4);
     rgb.resize(num_pixels * 3);
 
-    for (size_t pidx = 0; pidx < num_pixels; ++pidx) {
+#pragma omp parallel for
+    for (int64_t pidx = 0; pidx < num_pixels; ++pidx) {
         rgb[pidx * 3] = rgba[pidx * 4];
         rgb[pidx * 3 + 1] = rgba[pidx * 4 + 1];
         rgb[pidx * 3 + 2] = rgba[pidx * 4 + 2];
@@ -398,19 +401,29 @@ bool megamol::remote::FBOCompositor2::initThreads() {
 
 void megamol::remote::FBOCompositor2::receiverJob(
     FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close) {
+    using clock_type = FBOTransportStats::clock_type;
     try {
+        // the decoded image persists, messages only carry the tiles which changed
+        fbo_msg_t msg;
+        FBOTileDecoder decoder;
+        // message buffer, kept across frames
+        std::vector<char> buf;
+        std::vector<char> const data_request{'r', 'e', 'q'};
+        std::vector<char> const key_frame_request{'k', 'e', 'y'};
+        bool need_key_frame = true;
+        FBOTransportStats stats{"FBOCompositor2", {"receive", "decode"}};
         while (!shutdown_) {
             auto const status = close.wait_for(std::chrono::milliseconds(1));
             if (status == std::future_status::ready)
                 break;
 
+            auto const recv_start = clock_type::now();
             // send a request for data
-            std::vector<char> buf{'r', 'e', 'q'};
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sending request\n");
 #endif
-                if (!comm.Send(buf, send_type::SEND)) {
+                if (!comm.Send(need_key_frame ? key_frame_request : data_request, send_type::SEND)) {
                     megamol::core::utility::log::Log::DefaultLog.WriteError(
                         "FBOCompositor2: Exception during send in 'receiverJob'\n");
                 }
@@ -453,52 +466,34 @@ void megamol::remote::FBOCompositor2::receiverJob(
                     "FBOCompositor2: Exception during recv in 'receiverJob'\n");
             }
 
-            fbo_msg_header_t header;
-            char* buf_ptr = buf.data();
-            std::copy(buf_ptr, buf_ptr + sizeof(fbo_msg_header_t), reinterpret_cast<char*>(&header));
-            buf_ptr += sizeof(fbo_msg_header_t);
-            size_t fbo_depth_size;
-            auto vol =
-                (header.updated_area[2] - header.updated_area[0]) * (header.updated_area[3] - header.updated_area[1]);
-            size_t fbo_col_size = fbo_depth_size = static_cast<size_t>(vol);
-            fbo_col_size *= static_cast<size_t>(col_buf_el_size_);
-            fbo_depth_size *= static_cast<size_t>(depth_buf_el_size_);
-
-            if (header.depth_buf_size <= 1 || header.color_buf_size <= 1) {
+            auto const decode_start = clock_type::now();
+            if (!decoder.Decode(buf, msg.fbo_msg_header, msg.color_buf, msg.depth_buf)) {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "FBOCompositor2: Bad size for alloc color/depth; col_buf size: %d; col_comp_buf size: %d; "
-                    "depth_buf size: %d; depth_comp_buf size: %d;\n",
-                    fbo_col_size, header.color_buf_size, fbo_depth_size, header.depth_buf_size);
+                    "FBOCompositor2: Could not decode message of size %d, requesting key frame\n", buf.size());
 #endif
+                need_key_frame = true;
                 continue;
             }
-
-            std::vector<char> col_buf(fbo_col_size);
-            std::vector<char> col_comp_buf(header.color_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.color_buf_size, col_comp_buf.begin());
-            buf_ptr += header.color_buf_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::vector<char> depth_comp_buf(header.depth_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.depth_buf_size, depth_comp_buf.begin());
-
-            // snappy uncompress
-            snappy::RawUncompress(col_comp_buf.data(), col_comp_buf.size(), col_buf.data());
-            snappy::RawUncompress(depth_comp_buf.data(), depth_comp_buf.size(), depth_buf.data());
-
-            /*std::vector<char> col_buf(fbo_col_size);
-            std::copy(buf_ptr, buf_ptr + fbo_col_size, col_buf.begin());
-            buf_ptr += fbo_col_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::copy(buf_ptr, buf_ptr + fbo_depth_size, depth_buf.begin());*/
+            need_key_frame = false;
 
 #ifdef _DEBUG
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                "FBOCompositor2: Got message with col_buf size %d and depth_buf size %d\n", col_buf.size(),
-                depth_buf.size());
+                "FBOCompositor2: Got message with %d tiles, col_buf size %d and depth_buf size %d\n",
+                msg.fbo_msg_header.num_tiles, msg.fbo_msg_header.color_buf_size, msg.fbo_msg_header.depth_buf_size);
 #endif
 
-            auto const msg = fbo_msg{std::move(header), std::move(col_buf), std::move(depth_buf)};
+            auto const decode_end = clock_type::now();
+            stats.Record(0, decode_start - recv_start);
+            stats.Record(1, decode_end - decode_start);
+            stats.FrameDone(buf.size(), msg.fbo_msg_header.num_tiles, 0);
+            if (stats.Due(std::chrono::seconds(5))) {
+                if (this->transportStatsSlot_.Param<megamol::core::param::BoolParam>()->Value()) {
+                    stats.Report();
+                } else {
+                    stats.Reset();
+                }
+            }
 
             while (!shutdown_) {
                 try {
@@ -15,6 +15,7 @@
 
 #include "FBOCommFabric.h"
 #include "FBOProto.h"
+#include "FBOTileTransport.h"
 #include "mmcore/param/ParamSlot.h"
 #include "mmcore/utility/sys/FutureReset.h"
 
@@ -124,6 +125,8 @@ private:
 
     megamol::core::param::ParamSlot renderOnlyRequestedFramesSlot_;
 
+    megamol::core::param::ParamSlot transportStatsSlot_;
+
     // megamol::core::utility::gl::FramebufferObject fbo_;
 
     std::thread collector_thread_;
@@ -83,6 +83,9 @@ enum fbo_color_type : unsigned int { RGBAf, RGBAu8, RGBf, RGBu8 };
 
 enum fbo_depth_type : unsigned int { Df, Du16, Du24, Du32 };
 
+/// CODEC_DEPTH_Q16 quantizes depth values to 16 bit before snappy compression, it is lossy and only valid for depth
+enum fbo_codec_type : unsigned int { CODEC_RAW, CODEC_SNAPPY, CODEC_DEPTH_Q16 };
+
 using data_ptr = char*;
 
 using id_t = unsigned int;
@@ -112,10 +115,31 @@ struct fbo_msg_header {
     size_t color_buf_size;
     // depth buf size
     size_t depth_buf_size;
+    // edge length of the tiles in pixels
+    unsigned int tile_size;
+    // number of tiles contained in the message
+    unsigned int num_tiles;
+    // codec of the color tiles
+    fbo_codec_type color_codec;
+    // codec of the depth tiles
+    fbo_codec_type depth_codec;
+    // non-zero if the message contains all tiles
+    unsigned int key_frame;
 };
 
 using fbo_msg_header_t = fbo_msg_header;
 
+struct fbo_tile_header {
+    // row-major index of the tile
+    unsigned int index;
+    // size of the encoded color bytes
+    unsigned int color_size;
+    // size of the encoded depth bytes
+    unsigned int depth_size;
+};
+
+using fbo_tile_header_t = fbo_tile_header;
+
 struct fbo_msg {
     fbo_msg() = default;
 
@@ -0,0 +1,183 @@
+#include "FBORadixKCompositor.h"
+#include "stdafx.h"
+
+#ifdef WITH_MPI
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "mmcore/utility/log/Log.h"
+
+namespace {
+
+constexpr int color_el_size = 4;
+
+/**
+ * Keeps the fragments of 'recv' which are closer than the ones of 'color' and 'depth'.
+ */
+void depthComposite(
+    char* color, float* depth, char const* recv_color, float const* recv_depth, size_t num_pixels) {
+#pragma omp parallel for
+    for (int64_t p = 0; p < static_cast<int64_t>(num_pixels); ++p) {
+        if (recv_depth[p] < depth[p]) {
+            depth[p] = recv_depth[p];
+            std::memcpy(color + p * color_el_size, recv_color + p * color_el_size, color_el_size);
+        }
+    }
+}
+
+} // namespace
+
+
+megamol::remote::FBORadixKCompositor::FBORadixKCompositor(MPI_Comm comm, int k) : comm_{comm}, rank_{0}, size_{1} {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+
+    // factorize the number of ranks into rounds of k ranks, remaining factors get their own round
+    k = std::max(k, 2);
+    int rest = size_;
+    while (rest > 1) {
+        if (rest % k == 0) {
+            rounds_.push_back(k);
+            rest /= k;
+        } else {
+            int f = 2;
+            while (rest % f != 0) {
+                ++f;
+            }
+            rounds_.push_back(f);
+            rest /= f;
+        }
+    }
+}
+
+
+megamol::remote::FBORadixKCompositor::span_t megamol::remote::FBORadixKCompositor::getSpan(
+    int rank, size_t num_rounds, size_t num_pixels) const {
+    span_t span{0, num_pixels};
+    int stride = 1;
+    for (size_t r = 0; r < num_rounds; ++r) {
+        auto const k = rounds_[r];
+        auto const digit = (rank / stride) % k;
+        auto const len = span.second - span.first;
+        span = span_t{span.first + len * digit / k, span.first + len * (digit + 1) / k};
+        stride *= k;
+    }
+    return span;
+}
+
+
+bool megamol::remote::FBORadixKCompositor::Composite(std::vector<char>& color, std::vector<char>& depth, int root) {
+    using megamol::core::utility::log::Log;
+
+    auto const num_pixels = color.size() / color_el_size;
+    if (depth.size() != num_pixels * sizeof(float)) {
+        Log::DefaultLog.WriteError("FBORadixKCompositor: Color and depth image differ in size\n");
+        return false;
+    }
+    auto const depth_ptr = reinterpret_cast<float*>(depth.data());
+
+    int stride = 1;
+    for (size_t r = 0; r < rounds_.size(); ++r) {
+        auto const k = rounds_[r];
+        auto const digit = (rank_ / stride) % k;
+        auto const group_base = rank_ - digit * stride;
+        auto const span = this->getSpan(rank_, r, num_pixels);
+        auto const len = span.second - span.first;
+        auto const part = [&](int m) {
+            return span_t{span.first + len * m / k, span.first + len * (m + 1) / k};
+        };
+        auto const own = part(digit);
+        auto const own_len = own.second - own.first;
+
+        // all parts of the own span are received into one slot per group member
+        recv_color_.resize(k * own_len * color_el_size);
+        recv_depth_.resize(k * own_len);
+        requests_.assign(4 * k, MPI_REQUEST_NULL);
+        int const color_tag = 2 * static_cast<int>(r);
+        int const depth_tag = color_tag + 1;
+        for (int m = 0; m < k; ++m) {
+            if (m == digit) {
+                continue;
+            }
+            int const peer = group_base + m * stride;
+            MPI_Irecv(recv_color_.data() + m * own_len * color_el_size, static_cast<int>(own_len * color_el_size),
+                MPI_BYTE, peer, color_tag, comm_, &requests_[2 * m]);
+            MPI_Irecv(recv_depth_.data() + m * own_len, static_cast<int>(own_len), MPI_FLOAT, peer, depth_tag, comm_,
+                &requests_[2 * m + 1]);
+        }
+        for (int m = 0; m < k; ++m) {
+            if (m == digit) {
+                continue;
+            }
+            int const peer = group_base + m * stride;
+            auto const p = part(m);
+            auto const p_len = p.second - p.first;
+            MPI_Isend(color.data() + p.first * color_el_size, static_cast<int>(p_len * color_el_size), MPI_BYTE, peer,
+                color_tag, comm_, &requests_[2 * k + 2 * m]);
+            MPI_Isend(depth_ptr + p.first, static_cast<int>(p_len), MPI_FLOAT, peer, depth_tag, comm_,
+                &requests_[2 * k + 2 * m + 1]);
+        }
+
+        // composite in the order of the group members, which overlaps compositing with receiving the next part
+        for (int m = 0; m < k; ++m) {
+            if (m == digit) {
+                continue;
+            }
+            if (MPI_Waitall(2, &requests_[2 * m], MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+                Log::DefaultLog.WriteError("FBORadixKCompositor: Receiving image part failed\n");
+                return false;
+            }
+            depthComposite(color.data() + own.first * color_el_size, depth_ptr + own.first,
+                recv_color_.data() + m * own_len * color_el_size, recv_depth_.data() + m * own_len, own_len);
+        }
+        if (MPI_Waitall(2 * k, &requests_[2 * k], MPI_STATUSES_IGNORE) != MPI_SUCCESS) {
+            Log::DefaultLog.WriteError("FBORadixKCompositor: Sending image part failed\n");
+            return false;
+        }
+
+        stride *= k;
+    }
+
+    // the final spans are disjoint and cover the image, so they are gathered in place
+    gather_counts_.resize(size_);
+    gather_displs_.resize(size_);
+    for (int rank = 0; rank < size_; ++rank) {
+        auto const span = this->getSpan(rank, rounds_.size(), num_pixels);
+        gather_counts_[rank] = static_cast<int>(span.second - span.first);
+        gather_displs_[rank] = static_cast<int>(span.first);
+    }
+    auto const own = this->getSpan(rank_, rounds_.size(), num_pixels);
+    auto const own_len = static_cast<int>(own.second - own.first);
+
+    int ret = MPI_SUCCESS;
+    if (rank_ == root) {
+        ret = MPI_Gatherv(MPI_IN_PLACE, 0, MPI_FLOAT, depth_ptr, gather_counts_.data(), gather_displs_.data(),
+            MPI_FLOAT, root, comm_);
+    } else {
+        ret = MPI_Gatherv(depth_ptr + own.first, own_len, MPI_FLOAT, nullptr, nullptr, nullptr, MPI_FLOAT, root, comm_);
+    }
+    // color is gathered bytewise
+    for (int rank = 0; rank < size_; ++rank) {
+        gather_counts_[rank] *= color_el_size;
+        gather_displs_[rank] *= color_el_size;
+    }
+    if (ret == MPI_SUCCESS) {
+        if (rank_ == root) {
+            ret = MPI_Gatherv(MPI_IN_PLACE, 0, MPI_BYTE, color.data(), gather_counts_.data(), gather_displs_.data(),
+                MPI_BYTE, root, comm_);
+        } else {
+            ret = MPI_Gatherv(color.data() + own.first * color_el_size, own_len * color_el_size, MPI_BYTE, nullptr,
+                nullptr, nullptr, MPI_BYTE, root, comm_);
+        }
+    }
+    if (ret != MPI_SUCCESS) {
+        Log::DefaultLog.WriteError("FBORadixKCompositor: Gathering the composited image failed\n");
+        return false;
+    }
+
+    return true;
+}
+
+#endif // WITH_MPI
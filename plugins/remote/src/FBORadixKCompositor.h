@@ -0,0 +1,71 @@
+#pragma once
+
+#ifdef WITH_MPI
+
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace megamol {
+namespace remote {
+
+/**
+ * Sort-last depth compositing of RGBAu8 color and float depth images over MPI using radix-k.
+ *
+ * The ranks are arranged in a mixed-radix grid with one dimension per round. In each round the members of a group
+ * split their current image span into one part per member, exchange the parts and depth composite the part they keep.
+ * After the last round every rank owns a distinct span of the final image, which is gathered at the root. A radix of
+ * 2 gives binary swap, a radix of the number of ranks gives direct send.
+ */
+class FBORadixKCompositor {
+public:
+    using span_t = std::pair<size_t, size_t>;
+
+    /**
+     * @param comm The communicator of the render nodes, all of them have to call Composite.
+     * @param k The number of ranks exchanging parts per round if the number of ranks allows it.
+     */
+    FBORadixKCompositor(MPI_Comm comm, int k);
+
+    /**
+     * Composites the images of all ranks, which have to be of the same size. Afterwards 'root' holds the composited
+     * image, the images of the other ranks are overwritten partially.
+     *
+     * @return 'false' if the images do not fit or communication failed.
+     */
+    bool Composite(std::vector<char>& color, std::vector<char>& depth, int root);
+
+    /** The number of ranks per round */
+    std::vector<int> const& Rounds(void) const {
+        return rounds_;
+    }
+
+private:
+    /** Answers the span of the image the given rank owns after the first 'num_rounds' rounds */
+    span_t getSpan(int rank, size_t num_rounds, size_t num_pixels) const;
+
+    MPI_Comm comm_;
+
+    int rank_;
+
+    int size_;
+
+    std::vector<int> rounds_;
+
+    /** receive buffers of the parts from the other group members */
+    std::vector<char> recv_color_;
+
+    std::vector<float> recv_depth_;
+
+    std::vector<MPI_Request> requests_;
+
+    std::vector<int> gather_counts_;
+
+    std::vector<int> gather_displs_;
+};
+
+} // end namespace remote
+} // end namespace megamol
+
+#endif // WITH_MPI
@@ -0,0 +1,387 @@
+#include "FBOTileTransport.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <omp.h>
+
+#include "snappy.h"
+
+#include "mmcore/utility/log/Log.h"
+
+namespace {
+
+constexpr int color_el_size = 4;
+
+constexpr int depth_el_size = 4;
+
+struct tile_rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+tile_rect getTileRect(size_t idx, int width, int height, int tile_size) {
+    int const tiles_x = (width + tile_size - 1) / tile_size;
+    tile_rect r;
+    r.x = static_cast<int>(idx % tiles_x) * tile_size;
+    r.y = static_cast<int>(idx / tiles_x) * tile_size;
+    r.width = std::min(tile_size, width - r.x);
+    r.height = std::min(tile_size, height - r.y);
+    return r;
+}
+
+size_t getTileCount(int width, int height, int tile_size) {
+    size_t const tiles_x = (width + tile_size - 1) / tile_size;
+    size_t const tiles_y = (height + tile_size - 1) / tile_size;
+    return tiles_x * tiles_y;
+}
+
+bool isTileDirty(char const* img, char const* prev, tile_rect const& r, int width, int el_size) {
+    size_t const row_size = static_cast<size_t>(r.width) * el_size;
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        size_t const offset = (static_cast<size_t>(y) * width + r.x) * el_size;
+        if (std::memcmp(img + offset, prev + offset, row_size) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void copyTile(char const* img, char* prev, tile_rect const& r, int width, int el_size) {
+    size_t const row_size = static_cast<size_t>(r.width) * el_size;
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        size_t const offset = (static_cast<size_t>(y) * width + r.x) * el_size;
+        std::memcpy(prev + offset, img + offset, row_size);
+    }
+}
+
+void gatherTile(char const* img, tile_rect const& r, int width, int el_size, char* dst) {
+    size_t const row_size = static_cast<size_t>(r.width) * el_size;
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        std::memcpy(dst, img + (static_cast<size_t>(y) * width + r.x) * el_size, row_size);
+        dst += row_size;
+    }
+}
+
+void scatterTile(char const* src, tile_rect const& r, int width, int el_size, char* img) {
+    size_t const row_size = static_cast<size_t>(r.width) * el_size;
+    for (int y = r.y; y < r.y + r.height; ++y) {
+        std::memcpy(img + (static_cast<size_t>(y) * width + r.x) * el_size, src, row_size);
+        src += row_size;
+    }
+}
+
+/**
+ * Appends the encoded tile 'src' of 'size' bytes to 'dst' and answers the number of encoded bytes.
+ */
+size_t encodeTile(
+    megamol::remote::fbo_codec_type codec, char* src, size_t size, std::vector<char>& staging, std::vector<char>& dst) {
+    using namespace megamol::remote;
+    auto const offset = dst.size();
+    switch (codec) {
+    case CODEC_SNAPPY: {
+        dst.resize(offset + snappy::MaxCompressedLength(size));
+        size_t comp_size = 0;
+        snappy::RawCompress(src, size, dst.data() + offset, &comp_size);
+        dst.resize(offset + comp_size);
+    } break;
+    case CODEC_DEPTH_Q16: {
+        // depth values are within [0, 1], the background (1) stays exact
+        auto const cnt = size / sizeof(float);
+        staging.resize(std::max(staging.size(), cnt * sizeof(uint16_t)));
+        auto const depth = reinterpret_cast<float const*>(src);
+        auto const quant = reinterpret_cast<uint16_t*>(staging.data());
+        for (size_t i = 0; i < cnt; ++i) {
+            quant[i] = static_cast<uint16_t>(std::clamp(depth[i], 0.0f, 1.0f) * 65535.0f + 0.5f);
+        }
+        dst.resize(offset + snappy::MaxCompressedLength(cnt * sizeof(uint16_t)));
+        size_t comp_size = 0;
+        snappy::RawCompress(staging.data(), cnt * sizeof(uint16_t), dst.data() + offset, &comp_size);
+        dst.resize(offset + comp_size);
+    } break;
+    case CODEC_RAW:
+    default:
+        dst.insert(dst.end(), src, src + size);
+    }
+    return dst.size() - offset;
+}
+
+/**
+ * Decodes 'size' bytes from 'src' into 'dst' holding 'dst_size' bytes.
+ */
+bool decodeTile(megamol::remote::fbo_codec_type codec, char const* src, size_t size, std::vector<char>& staging,
+    char* dst, size_t dst_size) {
+    using namespace megamol::remote;
+    switch (codec) {
+    case CODEC_RAW:
+        if (size != dst_size) {
+            return false;
+        }
+        std::memcpy(dst, src, size);
+        return true;
+    case CODEC_SNAPPY: {
+        size_t length = 0;
+        if (!snappy::GetUncompressedLength(src, size, &length) || length != dst_size) {
+            return false;
+        }
+        return snappy::RawUncompress(src, size, dst);
+    }
+    case CODEC_DEPTH_Q16: {
+        auto const cnt = dst_size / sizeof(float);
+        size_t length = 0;
+        if (!snappy::GetUncompressedLength(src, size, &length) || length != cnt * sizeof(uint16_t)) {
+            return false;
+        }
+        staging.resize(std::max(staging.size(), length));
+        if (!snappy::RawUncompress(src, size, staging.data())) {
+            return false;
+        }
+        auto const quant = reinterpret_cast<uint16_t const*>(staging.data());
+        auto const depth = reinterpret_cast<float*>(dst);
+        for (size_t i = 0; i < cnt; ++i) {
+            depth[i] = static_cast<float>(quant[i]) / 65535.0f;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+
+void megamol::remote::FBOTileEncoder::Encode(fbo_msg_header_t& header, std::vector<char> const& color,
+    std::vector<char> const& depth, bool key_frame, std::vector<char>& buf) {
+    int const width = header.screen_area[2] - header.screen_area[0];
+    int const height = header.screen_area[3] - header.screen_area[1];
+    int const tile_size = static_cast<int>(std::max(header.tile_size, 1u));
+    header.tile_size = tile_size;
+
+    // anything which invalidates the image on the receiver requires all tiles, this includes switching codecs as
+    // clean tiles on the receiver may carry the error of a lossy one
+    if (width != prev_width_ || height != prev_height_ || static_cast<unsigned int>(tile_size) != prev_tile_size_ ||
+        header.color_codec != prev_color_codec_ || header.depth_codec != prev_depth_codec_) {
+        key_frame = true;
+        prev_color_.resize(color.size());
+        prev_depth_.resize(depth.size());
+        prev_width_ = width;
+        prev_height_ = height;
+        prev_tile_size_ = tile_size;
+        prev_color_codec_ = header.color_codec;
+        prev_depth_codec_ = header.depth_codec;
+    }
+
+    auto const num_tiles = getTileCount(width, height, tile_size);
+    dirty_.resize(num_tiles);
+    payload_.resize(num_tiles);
+    tile_headers_.resize(num_tiles);
+    staging_.resize(omp_get_max_threads());
+    quant_staging_.resize(staging_.size());
+
+    auto const tile_buf_size = static_cast<size_t>(tile_size) * tile_size * std::max(color_el_size, depth_el_size);
+    // quantization only applies to depth
+    auto const color_codec = (header.color_codec == CODEC_DEPTH_Q16) ? CODEC_SNAPPY : header.color_codec;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t idx = 0; idx < static_cast<int64_t>(num_tiles); ++idx) {
+        auto const r = getTileRect(idx, width, height, tile_size);
+        bool const col_dirty = key_frame || isTileDirty(color.data(), prev_color_.data(), r, width, color_el_size);
+        bool const depth_dirty = key_frame || isTileDirty(depth.data(), prev_depth_.data(), r, width, depth_el_size);
+        dirty_[idx] = col_dirty || depth_dirty;
+        if (!dirty_[idx]) {
+            continue;
+        }
+
+        auto& staging = staging_[omp_get_thread_num()];
+        if (staging.size() < tile_buf_size) {
+            staging.resize(tile_buf_size);
+        }
+        auto& quant_staging = quant_staging_[omp_get_thread_num()];
+        auto& payload = payload_[idx];
+        payload.clear();
+
+        size_t const pixels = static_cast<size_t>(r.width) * r.height;
+        gatherTile(color.data(), r, width, color_el_size, staging.data());
+        auto const col_size =
+            encodeTile(color_codec, staging.data(), pixels * color_el_size, quant_staging, payload);
+        gatherTile(depth.data(), r, width, depth_el_size, staging.data());
+        auto const depth_size =
+            encodeTile(header.depth_codec, staging.data(), pixels * depth_el_size, quant_staging, payload);
+
+        tile_headers_[idx] = fbo_tile_header_t{
+            static_cast<unsigned int>(idx), static_cast<unsigned int>(col_size), static_cast<unsigned int>(depth_size)};
+
+        if (col_dirty) {
+            copyTile(color.data(), prev_color_.data(), r, width, color_el_size);
+        }
+        if (depth_dirty) {
+            copyTile(depth.data(), prev_depth_.data(), r, width, depth_el_size);
+        }
+    }
+
+    // compose message from header and dirty tiles
+    size_t msg_size = sizeof(fbo_msg_header_t);
+    dirty_tiles_ = 0;
+    header.color_buf_size = 0;
+    header.depth_buf_size = 0;
+    for (size_t idx = 0; idx < num_tiles; ++idx) {
+        if (dirty_[idx]) {
+            ++dirty_tiles_;
+            msg_size += sizeof(fbo_tile_header_t) + payload_[idx].size();
+            header.color_buf_size += tile_headers_[idx].color_size;
+            header.depth_buf_size += tile_headers_[idx].depth_size;
+        }
+    }
+    header.num_tiles = static_cast<unsigned int>(dirty_tiles_);
+    header.key_frame = key_frame ? 1 : 0;
+
+    buf.resize(msg_size);
+    char* buf_ptr = buf.data();
+    std::memcpy(buf_ptr, &header, sizeof(fbo_msg_header_t));
+    buf_ptr += sizeof(fbo_msg_header_t);
+    for (size_t idx = 0; idx < num_tiles; ++idx) {
+        if (dirty_[idx]) {
+            std::memcpy(buf_ptr, &tile_headers_[idx], sizeof(fbo_tile_header_t));
+            buf_ptr += sizeof(fbo_tile_header_t);
+            std::memcpy(buf_ptr, payload_[idx].data(), payload_[idx].size());
+            buf_ptr += payload_[idx].size();
+        }
+    }
+}
+
+
+bool megamol::remote::FBOTileDecoder::Decode(
+    std::vector<char> const& buf, fbo_msg_header_t& header, std::vector<char>& color, std::vector<char>& depth) {
+    if (buf.size() < sizeof(fbo_msg_header_t)) {
+        return false;
+    }
+    std::memcpy(&header, buf.data(), sizeof(fbo_msg_header_t));
+
+    int const width = header.screen_area[2] - header.screen_area[0];
+    int const height = header.screen_area[3] - header.screen_area[1];
+    int const tile_size = static_cast<int>(header.tile_size);
+    if (width <= 0 || height <= 0 || tile_size <= 0) {
+        return false;
+    }
+    size_t const pixels = static_cast<size_t>(width) * height;
+    auto const num_tiles = getTileCount(width, height, tile_size);
+
+    if (header.key_frame != 0) {
+        color.resize(pixels * color_el_size);
+        depth.resize(pixels * depth_el_size);
+    } else if (color.size() != pixels * color_el_size || depth.size() != pixels * depth_el_size) {
+        // delta frame without matching previous image
+        return false;
+    }
+
+    // the tiles have variable size, locate them before decoding in parallel; tiles are decoded concurrently, so a
+    // message with a tile index occurring twice is malformed
+    if (header.num_tiles > num_tiles) {
+        return false;
+    }
+    seen_.assign(num_tiles, 0);
+    tile_headers_.resize(header.num_tiles);
+    offsets_.resize(header.num_tiles);
+    size_t offset = sizeof(fbo_msg_header_t);
+    for (unsigned int t = 0; t < header.num_tiles; ++t) {
+        if (offset + sizeof(fbo_tile_header_t) > buf.size()) {
+            return false;
+        }
+        std::memcpy(&tile_headers_[t], buf.data() + offset, sizeof(fbo_tile_header_t));
+        offset += sizeof(fbo_tile_header_t);
+        offsets_[t] = offset;
+        offset += static_cast<size_t>(tile_headers_[t].color_size) + tile_headers_[t].depth_size;
+        if (offset > buf.size() || tile_headers_[t].index >= num_tiles || seen_[tile_headers_[t].index] != 0) {
+            return false;
+        }
+        seen_[tile_headers_[t].index] = 1;
+    }
+
+    valid_.assign(header.num_tiles, 1);
+    staging_.resize(omp_get_max_threads());
+    quant_staging_.resize(staging_.size());
+    auto const tile_buf_size = static_cast<size_t>(tile_size) * tile_size * std::max(color_el_size, depth_el_size);
+    auto const color_codec = (header.color_codec == CODEC_DEPTH_Q16) ? CODEC_SNAPPY : header.color_codec;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t t = 0; t < static_cast<int64_t>(header.num_tiles); ++t) {
+        auto const& th = tile_headers_[t];
+        auto const r = getTileRect(th.index, width, height, tile_size);
+        size_t const tile_pixels = static_cast<size_t>(r.width) * r.height;
+
+        auto& staging = staging_[omp_get_thread_num()];
+        if (staging.size() < tile_buf_size) {
+            staging.resize(tile_buf_size);
+        }
+        auto& quant_staging = quant_staging_[omp_get_thread_num()];
+
+        char const* src = buf.data() + offsets_[t];
+        if (!decodeTile(color_codec, src, th.color_size, quant_staging, staging.data(), tile_pixels * color_el_size)) {
+            valid_[t] = 0;
+            continue;
+        }
+        scatterTile(staging.data(), r, width, color_el_size, color.data());
+        src += th.color_size;
+        if (!decodeTile(
+                header.depth_codec, src, th.depth_size, quant_staging, staging.data(), tile_pixels * depth_el_size)) {
+            valid_[t] = 0;
+            continue;
+        }
+        scatterTile(staging.data(), r, width, depth_el_size, depth.data());
+    }
+
+    return std::all_of(valid_.begin(), valid_.end(), [](unsigned char v) { return v != 0; });
+}
+
+
+megamol::remote::FBOTransportStats::FBOTransportStats(std::string name, std::vector<std::string> stages)
+        : name_{std::move(name)}
+        , stages_{std::move(stages)}
+        , durations_(stages_.size(), clock_type::duration::zero())
+        , start_{clock_type::now()} {}
+
+
+void megamol::remote::FBOTransportStats::FrameDone(size_t bytes, size_t dirty_tiles, size_t total_tiles) {
+    ++frames_;
+    bytes_ += bytes;
+    dirty_tiles_ += dirty_tiles;
+    total_tiles_ += total_tiles;
+}
+
+
+void megamol::remote::FBOTransportStats::Report(size_t produced_frames) {
+    auto const elapsed = clock_type::now() - start_;
+    if (frames_ > 0) {
+        auto const to_ms = [](clock_type::duration d) {
+            return std::chrono::duration<double, std::milli>(d).count();
+        };
+        double const elapsed_ms = to_ms(elapsed);
+        std::string msg = name_ + ": " + std::to_string(frames_ * 1000.0 / elapsed_ms) + " frames/s";
+        if (produced_frames > 0) {
+            msg += " (" + std::to_string(produced_frames * 1000.0 / elapsed_ms) + " produced)";
+        }
+        msg += ", " + std::to_string(bytes_ / 1024.0 / frames_) + " KiB/frame";
+        if (total_tiles_ > 0) {
+            msg += ", " + std::to_string(100.0 * dirty_tiles_ / total_tiles_) + "% dirty tiles";
+        }
+        // the busy share of a stage is the part of the wall clock time it overlaps the other threads
+        for (size_t s = 0; s < stages_.size(); ++s) {
+            msg += ", " + stages_[s] + " " + std::to_string(to_ms(durations_[s]) / frames_) + " ms (" +
+                   std::to_string(100.0 * to_ms(durations_[s]) / elapsed_ms) + "% busy)";
+        }
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("%s", msg.c_str());
+    }
+    this->Reset();
+}
+
+
+void megamol::remote::FBOTransportStats::Reset(void) {
+    std::fill(durations_.begin(), durations_.end(), clock_type::duration::zero());
+    frames_ = bytes_ = dirty_tiles_ = total_tiles_ = 0;
+    start_ = clock_type::now();
+}
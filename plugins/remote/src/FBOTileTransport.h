@@ -0,0 +1,150 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "FBOProto.h"
+
+namespace megamol {
+namespace remote {
+
+/**
+ * Tile-based encoding of FBO messages.
+ *
+ * The image is split into square tiles, only tiles which differ from the previously encoded image are transmitted,
+ * except for key frames which contain all tiles. A message consists of the fbo_msg_header followed by one
+ * fbo_tile_header and the compressed color and depth bytes per transmitted tile.
+ */
+class FBOTileEncoder {
+public:
+    /**
+     * Encodes the color (RGBAu8) and depth (Df) images described by 'header' into 'buf'.
+     * Tile size and codecs are taken from the header, the remaining tile fields are filled in.
+     *
+     * @param key_frame Forces all tiles to be transmitted.
+     */
+    void Encode(fbo_msg_header_t& header, std::vector<char> const& color, std::vector<char> const& depth,
+        bool key_frame, std::vector<char>& buf);
+
+    /** Forgets the previous image, the next message will be a key frame */
+    void Reset(void) {
+        prev_width_ = prev_height_ = 0;
+    }
+
+    size_t DirtyTiles(void) const {
+        return dirty_tiles_;
+    }
+
+    size_t TotalTiles(void) const {
+        return dirty_.size();
+    }
+
+private:
+    std::vector<char> prev_color_;
+
+    std::vector<char> prev_depth_;
+
+    int prev_width_ = 0;
+
+    int prev_height_ = 0;
+
+    unsigned int prev_tile_size_ = 0;
+
+    fbo_codec_type prev_color_codec_ = CODEC_RAW;
+
+    fbo_codec_type prev_depth_codec_ = CODEC_RAW;
+
+    std::vector<unsigned char> dirty_;
+
+    size_t dirty_tiles_ = 0;
+
+    /** compressed color and depth bytes per tile, kept to reuse the allocations */
+    std::vector<std::vector<char>> payload_;
+
+    std::vector<fbo_tile_header_t> tile_headers_;
+
+    /** per thread buffers for gathering and quantizing tiles */
+    std::vector<std::vector<char>> staging_;
+
+    std::vector<std::vector<char>> quant_staging_;
+};
+
+
+/**
+ * Decodes messages written by FBOTileEncoder into persistent images, tiles not contained in a message keep their
+ * content from the previous messages.
+ */
+class FBOTileDecoder {
+public:
+    /**
+     * Decodes 'buf' into 'color' and 'depth'.
+     *
+     * @return 'false' if the message is malformed or a delta frame does not fit the current images, a key frame has
+     *         to be requested in this case.
+     */
+    bool Decode(std::vector<char> const& buf, fbo_msg_header_t& header, std::vector<char>& color,
+        std::vector<char>& depth);
+
+private:
+    std::vector<fbo_tile_header_t> tile_headers_;
+
+    std::vector<size_t> offsets_;
+
+    std::vector<unsigned char> valid_;
+
+    /** tiles already present in the message, a tile must not be sent twice */
+    std::vector<unsigned char> seen_;
+
+    /** per thread buffers for decompressing and dequantizing tiles */
+    std::vector<std::vector<char>> staging_;
+
+    std::vector<std::vector<char>> quant_staging_;
+};
+
+
+/**
+ * Accumulates the durations of the stages of a transport thread and periodically logs their averages together with
+ * the share of the wall clock time spent in each stage, which shows how much transport overlaps rendering.
+ */
+class FBOTransportStats {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    FBOTransportStats(std::string name, std::vector<std::string> stages);
+
+    void Record(size_t stage, clock_type::duration duration) {
+        durations_[stage] += duration;
+    }
+
+    void FrameDone(size_t bytes, size_t dirty_tiles, size_t total_tiles);
+
+    bool Due(clock_type::duration interval) const {
+        return clock_type::now() - start_ >= interval;
+    }
+
+    /** Logs the averages since the last reset, 'produced_frames' is the number of frames rendered meanwhile */
+    void Report(size_t produced_frames = 0);
+
+    void Reset(void);
+
+private:
+    std::string name_;
+
+    std::vector<std::string> stages_;
+
+    std::vector<clock_type::duration> durations_;
+
+    clock_type::time_point start_;
+
+    size_t frames_ = 0;
+
+    size_t bytes_ = 0;
+
+    size_t dirty_tiles_ = 0;
+
+    size_t total_tiles_ = 0;
+};
+
+} // end namespace remote
+} // end namespace megamol
@@ -1,12 +1,11 @@
 #include "FBOTransmitter2.h"
 #include "stdafx.h"
 
+#include <algorithm>
 #include <array>
 
 #include "glad/glad.h"
 
-#include "snappy.h"
-
 #include "mmcore/utility/log/Log.h"
 
 #include "mmcore/CallerSlot.h"
@@ -39,20 +38,34 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
         , handshake_port_slot_{"handshakePort", "Port for zmq handshake"}
         , reconnect_slot_{"reconnect", "Reconnect comm threads"}
         , tiled_slot_("tiledDisplay", "True if rendering on a tiled display")
+        , tile_size_slot_{"tileSize", "Edge length of the tiles in pixels, only changed tiles are transmitted"}
+        , color_codec_slot_{"colorCodec", "Compression of the color tiles"}
+        , depth_codec_slot_{"depthCodec", "Compression of the depth tiles"}
+        , keyframe_interval_slot_{"keyframeInterval", "Number of frames after which all tiles are transmitted again"}
+        , transport_stats_slot_{"transportStats", "Periodically logs timings and sizes of the transmission"}
 #ifdef WITH_MPI
         , callRequestMpi("requestMpi", "Requests initialisation of MPI and the communicator for the view.")
         , toggle_aggregate_slot_{"aggregate", "Toggle whether to aggregate and composite FBOs prior to transmission"}
         , render_comp_img_slot_("renderCompImage", "Renders the complete composited image on the broadcast master")
+        , composite_method_slot_{"compositeMethod", "Method used to aggregate the FBOs of the render nodes"}
+        , radix_k_slot_{"radixK", "Number of nodes exchanging image parts per compositing round, 2 is binary swap"}
 #endif // WITH_MPI
         , aggregate_{false}
         , frame_id_{0}
         , thread_stop_{false}
-        , fbo_msg_read_{new fbo_msg_header_t}
-        , fbo_msg_send_{new fbo_msg_header_t}
+        , fbo_msg_read_{new fbo_msg_header_t{}}
+        , fbo_msg_send_{new fbo_msg_header_t{}}
         , color_buf_read_{new std::vector<char>}
         , depth_buf_read_{new std::vector<char>}
         , color_buf_send_{new std::vector<char>}
         , depth_buf_send_{new std::vector<char>}
+        , send_fresh_{false}
+        , fbo_msg_encode_{new fbo_msg_header_t{}}
+        , color_buf_encode_{new std::vector<char>}
+        , depth_buf_encode_{new std::vector<char>}
+        , keyframe_interval_{60}
+        , log_stats_{false}
+        , produced_frames_{0}
         , col_buf_el_size_{4}
         , depth_buf_el_size_{4}
         , connected_{false}
@@ -84,6 +97,13 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     render_comp_img_slot_ << new megamol::core::param::BoolParam{false};
     this->render_comp_img_slot_.SetUpdateCallback(&FBOTransmitter2::renderCompChanged);
     this->MakeSlotAvailable(&render_comp_img_slot_);
+    auto composite_method = new megamol::core::param::EnumParam(0);
+    composite_method->SetTypePair(0, "IceT");
+    composite_method->SetTypePair(1, "RadixK");
+    composite_method_slot_ << composite_method;
+    this->MakeSlotAvailable(&composite_method_slot_);
+    radix_k_slot_ << new megamol::core::param::IntParam(2, 2);
+    this->MakeSlotAvailable(&radix_k_slot_);
 #endif // WITH_MPI
     reconnect_slot_ << new megamol::core::param::ButtonParam{};
     reconnect_slot_.SetUpdateCallback(&FBOTransmitter2::reconnectCallback);
@@ -91,6 +111,24 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
 
     tiled_slot_ << new megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&tiled_slot_);
+
+    tile_size_slot_ << new megamol::core::param::IntParam(64, 8, 4096);
+    this->MakeSlotAvailable(&tile_size_slot_);
+    auto color_codec = new megamol::core::param::EnumParam(CODEC_SNAPPY);
+    color_codec->SetTypePair(CODEC_RAW, "None");
+    color_codec->SetTypePair(CODEC_SNAPPY, "Snappy");
+    color_codec_slot_ << color_codec;
+    this->MakeSlotAvailable(&color_codec_slot_);
+    auto depth_codec = new megamol::core::param::EnumParam(CODEC_SNAPPY);
+    depth_codec->SetTypePair(CODEC_RAW, "None");
+    depth_codec->SetTypePair(CODEC_SNAPPY, "Snappy");
+    depth_codec->SetTypePair(CODEC_DEPTH_Q16, "Quantized16+Snappy");
+    depth_codec_slot_ << depth_codec;
+    this->MakeSlotAvailable(&depth_codec_slot_);
+    keyframe_interval_slot_ << new megamol::core::param::IntParam(60, 0);
+    this->MakeSlotAvailable(&keyframe_interval_slot_);
+    transport_stats_slot_ << new megamol::core::param::BoolParam(false);
+    this->MakeSlotAvailable(&transport_stats_slot_);
 }
 
 
@@ -147,20 +185,31 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Extracting Viewport ... Done");
 #endif
 
-    // read FBO
-    std::vector<char> col_buf(width * height * col_buf_el_size_);
-    std::vector<char> depth_buf(width * height * depth_buf_el_size_);
+    // read FBO, the buffers are kept across frames
+    auto& col_buf = this->col_buf_;
+    auto& depth_buf = this->depth_buf_;
+    col_buf.resize(width * height * col_buf_el_size_);
+    depth_buf.resize(width * height * depth_buf_el_size_);
 
     if ((tile_width == width) && (tile_height == height)) {
         glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf.data());
         glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buf.data());
     } else {
-        std::vector<char> col_buf_tile(tile_width * tile_height * col_buf_el_size_);
-        std::vector<char> depth_buf_tile(tile_width * tile_height * depth_buf_el_size_);
+        auto& col_buf_tile = this->col_buf_tile_;
+        auto& depth_buf_tile = this->depth_buf_tile_;
+        col_buf_tile.resize(tile_width * tile_height * col_buf_el_size_);
+        depth_buf_tile.resize(tile_width * tile_height * depth_buf_el_size_);
 
         glReadPixels(0, 0, tile_width, tile_height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf_tile.data());
         glReadPixels(0, 0, tile_width, tile_height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_buf_tile.data());
 
+#ifdef WITH_MPI
+        if (aggregate_) {
+            // pixels outside the tile must not win the depth test when compositing
+            std::fill_n(reinterpret_cast<float*>(depth_buf.data()), width * height, 1.0f);
+        }
+#endif // WITH_MPI
+
         int row_offset = yoff * width; // y * width = row offset * tile width
         int column_offset = xoff;      // x  = column offset
         int color_row_tile_width = col_buf_el_size_ * tile_width;
@@ -186,7 +235,16 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
     IceTUByte* icet_col_buf = reinterpret_cast<IceTUByte*>(col_buf.data());
     IceTFloat* icet_depth_buf = reinterpret_cast<IceTFloat*>(depth_buf.data());
 
-    if (aggregate_) {
+    if (aggregate_ && this->radix_k_ != nullptr) {
+        // only the composited image on rank 0 is transmitted
+        if (!this->radix_k_->Composite(col_buf, depth_buf, 0)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "FBOTransmitter2: RadixK compositing failed at rank %d\n", mpiRank);
+        }
+        if (mpiRank == 0 && this->render_comp_img_slot_.Param<core::param::BoolParam>()->Value()) {
+            glDrawPixels(width, height, GL_RGBA, GL_UNSIGNED_BYTE, col_buf.data());
+        }
+    } else if (aggregate_) {
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "FBOTransmitter2: Simple IceT commit at rank %d\n", mpiRank);
@@ -249,6 +307,12 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
             }
             this->fbo_msg_read_->color_type = fbo_color_type::RGBAu8;
             this->fbo_msg_read_->depth_type = fbo_depth_type::Df;
+            this->fbo_msg_read_->tile_size = static_cast<unsigned int>(
+                this->tile_size_slot_.Param<megamol::core::param::IntParam>()->Value());
+            this->fbo_msg_read_->color_codec = static_cast<fbo_codec_type>(
+                this->color_codec_slot_.Param<megamol::core::param::EnumParam>()->Value());
+            this->fbo_msg_read_->depth_codec = static_cast<fbo_codec_type>(
+                this->depth_codec_slot_.Param<megamol::core::param::EnumParam>()->Value());
             for (int i = 0; i < 6; ++i) {
                 this->fbo_msg_read_->os_bbox[i] = this->fbo_msg_read_->cs_bbox[i] = bbox[i];
             }
@@ -275,6 +339,10 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
             this->fbo_msg_read_->frame_id = this->frame_id_.fetch_add(1);
         }
 
+        this->keyframe_interval_.store(this->keyframe_interval_slot_.Param<megamol::core::param::IntParam>()->Value());
+        this->log_stats_.store(this->transport_stats_slot_.Param<megamol::core::param::BoolParam>()->Value());
+        this->produced_frames_.fetch_add(1);
+
         this->swapBuffers();
 #if _DEBUG
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Swapping Buffer ... Done\n");
@@ -287,10 +355,15 @@ void megamol::remote::FBOTransmitter2::AfterRender(megamol::core::view::Abstract
 
 
 void megamol::remote::FBOTransmitter2::transmitterJob() {
+    using clock_type = FBOTransportStats::clock_type;
     try {
+        // message buffer, kept across frames
+        std::vector<char> buf;
+        FBOTransportStats stats{"FBOTransmitter2", {"wait", "encode", "send"}};
+        int frames_since_key_frame = 0;
         while (!this->thread_stop_) {
+            auto const wait_start = clock_type::now();
             // transmit only upon request
-            std::vector<char> buf;
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Waiting for request\n");
@@ -317,83 +390,65 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
                     "FBOTransmitter2: Exception during recv in 'transmitterJob'\n");
             }
 
-            // wait for request
+            // the compositor requests all tiles if it cannot apply the changed ones
+            static char const key_request[] = {'k', 'e', 'y'};
+            bool key_frame = std::equal(buf.begin(), buf.end(), std::begin(key_request), std::end(key_request));
+            auto const interval = this->keyframe_interval_.load();
+            if (interval > 0 && frames_since_key_frame >= interval) {
+                key_frame = true;
+            }
+
+            // take over the latest frame, the render thread meanwhile continues on the other buffers
+            auto const encode_start = clock_type::now();
             {
                 std::lock_guard<std::mutex> send_lock(this->buffer_send_guard_);
+                if (this->send_fresh_) {
+                    swap(this->fbo_msg_send_, this->fbo_msg_encode_);
+                    swap(this->color_buf_send_, this->color_buf_encode_);
+                    swap(this->depth_buf_send_, this->depth_buf_encode_);
+                    this->send_fresh_ = false;
+                }
+            }
 
-                //#ifdef WITH_MPI
-                //            IceTUByte* icet_col_buf = nullptr;
-                //            IceTFloat* icet_depth_buf = nullptr;
-                //            if (aggregate_) {
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Complex IceT commit at rank
-                //                %d\n", rank_);
-                //#endif
-                //                std::array<IceTFloat, 4> backgroundColor = {0, 0, 0, 0};
-                //                auto const icet_comp_image = icetCompositeImage(this->color_buf_send_->data(),
-                //                    this->depth_buf_send_->data(), nullptr, nullptr, nullptr, backgroundColor.data());
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Recieved IceT image at rank
-                //                %d\n", rank_);
-                //#endif
-                //                icet_col_buf = icetImageGetColorub(icet_comp_image);
-                //                icet_depth_buf = icetImageGetDepthf(icet_comp_image);
-                //            }
-                //#endif
-
-                // snappy compression
-                std::vector<char> col_comp_buf(snappy::MaxCompressedLength(this->color_buf_send_->size()));
-                std::vector<char> depth_comp_buf(snappy::MaxCompressedLength(this->depth_buf_send_->size()));
-                size_t col_comp_size = 0;
-                size_t depth_comp_size = 0;
-
-                // if (aggregate_) {
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_col_buf), this->color_buf_send_->size(),
-                //        col_comp_buf.data(), &col_comp_size);
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_depth_buf), this->depth_buf_send_->size(),
-                //        depth_comp_buf.data(), &depth_comp_size);
-                //} else {
-                snappy::RawCompress(
-                    this->color_buf_send_->data(), this->color_buf_send_->size(), col_comp_buf.data(), &col_comp_size);
-                snappy::RawCompress(this->depth_buf_send_->data(), this->depth_buf_send_->size(), depth_comp_buf.data(),
-                    &depth_comp_size);
-                //}
-
-                fbo_msg_send_->color_buf_size = col_comp_size;
-                fbo_msg_send_->depth_buf_size = depth_comp_size;
-                // compose message from header, color_buf, and depth_buf
-                buf.resize(sizeof(fbo_msg_header_t) + col_comp_size + depth_comp_size);
-                std::copy(reinterpret_cast<char*>(&(*fbo_msg_send_)),
-                    reinterpret_cast<char*>(&(*fbo_msg_send_)) + sizeof(fbo_msg_header_t), buf.data());
-                /*std::copy(
-                    this->color_buf_send_->begin(), this->color_buf_send_->end(), buf.data() +
-                sizeof(fbo_msg_header_t)); std::copy(this->depth_buf_send_->begin(), this->depth_buf_send_->end(),
-                    buf.data() + sizeof(fbo_msg_header_t) + this->color_buf_send_->size());*/
-                std::copy(
-                    col_comp_buf.data(), col_comp_buf.data() + col_comp_size, buf.data() + sizeof(fbo_msg_header_t));
-                std::copy(depth_comp_buf.data(), depth_comp_buf.data() + depth_comp_size,
-                    buf.data() + sizeof(fbo_msg_header_t) + col_comp_size);
-
-                // send data
-                try {
+            // without a new frame all tiles are clean and only the header is sent
+            this->encoder_.Encode(
+                *this->fbo_msg_encode_, *this->color_buf_encode_, *this->depth_buf_encode_, key_frame, buf);
+            frames_since_key_frame = (this->fbo_msg_encode_->key_frame != 0) ? 1 : frames_since_key_frame + 1;
+            auto const send_start = clock_type::now();
+
+            // send data
+            try {
 #if _DEBUG
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending answer\n");
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending answer\n");
 #endif
-                    if (!this->comm_->Send(buf, send_type::SEND)) {
-                        megamol::core::utility::log::Log::DefaultLog.WriteError(
-                            "FBOTransmitter2: Error during send in 'transmitterJob'\n");
-                    }
+                if (!this->comm_->Send(buf, send_type::SEND)) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError(
+                        "FBOTransmitter2: Error during send in 'transmitterJob'\n");
+                }
 #if _DEBUG
-                    else {
-                        megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Answer sent\n");
-                    }
+                else {
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Answer sent\n");
+                }
 #endif
-                } catch (zmq::error_t const& e) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "FBOTransmitter2: Exception during send in 'transmitterJob': %s\n", e.what());
-                } catch (...) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "FBOTransmitter2: Exception during send in 'transmitterJob'\n");
+            } catch (zmq::error_t const& e) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOTransmitter2: Exception during send in 'transmitterJob': %s\n", e.what());
+            } catch (...) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOTransmitter2: Exception during send in 'transmitterJob'\n");
+            }
+
+            auto const send_end = clock_type::now();
+            stats.Record(0, encode_start - wait_start);
+            stats.Record(1, send_start - encode_start);
+            stats.Record(2, send_end - send_start);
+            stats.FrameDone(buf.size(), this->encoder_.DirtyTiles(), this->encoder_.TotalTiles());
+            if (stats.Due(std::chrono::seconds(5))) {
+                auto const produced = this->produced_frames_.exchange(0);
+                if (this->log_stats_.load()) {
+                    stats.Report(produced);
+                } else {
+                    stats.Reset();
                 }
             }
         }
@@ -712,6 +767,7 @@ bool megamol::remote::FBOTransmitter2::initThreads() {
             this->comm_->Bind(std::string{"tcp://*:"} + address);
 
             this->thread_stop_ = false;
+            this->encoder_.Reset();
 
             this->transmitter_thread_ = std::thread(&FBOTransmitter2::transmitterJob, this);
 
@@ -735,9 +791,10 @@ bool megamol::remote::FBOTransmitter2::shutdownThreads() {
         this->transmitter_thread_.join();
 
 #ifdef WITH_MPI
-    if (useMpi) {
+    if (icet_initialized_) {
         icetDestroyMPICommunicator(icet_comm_);
         icetDestroyContext(icet_ctx_);
+        icet_initialized_ = false;
     }
 #endif // WITH_MPI
 
@@ -781,10 +838,23 @@ void megamol::remote::FBOTransmitter2::initIceT() {
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(
             "FBOTransmitter2: Initializing IceT at rank %d\n", mpiRank);
 #endif
+        if (this->composite_method_slot_.Param<megamol::core::param::EnumParam>()->Value() == 1) {
+            this->radix_k_ = std::make_unique<FBORadixKCompositor>(
+                this->mpi_comm_, this->radix_k_slot_.Param<megamol::core::param::IntParam>()->Value());
+#ifdef _DEBUG
+            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                "FBOTransmitter2: Initialized RadixK compositing with %d rounds at rank %d\n",
+                static_cast<int>(this->radix_k_->Rounds().size()), mpiRank);
+#endif
+            return;
+        }
+        this->radix_k_.reset();
+
         // icet setup
 
         icet_comm_ = icetCreateMPICommunicator(this->mpi_comm_);
         icet_ctx_ = icetCreateContext(icet_comm_);
+        icet_initialized_ = true;
         icetStrategy(ICET_STRATEGY_SEQUENTIAL);
         icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
         icetCompositeMode(ICET_COMPOSITE_MODE_Z_BUFFER);
@@ -12,11 +12,13 @@
 
 #include "FBOCommFabric.h"
 #include "FBOProto.h"
+#include "FBOTileTransport.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/view/AbstractView.h"
 #include "vislib/graphics/gl/FramebufferObject.h"
 
 #ifdef WITH_MPI
+#include "FBORadixKCompositor.h"
 #include "IceT.h"
 #include "IceTMPI.h"
 #endif // WITH_MPI
@@ -85,6 +87,7 @@ private:
         swap(fbo_msg_read_, fbo_msg_send_);
         swap(color_buf_read_, color_buf_send_);
         swap(depth_buf_read_, depth_buf_send_);
+        send_fresh_ = true;
     }
 
     void transmitterJob();
@@ -123,6 +126,16 @@ private:
 
     megamol::core::param::ParamSlot tiled_slot_;
 
+    megamol::core::param::ParamSlot tile_size_slot_;
+
+    megamol::core::param::ParamSlot color_codec_slot_;
+
+    megamol::core::param::ParamSlot depth_codec_slot_;
+
+    megamol::core::param::ParamSlot keyframe_interval_slot_;
+
+    megamol::core::param::ParamSlot transport_stats_slot_;
+
     bool aggregate_;
 
 #ifdef WITH_MPI
@@ -133,6 +146,10 @@ private:
 
     megamol::core::param::ParamSlot render_comp_img_slot_;
 
+    megamol::core::param::ParamSlot composite_method_slot_;
+
+    megamol::core::param::ParamSlot radix_k_slot_;
+
 
     bool useMpi = false;
     int mpiRank = -1, mpiSize = -1;
@@ -141,6 +158,11 @@ private:
 
     IceTCommunicator icet_comm_;
 
+    bool icet_initialized_ = false;
+
+    /** CPU compositor used instead of IceT if selected */
+    std::unique_ptr<FBORadixKCompositor> radix_k_;
+
     MPI_Comm mpi_comm_ = MPI_COMM_NULL;
 #endif // WITH_MPI
 
@@ -170,6 +192,33 @@ private:
 
     std::unique_ptr<std::vector<char>> depth_buf_send_;
 
+    /** true if the send buffers hold a frame which has not been handed to the transmitter thread */
+    bool send_fresh_;
+
+    /** buffers of the frame being encoded, only touched by the transmitter thread */
+    std::unique_ptr<fbo_msg_header_t> fbo_msg_encode_;
+
+    std::unique_ptr<std::vector<char>> color_buf_encode_;
+
+    std::unique_ptr<std::vector<char>> depth_buf_encode_;
+
+    FBOTileEncoder encoder_;
+
+    std::atomic<int> keyframe_interval_;
+
+    std::atomic<bool> log_stats_;
+
+    std::atomic<size_t> produced_frames_;
+
+    /** FBO read buffers, kept across frames */
+    std::vector<char> col_buf_;
+
+    std::vector<char> depth_buf_;
+
+    std::vector<char> col_buf_tile_;
+
+    std::vector<char> depth_buf_tile_;
+
     std::unique_ptr<AbstractCommFabric> comm_impl_;
 
     std::unique_ptr<FBOCommFabric> comm_;
@@ -0,0 +1,649 @@
+/*
+ * BrickPyramid.cpp
+ *
+ * Copyright (C) 2021 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "BrickPyramid.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "datRaw.h"
+
+#include "mmcore/utility/log/Log.h"
+
+
+namespace {
+
+const char SIDECAR_MAGIC[8] = {'M', 'M', 'B', 'R', 'I', 'C', 'K', 'S'};
+const uint32_t SIDECAR_VERSION = 1;
+
+/** Bytes of the sidecar header before the frame directory */
+const uint64_t SIDECAR_HEADER_SIZE = 8 + 4 + 4 * 8 + 4 + 4 * 8 + 3 * 4;
+
+template<class T>
+inline void write(std::fstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+inline void read(std::fstream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/** Answer the size and modification time of 'path', zero if it does not exist */
+void stampOf(const std::filesystem::path& path, uint64_t& outSize, int64_t& outModified) {
+    std::error_code ec;
+    outSize = 0;
+    outModified = 0;
+    if (path.empty()) {
+        return;
+    }
+    const auto size = std::filesystem::file_size(path, ec);
+    if (!ec) {
+        outSize = static_cast<uint64_t>(size);
+    }
+    const auto modified = std::filesystem::last_write_time(path, ec);
+    if (!ec) {
+        outModified = static_cast<int64_t>(modified.time_since_epoch().count());
+    }
+}
+
+/**
+ * Invokes 'func' with a null pointer of the scalar type of 'format'. Answer
+ * 'false' without calling 'func' if the scalars cannot be computed with.
+ */
+template<class F>
+bool dispatchFormat(const int format, F&& func) {
+    switch (format) {
+    case DR_FORMAT_CHAR:
+        func(static_cast<int8_t*>(nullptr));
+        return true;
+    case DR_FORMAT_UCHAR:
+        func(static_cast<uint8_t*>(nullptr));
+        return true;
+    case DR_FORMAT_SHORT:
+        func(static_cast<int16_t*>(nullptr));
+        return true;
+    case DR_FORMAT_USHORT:
+        func(static_cast<uint16_t*>(nullptr));
+        return true;
+    case DR_FORMAT_INT:
+        func(static_cast<int32_t*>(nullptr));
+        return true;
+    case DR_FORMAT_UINT:
+        func(static_cast<uint32_t*>(nullptr));
+        return true;
+    case DR_FORMAT_LONG:
+        func(static_cast<int64_t*>(nullptr));
+        return true;
+    case DR_FORMAT_ULONG:
+        func(static_cast<uint64_t*>(nullptr));
+        return true;
+    case DR_FORMAT_FLOAT:
+        func(static_cast<float*>(nullptr));
+        return true;
+    case DR_FORMAT_DOUBLE:
+        func(static_cast<double*>(nullptr));
+        return true;
+    default:
+        return false;
+    }
+}
+
+/** Halves the resolution by averaging 2x2x2 voxels (fewer at the border) */
+template<class T>
+void downsample(const T* src, const size_t* srcRes, T* dst, const size_t* dstRes, const size_t components) {
+    for (size_t z = 0; z < dstRes[2]; ++z) {
+        const size_t z1 = std::min(2 * z + 1, srcRes[2] - 1);
+        for (size_t y = 0; y < dstRes[1]; ++y) {
+            const size_t y1 = std::min(2 * y + 1, srcRes[1] - 1);
+            for (size_t x = 0; x < dstRes[0]; ++x) {
+                const size_t x1 = std::min(2 * x + 1, srcRes[0] - 1);
+                for (size_t c = 0; c < components; ++c) {
+                    double sum = 0.0;
+                    size_t cnt = 0;
+                    for (size_t sz = 2 * z; sz <= z1; ++sz) {
+                        for (size_t sy = 2 * y; sy <= y1; ++sy) {
+                            for (size_t sx = 2 * x; sx <= x1; ++sx) {
+                                sum += static_cast<double>(
+                                    src[((sz * srcRes[1] + sy) * srcRes[0] + sx) * components + c]);
+                                ++cnt;
+                            }
+                        }
+                    }
+                    sum /= static_cast<double>(cnt);
+                    if (std::is_integral<T>::value) {
+                        sum = std::round(sum);
+                    }
+                    dst[((z * dstRes[1] + y) * dstRes[0] + x) * components + c] = static_cast<T>(sum);
+                }
+            }
+        }
+    }
+}
+
+/** Halves the resolution by picking the first of 2x2x2 voxels */
+void downsampleRaw(
+    const uint8_t* src, const size_t* srcRes, uint8_t* dst, const size_t* dstRes, const size_t voxelSize) {
+    for (size_t z = 0; z < dstRes[2]; ++z) {
+        for (size_t y = 0; y < dstRes[1]; ++y) {
+            for (size_t x = 0; x < dstRes[0]; ++x) {
+                std::memcpy(dst + ((z * dstRes[1] + y) * dstRes[0] + x) * voxelSize,
+                    src + ((2 * z * srcRes[1] + 2 * y) * srcRes[0] + 2 * x) * voxelSize, voxelSize);
+            }
+        }
+    }
+}
+
+/**
+ * Computes the minima of all components followed by the maxima of all
+ * components within [begin, end[, ignoring NaN.
+ */
+template<class T>
+void statistics(const T* vol, const size_t* res, const size_t components, const size_t* begin, const size_t* end,
+    double* outStats) {
+    std::fill(outStats, outStats + components, std::numeric_limits<double>::infinity());
+    std::fill(outStats + components, outStats + 2 * components, -std::numeric_limits<double>::infinity());
+    for (size_t z = begin[2]; z < end[2]; ++z) {
+        for (size_t y = begin[1]; y < end[1]; ++y) {
+            const T* row = vol + ((z * res[1] + y) * res[0] + begin[0]) * components;
+            for (size_t i = 0; i < (end[0] - begin[0]) * components; ++i) {
+                const auto v = static_cast<double>(row[i]);
+                const auto c = i % components;
+                if (v < outStats[c]) {
+                    outStats[c] = v;
+                }
+                if (v > outStats[components + c]) {
+                    outStats[components + c] = v;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+/*
+ * megamol::volume::BrickPyramid::SidecarPath
+ */
+std::filesystem::path megamol::volume::BrickPyramid::SidecarPath(const std::filesystem::path& datFile) {
+    auto retval = datFile;
+    retval += ".mmbricks";
+    return retval;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::BrickPyramid
+ */
+megamol::volume::BrickPyramid::BrickPyramid(void) : frameBytes(0), layout(), totalBricks(0), voxelSize(0) {
+    // intentionally empty
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::~BrickPyramid
+ */
+megamol::volume::BrickPyramid::~BrickPyramid(void) {
+    this->Close();
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::Build
+ */
+bool megamol::volume::BrickPyramid::Build(const unsigned int frame, const void* data) {
+    using megamol::core::utility::log::Log;
+
+    if (!this->IsOpen() || (frame >= this->frameOffsets.size()) || (data == nullptr)) {
+        return false;
+    }
+
+    const auto components = this->layout.Components;
+    const auto brickSize = this->layout.BrickSize;
+
+    /* Compute all levels in memory, each one is an eighth of the previous one. */
+    std::vector<std::vector<uint8_t>> volumes(this->levels.size());
+    std::vector<const uint8_t*> voxels(this->levels.size());
+    voxels[0] = static_cast<const uint8_t*>(data);
+    for (size_t l = 1; l < this->levels.size(); ++l) {
+        const auto& src = this->levels[l - 1];
+        const auto& dst = this->levels[l];
+        volumes[l].resize(dst.Resolution[0] * dst.Resolution[1] * dst.Resolution[2] * this->voxelSize);
+        voxels[l] = volumes[l].data();
+        const bool isTyped = dispatchFormat(this->layout.Format, [&](auto* type) {
+            using T = std::remove_pointer_t<decltype(type)>;
+            downsample(reinterpret_cast<const T*>(voxels[l - 1]), src.Resolution,
+                reinterpret_cast<T*>(volumes[l].data()), dst.Resolution, components);
+        });
+        if (!isTyped) {
+            downsampleRaw(voxels[l - 1], src.Resolution, volumes[l].data(), dst.Resolution, this->voxelSize);
+        }
+    }
+
+    /*
+     * The statistics of level 0 are computed from the voxels, a brick of the
+     * next level covers 2x2x2 bricks of the previous one.
+     */
+    std::vector<double> stats(this->totalBricks * 2 * components, std::numeric_limits<double>::quiet_NaN());
+    {
+        const auto& l0 = this->levels[0];
+        dispatchFormat(this->layout.Format, [&](auto* type) {
+            using T = std::remove_pointer_t<decltype(type)>;
+            for (size_t z = 0; z < l0.Bricks[2]; ++z) {
+                for (size_t y = 0; y < l0.Bricks[1]; ++y) {
+                    for (size_t x = 0; x < l0.Bricks[0]; ++x) {
+                        const size_t begin[3] = {x * brickSize, y * brickSize, z * brickSize};
+                        const size_t end[3] = {std::min(begin[0] + brickSize, l0.Resolution[0]),
+                            std::min(begin[1] + brickSize, l0.Resolution[1]),
+                            std::min(begin[2] + brickSize, l0.Resolution[2])};
+                        const auto idx = (z * l0.Bricks[1] + y) * l0.Bricks[0] + x;
+                        statistics(reinterpret_cast<const T*>(data), l0.Resolution, components, begin, end,
+                            stats.data() + idx * 2 * components);
+                    }
+                }
+            }
+        });
+    }
+    for (size_t l = 1; l < this->levels.size(); ++l) {
+        const auto& src = this->levels[l - 1];
+        const auto& dst = this->levels[l];
+        for (size_t z = 0; z < dst.Bricks[2]; ++z) {
+            for (size_t y = 0; y < dst.Bricks[1]; ++y) {
+                for (size_t x = 0; x < dst.Bricks[0]; ++x) {
+                    double* s = stats.data() + (dst.FirstBrick + (z * dst.Bricks[1] + y) * dst.Bricks[0] + x) * 2 *
+                                                   components;
+                    std::fill(s, s + components, std::numeric_limits<double>::infinity());
+                    std::fill(s + components, s + 2 * components, -std::numeric_limits<double>::infinity());
+                    for (size_t cz = 2 * z; cz < std::min(2 * z + 2, src.Bricks[2]); ++cz) {
+                        for (size_t cy = 2 * y; cy < std::min(2 * y + 2, src.Bricks[1]); ++cy) {
+                            for (size_t cx = 2 * x; cx < std::min(2 * x + 2, src.Bricks[0]); ++cx) {
+                                const double* cs =
+                                    stats.data() +
+                                    (src.FirstBrick + (cz * src.Bricks[1] + cy) * src.Bricks[0] + cx) * 2 * components;
+                                for (size_t c = 0; c < components; ++c) {
+                                    // NaN, i.e. unknown statistics, propagate through the comparisons
+                                    s[c] = (cs[c] < s[c] || std::isnan(cs[c])) ? cs[c] : s[c];
+                                    s[components + c] = (cs[components + c] > s[components + c] ||
+                                                            std::isnan(cs[components + c]))
+                                                            ? cs[components + c]
+                                                            : s[components + c];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Append the frame and publish it in the directory only after it is complete. */
+    this->file.clear();
+    this->file.seekp(0, std::ios::end);
+    const auto offset = static_cast<uint64_t>(this->file.tellp());
+    std::vector<uint8_t> brick;
+    for (size_t l = 0; l < this->levels.size(); ++l) {
+        const auto& level = this->levels[l];
+        for (size_t z = 0; z < level.Bricks[2]; ++z) {
+            for (size_t y = 0; y < level.Bricks[1]; ++y) {
+                for (size_t x = 0; x < level.Bricks[0]; ++x) {
+                    const size_t begin[3] = {x * brickSize, y * brickSize, z * brickSize};
+                    const size_t res[3] = {std::min(brickSize, level.Resolution[0] - begin[0]),
+                        std::min(brickSize, level.Resolution[1] - begin[1]),
+                        std::min(brickSize, level.Resolution[2] - begin[2])};
+                    const size_t rowSize = res[0] * this->voxelSize;
+                    brick.resize(rowSize * res[1] * res[2]);
+                    for (size_t bz = 0; bz < res[2]; ++bz) {
+                        for (size_t by = 0; by < res[1]; ++by) {
+                            const auto src = voxels[l] + (((begin[2] + bz) * level.Resolution[1] + begin[1] + by) *
+                                                                 level.Resolution[0] +
+                                                             begin[0]) *
+                                                             this->voxelSize;
+                            std::memcpy(brick.data() + (bz * res[1] + by) * rowSize, src, rowSize);
+                        }
+                    }
+                    this->file.write(reinterpret_cast<const char*>(brick.data()), brick.size());
+                }
+            }
+        }
+    }
+    this->file.write(reinterpret_cast<const char*>(stats.data()), stats.size() * sizeof(double));
+    this->file.flush();
+
+    this->file.seekp(this->directoryOffset() + frame * sizeof(uint64_t));
+    write(this->file, offset);
+    this->file.flush();
+    if (!this->file) {
+        Log::DefaultLog.WriteError("Failed to write frame %u to the brick cache \"%s\".", frame,
+            SidecarPath(this->datFile).generic_u8string().c_str());
+        this->Close();
+        return false;
+    }
+
+    this->frameOffsets[frame] = offset;
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::Close
+ */
+void megamol::volume::BrickPyramid::Close(void) {
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+    this->file.clear();
+    this->bricks.clear();
+    this->brickData.clear();
+    this->brickStats.clear();
+    this->datFile.clear();
+    this->frameOffsets.clear();
+    this->levels.clear();
+    this->rawFile.clear();
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::Open
+ */
+bool megamol::volume::BrickPyramid::Open(const std::filesystem::path& datFile, const std::filesystem::path& rawFile,
+    const Layout& layout, const bool isCreate) {
+    using megamol::core::utility::log::Log;
+
+    const auto isSameLayout = [this](const Layout& l) {
+        return (l.Format == this->layout.Format) &&
+               std::equal(l.Resolution, l.Resolution + 3, this->layout.Resolution) &&
+               (l.Components == this->layout.Components) && (l.Frames == this->layout.Frames) &&
+               (l.BrickSize == this->layout.BrickSize);
+    };
+    if (this->IsOpen() && (this->datFile == datFile) && (this->rawFile == rawFile) && isSameLayout(layout)) {
+        return true;
+    }
+
+    this->Close();
+    if ((layout.BrickSize == 0) || (layout.Components == 0) || (::datRaw_getFormatSize(layout.Format) <= 0)) {
+        return false;
+    }
+    this->datFile = datFile;
+    this->rawFile = rawFile;
+    this->layout = layout;
+    this->voxelSize = layout.Components * ::datRaw_getFormatSize(layout.Format);
+    this->computeLevels();
+
+    Stamp stamp;
+    stampOf(datFile, stamp.DatSize, stamp.DatModified);
+    stampOf(rawFile, stamp.RawSize, stamp.RawModified);
+
+    const auto path = SidecarPath(datFile);
+    this->file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (this->file.is_open() && this->readHeader(stamp)) {
+        Log::DefaultLog.WriteInfo("Using the brick cache \"%s\" (%u levels).", path.generic_u8string().c_str(),
+            this->Levels());
+        return true;
+    }
+
+    if (!isCreate) {
+        this->Close();
+        return false;
+    }
+
+    this->file.close();
+    this->file.clear();
+    if (!this->writeHeader(stamp)) {
+        Log::DefaultLog.WriteError(
+            "Could not create the brick cache \"%s\". Bricks cannot be provided.", path.generic_u8string().c_str());
+        this->Close();
+        return false;
+    }
+    Log::DefaultLog.WriteInfo("Started the brick cache \"%s\" (%u levels of bricks with %zu voxels per edge).",
+        path.generic_u8string().c_str(), this->Levels(), layout.BrickSize);
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::Query
+ */
+bool megamol::volume::BrickPyramid::Query(
+    const unsigned int frame, unsigned int level, const size_t* min, const size_t* max) {
+    this->bricks.clear();
+    if (!this->IsBuilt(frame)) {
+        return false;
+    }
+
+    level = std::min(level, this->Levels() - 1);
+    const auto& lvl = this->levels[level];
+    const auto& l0 = this->levels[0];
+    const auto components = this->layout.Components;
+    const auto brickSize = this->layout.BrickSize;
+
+    /* Convert the region to bricks of the level, rounding outwards. */
+    size_t first[3], last[3];
+    for (int d = 0; d < 3; ++d) {
+        const size_t lo = min[d] >> level;
+        const size_t hi = (std::min(max[d], l0.Resolution[d]) + (static_cast<size_t>(1) << level) - 1) >> level;
+        if (lo >= std::min(hi, lvl.Resolution[d])) {
+            return true;
+        }
+        first[d] = lo / brickSize;
+        last[d] = (std::min(hi, lvl.Resolution[d]) - 1) / brickSize;
+    }
+
+    const size_t cnt = (last[0] - first[0] + 1) * (last[1] - first[1] + 1) * (last[2] - first[2] + 1);
+    uint64_t total = 0;
+    for (size_t z = first[2]; z <= last[2]; ++z) {
+        for (size_t y = first[1]; y <= last[1]; ++y) {
+            for (size_t x = first[0]; x <= last[0]; ++x) {
+                total += this->brickBytes(lvl, x, y, z);
+            }
+        }
+    }
+    this->brickData.resize(static_cast<size_t>(total));
+    this->brickStats.resize(cnt * 2 * components);
+    this->bricks.resize(cnt);
+
+    const auto frameOffset = this->frameOffsets[frame];
+    const auto statsOffset = frameOffset + this->frameBytes;
+    this->file.clear();
+    uint64_t dataOffset = 0;
+    size_t i = 0;
+    for (size_t z = first[2]; z <= last[2]; ++z) {
+        for (size_t y = first[1]; y <= last[1]; ++y) {
+            for (size_t x = first[0]; x <= last[0]; ++x, ++i) {
+                auto& brick = this->bricks[i];
+                const size_t idx[3] = {x, y, z};
+                brick.Level = level;
+                for (int d = 0; d < 3; ++d) {
+                    brick.Offset[d] = idx[d] * brickSize;
+                    brick.Resolution[d] = std::min(brickSize, lvl.Resolution[d] - brick.Offset[d]);
+                }
+
+                const auto size = this->brickBytes(lvl, x, y, z);
+                this->file.seekg(frameOffset + this->brickOffset(lvl, x, y, z));
+                this->file.read(reinterpret_cast<char*>(this->brickData.data() + dataOffset), size);
+                brick.Data = this->brickData.data() + dataOffset;
+                dataOffset += size;
+
+                double* stats = this->brickStats.data() + i * 2 * components;
+                const auto brickIdx = lvl.FirstBrick + (z * lvl.Bricks[1] + y) * lvl.Bricks[0] + x;
+                this->file.seekg(statsOffset + brickIdx * 2 * components * sizeof(double));
+                this->file.read(reinterpret_cast<char*>(stats), 2 * components * sizeof(double));
+                const bool isKnown = !std::isnan(stats[0]);
+                brick.MinValues = isKnown ? stats : nullptr;
+                brick.MaxValues = isKnown ? stats + components : nullptr;
+            }
+        }
+    }
+
+    if (!this->file) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Failed to read bricks of frame %u from \"%s\".",
+            frame, SidecarPath(this->datFile).generic_u8string().c_str());
+        this->bricks.clear();
+        this->file.clear();
+        return false;
+    }
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::brickBytes
+ */
+uint64_t megamol::volume::BrickPyramid::brickBytes(
+    const Level& level, const size_t x, const size_t y, const size_t z) const {
+    const auto b = this->layout.BrickSize;
+    return static_cast<uint64_t>(std::min(b, level.Resolution[0] - x * b)) *
+           std::min(b, level.Resolution[1] - y * b) * std::min(b, level.Resolution[2] - z * b) * this->voxelSize;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::brickOffset
+ */
+uint64_t megamol::volume::BrickPyramid::brickOffset(
+    const Level& level, const size_t x, const size_t y, const size_t z) const {
+    // all bricks before the last one of a row, column and slice have full size
+    const uint64_t b = this->layout.BrickSize;
+    const uint64_t sy = std::min<uint64_t>(b, level.Resolution[1] - y * b);
+    const uint64_t sz = std::min<uint64_t>(b, level.Resolution[2] - z * b);
+    const uint64_t voxels = z * b * level.Resolution[1] * level.Resolution[0] + sz * y * b * level.Resolution[0] +
+                            sz * sy * x * b;
+    return level.Offset + voxels * this->voxelSize;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::computeLevels
+ */
+void megamol::volume::BrickPyramid::computeLevels(void) {
+    const auto b = this->layout.BrickSize;
+    this->levels.clear();
+    this->totalBricks = 0;
+    this->frameBytes = 0;
+
+    Level level;
+    std::copy(this->layout.Resolution, this->layout.Resolution + 3, level.Resolution);
+    while (true) {
+        uint64_t voxels = 1;
+        for (int d = 0; d < 3; ++d) {
+            level.Resolution[d] = std::max<size_t>(level.Resolution[d], 1);
+            level.Bricks[d] = (level.Resolution[d] + b - 1) / b;
+            voxels *= level.Resolution[d];
+        }
+        level.FirstBrick = this->totalBricks;
+        level.Offset = this->frameBytes;
+        this->levels.push_back(level);
+        this->totalBricks += level.Bricks[0] * level.Bricks[1] * level.Bricks[2];
+        this->frameBytes += voxels * this->voxelSize;
+
+        if ((level.Bricks[0] == 1) && (level.Bricks[1] == 1) && (level.Bricks[2] == 1)) {
+            break;
+        }
+        for (int d = 0; d < 3; ++d) {
+            level.Resolution[d] = (level.Resolution[d] + 1) / 2;
+        }
+    }
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::directoryOffset
+ */
+uint64_t megamol::volume::BrickPyramid::directoryOffset(void) const {
+    return SIDECAR_HEADER_SIZE;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::readHeader
+ */
+bool megamol::volume::BrickPyramid::readHeader(const Stamp& stamp) {
+    char magic[8];
+    uint32_t version, brickSize, levels, frames;
+    int32_t format;
+    Stamp stored;
+    uint64_t resolution[3], components;
+
+    this->file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<uint64_t>(this->file.tellg());
+    this->file.seekg(0);
+    this->file.read(magic, sizeof(magic));
+    read(this->file, version);
+    read(this->file, stored.DatSize);
+    read(this->file, stored.DatModified);
+    read(this->file, stored.RawSize);
+    read(this->file, stored.RawModified);
+    read(this->file, format);
+    for (auto& r : resolution) {
+        read(this->file, r);
+    }
+    read(this->file, components);
+    read(this->file, brickSize);
+    read(this->file, levels);
+    read(this->file, frames);
+
+    if (!this->file || (std::memcmp(magic, SIDECAR_MAGIC, sizeof(magic)) != 0) || (version != SIDECAR_VERSION) ||
+        (std::memcmp(&stored, &stamp, sizeof(Stamp)) != 0) || (format != this->layout.Format) ||
+        (resolution[0] != this->layout.Resolution[0]) || (resolution[1] != this->layout.Resolution[1]) ||
+        (resolution[2] != this->layout.Resolution[2]) || (components != this->layout.Components) ||
+        (brickSize != this->layout.BrickSize) || (levels != this->levels.size()) ||
+        (frames != this->layout.Frames)) {
+        return false;
+    }
+
+    this->frameOffsets.resize(frames);
+    this->file.read(reinterpret_cast<char*>(this->frameOffsets.data()), frames * sizeof(uint64_t));
+    if (!this->file) {
+        return false;
+    }
+
+    // a frame that was not written completely is built again
+    const auto frameSize = this->frameBytes + this->totalBricks * 2 * this->layout.Components * sizeof(double);
+    for (auto& o : this->frameOffsets) {
+        if ((o != 0) && (o + frameSize > fileSize)) {
+            o = 0;
+        }
+    }
+    return true;
+}
+
+
+/*
+ * megamol::volume::BrickPyramid::writeHeader
+ */
+bool megamol::volume::BrickPyramid::writeHeader(const Stamp& stamp) {
+    const auto path = SidecarPath(this->datFile);
+    this->file.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!this->file.is_open()) {
+        return false;
+    }
+
+    this->file.write(SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+    write(this->file, SIDECAR_VERSION);
+    write(this->file, stamp.DatSize);
+    write(this->file, stamp.DatModified);
+    write(this->file, stamp.RawSize);
+    write(this->file, stamp.RawModified);
+    write(this->file, static_cast<int32_t>(this->layout.Format));
+    for (auto r : this->layout.Resolution) {
+        write(this->file, static_cast<uint64_t>(r));
+    }
+    write(this->file, static_cast<uint64_t>(this->layout.Components));
+    write(this->file, static_cast<uint32_t>(this->layout.BrickSize));
+    write(this->file, static_cast<uint32_t>(this->levels.size()));
+    write(this->file, static_cast<uint32_t>(this->layout.Frames));
+
+    this->frameOffsets.assign(this->layout.Frames, 0);
+    this->file.write(reinterpret_cast<const char*>(this->frameOffsets.data()),
+        this->frameOffsets.size() * sizeof(uint64_t));
+    this->file.flush();
+    return static_cast<bool>(this->file);
+}
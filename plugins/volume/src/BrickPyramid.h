@@ -0,0 +1,234 @@
+/*
+ * BrickPyramid.h
+ *
+ * Copyright (C) 2021 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "geometry_calls/VolumetricDataCall.h"
+
+namespace megamol {
+namespace volume {
+
+/**
+ * Resolution pyramid of a dat/raw data set, split into bricks and cached in
+ * a sidecar file next to the dat file ('<dat>.mmbricks').
+ *
+ * Every level halves the resolution of the previous one (rounding up) by
+ * averaging 2x2x2 voxels, until the whole volume fits into a single brick.
+ * The bricks of a frame are built once from the full frame and afterwards
+ * read individually, so region requests only touch the bricks they cover.
+ *
+ * Sidecar layout (native byte order):
+ *
+ *   char[8]  magic "MMBRICKS"
+ *   uint32   version
+ *   uint64   size and int64 modification time of the dat file
+ *   uint64   size and int64 modification time of the raw file (0 for multi-file data sets)
+ *   int32    voxel format (DatRawDataFormat)
+ *   uint64   resolution[3], components
+ *   uint32   brick edge length, levels, frames
+ *   uint64   frame directory, offset of every frame, 0 if not yet built
+ *
+ * A frame consists of the voxels of all bricks, level after level and in
+ * z-y-x order within a level, followed by the minima and then the maxima of
+ * all components of every brick as doubles (NaN for formats without
+ * statistics). Bricks at the border of the volume are stored with their
+ * actual size.
+ */
+class BrickPyramid {
+
+public:
+    /** The brick type of the call. */
+    typedef geocalls::VolumetricDataCall::Brick Brick;
+
+    /** Describes the frames stored in the pyramid. */
+    struct Layout {
+        /** The voxel format (DatRawDataFormat). */
+        int Format;
+        size_t Resolution[3];
+        size_t Components;
+        size_t Frames;
+        /** The edge length of a brick in voxels. */
+        size_t BrickSize;
+    };
+
+    /**
+     * Answer the path of the sidecar file of a dat file.
+     *
+     * @param datFile The dat file.
+     *
+     * @return The path of the sidecar file.
+     */
+    static std::filesystem::path SidecarPath(const std::filesystem::path& datFile);
+
+    /** Ctor. */
+    BrickPyramid(void);
+
+    /** Dtor. */
+    ~BrickPyramid(void);
+
+    /**
+     * Builds the pyramid of a frame from the full frame.
+     *
+     * @param frame The frame to build.
+     * @param data  The voxels of the frame in the format of the layout.
+     *
+     * @return 'true' on success, 'false' if the sidecar could not be written.
+     */
+    bool Build(const unsigned int frame, const void* data);
+
+    /**
+     * Gets the bricks of the last successful Query.
+     *
+     * @return The bricks, which remain valid until the next query.
+     */
+    inline const std::vector<Brick>& Bricks(void) const {
+        return this->bricks;
+    }
+
+    /** Closes the sidecar file. */
+    void Close(void);
+
+    /**
+     * Answer whether the pyramid of a frame has already been built.
+     *
+     * @param frame The frame to check.
+     *
+     * @return 'true' if the bricks of the frame are available.
+     */
+    inline bool IsBuilt(const unsigned int frame) const {
+        return (frame < this->frameOffsets.size()) && (this->frameOffsets[frame] != 0);
+    }
+
+    /**
+     * Answer whether a sidecar file is open.
+     *
+     * @return 'true' if the pyramid can be used.
+     */
+    inline bool IsOpen(void) const {
+        return this->file.is_open();
+    }
+
+    /**
+     * Answer the number of levels of the pyramid.
+     *
+     * @return The number of levels including the original resolution.
+     */
+    inline unsigned int Levels(void) const {
+        return static_cast<unsigned int>(this->levels.size());
+    }
+
+    /**
+     * Opens the sidecar file of a data set. A sidecar that does not match
+     * the data set or the layout is discarded and a new one is started.
+     * Nothing happens if the pyramid of the data set is already open.
+     *
+     * @param datFile  The dat file of the data set.
+     * @param rawFile  The raw file of the data set or an empty path if the
+     *                 frames are stored in multiple files.
+     * @param layout   The layout of the frames.
+     * @param isCreate Start a new sidecar if there is no matching one.
+     *
+     * @return 'true' on success, 'false' if the sidecar cannot be created or
+     *         if there is no matching sidecar and 'isCreate' is not set.
+     */
+    bool Open(const std::filesystem::path& datFile, const std::filesystem::path& rawFile, const Layout& layout,
+        const bool isCreate = true);
+
+    /**
+     * Reads the bricks of a frame overlapping a region.
+     *
+     * @param frame The frame, which must have been built.
+     * @param level The level, which is clamped to the coarsest level.
+     * @param min   The first voxel of the region in voxels of level 0.
+     * @param max   The voxel after the region in voxels of level 0.
+     *
+     * @return 'true' on success, 'false' if the sidecar could not be read.
+     */
+    bool Query(const unsigned int frame, unsigned int level, const size_t* min, const size_t* max);
+
+private:
+    /** The bricks of a single level. */
+    struct Level {
+        size_t Resolution[3];
+        /** The number of bricks in each dimension. */
+        size_t Bricks[3];
+        /** The index of the first brick of the level among all bricks of a frame. */
+        size_t FirstBrick;
+        /** The byte offset of the first brick of the level in a frame. */
+        uint64_t Offset;
+    };
+
+    /** Identifies the files the pyramid was built from. */
+    struct Stamp {
+        uint64_t DatSize;
+        int64_t DatModified;
+        uint64_t RawSize;
+        int64_t RawModified;
+    };
+
+    /** Answer the bytes of the voxels of a brick. */
+    uint64_t brickBytes(const Level& level, const size_t x, const size_t y, const size_t z) const;
+
+    /** Answer the byte offset of a brick in a frame. */
+    uint64_t brickOffset(const Level& level, const size_t x, const size_t y, const size_t z) const;
+
+    /** Computes the levels of the pyramid from 'layout'. */
+    void computeLevels(void);
+
+    /** Answer the offset of the frame directory in the sidecar. */
+    uint64_t directoryOffset(void) const;
+
+    /** Reads the open sidecar and answers whether it matches 'stamp' and 'layout'. */
+    bool readHeader(const Stamp& stamp);
+
+    /** Starts a new sidecar without any frames. */
+    bool writeHeader(const Stamp& stamp);
+
+    /** The bricks of the last query. */
+    std::vector<Brick> bricks;
+
+    /** The voxels of the bricks of the last query. */
+    std::vector<uint8_t> brickData;
+
+    /** The minima and maxima of the bricks of the last query. */
+    std::vector<double> brickStats;
+
+    /** The dat file of the open sidecar. */
+    std::filesystem::path datFile;
+
+    /** The open sidecar. */
+    std::fstream file;
+
+    /** The offsets of all frames in the sidecar, 0 for frames not yet built. */
+    std::vector<uint64_t> frameOffsets;
+
+    /** The number of bytes of the voxels of all bricks of a frame. */
+    uint64_t frameBytes;
+
+    /** The layout of the open sidecar. */
+    Layout layout;
+
+    /** The levels of the pyramid. */
+    std::vector<Level> levels;
+
+    /** The raw file of the open sidecar. */
+    std::filesystem::path rawFile;
+
+    /** The total number of bricks of a frame. */
+    size_t totalBricks;
+
+    /** The size of a voxel in bytes. */
+    size_t voxelSize;
+};
+
+} /* end namespace volume */
+} /* end namespace megamol */
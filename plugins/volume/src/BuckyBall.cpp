@@ -40,6 +40,9 @@ megamol::volume::BuckyBall::BuckyBall(void)
     this->getDataSlot.SetCallback(geocalls::VolumetricDataCall::ClassName(),
         geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_TRY_GET_DATA),
         &BuckyBall::getDummyCallback);
+    this->getDataSlot.SetCallback(geocalls::VolumetricDataCall::ClassName(),
+        geocalls::VolumetricDataCall::FunctionName(geocalls::VolumetricDataCall::IDX_GET_BRICKS),
+        &BuckyBall::getDummyCallback);
     this->MakeSlotAvailable(&this->getDataSlot);
 
     this->volume.resize(this->resolution[0] * this->resolution[1] * this->resolution[2]);
@@ -0,0 +1,530 @@
+/*
+ * CompressedVolume.cpp
+ *
+ * Copyright (C) 2021 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#include "CompressedVolume.h"
+#include "stdafx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "datRaw.h"
+#include "zfp.h"
+#include "zlib.h"
+
+#include "mmcore/utility/log/Log.h"
+
+
+namespace {
+
+const char CONTAINER_MAGIC[8] = {'M', 'M', 'V', 'C', 'O', 'M', 'P', 'R'};
+const uint32_t CONTAINER_VERSION = 1;
+
+/** Bytes of the container header before the frame directory */
+const uint64_t CONTAINER_HEADER_SIZE = 8 + 4 + 4 + 4 * 8 + 3 * 4 + 8;
+
+/** Bytes of an entry of a brick table */
+const uint64_t BRICK_ENTRY_SIZE = 8 + 8 + 1;
+
+/** A brick of a frame in voxels */
+struct BrickExtents {
+    size_t Begin[3];
+    size_t Resolution[3];
+};
+
+template<class T>
+inline void write(std::ostream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<class T>
+inline void read(std::istream& file, T& value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/** Answer the size of a scalar, i.e. the unit of the byte shuffling */
+inline size_t scalarSize(const int format) {
+    return static_cast<size_t>(std::max(1, ::datRaw_getFormatSize(format)));
+}
+
+/** Splits a frame into bricks in z-y-x order, the bricks at the border are smaller */
+std::vector<BrickExtents> brickExtents(const size_t* resolution, const size_t brickSize) {
+    std::vector<BrickExtents> retval;
+    for (size_t z = 0; z < resolution[2]; z += brickSize) {
+        for (size_t y = 0; y < resolution[1]; y += brickSize) {
+            for (size_t x = 0; x < resolution[0]; x += brickSize) {
+                BrickExtents b;
+                b.Begin[0] = x;
+                b.Begin[1] = y;
+                b.Begin[2] = z;
+                b.Resolution[0] = std::min(brickSize, resolution[0] - x);
+                b.Resolution[1] = std::min(brickSize, resolution[1] - y);
+                b.Resolution[2] = std::min(brickSize, resolution[2] - z);
+                retval.push_back(b);
+            }
+        }
+    }
+    return retval;
+}
+
+/** Copies the voxels of a brick from a frame ('toBrick') or back into a frame */
+void copyBrick(uint8_t* frame, uint8_t* brick, const size_t* resolution, const BrickExtents& extents,
+    const size_t voxelSize, const bool toBrick) {
+    const size_t rowSize = extents.Resolution[0] * voxelSize;
+    for (size_t z = 0; z < extents.Resolution[2]; ++z) {
+        for (size_t y = 0; y < extents.Resolution[1]; ++y) {
+            auto f = frame +
+                     (((extents.Begin[2] + z) * resolution[1] + extents.Begin[1] + y) * resolution[0] +
+                         extents.Begin[0]) *
+                         voxelSize;
+            auto b = brick + (z * extents.Resolution[1] + y) * rowSize;
+            if (toBrick) {
+                std::memcpy(b, f, rowSize);
+            } else {
+                std::memcpy(f, b, rowSize);
+            }
+        }
+    }
+}
+
+/** Shuffles the bytes of the scalars into planes and deflates them */
+bool deflateBrick(const std::vector<uint8_t>& brick, const size_t scalarSize, std::vector<uint8_t>& outData) {
+    const size_t cnt = brick.size() / scalarSize;
+    std::vector<uint8_t> shuffled(brick.size());
+    for (size_t i = 0; i < cnt; ++i) {
+        for (size_t b = 0; b < scalarSize; ++b) {
+            shuffled[b * cnt + i] = brick[i * scalarSize + b];
+        }
+    }
+
+    uLongf destLen = ::compressBound(static_cast<uLong>(brick.size()));
+    outData.resize(destLen);
+    if (::compress2(outData.data(), &destLen, shuffled.data(), static_cast<uLong>(shuffled.size()),
+            Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return false;
+    }
+    outData.resize(destLen);
+    return true;
+}
+
+bool inflateBrick(const uint8_t* data, const size_t size, const size_t scalarSize, std::vector<uint8_t>& inOutBrick) {
+    const size_t cnt = inOutBrick.size() / scalarSize;
+    std::vector<uint8_t> shuffled(inOutBrick.size());
+    uLongf destLen = static_cast<uLongf>(shuffled.size());
+    if ((::uncompress(shuffled.data(), &destLen, data, static_cast<uLong>(size)) != Z_OK) ||
+        (destLen != shuffled.size())) {
+        return false;
+    }
+    for (size_t i = 0; i < cnt; ++i) {
+        for (size_t b = 0; b < scalarSize; ++b) {
+            inOutBrick[i * scalarSize + b] = shuffled[b * cnt + i];
+        }
+    }
+    return true;
+}
+
+/**
+ * Creates a ZFP field of a single component of a brick, the components of a
+ * voxel are interleaved.
+ */
+zfp_field* zfpField(uint8_t* brick, const int format, const size_t* resolution, const size_t components,
+    const size_t component) {
+    const auto type = (format == DR_FORMAT_DOUBLE) ? zfp_type_double : zfp_type_float;
+    auto retval = ::zfp_field_3d(brick + component * scalarSize(format), type, static_cast<uint>(resolution[0]),
+        static_cast<uint>(resolution[1]), static_cast<uint>(resolution[2]));
+    ::zfp_field_set_stride_3d(retval, static_cast<int>(components), static_cast<int>(components * resolution[0]),
+        static_cast<int>(components * resolution[0] * resolution[1]));
+    return retval;
+}
+
+/**
+ * Compresses every component of a brick with a fixed accuracy. The payload
+ * starts with the compressed sizes of all components.
+ */
+bool zfpCompressBrick(std::vector<uint8_t>& brick, const int format, const size_t* resolution,
+    const size_t components, const double tolerance, std::vector<uint8_t>& outData) {
+    const auto type = (format == DR_FORMAT_DOUBLE) ? zfp_type_double : zfp_type_float;
+    outData.assign(components * sizeof(uint64_t), 0);
+    std::vector<uint8_t> stream;
+    bool retval = true;
+
+    for (size_t c = 0; (c < components) && retval; ++c) {
+        auto field = zfpField(brick.data(), format, resolution, components, c);
+        auto zfp = ::zfp_stream_open(nullptr);
+        ::zfp_stream_set_accuracy(zfp, tolerance, type);
+        stream.resize(::zfp_stream_maximum_size(zfp, field));
+        auto bits = ::stream_open(stream.data(), stream.size());
+        ::zfp_stream_set_bit_stream(zfp, bits);
+        ::zfp_stream_rewind(zfp);
+
+        const uint64_t size = ::zfp_compress(zfp, field);
+        if (size == 0) {
+            retval = false;
+        } else {
+            std::memcpy(outData.data() + c * sizeof(uint64_t), &size, sizeof(size));
+            outData.insert(outData.end(), stream.begin(), stream.begin() + size);
+        }
+
+        ::zfp_field_free(field);
+        ::zfp_stream_close(zfp);
+        ::stream_close(bits);
+    }
+
+    return retval;
+}
+
+bool zfpDecompressBrick(const uint8_t* data, const size_t size, const int format, const size_t* resolution,
+    const size_t components, const double tolerance, std::vector<uint8_t>& inOutBrick) {
+    const auto type = (format == DR_FORMAT_DOUBLE) ? zfp_type_double : zfp_type_float;
+    if (size < components * sizeof(uint64_t)) {
+        return false;
+    }
+    uint64_t offset = components * sizeof(uint64_t);
+    bool retval = true;
+
+    for (size_t c = 0; (c < components) && retval; ++c) {
+        uint64_t streamSize;
+        std::memcpy(&streamSize, data + c * sizeof(uint64_t), sizeof(streamSize));
+        if (offset + streamSize > size) {
+            return false;
+        }
+
+        auto field = zfpField(inOutBrick.data(), format, resolution, components, c);
+        auto zfp = ::zfp_stream_open(nullptr);
+        ::zfp_stream_set_accuracy(zfp, tolerance, type);
+        auto bits = ::stream_open(const_cast<uint8_t*>(data + offset), static_cast<size_t>(streamSize));
+        ::zfp_stream_set_bit_stream(zfp, bits);
+        ::zfp_stream_rewind(zfp);
+
+        retval = (::zfp_decompress(zfp, field) != 0);
+        offset += streamSize;
+
+        ::zfp_field_free(field);
+        ::zfp_stream_close(zfp);
+        ::stream_close(bits);
+    }
+
+    return retval;
+}
+
+} // namespace
+
+
+/*
+ * megamol::volume::CompressedVolume::BRICK_SIZE
+ */
+const size_t megamol::volume::CompressedVolume::BRICK_SIZE = 64;
+
+
+/*
+ * megamol::volume::CompressedVolume::IsCompressedVolume
+ */
+bool megamol::volume::CompressedVolume::IsCompressedVolume(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    char magic[8];
+    return file.read(magic, sizeof(magic)) && (std::memcmp(magic, CONTAINER_MAGIC, sizeof(magic)) == 0);
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::Write
+ */
+bool megamol::volume::CompressedVolume::Write(const std::filesystem::path& path, const Layout& layout,
+    const std::vector<const void*>& frames, Codec codec, const double tolerance) {
+    using megamol::core::utility::log::Log;
+
+    if ((codec == Codec::ZFP) && (layout.Format != DR_FORMAT_FLOAT) && (layout.Format != DR_FORMAT_DOUBLE)) {
+        Log::DefaultLog.WriteWarn("Lossy compression is only supported for floating point data, \"%s\" is "
+                                  "compressed losslessly instead.",
+            path.generic_u8string().c_str());
+        codec = Codec::DEFLATE;
+    }
+
+    const auto scalar = scalarSize(layout.Format);
+    const auto voxelSize = scalar * layout.Components;
+    const auto extents = brickExtents(layout.Resolution, BRICK_SIZE);
+    const auto cntBricks = static_cast<int64_t>(extents.size());
+
+    // write to a temporary file first, so a concurrent reader never sees half a container
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    bool retval = true;
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        const uint64_t resolution[3] = {layout.Resolution[0], layout.Resolution[1], layout.Resolution[2]};
+        file.write(CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+        write(file, CONTAINER_VERSION);
+        write(file, static_cast<int32_t>(layout.Format));
+        file.write(reinterpret_cast<const char*>(resolution), sizeof(resolution));
+        write(file, static_cast<uint64_t>(layout.Components));
+        write(file, static_cast<uint32_t>(BRICK_SIZE));
+        write(file, static_cast<uint32_t>(frames.size()));
+        write(file, static_cast<uint32_t>(codec));
+        write(file, tolerance);
+        std::vector<uint64_t> directory(frames.size(), 0);
+        file.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(uint64_t));
+
+        std::vector<std::vector<uint8_t>> payloads(extents.size());
+        std::vector<uint8_t> codecs(extents.size());
+        for (size_t f = 0; (f < frames.size()) && retval; ++f) {
+            auto frame = static_cast<uint8_t*>(const_cast<void*>(frames[f]));
+
+#pragma omp parallel
+            {
+                std::vector<uint8_t> brick;
+
+#pragma omp for schedule(dynamic)
+                for (int64_t i = 0; i < cntBricks; ++i) {
+                    const auto& e = extents[i];
+                    brick.resize(e.Resolution[0] * e.Resolution[1] * e.Resolution[2] * voxelSize);
+                    copyBrick(frame, brick.data(), layout.Resolution, e, voxelSize, true);
+
+                    bool isCompressed = false;
+                    if (codec == Codec::DEFLATE) {
+                        isCompressed = deflateBrick(brick, scalar, payloads[i]);
+                    } else if (codec == Codec::ZFP) {
+                        isCompressed = zfpCompressBrick(
+                            brick, layout.Format, e.Resolution, layout.Components, tolerance, payloads[i]);
+                    }
+
+                    if (isCompressed && (payloads[i].size() < brick.size())) {
+                        codecs[i] = static_cast<uint8_t>(codec);
+                    } else {
+                        // incompressible, e.g. noise, is stored as it is
+                        payloads[i] = brick;
+                        codecs[i] = static_cast<uint8_t>(Codec::NONE);
+                    }
+                }
+            }
+
+            std::vector<uint64_t> offsets(extents.size());
+            for (size_t i = 0; i < extents.size(); ++i) {
+                offsets[i] = static_cast<uint64_t>(file.tellp());
+                file.write(reinterpret_cast<const char*>(payloads[i].data()), payloads[i].size());
+            }
+            directory[f] = static_cast<uint64_t>(file.tellp());
+            for (size_t i = 0; i < extents.size(); ++i) {
+                write(file, offsets[i]);
+                write(file, static_cast<uint64_t>(payloads[i].size()));
+                write(file, codecs[i]);
+            }
+            retval = static_cast<bool>(file);
+        }
+
+        file.seekp(CONTAINER_HEADER_SIZE);
+        file.write(reinterpret_cast<const char*>(directory.data()), directory.size() * sizeof(uint64_t));
+        retval = retval && static_cast<bool>(file);
+    }
+
+    std::error_code ec;
+    if (retval) {
+        std::filesystem::rename(tmpPath, path, ec);
+        retval = !ec;
+    }
+    if (!retval) {
+        std::filesystem::remove(tmpPath, ec);
+    }
+    return retval;
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::CompressedVolume
+ */
+megamol::volume::CompressedVolume::CompressedVolume(void)
+        : brickSize(0)
+        , codec(Codec::NONE)
+        , layout()
+        , tolerance(0.0) {
+    // intentionally empty
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::~CompressedVolume
+ */
+megamol::volume::CompressedVolume::~CompressedVolume(void) {
+    this->Close();
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::Close
+ */
+void megamol::volume::CompressedVolume::Close(void) {
+    std::lock_guard<std::mutex> l(this->lock);
+    if (this->file.is_open()) {
+        this->file.close();
+    }
+    this->file.clear();
+    this->frameOffsets.clear();
+    this->layout = Layout();
+    this->brickSize = 0;
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::LoadFrame
+ */
+bool megamol::volume::CompressedVolume::LoadFrame(const unsigned int frame, void* dst) {
+    const auto scalar = scalarSize(this->layout.Format);
+    const auto voxelSize = scalar * this->layout.Components;
+    const auto extents = brickExtents(this->layout.Resolution, this->brickSize);
+    const auto cntBricks = static_cast<int64_t>(extents.size());
+
+    /*
+     * Read the brick table and all bricks of the frame at once, the bricks are
+     * stored contiguously in front of the table.
+     */
+    std::vector<uint64_t> offsets(extents.size());
+    std::vector<uint64_t> sizes(extents.size());
+    std::vector<uint8_t> codecs(extents.size());
+    std::vector<uint8_t> payload;
+    uint64_t begin = 0;
+    {
+        std::lock_guard<std::mutex> l(this->lock);
+        if (!this->file.is_open() || (frame >= this->frameOffsets.size()) || (dst == nullptr)) {
+            return false;
+        }
+
+        const auto tableOffset = this->frameOffsets[frame];
+        this->file.clear();
+        this->file.seekg(tableOffset);
+        for (size_t i = 0; i < extents.size(); ++i) {
+            read(this->file, offsets[i]);
+            read(this->file, sizes[i]);
+            read(this->file, codecs[i]);
+        }
+        if (!this->file) {
+            return false;
+        }
+
+        begin = extents.empty() ? tableOffset : offsets.front();
+        if (begin > tableOffset) {
+            return false;
+        }
+        payload.resize(static_cast<size_t>(tableOffset - begin));
+        this->file.seekg(begin);
+        if (!this->file.read(reinterpret_cast<char*>(payload.data()), payload.size())) {
+            return false;
+        }
+    }
+
+    std::atomic<bool> retval(true);
+    auto frameData = static_cast<uint8_t*>(dst);
+
+#pragma omp parallel
+    {
+        std::vector<uint8_t> brick;
+
+#pragma omp for schedule(dynamic)
+        for (int64_t i = 0; i < cntBricks; ++i) {
+            const auto& e = extents[i];
+            const auto brickBytes = e.Resolution[0] * e.Resolution[1] * e.Resolution[2] * voxelSize;
+            if ((offsets[i] < begin) || (offsets[i] - begin + sizes[i] > payload.size())) {
+                retval = false;
+                continue;
+            }
+            const auto data = payload.data() + (offsets[i] - begin);
+            const auto size = static_cast<size_t>(sizes[i]);
+
+            brick.resize(brickBytes);
+            bool isValid = false;
+            switch (static_cast<Codec>(codecs[i])) {
+            case Codec::NONE:
+                isValid = (size == brickBytes);
+                if (isValid) {
+                    std::memcpy(brick.data(), data, brickBytes);
+                }
+                break;
+            case Codec::DEFLATE:
+                isValid = inflateBrick(data, size, scalar, brick);
+                break;
+            case Codec::ZFP:
+                isValid = zfpDecompressBrick(data, size, this->layout.Format, e.Resolution, this->layout.Components,
+                    this->tolerance, brick);
+                break;
+            }
+
+            if (isValid) {
+                copyBrick(frameData, brick.data(), this->layout.Resolution, e, voxelSize, false);
+            } else {
+                retval = false;
+            }
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * megamol::volume::CompressedVolume::Open
+ */
+bool megamol::volume::CompressedVolume::Open(const std::filesystem::path& path) {
+    using megamol::core::utility::log::Log;
+
+    this->Close();
+    std::lock_guard<std::mutex> l(this->lock);
+
+    this->file.open(path, std::ios::in | std::ios::binary);
+    if (!this->file) {
+        this->file.close();
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version;
+    int32_t format;
+    uint64_t resolution[3];
+    uint64_t components;
+    uint32_t brickSize;
+    uint32_t frames;
+    uint32_t codec;
+    this->file.read(magic, sizeof(magic));
+    read(this->file, version);
+    read(this->file, format);
+    this->file.read(reinterpret_cast<char*>(resolution), sizeof(resolution));
+    read(this->file, components);
+    read(this->file, brickSize);
+    read(this->file, frames);
+    read(this->file, codec);
+    read(this->file, this->tolerance);
+    if (!this->file || (std::memcmp(magic, CONTAINER_MAGIC, sizeof(magic)) != 0) || (brickSize == 0) ||
+        (codec > static_cast<uint32_t>(Codec::ZFP))) {
+        this->file.close();
+        return false;
+    }
+    if (version != CONTAINER_VERSION) {
+        Log::DefaultLog.WriteError("The compressed volume \"%s\" has the unsupported version %u.",
+            path.generic_u8string().c_str(), version);
+        this->file.close();
+        return false;
+    }
+
+    this->frameOffsets.resize(frames);
+    this->file.read(reinterpret_cast<char*>(this->frameOffsets.data()), frames * sizeof(uint64_t));
+    if (!this->file) {
+        this->file.close();
+        this->frameOffsets.clear();
+        return false;
+    }
+
+    this->brickSize = brickSize;
+    this->codec = static_cast<Codec>(codec);
+    this->layout.Format = format;
+    this->layout.Resolution[0] = static_cast<size_t>(resolution[0]);
+    this->layout.Resolution[1] = static_cast<size_t>(resolution[1]);
+    this->layout.Resolution[2] = static_cast<size_t>(resolution[2]);
+    this->layout.Components = static_cast<size_t>(components);
+    this->layout.Frames = frames;
+    return true;
+}
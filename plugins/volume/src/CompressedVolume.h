@@ -0,0 +1,165 @@
+/*
+ * CompressedVolume.h
+ *
+ * Copyright (C) 2021 by Universitaet Stuttgart (VISUS).
+ * All rights reserved.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace megamol {
+namespace volume {
+
+/**
+ * Container of bricked, compressed volume frames, which a dat file can
+ * reference as its data file ('ObjectFileName: <name>.mmvc').
+ *
+ * Each frame is split into bricks of BRICK_SIZE voxels per edge, which are
+ * compressed independently and therefore can be compressed and decompressed
+ * in parallel.
+ *
+ * File layout (native byte order):
+ *
+ *   char[8]  magic "MMVCOMPR"
+ *   uint32   version
+ *   int32    voxel format (DatRawDataFormat)
+ *   uint64   resolution[3], components
+ *   uint32   brick edge length, frames, codec
+ *   double   error bound of the ZFP codec
+ *   uint64   frame directory, offset of the brick table of every frame
+ *
+ * A frame consists of the compressed bricks in z-y-x order, followed by its
+ * brick table: per brick uint64 offset, uint64 size and uint8 codec. The
+ * bricks of a frame are stored contiguously.
+ */
+class CompressedVolume {
+
+public:
+    /** The compression of a brick. */
+    enum class Codec : uint32_t {
+        /** The voxels as they are. */
+        NONE = 0,
+        /** Lossless, the bytes of the scalars shuffled into planes, then deflated. */
+        DEFLATE = 1,
+        /** Lossy with an absolute error bound, FLOAT and DOUBLE only. */
+        ZFP = 2
+    };
+
+    /** Describes the frames stored in the container. */
+    struct Layout {
+        /** The voxel format (DatRawDataFormat). */
+        int Format;
+        size_t Resolution[3];
+        size_t Components;
+        size_t Frames;
+    };
+
+    /** The edge length of a brick in voxels. */
+    static const size_t BRICK_SIZE;
+
+    /**
+     * Answer whether a file is a compressed volume container.
+     *
+     * @param path The file to check.
+     *
+     * @return 'true' if the file starts with the magic number.
+     */
+    static bool IsCompressedVolume(const std::filesystem::path& path);
+
+    /**
+     * Writes a container.
+     *
+     * ZFP is only applicable to floating point data, other data are
+     * compressed with DEFLATE instead. Bricks that do not become smaller are
+     * stored uncompressed.
+     *
+     * @param path      The file to be written.
+     * @param layout    The layout of the frames.
+     * @param frames    The voxels of every frame in the format of the layout.
+     * @param codec     The compression.
+     * @param tolerance The absolute error bound of ZFP.
+     *
+     * @return 'true' on success, 'false' if the file could not be written.
+     */
+    static bool Write(const std::filesystem::path& path, const Layout& layout, const std::vector<const void*>& frames,
+        Codec codec, const double tolerance);
+
+    /** Ctor. */
+    CompressedVolume(void);
+
+    /** Dtor. */
+    ~CompressedVolume(void);
+
+    /** Closes the container. */
+    void Close(void);
+
+    /**
+     * Gets the layout of the open container.
+     *
+     * @return The layout of the frames.
+     */
+    inline const Layout& GetLayout(void) const {
+        return this->layout;
+    }
+
+    /**
+     * Answer whether a container is open.
+     *
+     * @return 'true' if frames can be loaded.
+     */
+    inline bool IsOpen(void) const {
+        return this->file.is_open();
+    }
+
+    /**
+     * Reads a frame and decompresses its bricks in parallel. The method is
+     * thread-safe.
+     *
+     * @param frame The frame to load.
+     * @param dst   Receives the voxels of the frame in the format of the
+     *              layout.
+     *
+     * @return 'true' on success, 'false' if the frame could not be read.
+     */
+    bool LoadFrame(const unsigned int frame, void* dst);
+
+    /**
+     * Opens a container.
+     *
+     * @param path The container file.
+     *
+     * @return 'true' on success, 'false' if the file is not a valid container.
+     */
+    bool Open(const std::filesystem::path& path);
+
+private:
+    /** The edge length of the bricks of the open container. */
+    size_t brickSize;
+
+    /** The codec the bricks were compressed with. */
+    Codec codec;
+
+    /** The open container. */
+    std::ifstream file;
+
+    /** The offsets of the brick tables of all frames. */
+    std::vector<uint64_t> frameOffsets;
+
+    /** The layout of the open container. */
+    Layout layout;
+
+    /** Serialises reading from 'file'. */
+    std::mutex lock;
+
+    /** The error bound the ZFP bricks were compressed with. */
+    double tolerance;
+};
+
+} /* end namespace volume */
+} /* end namespace megamol */
@@ -6,7 +6,11 @@
  */
 #include "DatRawWriter.h"
 
+#include "CompressedVolume.h"
+#include "datRaw.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FilePathParam.h"
+#include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmcore/utility/log/Log.h"
 #include <iomanip>
@@ -17,6 +21,37 @@ using namespace megamol;
 using namespace megamol::core;
 using namespace megamol::volume;
 
+namespace {
+
+/** Answer the format of the scalars in the dat file, DR_FORMAT_NONE if there is none */
+DatRawDataFormat datRawFormat(const geocalls::VolumetricDataCall::ScalarType type, const size_t length) {
+    const int idx = (length == 1) ? 0 : (length == 2) ? 1 : (length == 4) ? 2 : (length == 8) ? 3 : -1;
+    if (idx < 0) {
+        return DR_FORMAT_NONE;
+    }
+
+    static const DatRawDataFormat FLOATING_POINT[] = {
+        DR_FORMAT_NONE, DR_FORMAT_HALF, DR_FORMAT_FLOAT, DR_FORMAT_DOUBLE};
+    static const DatRawDataFormat SIGNED_INTEGER[] = {DR_FORMAT_CHAR, DR_FORMAT_SHORT, DR_FORMAT_INT, DR_FORMAT_LONG};
+    static const DatRawDataFormat UNSIGNED_INTEGER[] = {
+        DR_FORMAT_UCHAR, DR_FORMAT_USHORT, DR_FORMAT_UINT, DR_FORMAT_ULONG};
+
+    switch (type) {
+    case geocalls::VolumetricDataCall::ScalarType::BITS:
+        return (length == 1) ? DR_FORMAT_UCHAR : DR_FORMAT_NONE;
+    case geocalls::VolumetricDataCall::ScalarType::FLOATING_POINT:
+        return FLOATING_POINT[idx];
+    case geocalls::VolumetricDataCall::ScalarType::SIGNED_INTEGER:
+        return SIGNED_INTEGER[idx];
+    case geocalls::VolumetricDataCall::ScalarType::UNSIGNED_INTEGER:
+        return UNSIGNED_INTEGER[idx];
+    default:
+        return DR_FORMAT_NONE;
+    }
+}
+
+} // namespace
+
 /*
  * DatRawWriter::DatRawWriter
  */
@@ -24,6 +59,9 @@ DatRawWriter::DatRawWriter(void)
         : AbstractDataWriter()
         , filenameSlot("filepathPrefix", "The path prefix of the folder and file the files will be written to. To this "
                                          "path the ending .dat and .raw will be added")
+        , compressionSlot("compression", "The compression of the voxels. Compressed voxels are written to a .mmvc "
+                                         "container instead of the .raw file")
+        , errorBoundSlot("errorBound", "The maximum absolute error of a voxel for the lossy compression")
         , frameIDSlot("frameID", "The id of the data frame that will be written")
         , dataSlot("data", "The slot requesting the data to be written") {
 
@@ -31,6 +69,16 @@ DatRawWriter::DatRawWriter(void)
         new param::FilePathParam("", megamol::core::param::FilePathParam::Flag_File_ToBeCreated));
     this->MakeSlotAvailable(&this->filenameSlot);
 
+    auto compression = new param::EnumParam(static_cast<int>(CompressedVolume::Codec::NONE));
+    compression->SetTypePair(static_cast<int>(CompressedVolume::Codec::NONE), "None");
+    compression->SetTypePair(static_cast<int>(CompressedVolume::Codec::DEFLATE), "Lossless");
+    compression->SetTypePair(static_cast<int>(CompressedVolume::Codec::ZFP), "Lossy (floating point only)");
+    this->compressionSlot.SetParameter(compression);
+    this->MakeSlotAvailable(&this->compressionSlot);
+
+    this->errorBoundSlot.SetParameter(new param::FloatParam(0.001f, 0.0f));
+    this->MakeSlotAvailable(&this->errorBoundSlot);
+
     this->frameIDSlot.SetParameter(new param::IntParam(0, 0));
     this->MakeSlotAvailable(&this->frameIDSlot);
 
@@ -100,8 +148,11 @@ bool DatRawWriter::run(void) {
 
     std::stringstream datpath;
     datpath << filepath << std::setw(4) << std::setfill('0') << std::to_string(frame) << ".dat";
+    const bool isCompressed = (this->compressionSlot.Param<param::EnumParam>()->Value() !=
+                               static_cast<int>(CompressedVolume::Codec::NONE));
     std::stringstream rawpath;
-    rawpath << filepath << std::setw(4) << std::setfill('0') << std::to_string(frame) << ".raw";
+    rawpath << filepath << std::setw(4) << std::setfill('0') << std::to_string(frame)
+            << (isCompressed ? ".mmvc" : ".raw");
     return writeFrame(datpath.str(), rawpath.str(), *vdc);
 }
 
@@ -122,28 +173,16 @@ bool DatRawWriter::writeFrame(std::string datpath, std::string rawpath, geocalls
     std::string writestring = rawpath.substr(lastPos + 1);
 
     auto meta = data.GetMetadata();
+    const auto format = datRawFormat(meta->ScalarType, meta->ScalarLength);
+    if (format == DR_FORMAT_NONE) {
+        Log::DefaultLog.WriteError("No Proper file format selected. Dat output is corrupted.");
+        return false;
+    }
 
     std::ofstream datfile(datpath, std::ios_base::binary);
     if (datfile.is_open()) {
         datfile << "ObjectFileName: " << writestring << std::endl;
-        datfile << "Format:         ";
-        switch (meta->ScalarType) {
-        case geocalls::VolumetricDataCall::ScalarType::BITS:
-            datfile << "UCHAR" << std::endl;
-            break;
-        case geocalls::VolumetricDataCall::ScalarType::FLOATING_POINT:
-            datfile << "FLOAT" << std::endl;
-            break;
-        case geocalls::VolumetricDataCall::ScalarType::SIGNED_INTEGER:
-            datfile << "INT" << std::endl;
-            break;
-        case geocalls::VolumetricDataCall::ScalarType::UNSIGNED_INTEGER:
-            datfile << "UINT" << std::endl;
-            break;
-        default:
-            Log::DefaultLog.WriteError("No Proper file format selected. Dat output is corrupted.");
-            return false;
-        }
+        datfile << "Format:         " << ::datRaw_getDataFormatName(format) << std::endl;
         datfile << "GridType:       ";
         switch (meta->GridType) {
         case geocalls::VolumetricDataCall::GridType::CARTESIAN:
@@ -180,6 +219,24 @@ bool DatRawWriter::writeFrame(std::string datpath, std::string rawpath, geocalls
         return false;
     }
 
+    const auto codec = static_cast<CompressedVolume::Codec>(this->compressionSlot.Param<param::EnumParam>()->Value());
+    if (codec != CompressedVolume::Codec::NONE) {
+        CompressedVolume::Layout layout;
+        layout.Format = format;
+        layout.Resolution[0] = meta->Resolution[0];
+        layout.Resolution[1] = meta->Resolution[1];
+        layout.Resolution[2] = meta->Resolution[2];
+        layout.Components = meta->Components;
+        layout.Frames = 1;
+        const auto tolerance = static_cast<double>(this->errorBoundSlot.Param<param::FloatParam>()->Value());
+        if (!CompressedVolume::Write(rawpath, layout, {data.GetData()}, codec, tolerance)) {
+            Log::DefaultLog.WriteError("Compressed volume \"%s\" could not be written", rawpath.c_str());
+            return false;
+        }
+        Log::DefaultLog.WriteInfo("Compressed volume successfully written to \"%s\"", rawpath.c_str());
+        return true;
+    }
+
     std::ofstream rawfile(rawpath, std::ios_base::binary);
     if (rawfile.is_open()) {
         rawfile.write(reinterpret_cast<const char*>(data.GetData()), data.GetVoxelSize() * data.GetVoxelsPerFrame());
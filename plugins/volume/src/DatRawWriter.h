@@ -102,7 +102,7 @@ private:
      * Writes the data of one frame to the file
      *
      * @param datpath The file path to the dat file
-     * @param rawpath The file path to the raw file
+     * @param rawpath The file path to the raw file or the compressed volume
      * @param data The data of the current frame
      *
      * @return True on success
@@ -112,6 +112,12 @@ private:
     /** The file name of the file to be written */
     core::param::ParamSlot filenameSlot;
 
+    /** The compression of the voxels */
+    core::param::ParamSlot compressionSlot;
+
+    /** The absolute error bound of the lossy compression */
+    core::param::ParamSlot errorBoundSlot;
+
     /** The frame ID of the frame to be written */
     core::param::ParamSlot frameIDSlot;
 
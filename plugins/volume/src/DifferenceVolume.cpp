@@ -8,6 +8,7 @@
 #include "DifferenceVolume.h"
 #include "stdafx.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mmcore/param/BoolParam.h"
@@ -44,6 +45,8 @@ megamol::volume::DifferenceVolume::DifferenceVolume(void)
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_STOP_ASYNC), &DifferenceVolume::onUnsupported);
     this->slotOut.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &DifferenceVolume::onUnsupported);
+    this->slotOut.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS), &DifferenceVolume::onGetBricks);
     this->MakeSlotAvailable(&this->slotOut);
 
     this->paramIgnoreInputHash << new core::param::BoolParam(false);
@@ -92,6 +95,92 @@ megamol::geocalls::ScalarType_t megamol::volume::DifferenceVolume::getDifference
 }
 
 
+/*
+ * megamol::volume::DifferenceVolume::getDifferenceLength
+ */
+std::size_t megamol::volume::DifferenceVolume::getDifferenceLength(const geocalls::VolumetricMetadata_t& md) {
+    // unsigned scalars are widened to the next signed type, but there is no
+    // wider type than 64 bits
+    if ((md.ScalarType == geocalls::UNSIGNED_INTEGER) && (md.ScalarLength < 8)) {
+        return 2 * md.ScalarLength;
+    } else {
+        return md.ScalarLength;
+    }
+}
+
+
+/*
+ * megamol::volume::DifferenceVolume::calcBrickDifference
+ */
+bool megamol::volume::DifferenceVolume::calcBrickDifference(const geocalls::VolumetricMetadata_t& md, void* dst,
+    const void* cur, const void* prev, const std::size_t cnt, double* minValues, double* maxValues) {
+    const auto components = md.Components;
+
+    switch (md.ScalarType) {
+    case geocalls::SIGNED_INTEGER:
+        switch (md.ScalarLength) {
+        case 1:
+            calcBrickDifference(static_cast<std::int8_t*>(dst), static_cast<const std::int8_t*>(cur),
+                static_cast<const std::int8_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 2:
+            calcBrickDifference(static_cast<std::int16_t*>(dst), static_cast<const std::int16_t*>(cur),
+                static_cast<const std::int16_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 4:
+            calcBrickDifference(static_cast<std::int32_t*>(dst), static_cast<const std::int32_t*>(cur),
+                static_cast<const std::int32_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 8:
+            calcBrickDifference(static_cast<std::int64_t*>(dst), static_cast<const std::int64_t*>(cur),
+                static_cast<const std::int64_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        default:
+            return false;
+        }
+
+    case geocalls::UNSIGNED_INTEGER:
+        switch (md.ScalarLength) {
+        case 1:
+            calcBrickDifference(static_cast<std::int16_t*>(dst), static_cast<const std::uint8_t*>(cur),
+                static_cast<const std::uint8_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 2:
+            calcBrickDifference(static_cast<std::int32_t*>(dst), static_cast<const std::uint16_t*>(cur),
+                static_cast<const std::uint16_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 4:
+            calcBrickDifference(static_cast<std::int64_t*>(dst), static_cast<const std::uint32_t*>(cur),
+                static_cast<const std::uint32_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 8:
+            calcBrickDifference(static_cast<std::int64_t*>(dst), static_cast<const std::uint64_t*>(cur),
+                static_cast<const std::uint64_t*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        default:
+            return false;
+        }
+
+    case geocalls::FLOATING_POINT:
+        switch (md.ScalarLength) {
+        case 4:
+            calcBrickDifference(static_cast<float*>(dst), static_cast<const float*>(cur),
+                static_cast<const float*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        case 8:
+            calcBrickDifference(static_cast<double*>(dst), static_cast<const double*>(cur),
+                static_cast<const double*>(prev), cnt, components, minValues, maxValues);
+            return true;
+        default:
+            return false;
+        }
+
+    default:
+        return false;
+    }
+}
+
+
 /*
  * megamol::volume::DifferenceVolume::checkCompatibility
  */
@@ -404,6 +493,131 @@ bool megamol::volume::DifferenceVolume::onGetData(core::Call& call) {
 }
 
 
+/*
+ * megamol::volume::DifferenceVolume::onGetBricks
+ */
+bool megamol::volume::DifferenceVolume::onGetBricks(core::Call& call) {
+    using geocalls::VolumetricDataCall;
+    using megamol::core::utility::log::Log;
+
+    auto dst = dynamic_cast<VolumetricDataCall*>(&call);
+    auto src = this->slotIn.CallAs<VolumetricDataCall>();
+
+    /* Sanity checks. */
+    if (dst == nullptr) {
+        Log::DefaultLog.WriteError("Call %hs of %hs received a wrong request.",
+            VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS), DifferenceVolume::ClassName());
+        return false;
+    }
+
+    if (src == nullptr) {
+        Log::DefaultLog.WriteError("Call %hs of %hs has a wrong source.",
+            VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS), DifferenceVolume::ClassName());
+        return false;
+    }
+
+    dst->SetBricks(nullptr, 0, 0);
+    *src = *dst;
+    src->SetFrameID(dst->FrameID(), true);
+    if (!VolumetricDataCall::GetMetadata(*src)) {
+        return false;
+    }
+    if ((src->GetMetadata()->GridType != geocalls::CARTESIAN) ||
+        (getDifferenceType(*src->GetMetadata()) == geocalls::UNKNOWN)) {
+        Log::DefaultLog.WriteError(
+            "%hs is only supported for Cartesian grids of numbers.", DifferenceVolume::ClassName());
+        return false;
+    }
+    this->brickMetadata = *src->GetMetadata();
+
+    /* Keep the bricks of the current frame, the source reuses their memory. */
+    if (!(*src)(VolumetricDataCall::IDX_GET_BRICKS)) {
+        Log::DefaultLog.WriteError("%hs failed to call %hs.", DifferenceVolume::ClassName(),
+            VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS));
+        return false;
+    }
+    const auto levels = src->GetLevels();
+    const auto voxelSize = src->GetMetadata()->ScalarLength * src->GetMetadata()->Components;
+    std::size_t cntVoxels = 0;
+    std::size_t maxVoxels = 0;
+    this->bricks.assign(src->GetBricks(), src->GetBricks() + src->GetBrickCount());
+    for (const auto& b : this->bricks) {
+        const auto voxels = b.Resolution[0] * b.Resolution[1] * b.Resolution[2];
+        cntVoxels += voxels;
+        maxVoxels = (std::max)(maxVoxels, voxels);
+    }
+    this->brickCache.resize(cntVoxels * voxelSize);
+    for (std::size_t i = 0, offset = 0; i < this->bricks.size(); ++i) {
+        auto& b = this->bricks[i];
+        const auto size = b.Resolution[0] * b.Resolution[1] * b.Resolution[2] * voxelSize;
+        ::memcpy(this->brickCache.data() + offset, b.Data, size);
+        b.Data = this->brickCache.data() + offset;
+        offset += size;
+    }
+
+    /* Get the same bricks of the previous frame or treat it as zero. */
+    std::vector<std::uint8_t> zero;
+    if (dst->FrameID() < 1) {
+        zero.resize(maxVoxels * voxelSize);
+    } else {
+        src->SetFrameID(dst->FrameID() - 1, true);
+        if (!(*src)(VolumetricDataCall::IDX_GET_BRICKS)) {
+            Log::DefaultLog.WriteError("%hs failed to call %hs.", DifferenceVolume::ClassName(),
+                VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS));
+            return false;
+        }
+        bool isCompatible = (src->GetBrickCount() == this->bricks.size());
+        for (std::size_t i = 0; isCompatible && (i < this->bricks.size()); ++i) {
+            const auto& c = this->bricks[i];
+            const auto& p = src->GetBricks()[i];
+            isCompatible = (c.Level == p.Level) && std::equal(c.Offset, c.Offset + 3, p.Offset) &&
+                           std::equal(c.Resolution, c.Resolution + 3, p.Resolution);
+        }
+        if (!isCompatible) {
+            Log::DefaultLog.WriteError("The bricks must not change over time in order for %hs to work.",
+                DifferenceVolume::ClassName());
+            return false;
+        }
+    }
+
+    /* Compute the differences, the voxels of the result may be wider. */
+    const auto components = this->brickMetadata.Components;
+    const auto diffVoxelSize = getDifferenceLength(this->brickMetadata) * components;
+    std::vector<double> minValues(components, (std::numeric_limits<double>::max)());
+    std::vector<double> maxValues(components, std::numeric_limits<double>::lowest());
+    this->brickData.resize(cntVoxels * diffVoxelSize);
+    for (std::size_t i = 0, offset = 0; i < this->bricks.size(); ++i) {
+        auto& b = this->bricks[i];
+        const auto voxels = b.Resolution[0] * b.Resolution[1] * b.Resolution[2];
+        const auto prev = zero.empty() ? src->GetBricks()[i].Data : zero.data();
+        if (!calcBrickDifference(this->brickMetadata, this->brickData.data() + offset, b.Data, prev,
+                voxels * components, minValues.data(), maxValues.data())) {
+            Log::DefaultLog.WriteError("%hs cannot process %u-byte scalars of type %u.", DifferenceVolume::ClassName(),
+                this->brickMetadata.ScalarLength, this->brickMetadata.ScalarType);
+            return false;
+        }
+        b.Data = this->brickData.data() + offset;
+        // the brick statistics of the source do not apply to the differences
+        b.MinValues = nullptr;
+        b.MaxValues = nullptr;
+        offset += voxels * diffVoxelSize;
+    }
+
+    this->brickMetadata.ScalarType = getDifferenceType(this->brickMetadata);
+    this->brickMetadata.ScalarLength = getDifferenceLength(this->brickMetadata);
+    if ((this->brickMetadata.MinValues != nullptr) && (this->brickMetadata.MaxValues != nullptr) &&
+        !this->bricks.empty()) {
+        std::copy(minValues.begin(), minValues.end(), this->brickMetadata.MinValues);
+        std::copy(maxValues.begin(), maxValues.end(), this->brickMetadata.MaxValues);
+    }
+
+    dst->SetBricks(this->bricks.data(), this->bricks.size(), levels);
+    dst->SetMetadata(&this->brickMetadata);
+    dst->SetDataHash(this->getHash());
+    return true;
+}
+
+
 /*
  * megamol::volume::DifferenceVolume::onGetExtents
  */
@@ -484,6 +698,9 @@ bool megamol::volume::DifferenceVolume::onUnsupported(core::Call& call) {
  * megamol::volume::DifferenceVolume::release
  */
 void megamol::volume::DifferenceVolume::release(void) {
+    this->brickCache.clear();
+    this->brickData.clear();
+    this->bricks.clear();
     for (auto& c : this->cache) {
         c.clear();
     }
@@ -79,6 +79,11 @@ protected:
      */
     static geocalls::ScalarType_t getDifferenceType(const geocalls::VolumetricMetadata_t& md);
 
+    /**
+     * Gets the length of a scalar in bytes used for the difference volume.
+     */
+    static std::size_t getDifferenceLength(const geocalls::VolumetricMetadata_t& md);
+
     /**
      * Increment the cache ring index.
      */
@@ -92,6 +97,23 @@ protected:
     template<class D, class S>
     void calcDifference(D* dst, const S* cur, const S* prev, const std::size_t cnt);
 
+    /**
+     * Compute the difference from 'prev' to 'cur' into 'dst' and extend
+     * the per-component range in 'minValues' and 'maxValues' by it.
+     */
+    template<class D, class S>
+    static void calcBrickDifference(D* dst, const S* cur, const S* prev, const std::size_t cnt,
+        const std::size_t components, double* minValues, double* maxValues);
+
+    /**
+     * Calls calcBrickDifference for the scalar type of 'md', 'dst' must use
+     * the type answered by getDifferenceType and getDifferenceLength.
+     *
+     * @return false if the scalar type of 'md' is not supported.
+     */
+    static bool calcBrickDifference(const geocalls::VolumetricMetadata_t& md, void* dst, const void* cur,
+        const void* prev, const std::size_t cnt, double* minValues, double* maxValues);
+
     /**
      * Check whether the given metadata are compatible with the cache state
      * of the module.
@@ -125,6 +147,16 @@ protected:
      */
     bool onGetData(core::Call& call);
 
+    /**
+     * Gets the difference of the requested bricks to the same bricks of the
+     * previous frame.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool onGetBricks(core::Call& call);
+
     /**
      * Gets the data extents.
      *
@@ -154,6 +186,10 @@ protected:
     virtual void release(void) override;
 
 private:
+    std::vector<std::uint8_t> brickCache;
+    std::vector<std::uint8_t> brickData;
+    geocalls::VolumetricMetadataStore brickMetadata;
+    std::vector<geocalls::VolumetricBrick_t> bricks;
     std::array<std::vector<std::uint8_t>, 2> cache;
     std::vector<std::uint8_t> data;
     unsigned int frameID;
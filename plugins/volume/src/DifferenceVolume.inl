@@ -33,3 +33,21 @@ void megamol::volume::DifferenceVolume::calcDifference(D* dst, const S* cur, con
         }
     }
 }
+
+
+/*
+ * megamol::volume::DifferenceVolume::calcBrickDifference
+ */
+template<class D, class S>
+void megamol::volume::DifferenceVolume::calcBrickDifference(D* dst, const S* cur, const S* prev,
+    const std::size_t cnt, const std::size_t components, double* minValues, double* maxValues) {
+    for (std::size_t i = 0; i < cnt; ++i) {
+        dst[i] = static_cast<D>(cur[i]) - static_cast<D>(prev[i]);
+        if (dst[i] < minValues[i % components]) {
+            minValues[i % components] = dst[i];
+        }
+        if (dst[i] > maxValues[i % components]) {
+            maxValues[i % components] = dst[i];
+        }
+    }
+}
@@ -42,6 +42,7 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
         , paramAsyncSleep("AsyncSleep", "The time in milliseconds that the loader sleeps between two frames.")
         , paramAsyncWake("AsyncWake", "The time in milliseconds after that the loader wakes itself.")
         , paramBuffers("Buffers", "The number of buffers for loading frames asynchronously.")
+        , paramBrickSize("BrickSize", "The edge length of the bricks of the resolution pyramid in voxels.")
         , paramFileName("FileName", "The path to the dat file to be loaded.")
         , paramOutputDataSize("OutputDataSize", "Forces the scalar type to the specified size.")
         , paramOutputDataType("OutputDataType", "Enforces the type of a scalar during loading.")
@@ -61,6 +62,9 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
     this->paramBuffers.SetParameter(new core::param::IntParam(2, 2));
     this->MakeSlotAvailable(&this->paramBuffers);
 
+    this->paramBrickSize.SetParameter(new core::param::IntParam(64, 8, 1024));
+    this->MakeSlotAvailable(&this->paramBrickSize);
+
     this->paramFileName.SetParameter(new core::param::FilePathParam(""));
     this->paramFileName.SetUpdateCallback(&VolumetricDataSource::onFileNameChanged);
     this->MakeSlotAvailable(&this->paramFileName);
@@ -99,6 +103,8 @@ megamol::volume::VolumetricDataSource::VolumetricDataSource(void)
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_STOP_ASYNC), &VolumetricDataSource::onStopAsync);
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &VolumetricDataSource::onTryGetData);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_BRICKS), &VolumetricDataSource::onGetBricks);
     this->MakeSlotAvailable(&this->slotGetData);
 }
 
@@ -207,6 +213,30 @@ DatRawDataFormat megamol::volume::VolumetricDataSource::getOutputDataFormat(void
 }
 
 
+/*
+ * megamol::volume::VolumetricDataSource::loadFrame
+ */
+bool megamol::volume::VolumetricDataSource::loadFrame(
+    const unsigned int frameID, void* dst, const DatRawDataFormat format) {
+    using megamol::core::utility::log::Log;
+    ASSERT(this->fileInfo != nullptr);
+
+    if (this->compressed.IsOpen()) {
+        if (format != this->compressed.GetLayout().Format) {
+            Log::DefaultLog.WriteError(_T("The scalars of a compressed volume cannot be converted to %hs."),
+                ::datRaw_getDataFormatName(format));
+            return false;
+        }
+        return this->compressed.LoadFrame(frameID, dst);
+
+    } else {
+        auto retval = (::datRaw_loadStep(this->fileInfo, static_cast<int>(frameID), &dst, format) != 0);
+        ::datRaw_close(this->fileInfo);
+        return retval;
+    }
+}
+
+
 /*
  * megamol::volume::VolumetricDataSource::onFileNameChanged
  */
@@ -214,6 +244,10 @@ bool megamol::volume::VolumetricDataSource::onFileNameChanged(core::param::Param
     using geocalls::VolumetricDataCall;
     using megamol::core::utility::log::Log;
 
+    /* The bricks of the previous data set are not valid any more. */
+    this->pyramid.Close();
+    this->compressed.Close();
+
     /* Allocate header or prepare it for re-use. */
     if (this->fileInfo == nullptr) {
         this->fileInfo = new DatRawFileInfo();
@@ -366,6 +400,32 @@ bool megamol::volume::VolumetricDataSource::onFileNameChanged(core::param::Param
         this->metadata.NumberOfFrames = this->fileInfo->timeSteps;
         Log::DefaultLog.WriteInfo(_T("The data set comprises %u frames."), this->metadata.NumberOfFrames);
 
+        /* Check whether the data file is a compressed volume rather than raw voxels. */
+        if ((this->fileInfo->multiDataFiles == FALSE) && (this->fileInfo->dataFileName != nullptr) &&
+            CompressedVolume::IsCompressedVolume(this->fileInfo->dataFileName)) {
+            if (this->compressed.Open(this->fileInfo->dataFileName)) {
+                const auto& layout = this->compressed.GetLayout();
+                bool isMatch = (layout.Format == this->fileInfo->dataFormat) &&
+                               (layout.Components == static_cast<size_t>(this->fileInfo->numComponents)) &&
+                               (layout.Frames >= static_cast<size_t>(this->fileInfo->timeSteps));
+                for (int d = 0; d < 3; ++d) {
+                    const auto res = (d < this->fileInfo->dimensions) ? this->fileInfo->resolution[d] : 1;
+                    isMatch = isMatch && (layout.Resolution[d] == static_cast<size_t>(res));
+                }
+                if (isMatch) {
+                    Log::DefaultLog.WriteInfo(_T("The voxels are stored in the compressed volume %hs."),
+                        this->fileInfo->dataFileName);
+                } else {
+                    Log::DefaultLog.WriteError(_T("The compressed volume %hs does not match the dat file."),
+                        this->fileInfo->dataFileName);
+                    this->compressed.Close();
+                }
+            } else {
+                Log::DefaultLog.WriteError(
+                    _T("Failed to open the compressed volume %hs."), this->fileInfo->dataFileName);
+            }
+        }
+
         /* Compute extents. */
         ::ZeroMemory(this->metadata.Extents, sizeof(this->metadata.Extents));
         for (int d = 0; (d < STATIC_ARRAY_COUNT(this->metadata.Extents)) && (d < this->fileInfo->dimensions); ++d) {
@@ -664,8 +724,7 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
                                               _T("%hs to 0x%p"),
                         frameID, ::datRaw_getDataFormatName(format), dst.PeekElements());
 #endif /* (defined(DEBUG) || defined(_DEBUG)) */
-                    retval = (::datRaw_loadStep(this->fileInfo, static_cast<int>(frameID), &buffer, format) != 0);
-                    ::datRaw_close(this->fileInfo);
+                    retval = this->loadFrame(static_cast<unsigned int>(frameID), buffer, format);
                     if (!retval) {
                         Log::DefaultLog.WriteError(_T("Loading frame %u failed."), frameID);
                         break;
@@ -724,6 +783,92 @@ bool megamol::volume::VolumetricDataSource::onGetData(core::Call& call) {
 }
 
 
+/*
+ * megamol::volume::VolumetricDataSource::onGetBricks
+ */
+bool megamol::volume::VolumetricDataSource::onGetBricks(core::Call& call) {
+    using core::param::FilePathParam;
+    using core::param::IntParam;
+    using geocalls::VolumetricDataCall;
+    using megamol::core::utility::log::Log;
+
+    try {
+        VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
+        c.SetBricks(nullptr, 0, 0);
+
+        /* Sanity check. */
+        if (this->fileInfo == nullptr) {
+            throw vislib::IllegalStateException(_T("A valid dat file must be ")
+                                                _T("loaded before bricks can be read."),
+                __FILE__, __LINE__);
+        }
+        if (c.FrameID() >= this->metadata.NumberOfFrames) {
+            Log::DefaultLog.WriteError(_T("The requested frame %u does not exist."), c.FrameID());
+            return false;
+        }
+
+        BrickPyramid::Layout layout;
+        layout.Format = this->getOutputDataFormat();
+        std::copy(this->metadata.Resolution, this->metadata.Resolution + 3, layout.Resolution);
+        layout.Components = this->metadata.Components;
+        layout.Frames = this->metadata.NumberOfFrames;
+        layout.BrickSize = static_cast<size_t>(this->paramBrickSize.Param<IntParam>()->Value());
+
+        const auto datFile = this->paramFileName.Param<FilePathParam>()->Value();
+        const auto rawFile = (this->fileInfo->multiDataFiles != FALSE)
+                                 ? std::filesystem::path()
+                                 : std::filesystem::path(this->fileInfo->dataFileName);
+        if (!this->pyramid.Open(datFile, rawFile, layout, c.IsBuildAllowed())) {
+            return false;
+        }
+
+        if (!this->pyramid.IsBuilt(c.FrameID())) {
+            if (!c.IsBuildAllowed()) {
+                return false;
+            }
+
+            /*
+             * datraw can only read whole frames, so the pyramid of a frame
+             * is built from a single full read. The loader thread must not
+             * use the file in the meantime.
+             */
+            Log::DefaultLog.WriteInfo(_T("Building the bricks of frame %u..."), c.FrameID());
+            std::vector<BYTE> frame(this->calcFrameSize());
+            bool isResume = this->suspendAsyncLoad(true);
+            bool isLoaded = this->loadFrame(c.FrameID(), frame.data(), static_cast<DatRawDataFormat>(layout.Format));
+            if (isResume) {
+                this->resumeAsyncLoad();
+            }
+            if (!isLoaded) {
+                Log::DefaultLog.WriteError(_T("Loading frame %u failed."), c.FrameID());
+                return false;
+            }
+            if (!this->pyramid.Build(c.FrameID(), frame.data())) {
+                return false;
+            }
+        }
+
+        if (!this->pyramid.Query(c.FrameID(), c.GetRequestedLevel(), c.GetRegionMin(), c.GetRegionMax())) {
+            return false;
+        }
+
+        const auto& bricks = this->pyramid.Bricks();
+        c.SetBricks(bricks.data(), bricks.size(), this->pyramid.Levels());
+        c.SetMetadata(&this->metadata);
+        c.SetDataHash(this->dataHash);
+        return true;
+
+    } catch (vislib::Exception e) {
+        Log::DefaultLog.WriteError(1, e.GetMsg());
+        return false;
+    } catch (...) {
+        Log::DefaultLog.WriteError(1, _T("Unexpected exception in callback ")
+                                      _T("onGetBricks (please check the call)."));
+        return false;
+    }
+}
+
+
 /*
  * megamol::volume::VolumetricDataSource::onGetExtents
  */
@@ -1020,6 +1165,8 @@ void megamol::volume::VolumetricDataSource::release(void) {
 
     if (this->fileInfo != nullptr) {
         Log::DefaultLog.WriteInfo(10, _T("Releasing dat file..."));
+        this->pyramid.Close();
+        this->compressed.Close();
         ::datRaw_close(this->fileInfo);
         ::datRaw_freeInfo(this->fileInfo);
         SAFE_DELETE(this->fileInfo);
@@ -1160,7 +1307,7 @@ DWORD megamol::volume::VolumetricDataSource::loadAsync(void* userData) {
                                               _T("%hs to 0x%p (async)."),
                         that->buffers[i]->FrameID, ::datRaw_getDataFormatName(format), dst);
 #endif /* (defined(DEBUG) || defined(_DEBUG)) */
-                    if (::datRaw_loadStep(that->fileInfo, static_cast<int>(that->buffers[i]->FrameID), &dst, format)) {
+                    if (that->loadFrame(that->buffers[i]->FrameID, dst, format)) {
                         that->buffers[i]->status.store(BUFFER_STATUS_READY);
                     } else {
                         Log::DefaultLog.WriteError(_T("Loading frame %u ")
@@ -1168,7 +1315,6 @@ DWORD megamol::volume::VolumetricDataSource::loadAsync(void* userData) {
                             that->buffers[i]->FrameID);
                         that->buffers[i]->status.store(BUFFER_STATUS_UNUSED);
                     }
-                    ::datRaw_close(that->fileInfo);
 
                     /* Sleep if requested by user. */
                     auto asyncSleep = that->paramAsyncSleep.Param<IntParam>()->Value();
@@ -13,6 +13,8 @@
 
 #include "datRaw.h"
 
+#include "BrickPyramid.h"
+#include "CompressedVolume.h"
 #include "geometry_calls/VolumetricDataCall.h"
 
 #include "mmcore/param/ParamSlot.h"
@@ -97,6 +99,20 @@ protected:
      */
     DatRawDataFormat getOutputDataFormat(void) const;
 
+    /**
+     * Loads a whole frame either from the raw file(s) or by decompressing
+     * it from the compressed volume container.
+     *
+     * @param frameID The frame to load.
+     * @param dst     Receives the frame, which must be large enough to hold
+     *                'calcFrameSize' bytes.
+     * @param format  The format of the scalars in 'dst'. The scalars of a
+     *                compressed volume cannot be converted.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool loadFrame(const unsigned int frameID, void* dst, const DatRawDataFormat format);
+
     /**
      * Handles a change of 'paramFileName'.
      *
@@ -115,6 +131,16 @@ protected:
      */
     bool onGetData(core::Call& call);
 
+    /**
+     * Gets the bricks of the requested region and level of detail. The
+     * resolution pyramid of a frame is built on the first request.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool onGetBricks(core::Call& call);
+
     /**
      * Gets the data extents.
      *
@@ -338,6 +364,9 @@ private:
     /** The buffers that volume data can be loaded to. */
     vislib::PtrArray<BufferSlot> buffers;
 
+    /** The container if the dat file references a compressed volume. */
+    CompressedVolume compressed;
+
     /** Hash for the data set. */
     unsigned int dataHash;
 
@@ -359,6 +388,9 @@ private:
      */
     geocalls::VolumetricDataCall::Metadata metadata;
 
+    /** The bricked resolution pyramid cached next to the dat file. */
+    BrickPyramid pyramid;
+
     /**
      * Determines how long the loader thread sleeps after it loaded a
      * frame. If zero, the loader will not sleep.
@@ -378,6 +410,9 @@ private:
      */
     core::param::ParamSlot paramBuffers;
 
+    /** The edge length of the bricks of the resolution pyramid. */
+    core::param::ParamSlot paramBrickSize;
+
     /** The path to the dat file. */
     core::param::ParamSlot paramFileName;
 
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "datatools/clustering/DBSCAN.h"
+
+using namespace megamol::datatools;
+using namespace megamol::datatools::clustering;
+
+namespace {
+
+/**
+ * Generates x, y, z, intensity of 'count' particles like ParticleBoxGeneratorDataSource with 'store::color' = If:
+ * a regular grid in [-1, 1]^3 with positional noise of 'noise' radii and random intensities.
+ */
+std::vector<float> generateBox(uint32_t count, float radiusScale, float noise, uint32_t seed) {
+    std::mt19937 rnd_engine(seed);
+    std::uniform_real_distribution<float> rnd_uni;
+
+    auto const xcnt = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(count))));
+    auto const yzcnt = std::ceil(static_cast<float>(count) / static_cast<float>(xcnt));
+    auto const ycnt = static_cast<uint32_t>(std::ceil(std::sqrt(yzcnt)));
+    auto const zcnt = static_cast<uint32_t>(std::ceil(yzcnt / static_cast<float>(ycnt)));
+
+    float const x_a = 2.0f / static_cast<float>(xcnt);
+    float const y_a = 2.0f / static_cast<float>(ycnt);
+    float const z_a = 2.0f / static_cast<float>(zcnt);
+    float const rad = std::min(std::min(x_a, y_a), z_a) * 0.5f * radiusScale;
+    float const pn = rad * noise;
+
+    std::vector<float> points;
+    points.reserve(static_cast<size_t>(count) * 4);
+    uint32_t i_all = 0;
+    for (uint32_t iz = 0; (iz < zcnt) && (i_all < count); ++iz) {
+        for (uint32_t iy = 0; (iy < ycnt) && (i_all < count); ++iy) {
+            for (uint32_t ix = 0; (ix < xcnt) && (i_all < count); ++ix, ++i_all) {
+                points.push_back(-1.0f + x_a * (ix + 0.5f) + (rnd_uni(rnd_engine) * 2.0f - 1.0f) * pn);
+                points.push_back(-1.0f + y_a * (iy + 0.5f) + (rnd_uni(rnd_engine) * 2.0f - 1.0f) * pn);
+                points.push_back(-1.0f + z_a * (iz + 0.5f) + (rnd_uni(rnd_engine) * 2.0f - 1.0f) * pn);
+                points.push_back(rnd_uni(rnd_engine));
+            }
+        }
+    }
+    return points;
+}
+
+/** Number of clusters, not counting noise */
+index_t clusterCount(cluster_result_t const& res) {
+    auto const max = res.empty() ? 0 : *std::max_element(res.cbegin(), res.cend());
+    return (max > static_cast<cluster_type_ut>(cluster_type::NOISE)) ? (max - 1) : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if ((argc > 1) && (argv[1][0] == '-')) {
+        std::cout << "Usage: " << argv[0] << " [count [eps [minpts [icolWeight [repeats]]]]]" << std::endl;
+        return 0;
+    }
+    auto const count = static_cast<uint32_t>((argc > 1) ? std::atol(argv[1]) : 1000000);
+    auto const eps = static_cast<float>((argc > 2) ? std::atof(argv[2]) : 0.01);
+    auto const minpts = static_cast<index_t>((argc > 3) ? std::atol(argv[3]) : 4);
+    auto const icol_weight = static_cast<float>((argc > 4) ? std::atof(argv[4]) : 0.5);
+    auto const repeats = (argc > 5) ? std::max(1, std::atoi(argv[5])) : 3;
+
+    // the same preparation as ParticleIColClustering
+    std::array<float, 4> const weights = {
+        (1.0f - icol_weight), (1.0f - icol_weight), (1.0f - icol_weight), icol_weight};
+    std::array<float, 8> const bbox = {-1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 1.0f};
+    genericPointcloud<float, 4> points(generateBox(count, 0.5f, 1.25f, 2007), bbox, weights);
+    points.normalize_data();
+    auto const tree = std::make_shared<kd_tree_t<float, 4>>(4, points, nanoflann::KDTreeSingleIndexAdaptorParams());
+    tree->buildIndex();
+
+    std::cout << "Particles: " << count << std::endl;
+    std::cout << "eps:       " << eps << std::endl;
+    std::cout << "minpts:    " << minpts << std::endl;
+
+    double serial_ms = 0.0, parallel_ms = 0.0;
+    cluster_result_t serial_res, parallel_res;
+    for (int r = 0; r < repeats; ++r) {
+        auto const serial_start = std::chrono::steady_clock::now();
+        serial_res = DBSCAN(tree, eps * eps, minpts);
+        auto const serial_end = std::chrono::steady_clock::now();
+        parallel_res = DBSCAN_parallel(tree, eps * eps, minpts);
+        auto const parallel_end = std::chrono::steady_clock::now();
+        serial_ms += std::chrono::duration<double, std::milli>(serial_end - serial_start).count();
+        parallel_ms += std::chrono::duration<double, std::milli>(parallel_end - serial_end).count();
+    }
+
+    std::cout << "serial:    " << serial_ms / repeats << " ms, " << clusterCount(serial_res) << " clusters"
+              << std::endl;
+    std::cout << "parallel:  " << parallel_ms / repeats << " ms, " << clusterCount(parallel_res) << " clusters"
+              << std::endl;
+    std::cout << "speedup:   " << serial_ms / std::max(parallel_ms, 1e-9) << std::endl;
+
+    return (clusterCount(serial_res) == clusterCount(parallel_res)) ? 0 : 1;
+}
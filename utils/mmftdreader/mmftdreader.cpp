@@ -1,9 +1,15 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
 
+#ifdef MMFTDREADER_WITH_ZLIB
+#include "zlib.h"
+#endif
+
 #if defined(_HAS_CXX17) || ((defined(_MSC_VER) && (_MSC_VER > 1916))) // C++2017 or since VS2019
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -23,15 +29,78 @@ struct ColumnInfo {
     float max;
 };
 
+struct ChunkInfo {
+    uint64_t offset;
+    uint64_t size;
+    uint8_t compression;
+    float min;
+    float max;
+};
+
+struct RowGroupInfo {
+    uint64_t rowCount;
+    std::vector<ChunkInfo> chunks;
+};
+
+const char* compressionName(uint8_t compression) {
+    switch (compression) {
+    case 0:
+        return "none";
+    case 1:
+        return "deflate";
+    default:
+        return "unknown";
+    }
+}
+
+// see MMFTFormat.h of the datatools plugin
+bool readChunk(std::ifstream& file, const ChunkInfo& chunk, uint64_t rowCount, float* values) {
+    std::vector<uint8_t> stored(chunk.size);
+    file.seekg(chunk.offset);
+    file.read(reinterpret_cast<char*>(stored.data()), chunk.size);
+    if (!file.good()) {
+        return false;
+    }
+    const uint64_t byteSize = rowCount * sizeof(float);
+    if (chunk.compression == 0) {
+        if (chunk.size != byteSize) {
+            return false;
+        }
+        std::memcpy(values, stored.data(), byteSize);
+        return true;
+    }
+#ifdef MMFTDREADER_WITH_ZLIB
+    if (chunk.compression == 1) {
+        std::vector<uint8_t> shuffled(byteSize);
+        uLongf destLen = static_cast<uLongf>(byteSize);
+        if (uncompress(shuffled.data(), &destLen, stored.data(), static_cast<uLong>(chunk.size)) != Z_OK ||
+            destLen != byteSize) {
+            return false;
+        }
+        auto* dst = reinterpret_cast<uint8_t*>(values);
+        for (uint64_t i = 0; i < rowCount; ++i) {
+            for (size_t b = 0; b < sizeof(float); ++b) {
+                dst[i * sizeof(float) + b] = shuffled[b * rowCount + i];
+            }
+        }
+        return true;
+    }
+#endif
+    return false;
+}
+
 int main(int argc, char* argv[]) {
     using namespace std::string_literals;
 
-    if (argc != 2) {
-        std::cerr << "mmftdreader" << std::endl << "Usage: ./mmftdreader <mmftd file>" << std::endl;
+    bool statsOnly = (argc == 3) && (argv[1] == "--stats"s);
+    if (argc != 2 && !statsOnly) {
+        std::cerr << "mmftdreader" << std::endl
+                  << "Usage: ./mmftdreader [--stats] <mmftd file>" << std::endl
+                  << "  --stats  show the row group statistics instead of the table data" << std::endl;
         return 1;
     }
 
-    fs::path filename(argv[1]);
+    fs::path filename(argv[argc - 1]);
 
     if (!fs::is_regular_file(filename)) {
         std::cerr << "File not found: " << filename.string() << std::endl;
@@ -58,6 +127,10 @@ int main(int argc, char* argv[]) {
     uint16_t version;
     file.read(reinterpret_cast<char*>(&version), sizeof(uint16_t));
     std::cout << "Version:   " << version << std::endl;
+    if (version != 0 && version != 2) {
+        std::cerr << "Unsupported file version." << std::endl;
+        return 1;
+    }
 
     uint32_t colCount;
     file.read(reinterpret_cast<char*>(&colCount), sizeof(uint32_t));
@@ -68,7 +141,7 @@ int main(int argc, char* argv[]) {
         file.read(reinterpret_cast<char*>(&info[i].nameLength), sizeof(uint16_t));
         std::vector<char> nameBuf(info[i].nameLength);
         file.read(nameBuf.data(), info[i].nameLength);
-        info[i].name = std::string(nameBuf.data());
+        info[i].name = std::string(nameBuf.begin(), std::find(nameBuf.begin(), nameBuf.end(), '\0'));
         file.read(reinterpret_cast<char*>(&info[i].type), sizeof(uint8_t));
         file.read(reinterpret_cast<char*>(&info[i].min), sizeof(float));
         file.read(reinterpret_cast<char*>(&info[i].max), sizeof(float));
@@ -78,6 +151,32 @@ int main(int argc, char* argv[]) {
     file.read(reinterpret_cast<char*>(&rowCount), sizeof(uint64_t));
     std::cout << "Rows:      " << rowCount << std::endl;
 
+    std::vector<RowGroupInfo> groups;
+    if (version == 2) {
+        uint64_t directoryOffset;
+        file.read(reinterpret_cast<char*>(&directoryOffset), sizeof(uint64_t));
+        file.seekg(directoryOffset);
+        uint32_t groupCount = 0;
+        file.read(reinterpret_cast<char*>(&groupCount), sizeof(uint32_t));
+        groups.resize(groupCount);
+        for (auto& g : groups) {
+            file.read(reinterpret_cast<char*>(&g.rowCount), sizeof(uint64_t));
+            g.chunks.resize(colCount);
+            for (auto& c : g.chunks) {
+                file.read(reinterpret_cast<char*>(&c.offset), sizeof(uint64_t));
+                file.read(reinterpret_cast<char*>(&c.size), sizeof(uint64_t));
+                file.read(reinterpret_cast<char*>(&c.compression), sizeof(uint8_t));
+                file.read(reinterpret_cast<char*>(&c.min), sizeof(float));
+                file.read(reinterpret_cast<char*>(&c.max), sizeof(float));
+            }
+        }
+        if (!file.good()) {
+            std::cerr << "Invalid row group directory." << std::endl;
+            return 1;
+        }
+        std::cout << "Groups:    " << groupCount << std::endl;
+    }
+
     std::cout << std::endl
               << "# Table Column Info" << std::endl
               << std::endl
@@ -94,8 +193,71 @@ int main(int argc, char* argv[]) {
     }
     std::cout << "|----------------------|------|--------------|--------------|" << std::endl;
 
+    if (statsOnly) {
+        if (version == 0) {
+            std::cout << std::endl << "Version 0 files have no row groups." << std::endl;
+            return 0;
+        }
+
+        std::cout << std::endl
+                  << "# Row Group Statistics" << std::endl
+                  << std::endl
+                  << "| Group  | Rows       | Column               | Compression | Stored     | Ratio  | Min          "
+                     "| Max          |"
+                  << std::endl
+                  << "|--------|------------|----------------------|-------------|------------|--------|--------------"
+                     "|--------------|"
+                  << std::endl;
+        uint64_t stored = 0;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            for (uint32_t c = 0; c < colCount; ++c) {
+                const auto& chunk = groups[g].chunks[c];
+                stored += chunk.size;
+                const double ratio = groups[g].rowCount == 0
+                                         ? 1.0
+                                         : static_cast<double>(chunk.size) / (groups[g].rowCount * sizeof(float));
+                // clang-format off
+                std::cout << "| " << std::right << std::setw(6) << g
+                          << " | " << std::setw(10) << groups[g].rowCount
+                          << " | " << std::left << std::setw(20) << info[c].name
+                          << " | " << std::setw(11) << compressionName(chunk.compression)
+                          << " | " << std::right << std::setw(10) << chunk.size
+                          << " | " << std::setw(6) << std::fixed << std::setprecision(3) << ratio
+                          << std::defaultfloat << std::setprecision(6)
+                          << " | " << std::setw(12) << chunk.min
+                          << " | " << std::setw(12) << chunk.max
+                          << " |" << std::endl;
+                // clang-format on
+            }
+        }
+        std::cout << std::endl
+                  << "Stored column data: " << stored << " bytes ("
+                  << rowCount * colCount * sizeof(float) << " bytes uncompressed)" << std::endl;
+        return 0;
+    }
+
     std::vector<float> data(rowCount * colCount);
-    file.read(reinterpret_cast<char*>(data.data()), rowCount * colCount * sizeof(float));
+    if (version == 0) {
+        file.read(reinterpret_cast<char*>(data.data()), rowCount * colCount * sizeof(float));
+    } else {
+        uint64_t firstRow = 0;
+        std::vector<float> column;
+        for (const auto& g : groups) {
+            column.resize(g.rowCount);
+            for (uint32_t c = 0; c < colCount; ++c) {
+                if (!readChunk(file, g.chunks[c], g.rowCount, column.data())) {
+                    std::cerr << "Cannot read the chunk of column " << info[c].name << " at offset "
+                              << g.chunks[c].offset << " (" << compressionName(g.chunks[c].compression) << ")."
+                              << std::endl;
+                    return 1;
+                }
+                for (uint64_t r = 0; r < g.rowCount; ++r) {
+                    data[(firstRow + r) * colCount + c] = column[r];
+                }
+            }
+            firstRow += g.rowCount;
+        }
+    }
 
     // clang-format off
     std::cout << std::endl
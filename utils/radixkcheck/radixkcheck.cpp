@@ -0,0 +1,117 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <mpi.h>
+
+#include "FBORadixKCompositor.h"
+
+using megamol::remote::FBORadixKCompositor;
+
+namespace {
+
+/** Deterministic color and depth image of a rank, so every rank can compute the expected result */
+void makeImage(int rank, size_t numPixels, std::vector<char>& color, std::vector<float>& depth) {
+    std::mt19937 rng(static_cast<unsigned int>(rank) * 7919u + 1u);
+    std::uniform_real_distribution<float> distr(0.0f, 1.0f);
+    color.resize(numPixels * 4);
+    depth.resize(numPixels);
+    for (size_t p = 0; p < numPixels; ++p) {
+        // ties are resolved differently depending on the order of the rounds, so make all depths distinct
+        depth[p] = distr(rng) + static_cast<float>(rank) * 1e-6f;
+        uint32_t const c = rng();
+        std::memcpy(color.data() + p * 4, &c, 4);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int const k = (argc > 1) ? std::atoi(argv[1]) : 2;
+    int const width = (argc > 2) ? std::atoi(argv[2]) : 1920;
+    int const height = (argc > 3) ? std::atoi(argv[3]) : 1080;
+    int const frames = (argc > 4) ? std::atoi(argv[4]) : 10;
+    int const root = 0;
+    if ((k < 2) || (width < 1) || (height < 1) || (frames < 1)) {
+        if (rank == root) {
+            std::cerr << "Usage: mpirun -np N " << argv[0] << " [k [width height [frames]]]" << std::endl;
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    size_t const numPixels = static_cast<size_t>(width) * height;
+
+    std::vector<char> ownColor;
+    std::vector<float> ownDepth;
+    makeImage(rank, numPixels, ownColor, ownDepth);
+
+    FBORadixKCompositor compositor(MPI_COMM_WORLD, k);
+    std::vector<char> color, depth(numPixels * sizeof(float));
+    double seconds = 0.0;
+    bool ok = true;
+    for (int f = 0; f < frames; ++f) {
+        // the compositor overwrites the images
+        color = ownColor;
+        std::memcpy(depth.data(), ownDepth.data(), depth.size());
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto const start = std::chrono::steady_clock::now();
+        ok = compositor.Composite(color, depth, root) && ok;
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int failures = ok ? 0 : 1;
+    if (rank == root) {
+        // nearest fragment over the images of all ranks
+        std::vector<char> expColor(ownColor), otherColor;
+        std::vector<float> expDepth(ownDepth), otherDepth;
+        for (int r = 0; r < size; ++r) {
+            if (r == rank) {
+                continue;
+            }
+            makeImage(r, numPixels, otherColor, otherDepth);
+            for (size_t p = 0; p < numPixels; ++p) {
+                if (otherDepth[p] < expDepth[p]) {
+                    expDepth[p] = otherDepth[p];
+                    std::memcpy(expColor.data() + p * 4, otherColor.data() + p * 4, 4);
+                }
+            }
+        }
+        size_t wrong = 0;
+        for (size_t p = 0; p < numPixels; ++p) {
+            if ((std::memcmp(depth.data() + p * sizeof(float), &expDepth[p], sizeof(float)) != 0) ||
+                (std::memcmp(color.data() + p * 4, expColor.data() + p * 4, 4) != 0)) {
+                ++wrong;
+            }
+        }
+        if (wrong > 0) {
+            std::cerr << wrong << " of " << numPixels << " pixels differ from the reference" << std::endl;
+            ++failures;
+        }
+
+        std::cout << "Ranks:     " << size << std::endl;
+        std::cout << "Rounds:   ";
+        for (auto const r : compositor.Rounds()) {
+            std::cout << " " << r;
+        }
+        std::cout << std::endl;
+        std::cout << "Image:     " << width << " x " << height << std::endl;
+        std::cout << "Composite: " << 1000.0 * seconds / frames << " ms per frame" << std::endl;
+    }
+
+    int totalFailures = 0;
+    MPI_Reduce(&failures, &totalFailures, 1, MPI_INT, MPI_SUM, root, MPI_COMM_WORLD);
+    if (rank == root) {
+        std::cout << ((totalFailures == 0) ? "OK" : "FAILED") << std::endl;
+    }
+    MPI_Finalize();
+    return (totalFailures == 0) ? 0 : 1;
+}